@@ -1,18 +1,89 @@
 #!/usr/bin/env python2
 
 import sys
+import struct
 import pickle
 import argparse
 
+
+def read_exactly(stream, size):
+    data = b''
+    while len(data) < size:
+        chunk = stream.read(size - len(data))
+        if not chunk:
+            return None
+        data += chunk
+    return data
+
+
+def read_size(stream):
+    data = read_exactly(stream, 4)
+    if data is None:
+        return None
+    return struct.unpack('>I', data)[0]
+
+
+def decode_value(raw_pickle):
+    try:
+        value = pickle.loads(raw_pickle)
+    except UnicodeDecodeError:
+        # python 2 str pickles in python 3
+        value = pickle.loads(raw_pickle, encoding='bytes')
+
+    if isinstance(value, bytes):
+        return value
+    if isinstance(value, type(u'')):
+        return value.encode('utf-8')
+    return repr(value).encode('utf-8')
+
+
+def serve():
+    # length prefixed batches: uint32 count, then uint32 size + pickle per value,
+    # answers with uint32 count, then status byte + uint32 size + data per value
+    stdin = getattr(sys.stdin, 'buffer', sys.stdin)
+    stdout = getattr(sys.stdout, 'buffer', sys.stdout)
+    while True:
+        count = read_size(stdin)
+        if count is None:
+            return 0
+
+        values = []
+        for _ in range(count):
+            size = read_size(stdin)
+            data = read_exactly(stdin, size) if size is not None else None
+            if data is None:
+                return 1
+            values.append(data)
+
+        response = [struct.pack('>I', count)]
+        for data in values:
+            try:
+                decoded = decode_value(data)
+                response.append(struct.pack('>BI', 0, len(decoded)))
+                response.append(decoded)
+            except Exception:
+                response.append(struct.pack('>BI', 1, 0))
+
+        stdout.write(b''.join(response))
+        stdout.flush()
+
+
 if __name__ == "__main__":
     argc = len(sys.argv)
 
     parser = argparse.ArgumentParser()
-    parser.add_argument('data', help='pickle encode/decode hexed string', type=str)
+    parser.add_argument('data', nargs='?', help='pickle encode/decode hexed string', type=str)
     parser.add_argument('--encode', action='store_true', help='pickle encode string')
     parser.add_argument('--decode', action='store_false', help='pickle decode string')
+    parser.add_argument('--server', action='store_true', help='decode length prefixed pickles from stdin')
     args = parser.parse_args()
 
+    if args.server:
+        sys.exit(serve())
+
+    if args.data is None:
+        parser.error('data is required')
+
     hexed_data = args.data
     unhexed = hexed_data.replace('x', '')  # 1122
     raw_pickle = unhexed.decode('hex')
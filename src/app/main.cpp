@@ -22,10 +22,14 @@
 #include <signal.h>
 #endif
 
+#include <iostream>
+#include <string>
+
 #include <QApplication>
 #include <QFile>
 #include <QMessageBox>
 #include <QScreen>
+#include <QThread>
 
 #include <common/file_system/file.h>
 #include <common/file_system/file_system.h>
@@ -38,8 +42,12 @@
 
 #include "app/credentials_dialog.h"
 
+#include "proxy/metrics_exporter.h"
+#include "proxy/metrics_registry.h"
+#include "proxy/request_tracer.h"
 #include "proxy/server_config.h"
 #include "proxy/settings_manager.h"
+#include "proxy/startup_profiler.h"
 
 #include "gui/gui_factory.h"
 #include "gui/main_window.h"
@@ -181,9 +189,52 @@ class MainCredentialsDialog : public fastonosql::CredentialsDialog {
 }  // namespace
 
 int main(int argc, char* argv[]) {
+  // first call fixes process start time for all phases
+  fastonosql::proxy::StartupProfiler& profiler = fastonosql::proxy::StartupProfiler::GetInstance();
+  std::string trace_path;
+  uint16_t metrics_port = 0;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "--profile-startup") {
+      profiler.SetVerbose(true);
+    } else if (arg == "--trace-requests" && i + 1 < argc) {
+      trace_path = argv[++i];
+    } else if (arg == "--metrics-port" && i + 1 < argc) {
+      if (!common::ConvertFromString(std::string(argv[++i]), &metrics_port)) {
+        std::cerr << "Invalid metrics port: " << argv[i] << std::endl;
+        return EXIT_FAILURE;
+      }
+    } else if (arg == "--export-trace" && i + 2 < argc) {
+      // offline conversion of saved binary trace, no gui
+      common::Error err = fastonosql::proxy::RequestTracer::ExportChromeTrace(argv[i + 1], argv[i + 2]);
+      if (err) {
+        std::cerr << err->GetDescription() << std::endl;
+        return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+    }
+  }
+
+  if (metrics_port) {
+    fastonosql::proxy::MetricsRegistry::GetInstance().Enable();
+  }
+
+  fastonosql::proxy::RequestTracer& tracer = fastonosql::proxy::RequestTracer::GetInstance();
+  if (!trace_path.empty()) {
+    tracer.Enable();
+    tracer.SetThreadName("gui");
+  }
+
+  common::time64_t phase_start = common::time::current_utc_mstime();
   QApplication app(argc, argv);
+  profiler.AddPhase("qt application", phase_start, common::time::current_utc_mstime());
+
+  phase_start = common::time::current_utc_mstime();
   const auto settings_manager = fastonosql::proxy::SettingsManager::GetInstance();
   settings_manager->Load();
+  profiler.AddPhase("settings load", phase_start, common::time::current_utc_mstime());
+
+  phase_start = common::time::current_utc_mstime();
   app.setOrganizationName(PROJECT_COMPANYNAME);
   app.setOrganizationDomain(PROJECT_COMPANYNAME_DOMAIN);
   app.setApplicationName(PROJECT_NAME_TITLE);
@@ -198,6 +249,7 @@ int main(int argc, char* argv[]) {
   settings_manager->SetCurrentLanguage(new_language);
   common::qt::gui::applyStyle(settings_manager->GetCurrentStyle());
   common::qt::gui::applyFont(settings_manager->GetCurrentFont());
+  profiler.AddPhase("language and style", phase_start, common::time::current_utc_mstime());
 
   // EULA License Agreement
   if (!settings_manager->GetAccpetedEula()) {
@@ -307,6 +359,7 @@ int main(int argc, char* argv[]) {
 #endif
   }
 
+  phase_start = common::time::current_utc_mstime();
   QFile file(":" PROJECT_NAME_LOWERCASE "/default.qss");
   file.open(QFile::ReadOnly);
   QString styleSheet = QLatin1String(file.readAll());
@@ -324,7 +377,9 @@ int main(int argc, char* argv[]) {
 #endif
 
   INIT_TRANSLATION(PROJECT_NAME_LOWERCASE);
+  profiler.AddPhase("stylesheet and logger", phase_start, common::time::current_utc_mstime());
 
+  phase_start = common::time::current_utc_mstime();
   fastonosql::gui::MainWindow main_window;
   QByteArray win_settings = settings_manager->GetMainWindowSettings();
   if (!win_settings.isEmpty()) {
@@ -347,8 +402,40 @@ int main(int argc, char* argv[]) {
 #endif
   }
 
+  profiler.AddPhase("main window construction", phase_start, common::time::current_utc_mstime());
+
+  // localhost prometheus endpoint, scraped alongside servers
+  QThread* metrics_thread = nullptr;
+  fastonosql::proxy::MetricsExporter* metrics_exporter = nullptr;
+  if (metrics_port) {
+    metrics_thread = new QThread;
+    metrics_exporter = new fastonosql::proxy::MetricsExporter(metrics_port);
+    metrics_exporter->moveToThread(metrics_thread);
+    VERIFY(QObject::connect(metrics_thread, &QThread::started, metrics_exporter,
+                            &fastonosql::proxy::MetricsExporter::Routine));
+    VERIFY(QObject::connect(metrics_exporter, &fastonosql::proxy::MetricsExporter::Finished, metrics_thread,
+                            &QThread::quit));
+    metrics_thread->start();
+  }
+
+  // summary is reported by the main window on first show
   main_window.show();
   int res = app.exec();
+  if (metrics_thread) {
+    metrics_exporter->Stop();
+    metrics_thread->wait();
+    delete metrics_exporter;
+    delete metrics_thread;
+  }
+  if (tracer.IsEnabled()) {
+    common::Error err = tracer.SaveBinary(trace_path);
+    if (!err) {
+      err = fastonosql::proxy::RequestTracer::ExportChromeTrace(trace_path, trace_path + ".json");
+    }
+    if (err) {
+      std::cerr << "Request trace not saved: " << err->GetDescription() << std::endl;
+    }
+  }
   settings_manager->SetMainWindowSettings(main_window.saveGeometry());
   settings_manager->Save();
   settings_manager->FreeInstance();
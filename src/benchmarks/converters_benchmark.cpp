@@ -0,0 +1,144 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fastonosql/core/types.h>
+
+#include "gui/text_converter.h"
+
+// converters_benchmark [max_size_bytes] [min_time_msec]
+// prints one row per converter and payload size, in the spirit of google benchmark output
+
+namespace {
+
+typedef bool (*converter_t)(const fastonosql::gui::convert_in_t& value, fastonosql::gui::convert_out_t* out);
+
+struct Benchmark {
+  const char* name;
+  converter_t encode;
+  converter_t decode;
+  bool is_text;  // fed with printable text instead of random bytes
+};
+
+const Benchmark kBenchmarks[] = {
+    {"hex", fastonosql::gui::string_to_hex, fastonosql::gui::string_from_hex, false},
+    {"base64", fastonosql::gui::string_to_base64, fastonosql::gui::string_from_base64, false},
+    {"unicode", fastonosql::gui::string_to_unicode, fastonosql::gui::string_from_unicode, true},
+    {"json", fastonosql::gui::string_to_json, fastonosql::gui::string_from_json, true},
+    {"snappy", fastonosql::gui::string_to_snappy, fastonosql::gui::string_from_snappy, true},
+    {"zlib", fastonosql::gui::string_to_zlib, fastonosql::gui::string_from_zlib, true},
+    {"gzip", fastonosql::gui::string_to_gzip, fastonosql::gui::string_from_gzip, true},
+    {"lz4", fastonosql::gui::string_to_lz4, fastonosql::gui::string_from_lz4, true},
+    {"bzip2", fastonosql::gui::string_to_bzip2, fastonosql::gui::string_from_bzip2, true}};
+
+const size_t kSizes[] = {1 << 10, 64 << 10, 1 << 20, 16 << 20, 100 << 20};
+
+std::string MakePayload(size_t size, bool is_text) {
+  std::mt19937 gen(size);
+  std::string result(size, 0);
+  if (!is_text) {
+    for (size_t i = 0; i < size; ++i) {
+      result[i] = static_cast<char>(gen());
+    }
+    return result;
+  }
+
+  // json array of words, valid input for the json view and compressible for the others
+  static const char* words[] = {"redis", "key", "value", "stream", "hash", "42", "true", "null", "fasto", "nosql"};
+  result = "[";
+  while (result.size() + 16 < size) {
+    if (result.size() > 1) {
+      result += ',';
+    }
+    result += '"';
+    result += words[gen() % (sizeof(words) / sizeof(*words))];
+    result += '"';
+  }
+  result += ']';
+  return result;
+}
+
+// runs the converter until min_time passes, returns nanoseconds per call or -1 on failure
+double Measure(converter_t converter, const fastonosql::gui::convert_in_t& input, long min_time_msec, size_t* iterations) {
+  typedef std::chrono::steady_clock clock_t;
+  const clock_t::time_point start = clock_t::now();
+  clock_t::duration elapsed;
+  size_t count = 0;
+  do {
+    fastonosql::gui::convert_out_t out;
+    if (!converter(input, &out)) {
+      return -1;
+    }
+    ++count;
+    elapsed = clock_t::now() - start;
+  } while (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() < min_time_msec);
+
+  *iterations = count;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / count;
+}
+
+void PrintRow(const char* name, const char* direction, size_t size, double ns, size_t iterations) {
+  char label[64];
+  snprintf(label, sizeof(label), "%s/%s/%zu", name, direction, size);
+  if (ns < 0) {
+    printf("%-28s %15s\n", label, "FAILED");
+    return;
+  }
+
+  const double mb_per_sec = static_cast<double>(size) / (1 << 20) / (ns / 1e9);
+  printf("%-28s %15.0f ns %12zu %12.1f MB/s\n", label, ns, iterations, mb_per_sec);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const size_t max_size = argc > 1 ? strtoull(argv[1], nullptr, 10) : kSizes[sizeof(kSizes) / sizeof(*kSizes) - 1];
+  const long min_time_msec = argc > 2 ? strtol(argv[2], nullptr, 10) : 500;
+
+  printf("%-28s %18s %12s %17s\n", "Benchmark", "Time", "Iterations", "Throughput");
+  for (const Benchmark& bench : kBenchmarks) {
+    for (size_t size : kSizes) {
+      if (size > max_size) {
+        break;
+      }
+
+      const std::string payload = MakePayload(size, bench.is_text);
+      const fastonosql::gui::convert_in_t input = GEN_CMD_STRING_SIZE(payload.data(), payload.size());
+      size_t iterations = 0;
+      const double encode_ns = Measure(bench.encode, input, min_time_msec, &iterations);
+      PrintRow(bench.name, "encode", size, encode_ns, iterations);
+
+      fastonosql::gui::convert_out_t encoded;
+      if (encode_ns < 0 || !bench.encode(input, &encoded)) {
+        continue;
+      }
+
+      const double decode_ns = Measure(bench.decode, encoded, min_time_msec, &iterations);
+      PrintRow(bench.name, "decode", size, decode_ns, iterations);
+    }
+  }
+  return EXIT_SUCCESS;
+}
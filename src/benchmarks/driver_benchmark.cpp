@@ -0,0 +1,254 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <string>
+
+#include <QApplication>
+#include <QDir>
+#include <QEventLoop>
+
+#include <common/convert2string.h>
+
+#include <fastonosql/core/macros.h>
+
+#include "benchmarks/resp_stub_server.h"
+#include "benchmarks/stub_connection.h"
+#include "proxy/connection_settings_factory.h"
+#include "proxy/events/events_info.h"
+#include "proxy/server/iserver.h"
+#include "proxy/servers_manager.h"
+
+// driver_benchmark [keys_count] [min_time_msec] [latency_usec]
+// drives redis driver request handlers end to end (gui thread -> driver thread -> stub server and back)
+// and reports throughput with heap allocations of the whole process per request
+
+namespace {
+
+std::atomic<size_t> g_allocations(0);
+std::atomic<size_t> g_allocated_bytes(0);
+
+const size_t kHistorySnapshots = 100;
+const fastonosql::core::keys_limit_t kPageSize = 100;
+
+struct Result {
+  size_t iterations;
+  double ns;
+  size_t allocations;
+  size_t bytes;
+  common::Error err;
+};
+
+template <typename R>
+Result Measure(fastonosql::proxy::IServer* server,
+               void (fastonosql::proxy::IServer::*finished)(const R&),
+               const std::function<void()>& request,
+               long min_time_msec) {
+  typedef std::chrono::steady_clock clock_t;
+  QEventLoop loop;
+  Result result = {0, 0, 0, 0, common::Error()};
+  const size_t allocations = g_allocations;
+  const size_t bytes = g_allocated_bytes;
+  const clock_t::time_point start = clock_t::now();
+  // next request goes from the reply handler, so there is always exactly one in flight
+  QObject::connect(server, finished, &loop, [&](const R& res) {
+    result.iterations++;
+    result.err = res.errorInfo();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(clock_t::now() - start);
+    if (result.err || elapsed.count() >= min_time_msec) {
+      loop.quit();
+      return;
+    }
+    request();
+  });
+  request();
+  loop.exec();
+
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_t::now() - start);
+  result.ns = static_cast<double>(elapsed.count()) / result.iterations;
+  result.allocations = g_allocations - allocations;
+  result.bytes = g_allocated_bytes - bytes;
+  return result;
+}
+
+// same layout as the driver writes when history is enabled: stamp line, then info text
+bool SeedHistory(const std::string& path, const std::string& info) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return false;
+  }
+
+  for (size_t i = 0; i < kHistorySnapshots; ++i) {
+    file << '\x1E' << common::ConvertToString(static_cast<common::time64_t>(1000 * i)) << '\n' << info;
+  }
+  return static_cast<bool>(file);
+}
+
+void PrintRow(const char* label, const Result& result) {
+  if (result.err) {
+    printf("%-24s failed: %s\n", label, result.err->GetDescription().c_str());
+    return;
+  }
+
+  const double iterations = static_cast<double>(result.iterations);
+  printf("%-24s %12.0f %15.0f ns %12.1f %12.0f %10zu\n", label, 1e9 / result.ns, result.ns,
+         result.allocations / iterations, result.bytes / iterations, result.iterations);
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  void* result = malloc(size ? size : 1);
+  if (!result) {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  free(ptr);
+}
+
+int main(int argc, char* argv[]) {
+  fastonosql::benchmarks::RespStubServer::Config config;
+  if (argc > 1) {
+    config.keys_count = strtoull(argv[1], nullptr, 10);
+  }
+  const long min_time_msec = argc > 2 ? strtol(argv[2], nullptr, 10) : 1000;
+  if (argc > 3) {
+    config.latency_usec = static_cast<unsigned>(strtoul(argv[3], nullptr, 10));
+  }
+
+  // settings manager keeps fonts, nothing is shown
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  QApplication app(argc, argv);
+
+  fastonosql::benchmarks::RespStubServer stub(config);
+  if (!stub.Start()) {
+    fprintf(stderr, "Can't start stub server\n");
+    return EXIT_FAILURE;
+  }
+
+  const QString log_dir = QDir::tempPath() + "/" PROJECT_NAME_LOWERCASE "_driver_benchmark/";
+  QDir().mkpath(log_dir);
+  fastonosql::proxy::ConnectionSettingsFactory::GetInstance().SetLoggingDirectory(log_dir.toStdString());
+  fastonosql::proxy::IConnectionSettingsBaseSPtr settings = fastonosql::benchmarks::MakeStubSettings(stub);
+  QObject initiator;
+  common::Error err;
+  fastonosql::proxy::IServerSPtr server = fastonosql::benchmarks::ConnectToStub(settings, &initiator, &err);
+  if (err) {
+    fprintf(stderr, "Can't connect to stub server: %s\n", err->GetDescription().c_str());
+    return EXIT_FAILURE;
+  }
+
+  typedef fastonosql::proxy::IServer server_t;
+  namespace info = fastonosql::proxy::events_info;
+  printf("%zu keys, %zu bytes values, %zu elements collections, %u usec latency\n", config.keys_count,
+         config.value_size, config.collection_size, config.latency_usec);
+  printf("%-24s %12s %18s %12s %12s %10s\n", "Benchmark", "Ops/sec", "Time", "Allocs/op", "Bytes/op",
+         "Iterations");
+
+  fastonosql::core::cursor_t cursor = 0;
+  fastonosql::core::command_buffer_t key_cursor;
+  QObject::connect(server.get(), &server_t::LoadDatabaseContentFinished, &initiator,
+                   [&](const info::LoadDatabaseContentResponse& res) {
+                     cursor = res.cursor_out;
+                     key_cursor = res.key_cursor_out;
+                   });
+  Result result = Measure(server.get(), &server_t::LoadDatabaseContentFinished, [&]() {
+    server->LoadDatabaseContent(info::LoadDatabaseContentRequest(&initiator, server->GetCurrentDatabaseInfo(),
+                                                                 ALL_KEYS_PATTERNS, kPageSize, cursor, key_cursor));
+  }, min_time_msec);
+  PrintRow("load_content/page", result);
+
+  const std::string string_key = fastonosql::benchmarks::RespStubServer::MakeKey(0);
+  const std::string hash_key = fastonosql::benchmarks::RespStubServer::MakeKey(1);
+  const struct {
+    const char* label;
+    std::string command;
+  } commands[] = {{"execute/ping", "PING"},
+                  {"execute/get", "GET " + string_key},
+                  {"execute/hgetall", "HGETALL " + hash_key},
+                  {"execute/scan", "SCAN 0 COUNT " + common::ConvertToString(kPageSize)}};
+  for (const auto& command : commands) {
+    result = Measure(server.get(), &server_t::ExecuteFinished, [&]() {
+      server->Execute(info::ExecuteInfoRequest(&initiator, common::ConvertToCharBytes(command.command), 0, 0, false,
+                                               true, fastonosql::core::C_INNER));
+    }, min_time_msec);
+    PrintRow(command.label, result);
+  }
+
+  result = Measure(server.get(), &server_t::LoadServerClientsFinished,
+                   [&]() { server->LoadClients(info::LoadServerClientsRequest(&initiator)); }, min_time_msec);
+  PrintRow("clients", result);
+
+  result = Measure(server.get(), &server_t::LoadServerChannelsFinished,
+                   [&]() { server->LoadChannels(info::LoadServerChannelsRequest(&initiator, "*")); }, min_time_msec);
+  PrintRow("channels", result);
+
+  std::string info_text;
+  QObject::connect(server.get(), &server_t::LoadServerInfoFinished, &initiator,
+                   [&](const info::ServerInfoResponse& res) {
+                     const auto server_info = res.GetInfo();
+                     if (server_info) {
+                       info_text = server_info->ToString();
+                     }
+                   });
+  result = Measure(server.get(), &server_t::LoadServerInfoFinished,
+                   [&]() { server->LoadServerInfo(info::ServerInfoRequest(&initiator)); }, min_time_msec);
+  PrintRow("info", result);
+
+  if (SeedHistory(settings->GetLoggingPath(), info_text)) {
+    result = Measure(server.get(), &server_t::LoadServerHistoryInfoFinished,
+                     [&]() { server->RequestHistoryInfo(info::ServerInfoHistoryRequest(&initiator)); },
+                     min_time_msec);
+    PrintRow("info_history", result);
+  }
+
+  printf("%zu commands served\n", stub.GetCommandsCount());
+  fastonosql::proxy::ServersManager::GetInstance().CloseServer(server);
+  stub.Stop();
+  return EXIT_SUCCESS;
+}
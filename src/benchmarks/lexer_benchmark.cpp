@@ -0,0 +1,172 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <strings.h>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <QApplication>
+
+#include <Qsci/qsciscintilla.h>
+
+#include "gui/db/redis/lexer.h"
+#include "gui/shell/command_trie.h"
+
+// lexer_benchmark [script_size_bytes] [min_time_msec]
+// drives the redis shell lexer and its api the way the editor does and compares them against the old
+// per command scan, both for highlighting and completion; run with QT_QPA_PLATFORM=offscreen on servers
+
+namespace {
+
+std::vector<std::string> MakeCommands(const fastonosql::gui::BaseCommandsQsciLexer& lexer) {
+  std::vector<std::string> result;
+  for (const fastonosql::core::CommandInfo& cmd : lexer.commands()) {
+    result.push_back(std::string(cmd.name.begin(), cmd.name.end()));
+  }
+  return result;
+}
+
+std::string MakeScript(const std::vector<std::string>& commands, size_t size) {
+  std::mt19937 gen(size);
+  static const char* args[] = {"user:1", "session:abc", "42", "field", "value", "\"quoted text\"", "0", "-1"};
+  std::string result;
+  result.reserve(size + 128);
+  while (result.size() < size) {
+    const std::string& command = commands[gen() % commands.size()];
+    for (char c : command) {
+      result += gen() % 2 ? c : static_cast<char>(tolower(c));
+    }
+    const size_t args_count = gen() % 4;
+    for (size_t i = 0; i < args_count; ++i) {
+      result += ' ';
+      result += args[gen() % (sizeof(args) / sizeof(*args))];
+    }
+    result += '\n';
+  }
+  return result;
+}
+
+// highlighting as it was done before the trie: every command searched over the whole text
+size_t NaiveTokenize(const std::vector<std::string>& commands, const std::string& script) {
+  size_t styled = 0;
+  for (const std::string& command : commands) {
+    const size_t length = command.size();
+    for (size_t pos = 0; pos + length <= script.size(); ++pos) {
+      if (strncasecmp(script.data() + pos, command.data(), length) == 0) {
+        styled += length;
+        pos += length - 1;
+      }
+    }
+  }
+  return styled;
+}
+
+// full restyle through the lexer, as after loading a script into the shell
+size_t LexerTokenize(QsciLexerCustom* lexer, QsciScintilla* editor) {
+  const int length = editor->length();
+  lexer->styleText(0, length);
+  return static_cast<size_t>(length);
+}
+
+size_t NaiveComplete(const std::vector<std::string>& commands, const std::vector<std::string>& prefixes) {
+  size_t found = 0;
+  for (const std::string& prefix : prefixes) {
+    for (const std::string& command : commands) {
+      if (command.size() >= prefix.size() && strncasecmp(command.data(), prefix.data(), prefix.size()) == 0) {
+        ++found;
+      }
+    }
+  }
+  return found;
+}
+
+size_t ApiComplete(fastonosql::gui::BaseCommandsQsciApi* api, const std::vector<QStringList>& contexts) {
+  size_t found = 0;
+  for (const QStringList& context : contexts) {
+    QStringList list;
+    api->updateAutoCompletionList(context, list);
+    found += list.size();
+  }
+  return found;
+}
+
+template <typename F>
+double Measure(F func, long min_time_msec, size_t* iterations, size_t* result) {
+  typedef std::chrono::steady_clock clock_t;
+  const clock_t::time_point start = clock_t::now();
+  clock_t::duration elapsed;
+  size_t count = 0;
+  do {
+    *result = func();
+    ++count;
+    elapsed = clock_t::now() - start;
+  } while (std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() < min_time_msec);
+
+  *iterations = count;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / count;
+}
+
+void PrintRow(const char* label, double ns, size_t iterations, size_t result) {
+  printf("%-28s %15.0f ns %12zu %12zu\n", label, ns, iterations, result);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  QApplication app(argc, argv);
+  const size_t script_size = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10 << 20;
+  const long min_time_msec = argc > 2 ? strtol(argv[2], nullptr, 10) : 500;
+
+  fastonosql::gui::redis::Lexer lexer;
+  fastonosql::gui::BaseCommandsQsciApi* api = static_cast<fastonosql::gui::BaseCommandsQsciApi*>(lexer.apis());
+  const std::vector<std::string> commands = MakeCommands(lexer);
+  const std::string script = MakeScript(commands, script_size);
+  QsciScintilla editor;
+  editor.setLexer(&lexer);
+  editor.setText(QString::fromStdString(script));
+  printf("%zu commands, %zu trie nodes, %zu bytes script\n", lexer.commandsTrie().GetWordsCount(),
+         lexer.commandsTrie().GetNodesCount(), script.size());
+
+  std::vector<std::string> prefixes;
+  std::vector<QStringList> contexts;
+  for (const std::string& command : commands) {
+    for (size_t i = 1; i <= command.size() && i <= 4; ++i) {
+      prefixes.push_back(command.substr(0, i));
+      contexts.push_back(QStringList() << QString::fromStdString(prefixes.back()));
+    }
+  }
+
+  printf("%-28s %18s %12s %12s\n", "Benchmark", "Time", "Iterations", "Result");
+  size_t iterations = 0;
+  size_t result = 0;
+  double ns = Measure([&]() { return NaiveTokenize(commands, script); }, min_time_msec, &iterations, &result);
+  PrintRow("tokenize/naive", ns, iterations, result);
+  ns = Measure([&]() { return LexerTokenize(&lexer, &editor); }, min_time_msec, &iterations, &result);
+  PrintRow("tokenize/lexer", ns, iterations, result);
+  ns = Measure([&]() { return NaiveComplete(commands, prefixes); }, min_time_msec, &iterations, &result);
+  PrintRow("complete/naive", ns / prefixes.size(), iterations, result);
+  ns = Measure([&]() { return ApiComplete(api, contexts); }, min_time_msec, &iterations, &result);
+  PrintRow("complete/api", ns / contexts.size(), iterations, result);
+  editor.setLexer(nullptr);
+  return EXIT_SUCCESS;
+}
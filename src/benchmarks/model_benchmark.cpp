@@ -0,0 +1,532 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <QApplication>
+#include <QDir>
+
+#include <json-c/json_object.h>
+
+#include <common/convert2string.h>
+#include <common/error.h>
+
+#include "benchmarks/resp_stub_server.h"
+#include "benchmarks/stub_connection.h"
+#include "gui/models/clients_table_model.h"
+#include "gui/models/explorer_tree_model.h"
+#include "gui/models/explorer_tree_sort_filter_proxy_model.h"
+#include "gui/models/fasto_common_model.h"
+#include "gui/models/hash_table_model.h"
+#include "gui/models/items/client_table_item.h"
+#include "gui/models/items/fasto_common_item.h"
+#include "gui/models/keys_table_model.h"
+#include "gui/workers/key_search_index.h"
+#include "proxy/connection_settings_factory.h"
+#include "proxy/server/iserver.h"
+#include "proxy/servers_manager.h"
+
+// model_benchmark [max_rows] [--json <path>] [--max-seconds <sec>]
+// feeds gui models synthetic rows at 10k/100k/1M scale and measures insert, update, remove, explorer
+// sort/filter through the proxy model and live heap bytes per row; json output is for per commit tracking
+
+namespace {
+
+typedef std::chrono::steady_clock steady_clock_t;
+
+std::atomic<size_t> g_live_bytes(0);
+// every block carries its size so frees can be subtracted, keeps new's default alignment
+const size_t kAllocHeader = 16;
+
+const size_t kScales[] = {10000, 100000, 1000000};
+const size_t kSampleOps = 1000;  // update and remove are linear per call, a sample is enough
+const size_t kDeadlineCheckRows = 1024;
+const size_t kNamespaces = 100;
+const char kNsSeparator[] = ":";
+
+class Deadline {
+ public:
+  explicit Deadline(long seconds) : end_(steady_clock_t::now() + std::chrono::seconds(seconds)) {}
+  bool Passed() const { return steady_clock_t::now() > end_; }
+
+ private:
+  const steady_clock_t::time_point end_;
+};
+
+class Report {
+ public:
+  Report() : results_(json_object_new_array()) {}
+  ~Report() { json_object_put(results_); }
+
+  // rows is the model size, ops the measured calls; bytes_per_row < 0 if not measured
+  void Add(const char* model, const char* operation, size_t rows, size_t ops, double elapsed_ns,
+           double bytes_per_row, bool completed) {
+    const double ns_per_op = ops ? elapsed_ns / ops : 0;
+    printf("%-12s %-8s %10zu %10zu %15.0f ns", model, operation, rows, ops, ns_per_op);
+    if (bytes_per_row >= 0) {
+      printf(" %10.0f B/row", bytes_per_row);
+    }
+    printf("%s\n", completed ? "" : " (timeout)");
+
+    json_object* result = json_object_new_object();
+    json_object_object_add(result, "model", json_object_new_string(model));
+    json_object_object_add(result, "operation", json_object_new_string(operation));
+    json_object_object_add(result, "rows", json_object_new_int64(static_cast<int64_t>(rows)));
+    json_object_object_add(result, "ops", json_object_new_int64(static_cast<int64_t>(ops)));
+    json_object_object_add(result, "ns_per_op", json_object_new_double(ns_per_op));
+    if (bytes_per_row >= 0) {
+      json_object_object_add(result, "bytes_per_row", json_object_new_double(bytes_per_row));
+    }
+    json_object_object_add(result, "completed", json_object_new_boolean(completed));
+    json_object_array_add(results_, result);
+  }
+
+  bool Save(const std::string& path) const {
+    json_object* root = json_object_new_object();
+    json_object_object_add(root, "benchmark", json_object_new_string("model_benchmark"));
+    json_object_object_add(root, "version", json_object_new_string(PROJECT_VERSION_HUMAN));
+    json_object_object_add(root, "results", json_object_get(results_));
+    FILE* file = fopen(path.c_str(), "wb");
+    bool result = false;
+    if (file) {
+      result = fputs(json_object_to_json_string_ext(root, JSON_C_TO_STRING_PRETTY), file) >= 0;
+      result = fclose(file) == 0 && result;
+    }
+    json_object_put(root);
+    return result;
+  }
+
+ private:
+  json_object* results_;
+};
+
+template <typename F>
+double MeasureNs(F func) {
+  const steady_clock_t::time_point start = steady_clock_t::now();
+  func();
+  const steady_clock_t::duration elapsed = steady_clock_t::now() - start;
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+std::string MakeKeyName(size_t index) {
+  return "ns" + std::to_string(index % kNamespaces) + kNsSeparator + "key" + kNsSeparator + std::to_string(index);
+}
+
+fastonosql::core::NKey MakeKey(size_t index, fastonosql::core::ttl_t ttl) {
+  fastonosql::core::NKey key(fastonosql::core::nkey_t(common::ConvertToCharBytes(MakeKeyName(index))));
+  key.SetTTL(ttl);
+  return key;
+}
+
+fastonosql::core::NDbKValue MakeDbv(size_t index) {
+  const std::string value = "value:" + std::to_string(index);
+  const fastonosql::core::NValue nvalue(
+      common::ValueSPtr(common::Value::CreateStringValue(common::ConvertToCharBytes(value))));
+  return fastonosql::core::NDbKValue(MakeKey(index, -1), nvalue);
+}
+
+std::string MakeClientLine(size_t index) {
+  const std::string id = std::to_string(index + 1);
+  return "id=" + id + " addr=127.0.0.1:" + std::to_string(10000 + index % 50000) + " fd=" + id + " name=client" + id +
+         " age=10 idle=0 flags=N db=0 sub=0 psub=0 multi=-1 qbuf=0 qbuf-free=0 obl=0 oll=0 omem=0 events=r cmd=get";
+}
+
+// sample rows spread over the whole model, from the back so earlier removals don't shift them
+size_t SampleRow(size_t sample, size_t samples, size_t rows) {
+  return rows - 1 - sample * rows / samples;
+}
+
+size_t CountRows(const QAbstractItemModel& model, const QModelIndex& parent) {
+  size_t count = 0;
+  const int rows = model.rowCount(parent);
+  for (int i = 0; i < rows; ++i) {
+    count += 1 + CountRows(model, model.index(i, 0, parent));
+  }
+  return count;
+}
+
+bool BenchKeysTable(size_t rows, const Deadline& deadline, Report* report) {
+  fastonosql::gui::KeysTableModel model;
+  size_t inserted = 0;
+  const size_t live_bytes = g_live_bytes;
+  double ns = MeasureNs([&]() {
+    for (; inserted < rows; ++inserted) {
+      if (inserted % kDeadlineCheckRows == 0 && deadline.Passed()) {
+        return;
+      }
+      model.insertKey(MakeDbv(inserted));
+    }
+  });
+  const bool completed = inserted == rows;
+  report->Add("keys_table", "insert", rows, inserted, ns, static_cast<double>(g_live_bytes - live_bytes) / inserted,
+              completed);
+  if (!completed) {
+    return false;
+  }
+
+  const size_t samples = std::min(kSampleOps, rows);
+  ns = MeasureNs([&]() {
+    for (size_t i = 0; i < samples; ++i) {
+      model.updateKey(MakeKey(SampleRow(i, samples, rows), 3600));
+    }
+  });
+  report->Add("keys_table", "update", rows, samples, ns, -1, true);
+
+  ns = MeasureNs([&]() { model.clear(); });
+  report->Add("keys_table", "clear", rows, rows, ns, -1, true);
+  return !deadline.Passed();
+}
+
+bool BenchExplorer(fastonosql::proxy::IServerSPtr server, size_t rows, const Deadline& deadline, Report* report) {
+  fastonosql::gui::ExplorerTreeModel model;
+  model.addServer(server);
+  const fastonosql::core::IDataBaseInfoSPtr db = server->GetCurrentDatabaseInfo();
+  model.addDatabase(server.get(), db);
+
+  size_t inserted = 0;
+  const size_t live_bytes = g_live_bytes;
+  double ns = MeasureNs([&]() {
+    for (; inserted < rows; ++inserted) {
+      if (inserted % kDeadlineCheckRows == 0 && deadline.Passed()) {
+        return;
+      }
+      model.addKey(server.get(), db, MakeDbv(inserted), kNsSeparator, fastonosql::proxy::KEY_NAME);
+    }
+  });
+  const bool completed = inserted == rows;
+  report->Add("explorer", "insert", rows, inserted, ns, static_cast<double>(g_live_bytes - live_bytes) / inserted,
+              completed);
+  if (!completed) {
+    return false;
+  }
+
+  const size_t samples = std::min(kSampleOps, rows);
+  ns = MeasureNs([&]() {
+    for (size_t i = 0; i < samples; ++i) {
+      model.updateValue(server.get(), db, MakeDbv(SampleRow(i, samples, rows)));
+    }
+  });
+  report->Add("explorer", "update", rows, samples, ns, -1, true);
+
+  fastonosql::gui::ExplorerTreeSortFilterProxyModel proxy_model;
+  proxy_model.setSourceModel(&model);
+  size_t mapped = 0;
+  ns = MeasureNs([&]() {
+    proxy_model.sort(0, Qt::AscendingOrder);
+    mapped = CountRows(proxy_model, QModelIndex());
+  });
+  report->Add("explorer", "sort", rows, mapped, ns, -1, true);
+
+  // every tenth key passes, the set comes precomputed from the search index
+  std::shared_ptr<fastonosql::gui::KeySearchIndex::match_set_t> matches =
+      std::make_shared<fastonosql::gui::KeySearchIndex::match_set_t>();
+  for (size_t i = 0; i < rows; i += 10) {
+    matches->insert(fastonosql::gui::KeySearchIndex::makeKeyId(server.get(), db->GetName(), MakeKey(i, -1)));
+  }
+  ns = MeasureNs([&]() {
+    proxy_model.setMatchSet(matches);
+    mapped = CountRows(proxy_model, QModelIndex());
+  });
+  report->Add("explorer", "filter", rows, mapped, ns, -1, true);
+  proxy_model.setSourceModel(nullptr);
+
+  ns = MeasureNs([&]() {
+    for (size_t i = 0; i < samples; ++i) {
+      model.removeKey(server.get(), db, MakeKey(SampleRow(i, samples, rows), -1));
+    }
+  });
+  report->Add("explorer", "remove", rows, samples, ns, -1, true);
+
+  ns = MeasureNs([&]() { model.removeAllKeys(server.get(), db); });
+  report->Add("explorer", "clear", rows, rows - samples, ns, -1, true);
+  model.removeServer(server);
+  return !deadline.Passed();
+}
+
+bool BenchOutputTree(size_t rows, const Deadline& deadline, Report* report) {
+  fastonosql::gui::FastoCommonModel model;
+  fastonosql::gui::FastoCommonItem* root = new fastonosql::gui::FastoCommonItem(
+      fastonosql::core::NDbKValue(fastonosql::core::NKey(), fastonosql::core::NValue()), std::string(), true, nullptr,
+      nullptr);
+  model.setRoot(root);
+
+  size_t inserted = 0;
+  const size_t live_bytes = g_live_bytes;
+  double ns = MeasureNs([&]() {
+    for (; inserted < rows; ++inserted) {
+      if (inserted % kDeadlineCheckRows == 0 && deadline.Passed()) {
+        return;
+      }
+      model.insertItem(QModelIndex(),
+                       new fastonosql::gui::FastoCommonItem(MakeDbv(inserted), std::string(), false, root, nullptr));
+    }
+  });
+  const bool completed = inserted == rows;
+  report->Add("output_tree", "insert", rows, inserted, ns, static_cast<double>(g_live_bytes - live_bytes) / inserted,
+              completed);
+  if (!completed) {
+    return false;
+  }
+
+  const size_t samples = std::min(kSampleOps, rows);
+  ns = MeasureNs([&]() {
+    for (size_t i = 0; i < samples; ++i) {
+      model.changeValue(MakeDbv(SampleRow(i, samples, rows)));
+    }
+  });
+  report->Add("output_tree", "update", rows, samples, ns, -1, true);
+
+  // output is never edited row by row, a new command replaces the whole tree
+  ns = MeasureNs([&]() {
+    model.setRoot(new fastonosql::gui::FastoCommonItem(
+        fastonosql::core::NDbKValue(fastonosql::core::NKey(), fastonosql::core::NValue()), std::string(), true,
+        nullptr, nullptr));
+  });
+  report->Add("output_tree", "clear", rows, rows, ns, -1, true);
+  return !deadline.Passed();
+}
+
+bool BenchClientsTable(size_t rows, const Deadline& deadline, Report* report) {
+  fastonosql::gui::ClientsTableModel model;
+  size_t inserted = 0;
+  const size_t live_bytes = g_live_bytes;
+  double ns = MeasureNs([&]() {
+    for (; inserted < rows; ++inserted) {
+      if (inserted % kDeadlineCheckRows == 0 && deadline.Passed()) {
+        return;
+      }
+      model.insertItem(new fastonosql::gui::ClientTableItem(fastonosql::proxy::NDbClient(MakeClientLine(inserted))));
+    }
+  });
+  const bool completed = inserted == rows;
+  report->Add("clients", "insert", rows, inserted, ns, static_cast<double>(g_live_bytes - live_bytes) / inserted,
+              completed);
+  if (!completed) {
+    return false;
+  }
+
+  // same path as the monitor dialog: find by id, then remove
+  const size_t samples = std::min(kSampleOps, rows);
+  ns = MeasureNs([&]() {
+    for (size_t i = 0; i < samples; ++i) {
+      common::qt::gui::TableItem* item = model.findChildById(static_cast<int>(SampleRow(i, samples, rows) + 1));
+      if (item) {
+        model.removeItem(item);
+      }
+    }
+  });
+  report->Add("clients", "remove", rows, samples, ns, -1, true);
+
+  ns = MeasureNs([&]() { model.clear(); });
+  report->Add("clients", "clear", rows, rows - samples, ns, -1, true);
+  return !deadline.Passed();
+}
+
+bool BenchHashTable(size_t rows, const Deadline& deadline, Report* report) {
+  fastonosql::gui::HashTableModel model;
+  size_t inserted = 0;
+  const size_t live_bytes = g_live_bytes;
+  double ns = MeasureNs([&]() {
+    for (; inserted < rows; ++inserted) {
+      if (inserted % kDeadlineCheckRows == 0 && deadline.Passed()) {
+        return;
+      }
+      model.insertRow(common::ConvertToCharBytes("field:" + std::to_string(inserted)),
+                      common::ConvertToCharBytes("value:" + std::to_string(inserted)));
+    }
+  });
+  const bool completed = inserted == rows;
+  report->Add("hash_table", "insert", rows, inserted, ns, static_cast<double>(g_live_bytes - live_bytes) / inserted,
+              completed);
+  if (!completed) {
+    return false;
+  }
+
+  const size_t samples = std::min(kSampleOps, rows);
+  ns = MeasureNs([&]() {
+    for (size_t i = 0; i < samples; ++i) {
+      const int row = static_cast<int>(SampleRow(i, samples, rows));
+      model.setData(model.index(row, fastonosql::gui::HashTableModel::kValue), QString("updated"), Qt::EditRole);
+    }
+  });
+  report->Add("hash_table", "update", rows, samples, ns, -1, true);
+
+  ns = MeasureNs([&]() {
+    for (size_t i = 0; i < samples; ++i) {
+      model.removeRow(static_cast<int>(SampleRow(i, samples, rows)));
+    }
+  });
+  report->Add("hash_table", "remove", rows, samples, ns, -1, true);
+
+  ns = MeasureNs([&]() { model.clear(); });
+  report->Add("hash_table", "clear", rows, rows - samples, ns, -1, true);
+  return !deadline.Passed();
+}
+
+bool BenchSearchIndex(size_t rows, const Deadline& deadline, Report* report) {
+  fastonosql::gui::KeyTrigramIndex index;
+  size_t inserted = 0;
+  const size_t live_bytes = g_live_bytes;
+  double ns = MeasureNs([&]() {
+    for (; inserted < rows; ++inserted) {
+      if (inserted % kDeadlineCheckRows == 0 && deadline.Passed()) {
+        return;
+      }
+      const std::string name = MakeKeyName(inserted);
+      index.insert(name, name, "value:" + std::to_string(inserted));
+    }
+  });
+  const bool completed = inserted == rows;
+  report->Add("search_index", "insert", rows, inserted, ns, static_cast<double>(g_live_bytes - live_bytes) / inserted,
+              completed);
+  if (!completed) {
+    return false;
+  }
+
+  const size_t samples = std::min(kSampleOps, rows);
+  ns = MeasureNs([&]() {
+    for (size_t i = 0; i < samples; ++i) {
+      index.search("key:" + std::to_string(SampleRow(i, samples, rows)), true);
+    }
+  });
+  report->Add("search_index", "search", rows, samples, ns, -1, true);
+
+  ns = MeasureNs([&]() {
+    for (size_t i = 0; i < samples; ++i) {
+      index.remove(MakeKeyName(SampleRow(i, samples, rows)));
+    }
+  });
+  report->Add("search_index", "remove", rows, samples, ns, -1, true);
+  return !deadline.Passed();
+}
+
+}  // namespace
+
+void* operator new(size_t size) {
+  char* block = static_cast<char*>(malloc(size + kAllocHeader));
+  if (!block) {
+    throw std::bad_alloc();
+  }
+  memcpy(block, &size, sizeof(size));
+  g_live_bytes.fetch_add(size, std::memory_order_relaxed);
+  return block + kAllocHeader;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept {
+  if (!ptr) {
+    return;
+  }
+  char* block = static_cast<char*>(ptr) - kAllocHeader;
+  size_t size;
+  memcpy(&size, block, sizeof(size));
+  g_live_bytes.fetch_sub(size, std::memory_order_relaxed);
+  free(block);
+}
+
+void operator delete[](void* ptr) noexcept {
+  operator delete(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  operator delete(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+  operator delete(ptr);
+}
+
+int main(int argc, char* argv[]) {
+  size_t max_rows = kScales[sizeof(kScales) / sizeof(*kScales) - 1];
+  std::string json_path;
+  long max_seconds = 60;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      json_path = argv[++i];
+    } else if (strcmp(argv[i], "--max-seconds") == 0 && i + 1 < argc) {
+      max_seconds = strtol(argv[++i], nullptr, 10);
+    } else {
+      max_rows = strtoull(argv[i], nullptr, 10);
+    }
+  }
+
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+  QApplication app(argc, argv);
+
+  // explorer needs a connected server with a discovered database, the keys are synthetic anyway
+  fastonosql::benchmarks::RespStubServer::Config config;
+  config.keys_count = 0;
+  fastonosql::benchmarks::RespStubServer stub(config);
+  if (!stub.Start()) {
+    fprintf(stderr, "Can't start stub server\n");
+    return EXIT_FAILURE;
+  }
+
+  const QString log_dir = QDir::tempPath() + "/" PROJECT_NAME_LOWERCASE "_model_benchmark/";
+  QDir().mkpath(log_dir);
+  fastonosql::proxy::ConnectionSettingsFactory::GetInstance().SetLoggingDirectory(log_dir.toStdString());
+  QObject initiator;
+  common::Error err;
+  fastonosql::proxy::IServerSPtr server =
+      fastonosql::benchmarks::ConnectToStub(fastonosql::benchmarks::MakeStubSettings(stub), &initiator, &err);
+  if (err) {
+    fprintf(stderr, "Can't connect to stub server: %s\n", err->GetDescription().c_str());
+    return EXIT_FAILURE;
+  }
+
+  printf("%-12s %-8s %10s %10s %18s %15s\n", "Model", "Op", "Rows", "Ops", "Time/op", "Memory");
+  Report report;
+  // a model whose scale ran out of time isn't tried on the bigger ones
+  bool keys_table = true, explorer = true, output_tree = true, clients = true, hash_table = true,
+       search_index = true;
+  for (size_t rows : kScales) {
+    if (rows > max_rows) {
+      break;
+    }
+
+    keys_table = keys_table && BenchKeysTable(rows, Deadline(max_seconds), &report);
+    explorer = explorer && BenchExplorer(server, rows, Deadline(max_seconds), &report);
+    output_tree = output_tree && BenchOutputTree(rows, Deadline(max_seconds), &report);
+    clients = clients && BenchClientsTable(rows, Deadline(max_seconds), &report);
+    hash_table = hash_table && BenchHashTable(rows, Deadline(max_seconds), &report);
+    search_index = search_index && BenchSearchIndex(rows, Deadline(max_seconds), &report);
+  }
+
+  fastonosql::proxy::ServersManager::GetInstance().CloseServer(server);
+  stub.Stop();
+  if (!json_path.empty() && !report.Save(json_path)) {
+    fprintf(stderr, "Can't save results to %s\n", json_path.c_str());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,481 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmarks/resp_stub_server.h"
+
+#if defined(OS_WIN)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace fastonosql {
+namespace benchmarks {
+
+namespace {
+
+#if defined(OS_WIN)
+typedef SOCKET socket_t;
+const socket_t kInvalidSocket = INVALID_SOCKET;
+void CloseSocket(socket_t sock) {
+  closesocket(sock);
+}
+#else
+typedef int socket_t;
+const socket_t kInvalidSocket = -1;
+void CloseSocket(socket_t sock) {
+  close(sock);
+}
+#endif
+
+const char kKeyPrefix[] = "key:";
+const size_t kKeyDigits = 8;
+const char* kTypeNames[] = {"string", "hash", "list", "set", "zset"};
+const int kPollIntervalMsec = 100;
+
+struct Client {
+  socket_t sock;
+  proxy::RespReader reader;
+};
+
+std::string Simple(const std::string& str) {
+  return "+" + str + "\r\n";
+}
+
+std::string Error(const std::string& str) {
+  return "-" + str + "\r\n";
+}
+
+std::string Integer(long long value) {
+  return ":" + std::to_string(value) + "\r\n";
+}
+
+std::string Bulk(const std::string& str) {
+  return "$" + std::to_string(str.size()) + "\r\n" + str + "\r\n";
+}
+
+std::string ArrayHeader(size_t size) {
+  return "*" + std::to_string(size) + "\r\n";
+}
+
+std::string ToUpper(std::string str) {
+  std::transform(str.begin(), str.end(), str.begin(), ::toupper);
+  return str;
+}
+
+// redis glob subset: '*' and '?', enough for key and channel patterns
+bool MatchPattern(const char* pattern, const char* str) {
+  while (*pattern) {
+    if (*pattern == '*') {
+      ++pattern;
+      if (!*pattern) {
+        return true;
+      }
+      for (; *str; ++str) {
+        if (MatchPattern(pattern, str)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    if (!*str || (*pattern != '?' && *pattern != *str)) {
+      return false;
+    }
+    ++pattern;
+    ++str;
+  }
+  return !*str;
+}
+
+void SendAll(socket_t sock, const std::string& data) {
+  size_t total = 0;
+  while (total < data.size()) {
+    const auto nwrite = send(sock, data.data() + total, static_cast<int>(data.size() - total), 0);
+    if (nwrite <= 0) {
+      return;
+    }
+    total += static_cast<size_t>(nwrite);
+  }
+}
+
+}  // namespace
+
+RespStubServer::Config::Config()
+    : keys_count(10000),
+      value_size(64),
+      collection_size(16),
+      clients_count(100),
+      channels_count(100),
+      latency_usec(0) {}
+
+RespStubServer::RespStubServer(const Config& config)
+    : config_(config),
+      value_(config.value_size, 'v'),
+      listen_socket_(static_cast<intptr_t>(kInvalidSocket)),
+      port_(0),
+      thread_(),
+      stop_(false),
+      commands_count_(0) {}
+
+RespStubServer::~RespStubServer() {
+  Stop();
+}
+
+bool RespStubServer::Start() {
+  socket_t sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (sock == kInvalidSocket) {
+    return false;
+  }
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;  // any free port
+  socklen_t addr_len = sizeof(addr);
+  if (bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 || listen(sock, SOMAXCONN) != 0 ||
+      getsockname(sock, reinterpret_cast<struct sockaddr*>(&addr), &addr_len) != 0) {
+    CloseSocket(sock);
+    return false;
+  }
+
+  listen_socket_ = static_cast<intptr_t>(sock);
+  port_ = ntohs(addr.sin_port);
+  stop_ = false;
+  thread_ = std::thread(&RespStubServer::Routine, this);
+  return true;
+}
+
+void RespStubServer::Stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+
+  stop_ = true;
+  thread_.join();
+  CloseSocket(static_cast<socket_t>(listen_socket_));
+  listen_socket_ = static_cast<intptr_t>(kInvalidSocket);
+}
+
+uint16_t RespStubServer::GetPort() const {
+  return port_;
+}
+
+size_t RespStubServer::GetCommandsCount() const {
+  return commands_count_;
+}
+
+std::string RespStubServer::MakeKey(size_t index) {
+  char buff[32];
+  snprintf(buff, sizeof(buff), "%s%08zu", kKeyPrefix, index);
+  return buff;
+}
+
+void RespStubServer::Routine() {
+  const socket_t server = static_cast<socket_t>(listen_socket_);
+  std::vector<Client> clients;
+  while (!stop_) {
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    FD_SET(server, &read_set);
+    socket_t max_sock = server;
+    for (const Client& client : clients) {
+      FD_SET(client.sock, &read_set);
+      max_sock = std::max(max_sock, client.sock);
+    }
+
+    struct timeval wait;
+    wait.tv_sec = 0;
+    wait.tv_usec = kPollIntervalMsec * 1000;
+    if (select(static_cast<int>(max_sock) + 1, &read_set, nullptr, nullptr, &wait) <= 0) {
+      continue;
+    }
+
+    if (FD_ISSET(server, &read_set)) {
+      socket_t sock = accept(server, nullptr, nullptr);
+      if (sock != kInvalidSocket) {
+        clients.push_back({sock, proxy::RespReader()});
+      }
+    }
+
+    for (auto it = clients.begin(); it != clients.end();) {
+      if (!FD_ISSET(it->sock, &read_set)) {
+        ++it;
+        continue;
+      }
+
+      char buff[16 * 1024];
+      const auto nread = recv(it->sock, buff, sizeof(buff), 0);
+      bool alive = nread > 0;
+      if (alive) {
+        it->reader.Feed(buff, static_cast<size_t>(nread));
+        // pipelined commands are answered by one write, like a real server does
+        std::string replies;
+        proxy::RespReply request;
+        proxy::RespReader::Status status;
+        while ((status = it->reader.Next(&request)) == proxy::RespReader::REPLY_READY) {
+          std::vector<std::string> argv;
+          for (const proxy::RespReply& arg : request.elements) {
+            argv.push_back(arg.str);
+          }
+          if (config_.latency_usec) {
+            std::this_thread::sleep_for(std::chrono::microseconds(config_.latency_usec));
+          }
+          replies += HandleCommand(argv);
+        }
+        SendAll(it->sock, replies);
+        alive = status != proxy::RespReader::PROTOCOL_ERROR;
+      }
+
+      if (!alive) {
+        CloseSocket(it->sock);
+        it = clients.erase(it);
+        continue;
+      }
+      ++it;
+    }
+  }
+
+  for (const Client& client : clients) {
+    CloseSocket(client.sock);
+  }
+}
+
+std::string RespStubServer::HandleCommand(const std::vector<std::string>& argv) {
+  commands_count_++;
+  if (argv.empty()) {
+    return Error("ERR empty command");
+  }
+
+  const std::string command = ToUpper(argv[0]);
+  const std::string sub = argv.size() > 1 ? ToUpper(argv[1]) : std::string();
+  if (command == "PING") {
+    return Simple("PONG");
+  } else if (command == "ECHO" && argv.size() == 2) {
+    return Bulk(argv[1]);
+  } else if (command == "AUTH" || command == "SELECT" || command == "READONLY" || command == "QUIT") {
+    return Simple("OK");
+  } else if (command == "INFO") {
+    return Bulk(MakeInfo());
+  } else if (command == "DBSIZE") {
+    return Integer(static_cast<long long>(config_.keys_count));
+  } else if (command == "SCAN") {
+    return HandleScan(argv);
+  } else if (command == "CONFIG" && sub == "GET" && argv.size() == 3) {
+    if (ToUpper(argv[2]) == "DATABASES") {
+      return ArrayHeader(2) + Bulk("databases") + Bulk("16");
+    }
+    return ArrayHeader(0);
+  } else if (command == "CLIENT") {
+    if (sub == "LIST") {
+      return Bulk(MakeClientList());
+    } else if (sub == "GETNAME") {
+      return "$-1\r\n";
+    }
+    return Simple("OK");
+  } else if (command == "PUBSUB" && sub == "CHANNELS") {
+    const std::string pattern = argv.size() > 2 ? argv[2] : "*";
+    std::vector<std::string> channels;
+    for (size_t i = 0; i < config_.channels_count; ++i) {
+      const std::string channel = "channel:" + std::to_string(i);
+      if (MatchPattern(pattern.c_str(), channel.c_str())) {
+        channels.push_back(channel);
+      }
+    }
+    std::string reply = ArrayHeader(channels.size());
+    for (const std::string& channel : channels) {
+      reply += Bulk(channel);
+    }
+    return reply;
+  } else if (command == "PUBSUB" && sub == "NUMSUB") {
+    std::string reply = ArrayHeader((argv.size() - 2) * 2);
+    for (size_t i = 2; i < argv.size(); ++i) {
+      reply += Bulk(argv[i]) + Integer(1);
+    }
+    return reply;
+  } else if (command == "COMMAND" || (command == "MODULE" && sub == "LIST")) {
+    return ArrayHeader(0);
+  } else if (argv.size() >= 2) {
+    return HandleValue(command, argv[1]);
+  }
+
+  return Error("ERR unknown command '" + argv[0] + "'");
+}
+
+std::string RespStubServer::HandleScan(const std::vector<std::string>& argv) const {
+  char* end_ptr = nullptr;
+  const size_t cursor = argv.size() < 2 ? 0 : strtoull(argv[1].c_str(), &end_ptr, 10);
+  if (!end_ptr || *end_ptr) {
+    return Error("ERR invalid cursor");
+  }
+
+  std::string pattern = "*";
+  size_t count = 10;
+  for (size_t i = 2; i + 1 < argv.size(); i += 2) {
+    const std::string option = ToUpper(argv[i]);
+    if (option == "MATCH") {
+      pattern = argv[i + 1];
+    } else if (option == "COUNT") {
+      count = std::max<size_t>(strtoull(argv[i + 1].c_str(), nullptr, 10), 1);
+    }
+  }
+
+  // cursor is the next key index, count is the amount of work as in redis
+  const size_t end = std::min(cursor + count, config_.keys_count);
+  std::vector<std::string> keys;
+  for (size_t i = cursor; i < end; ++i) {
+    std::string key = MakeKey(i);
+    if (MatchPattern(pattern.c_str(), key.c_str())) {
+      keys.push_back(std::move(key));
+    }
+  }
+
+  const size_t next = end >= config_.keys_count ? 0 : end;
+  std::string reply = ArrayHeader(2) + Bulk(std::to_string(next)) + ArrayHeader(keys.size());
+  for (const std::string& key : keys) {
+    reply += Bulk(key);
+  }
+  return reply;
+}
+
+std::string RespStubServer::HandleValue(const std::string& command, const std::string& key) const {
+  size_t index = 0;
+  const bool exists = FindKey(key, &index);
+  const KeyType type = static_cast<KeyType>(index % KEY_TYPES_COUNT);
+  if (command == "EXISTS") {
+    return Integer(exists ? 1 : 0);
+  } else if (command == "TYPE") {
+    return Simple(exists ? kTypeNames[type] : "none");
+  } else if (command == "TTL" || command == "PTTL") {
+    if (!exists) {
+      return Integer(-2);
+    }
+    const long long ttl = index % 3 == 0 ? -1 : 1000 + static_cast<long long>(index % 1000);
+    return Integer(command == "PTTL" && ttl > 0 ? ttl * 1000 : ttl);
+  }
+
+  struct ValueCommand {
+    const char* name;
+    KeyType type;
+    bool size_only;
+  };
+  static const ValueCommand value_commands[] = {
+      {"GET", STRING_KEY, false},    {"STRLEN", STRING_KEY, true}, {"HGETALL", HASH_KEY, false},
+      {"HLEN", HASH_KEY, true},      {"LRANGE", LIST_KEY, false},  {"LLEN", LIST_KEY, true},
+      {"SMEMBERS", SET_KEY, false},  {"SCARD", SET_KEY, true},     {"ZRANGE", ZSET_KEY, false},
+      {"ZCARD", ZSET_KEY, true}};
+  for (const ValueCommand& value_command : value_commands) {
+    if (command != value_command.name) {
+      continue;
+    }
+
+    if (!exists) {
+      return value_command.size_only ? Integer(0) : (value_command.type == STRING_KEY ? "$-1\r\n" : ArrayHeader(0));
+    }
+    if (type != value_command.type) {
+      return Error("WRONGTYPE Operation against a key holding the wrong kind of value");
+    }
+    if (type == STRING_KEY) {
+      return value_command.size_only ? Integer(static_cast<long long>(value_.size())) : Bulk(value_);
+    }
+    if (value_command.size_only) {
+      return Integer(static_cast<long long>(config_.collection_size));
+    }
+
+    // hash and zset replies are pairs, zset always with scores for simplicity
+    const bool pairs = type == HASH_KEY || type == ZSET_KEY;
+    std::string reply = ArrayHeader(config_.collection_size * (pairs ? 2 : 1));
+    for (size_t i = 0; i < config_.collection_size; ++i) {
+      reply += Bulk("member:" + std::to_string(i));
+      if (type == HASH_KEY) {
+        reply += Bulk(value_);
+      } else if (type == ZSET_KEY) {
+        reply += Bulk(std::to_string(i));
+      }
+    }
+    return reply;
+  }
+
+  return Error("ERR unknown command '" + command + "'");
+}
+
+std::string RespStubServer::MakeInfo() const {
+  const size_t expires = config_.keys_count - (config_.keys_count + 2) / 3;
+  std::string info;
+  info += "# Server\r\nredis_version:6.2.6\r\nredis_git_sha1:00000000\r\nredis_git_dirty:0\r\n";
+  info += "redis_mode:standalone\r\n";
+  info += "os:Linux\r\narch_bits:64\r\nmultiplexing_api:epoll\r\nprocess_id:1\r\ntcp_port:" + std::to_string(port_) +
+          "\r\nuptime_in_seconds:3600\r\nuptime_in_days:0\r\n\r\n";
+  info += "# Clients\r\nconnected_clients:" + std::to_string(config_.clients_count) + "\r\nblocked_clients:0\r\n\r\n";
+  info += "# Memory\r\nused_memory:" + std::to_string(config_.keys_count * (config_.value_size + 64)) +
+          "\r\nused_memory_peak:0\r\nmem_fragmentation_ratio:1.00\r\n\r\n";
+  info += "# Persistence\r\nloading:0\r\nrdb_changes_since_last_save:0\r\nrdb_bgsave_in_progress:0\r\n\r\n";
+  info += "# Stats\r\ntotal_connections_received:1\r\ntotal_commands_processed:" + std::to_string(commands_count_) +
+          "\r\ninstantaneous_ops_per_sec:0\r\nkeyspace_hits:0\r\nkeyspace_misses:0\r\n\r\n";
+  info += "# Replication\r\nrole:master\r\nconnected_slaves:0\r\n\r\n";
+  info += "# CPU\r\nused_cpu_sys:0.00\r\nused_cpu_user:0.00\r\n\r\n";
+  info += "# Keyspace\r\ndb0:keys=" + std::to_string(config_.keys_count) + ",expires=" + std::to_string(expires) +
+          ",avg_ttl=0\r\n";
+  return info;
+}
+
+std::string RespStubServer::MakeClientList() const {
+  std::string list;
+  for (size_t i = 0; i < config_.clients_count; ++i) {
+    const std::string id = std::to_string(i + 1);
+    list += "id=" + id + " addr=127.0.0.1:" + std::to_string(40000 + i % 20000) + " fd=" + std::to_string(i + 8) +
+            " name=client" + id +
+            " age=10 idle=0 flags=N db=0 sub=0 psub=0 multi=-1 qbuf=0 qbuf-free=0 obl=0 oll=0 omem=0 events=r"
+            " cmd=client\n";
+  }
+  return list;
+}
+
+bool RespStubServer::FindKey(const std::string& key, size_t* index) const {
+  const size_t prefix_size = sizeof(kKeyPrefix) - 1;
+  if (key.size() != prefix_size + kKeyDigits || key.compare(0, prefix_size, kKeyPrefix) != 0) {
+    return false;
+  }
+
+  size_t result = 0;
+  for (size_t i = prefix_size; i < key.size(); ++i) {
+    if (key[i] < '0' || key[i] > '9') {
+      return false;
+    }
+    result = result * 10 + static_cast<size_t>(key[i] - '0');
+  }
+
+  *index = result;
+  return result < config_.keys_count;
+}
+
+}  // namespace benchmarks
+}  // namespace fastonosql
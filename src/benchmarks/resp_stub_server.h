@@ -0,0 +1,81 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "proxy/resp_reader.h"
+
+namespace fastonosql {
+namespace benchmarks {
+
+// redis protocol server on 127.0.0.1 serving a synthetic read only keyspace, it knows just
+// enough commands for the redis driver to connect, scan, inspect keys and list clients/channels
+class RespStubServer {
+ public:
+  struct Config {
+    Config();
+
+    size_t keys_count;
+    size_t value_size;       // bytes of string values
+    size_t collection_size;  // elements of hash, list, set and zset values
+    size_t clients_count;    // lines of CLIENT LIST
+    size_t channels_count;   // PUBSUB CHANNELS
+    unsigned latency_usec;   // injected before every reply
+  };
+
+  explicit RespStubServer(const Config& config);
+  ~RespStubServer();
+
+  bool Start();
+  void Stop();
+
+  uint16_t GetPort() const;
+  size_t GetCommandsCount() const;
+
+  static std::string MakeKey(size_t index);
+
+ private:
+  enum KeyType { STRING_KEY, HASH_KEY, LIST_KEY, SET_KEY, ZSET_KEY, KEY_TYPES_COUNT };
+
+  void Routine();
+  std::string HandleCommand(const std::vector<std::string>& argv);
+  std::string HandleScan(const std::vector<std::string>& argv) const;
+  std::string HandleValue(const std::string& command, const std::string& key) const;
+  std::string MakeInfo() const;
+  std::string MakeClientList() const;
+
+  bool FindKey(const std::string& key, size_t* index) const;
+
+  const Config config_;
+  std::string value_;
+  intptr_t listen_socket_;
+  uint16_t port_;
+  std::thread thread_;
+  std::atomic<bool> stop_;
+  std::atomic<size_t> commands_count_;
+};
+
+}  // namespace benchmarks
+}  // namespace fastonosql
@@ -0,0 +1,75 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmarks/stub_connection.h"
+
+#include <QEventLoop>
+#include <QTimer>
+
+#include "benchmarks/resp_stub_server.h"
+#include "proxy/connection_settings/iconnection_settings_remote.h"
+#include "proxy/connection_settings_factory.h"
+#include "proxy/events/events_info.h"
+#include "proxy/server/iserver.h"
+#include "proxy/servers_manager.h"
+
+namespace fastonosql {
+namespace benchmarks {
+
+namespace {
+const int kConnectTimeoutMsec = 10000;
+}
+
+proxy::IConnectionSettingsBaseSPtr MakeStubSettings(const RespStubServer& stub) {
+  return proxy::IConnectionSettingsBaseSPtr(
+      proxy::ConnectionSettingsFactory::GetInstance().CreateRemoteSettingsFromTypeConnection(
+          core::REDIS, proxy::connection_path_t("/benchmark"), common::net::HostAndPort("127.0.0.1", stub.GetPort())));
+}
+
+proxy::IServerSPtr ConnectToStub(proxy::IConnectionSettingsBaseSPtr settings, QObject* initiator, common::Error* err) {
+  proxy::IServerSPtr server = proxy::ServersManager::GetInstance().CreateServer(settings);
+
+  QEventLoop loop;
+  common::Error result = common::make_error("Connection timeout");
+  QTimer::singleShot(kConnectTimeoutMsec, &loop, &QEventLoop::quit);
+  QObject::connect(server.get(), &proxy::IServer::ConnectFinished, &loop,
+                   [&](const proxy::events_info::ConnectInfoResponse& res) {
+                     if (res.errorInfo()) {
+                       result = res.errorInfo();
+                       loop.quit();
+                     }
+                   });
+  // discovery follows a successful connect
+  QObject::connect(server.get(), &proxy::IServer::LoadDiscoveryInfoFinished, &loop,
+                   [&](const proxy::events_info::DiscoveryInfoResponse& res) {
+                     result = res.errorInfo();
+                     loop.quit();
+                   });
+  server->Connect(proxy::events_info::ConnectInfoRequest(initiator));
+  loop.exec();
+
+  if (result) {
+    proxy::ServersManager::GetInstance().CloseServer(server);
+    *err = result;
+    return proxy::IServerSPtr();
+  }
+  return server;
+}
+
+}  // namespace benchmarks
+}  // namespace fastonosql
@@ -0,0 +1,39 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QObject>
+
+#include <common/error.h>
+
+#include "proxy/connection_settings/iconnection_settings.h"
+#include "proxy/proxy_fwd.h"
+
+namespace fastonosql {
+namespace benchmarks {
+
+class RespStubServer;
+
+proxy::IConnectionSettingsBaseSPtr MakeStubSettings(const RespStubServer& stub);
+
+// server object connected and discovered, so it is idle on return
+proxy::IServerSPtr ConnectToStub(proxy::IConnectionSettingsBaseSPtr settings, QObject* initiator, common::Error* err);
+
+}  // namespace benchmarks
+}  // namespace fastonosql
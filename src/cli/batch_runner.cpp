@@ -0,0 +1,427 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "cli/batch_runner.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+
+#include <json-c/json_object.h>
+
+#include <common/convert2string.h>
+#include <common/macros.h>
+#include <common/time.h>
+
+#include <fastonosql/core/connection_types.h>
+#include <fastonosql/core/macros.h>
+
+#include "proxy/connection_settings/iconnection_settings.h"
+#include "proxy/connection_settings/iconnection_settings_ssh.h"
+#include "proxy/events/events_info.h"
+#include "proxy/server/iserver.h"
+#include "proxy/servers_manager.h"
+#include "proxy/settings_manager.h"
+
+namespace fastonosql {
+namespace cli {
+
+namespace {
+
+const char* GetOperationName(BatchRunner::Operation operation) {
+  switch (operation) {
+    case BatchRunner::LIST:
+      return "list";
+    case BatchRunner::EXEC:
+      return "exec";
+    case BatchRunner::SCAN:
+      return "scan";
+    case BatchRunner::BACKUP:
+      return "backup";
+    case BatchRunner::BENCH:
+      return "bench";
+    case BatchRunner::MIGRATE:
+      return "migrate";
+  }
+  return "unknown";
+}
+
+json_object* MakeString(const std::string& str) {
+  return json_object_new_string_len(str.data(), static_cast<int>(str.size()));
+}
+
+double Percentile(const std::vector<double>& sorted, double percent) {
+  if (sorted.empty()) {
+    return 0;
+  }
+
+  const size_t index = static_cast<size_t>(percent / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+  return sorted[std::min(index, sorted.size() - 1)];
+}
+
+}  // namespace
+
+BatchRunner::Options::Options()
+    : operation(LIST),
+      connection(),
+      destination(),
+      script(),
+      path(),
+      command("PING"),
+      pattern(ALL_KEYS_PATTERNS),
+      count(default_scan_count),
+      limit(0),
+      requests(default_bench_requests),
+      window(proxy::MigrationJob::default_window),
+      workers(proxy::MigrationJob::default_workers) {}
+
+BatchRunner::BatchRunner(const Options& options, QObject* parent)
+    : QObject(parent),
+      options_(options),
+      result_(json_object_new_object()),
+      start_msec_(0),
+      server_(),
+      database_(),
+      running_(false),
+      cursor_(0),
+      key_cursor_(),
+      scanned_keys_(0),
+      bench_latencies_(),
+      request_start_(),
+      migration_(nullptr),
+      migration_stat_() {}
+
+BatchRunner::~BatchRunner() {
+  json_object_put(result_);
+}
+
+proxy::IConnectionSettingsBaseSPtr BatchRunner::FindConnection(const std::string& name) {
+  // full path "/dir/name" or just name if it's unique enough for the caller
+  const auto connections = proxy::SettingsManager::GetInstance()->GetConnections();
+  for (const auto& connection : connections) {
+    if (connection->GetPath().ToString() == name) {
+      return connection;
+    }
+  }
+
+  for (const auto& connection : connections) {
+    if (connection->GetPath().GetName() == name) {
+      return connection;
+    }
+  }
+  return proxy::IConnectionSettingsBaseSPtr();
+}
+
+void BatchRunner::Start() {
+  start_msec_ = common::time::current_utc_mstime();
+  running_ = true;
+  json_object_object_add(result_, "operation", json_object_new_string(GetOperationName(options_.operation)));
+  if (options_.operation == LIST) {
+    ListConnections();
+    return;
+  }
+
+  json_object_object_add(result_, "connection", MakeString(options_.connection));
+  if (options_.operation == MIGRATE) {
+    StartMigration();
+    return;
+  }
+
+  proxy::IConnectionSettingsBaseSPtr settings = FindConnection(options_.connection);
+  if (!settings) {
+    Finish(common::make_error("Connection not found: " + options_.connection));
+    return;
+  }
+
+  // nobody can answer password dialog in batch mode
+  proxy::IConnectionSettingsRemoteSSH* ssh = dynamic_cast<proxy::IConnectionSettingsRemoteSSH*>(settings.get());
+  if (ssh && ssh->GetSSHInfo().GetAuthMethod() == core::SSHInfo::ASK_PASSWORD) {
+    Finish(common::make_error("SSH password prompt isn't supported in batch mode, save the password in connection"));
+    return;
+  }
+
+  server_ = proxy::ServersManager::GetInstance().CreateServer(settings);
+  if (!server_) {
+    Finish(common::make_error("Invalid connection settings"));
+    return;
+  }
+
+  VERIFY(connect(server_.get(), &proxy::IServer::ConnectFinished, this, &BatchRunner::HandleConnectFinished));
+  VERIFY(connect(server_.get(), &proxy::IServer::LoadDiscoveryInfoFinished, this,
+                 &BatchRunner::HandleDiscoveryFinished));
+  VERIFY(connect(server_.get(), &proxy::IServer::ExecuteFinished, this, &BatchRunner::HandleExecuteFinished));
+  VERIFY(connect(server_.get(), &proxy::IServer::LoadDatabaseContentFinished, this, &BatchRunner::HandlePageLoaded));
+  VERIFY(connect(server_.get(), &proxy::IServer::BackupFinished, this, &BatchRunner::HandleBackupFinished));
+
+  proxy::events_info::ConnectInfoRequest req(this);
+  server_->Connect(req);
+}
+
+void BatchRunner::ListConnections() {
+  json_object* jconnections = json_object_new_array();
+  const auto connections = proxy::SettingsManager::GetInstance()->GetConnections();
+  for (const auto& connection : connections) {
+    json_object* jconnection = json_object_new_object();
+    json_object_object_add(jconnection, "path", MakeString(connection->GetPath().ToString()));
+    json_object_object_add(jconnection, "name", MakeString(connection->GetPath().GetName()));
+    json_object_object_add(jconnection, "type", MakeString(core::ConnectionTypeToString(connection->GetType())));
+    json_object_array_add(jconnections, jconnection);
+  }
+  json_object_object_add(result_, "connections", jconnections);
+  Finish(common::Error());
+}
+
+void BatchRunner::StartMigration() {
+  json_object_object_add(result_, "destination", MakeString(options_.destination));
+  proxy::IConnectionSettingsBaseSPtr source = FindConnection(options_.connection);
+  proxy::IConnectionSettingsBaseSPtr destination = FindConnection(options_.destination);
+  if (!source || !destination) {
+    Finish(common::make_error("Connection not found: " + (source ? options_.destination : options_.connection)));
+    return;
+  }
+
+  migration_ = new proxy::MigrationJob(source, destination, options_.pattern, options_.count, options_.window,
+                                       options_.workers, proxy::MigrationJob::Checkpoint(), this);
+  VERIFY(connect(migration_, &proxy::MigrationJob::Progressed, this, &BatchRunner::HandleMigrationProgressed));
+  VERIFY(connect(migration_, &proxy::MigrationJob::Finished, this, &BatchRunner::HandleMigrationFinished));
+  migration_->Start();
+}
+
+void BatchRunner::HandleConnectFinished(const proxy::events_info::ConnectInfoResponse& res) {
+  if (res.initiator() != this || !running_) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+  }
+  // operation starts once discovery gives the current database
+}
+
+void BatchRunner::HandleDiscoveryFinished(const proxy::events_info::DiscoveryInfoResponse& res) {
+  if (!running_ || database_) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  database_ = res.dbinfo ? res.dbinfo : server_->GetCurrentDatabaseInfo();
+  RunOperation();
+}
+
+void BatchRunner::RunOperation() {
+  switch (options_.operation) {
+    case EXEC: {
+      proxy::events_info::ExecuteInfoRequest req(this, common::ConvertToCharBytes(options_.script), 0, 0, false,
+                                                 true);
+      server_->Execute(req);
+      return;
+    }
+    case SCAN:
+      json_object_object_add(result_, "keys", json_object_new_array());
+      FetchNextPage();
+      return;
+    case BACKUP: {
+      proxy::events_info::BackupInfoRequest req(this, options_.path);
+      server_->BackupToPath(req);
+      return;
+    }
+    case BENCH:
+      bench_latencies_.reserve(options_.requests);
+      SendBenchRequest();
+      return;
+    default:
+      Finish(common::make_error_inval());
+      return;
+  }
+}
+
+void BatchRunner::SendBenchRequest() {
+  request_start_ = std::chrono::steady_clock::now();
+  proxy::events_info::ExecuteInfoRequest req(this, common::ConvertToCharBytes(options_.command), 0, 0, false, true,
+                                             core::C_INNER);
+  server_->Execute(req);
+}
+
+void BatchRunner::FetchNextPage() {
+  if (!database_) {
+    Finish(common::make_error("Database not discovered"));
+    return;
+  }
+
+  core::keys_limit_t count = options_.count;
+  if (options_.limit) {
+    count = std::min<core::keys_limit_t>(count, options_.limit - scanned_keys_);
+  }
+  proxy::events_info::LoadDatabaseContentRequest req(this, database_, options_.pattern, count, cursor_, key_cursor_);
+  server_->LoadDatabaseContent(req);
+}
+
+void BatchRunner::HandleExecuteFinished(const proxy::events_info::ExecuteInfoResponse& res) {
+  if (res.initiator() != this || !running_) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (options_.operation == BENCH) {
+    if (err) {
+      Finish(err);
+      return;
+    }
+
+    // round trip as user sees it: gui queue, driver queue and network
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - request_start_;
+    bench_latencies_.push_back(elapsed.count());
+    if (bench_latencies_.size() < options_.requests) {
+      SendBenchRequest();
+      return;
+    }
+
+    std::vector<double> sorted = bench_latencies_;
+    std::sort(sorted.begin(), sorted.end());
+    const double total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+    json_object* jlatency = json_object_new_object();
+    json_object_object_add(jlatency, "min", json_object_new_double(sorted.front()));
+    json_object_object_add(jlatency, "avg", json_object_new_double(total / static_cast<double>(sorted.size())));
+    json_object_object_add(jlatency, "p50", json_object_new_double(Percentile(sorted, 50)));
+    json_object_object_add(jlatency, "p95", json_object_new_double(Percentile(sorted, 95)));
+    json_object_object_add(jlatency, "p99", json_object_new_double(Percentile(sorted, 99)));
+    json_object_object_add(jlatency, "max", json_object_new_double(sorted.back()));
+    json_object_object_add(result_, "command", MakeString(options_.command));
+    json_object_object_add(result_, "requests", json_object_new_int64(static_cast<int64_t>(sorted.size())));
+    json_object_object_add(result_, "latency_msec", jlatency);
+    const double ops_per_sec = total > 0 ? static_cast<double>(sorted.size()) * 1000.0 / total : 0;
+    json_object_object_add(result_, "ops_per_sec", json_object_new_double(ops_per_sec));
+    Finish(common::Error());
+    return;
+  }
+
+  if (options_.operation != EXEC) {
+    return;
+  }
+
+  // replies of commands executed before a failure are still reported
+  json_object* jcommands = json_object_new_array();
+  for (const core::FastoObjectCommandIPtr& cmd : res.executed_commands) {
+    json_object* jcommand = json_object_new_object();
+    json_object_object_add(jcommand, "command", MakeString(cmd->GetInputCommand().as_string()));
+    json_object_object_add(jcommand, "reply", MakeString(common::ConvertToString(cmd.get())));
+    json_object_array_add(jcommands, jcommand);
+  }
+  json_object_object_add(result_, "commands", jcommands);
+  Finish(err);
+}
+
+void BatchRunner::HandlePageLoaded(const proxy::events_info::LoadDatabaseContentResponse& res) {
+  if (res.initiator() != this || !running_) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  json_object* jkeys = nullptr;
+  json_object_object_get_ex(result_, "keys", &jkeys);
+  for (const core::NDbKValue& key : res.keys) {
+    const core::NKey nkey = key.GetKey();
+    json_object* jkey = json_object_new_object();
+    json_object_object_add(jkey, "key", MakeString(nkey.GetKey().ToString()));
+    json_object_object_add(jkey, "type", MakeString(common::Value::GetTypeName(key.GetType())));
+    json_object_object_add(jkey, "ttl", json_object_new_int64(nkey.GetTTL()));
+    json_object_array_add(jkeys, jkey);
+  }
+
+  scanned_keys_ += res.keys.size();
+  cursor_ = res.cursor_out;
+  key_cursor_ = res.key_cursor_out;
+  const bool limit_reached = options_.limit && scanned_keys_ >= options_.limit;
+  if (res.cursor_out == 0 || limit_reached) {
+    json_object_object_add(result_, "db_keys_count", json_object_new_int64(static_cast<int64_t>(res.db_keys_count)));
+    json_object_object_add(result_, "keys_count", json_object_new_int64(static_cast<int64_t>(scanned_keys_)));
+    Finish(common::Error());
+    return;
+  }
+
+  FetchNextPage();
+}
+
+void BatchRunner::HandleBackupFinished(const proxy::events_info::BackupInfoResponse& res) {
+  if (res.initiator() != this || !running_) {
+    return;
+  }
+
+  json_object_object_add(result_, "path", MakeString(res.path));
+  Finish(res.errorInfo());
+}
+
+void BatchRunner::HandleMigrationProgressed(const proxy::MigrationJob::Statistic& stat,
+                                            const proxy::MigrationJob::Checkpoint& checkpoint) {
+  UNUSED(checkpoint);
+  migration_stat_ = stat;
+  // stdout is reserved for the result document
+  std::cerr << "migrated " << stat.migrated_keys << "/" << stat.total_keys << " keys, " << stat.keys_per_sec
+            << " keys/sec" << std::endl;
+}
+
+void BatchRunner::HandleMigrationFinished(common::Error err, const proxy::MigrationJob::Checkpoint& checkpoint) {
+  if (!running_) {
+    return;
+  }
+
+  json_object_object_add(result_, "migrated_keys",
+                         json_object_new_int64(static_cast<int64_t>(checkpoint.migrated_keys)));
+  json_object_object_add(result_, "skipped_keys",
+                         json_object_new_int64(static_cast<int64_t>(migration_stat_.skipped_keys)));
+  json_object_object_add(result_, "failed_keys",
+                         json_object_new_int64(static_cast<int64_t>(migration_stat_.failed_keys)));
+  json_object_object_add(result_, "keys_per_sec", json_object_new_double(migration_stat_.keys_per_sec));
+  Finish(err);
+}
+
+void BatchRunner::Finish(common::Error err) {
+  if (!running_) {
+    return;
+  }
+
+  running_ = false;
+  json_object_object_add(result_, "ok", json_object_new_boolean(!err));
+  if (err) {
+    json_object_object_add(result_, "error", MakeString(err->GetDescription()));
+  }
+  json_object_object_add(result_, "elapsed_msec",
+                         json_object_new_int64(common::time::current_utc_mstime() - start_msec_));
+  std::cout << json_object_to_json_string_ext(result_, JSON_C_TO_STRING_PRETTY) << std::endl;
+
+  if (server_) {
+    proxy::ServersManager::GetInstance().CloseServer(server_);
+    server_.reset();
+  }
+  emit Finished(err ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+}  // namespace cli
+}  // namespace fastonosql
@@ -0,0 +1,118 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <QObject>
+
+#include <common/error.h>
+
+#include <fastonosql/core/database/idatabase_info.h>
+
+#include "proxy/migration_job.h"
+
+struct json_object;
+
+namespace fastonosql {
+namespace proxy {
+namespace events_info {
+struct BackupInfoResponse;
+}  // namespace events_info
+}  // namespace proxy
+
+namespace cli {
+
+// one operation against saved connections without any widget, result is a single
+// json document printed to stdout, diagnostics go to stderr
+class BatchRunner : public QObject {
+  Q_OBJECT
+
+ public:
+  enum Operation { LIST, EXEC, SCAN, BACKUP, BENCH, MIGRATE };
+  enum { default_scan_count = 1000, default_bench_requests = 1000 };
+
+  struct Options {
+    Options();
+
+    Operation operation;
+    std::string connection;
+    std::string destination;  // migrate
+    std::string script;       // exec, commands separated by new lines
+    std::string path;         // backup
+    std::string command;      // bench
+    core::pattern_t pattern;
+    core::keys_limit_t count;  // scan page size, migrate batch size
+    size_t limit;              // scan, 0 - all keys
+    size_t requests;           // bench
+    size_t window;             // migrate
+    size_t workers;            // migrate
+  };
+
+  explicit BatchRunner(const Options& options, QObject* parent = Q_NULLPTR);
+  ~BatchRunner() override;
+
+  void Start();
+
+  static proxy::IConnectionSettingsBaseSPtr FindConnection(const std::string& name);
+
+ Q_SIGNALS:
+  void Finished(int exit_code);
+
+ private Q_SLOTS:
+  void HandleConnectFinished(const proxy::events_info::ConnectInfoResponse& res);
+  void HandleDiscoveryFinished(const proxy::events_info::DiscoveryInfoResponse& res);
+  void HandleExecuteFinished(const proxy::events_info::ExecuteInfoResponse& res);
+  void HandlePageLoaded(const proxy::events_info::LoadDatabaseContentResponse& res);
+  void HandleBackupFinished(const proxy::events_info::BackupInfoResponse& res);
+  void HandleMigrationProgressed(const proxy::MigrationJob::Statistic& stat,
+                                 const proxy::MigrationJob::Checkpoint& checkpoint);
+  void HandleMigrationFinished(common::Error err, const proxy::MigrationJob::Checkpoint& checkpoint);
+
+ private:
+  void ListConnections();
+  void StartMigration();
+  void RunOperation();
+  void SendBenchRequest();
+  void FetchNextPage();
+  void Finish(common::Error err);
+
+  const Options options_;
+  json_object* result_;
+  common::time64_t start_msec_;
+
+  proxy::IServerSPtr server_;
+  core::IDataBaseInfoSPtr database_;
+  bool running_;
+
+  core::cursor_t cursor_;
+  core::command_buffer_t key_cursor_;
+  size_t scanned_keys_;
+
+  std::vector<double> bench_latencies_;  // msec
+  std::chrono::steady_clock::time_point request_start_;
+
+  proxy::MigrationJob* migration_;
+  proxy::MigrationJob::Statistic migration_stat_;
+};
+
+}  // namespace cli
+}  // namespace fastonosql
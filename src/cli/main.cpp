@@ -0,0 +1,229 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#if defined(OS_WIN)
+#include <winsock2.h>
+#else
+#include <signal.h>
+#endif
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <QApplication>
+#include <QTimer>
+
+#include <common/convert2string.h>
+#include <common/macros.h>
+#include <common/file_system/string_path_utils.h>
+
+#include "cli/batch_runner.h"
+#include "proxy/settings_manager.h"
+
+namespace {
+#if defined(OS_WIN)
+struct WinsockInit {
+  WinsockInit() {
+    WSADATA d;
+    if (WSAStartup(0x202, &d) != 0) {
+      _exit(1);
+    }
+  }
+  ~WinsockInit() { WSACleanup(); }
+} winsock_init;
+#else
+struct SigIgnInit {
+  SigIgnInit() { signal(SIGPIPE, SIG_IGN); }
+} sig_init;
+#endif
+
+const char kUsage[] =
+    "Usage: " PROJECT_NAME_LOWERCASE "_cli [--settings <ini>] <operation> [options]\n"
+    "Operations:\n"
+    "  list                                   saved connections\n"
+    "  exec --connection <name> --file <path|->\n"
+    "                                         run commands, one per line\n"
+    "  scan --connection <name> [--pattern <pattern>] [--count <page>] [--limit <keys>]\n"
+    "                                         keys with types and ttl\n"
+    "  backup --connection <name> --path <path>\n"
+    "                                         server backup to path\n"
+    "  bench --connection <name> [--command <command>] [--requests <n>]\n"
+    "                                         sequential request latency\n"
+    "  migrate --connection <name> --to <name> [--pattern <pattern>] [--count <batch>]\n"
+    "          [--window <pages>] [--workers <n>]\n"
+    "                                         copy keys between connections\n"
+    "Connection is a name or a full path like /folder/name, result is json on stdout.\n";
+
+bool ParseOperation(const std::string& name, fastonosql::cli::BatchRunner::Operation* operation) {
+  static const std::pair<const char*, fastonosql::cli::BatchRunner::Operation> operations[] = {
+      {"list", fastonosql::cli::BatchRunner::LIST},       {"exec", fastonosql::cli::BatchRunner::EXEC},
+      {"scan", fastonosql::cli::BatchRunner::SCAN},       {"backup", fastonosql::cli::BatchRunner::BACKUP},
+      {"bench", fastonosql::cli::BatchRunner::BENCH},     {"migrate", fastonosql::cli::BatchRunner::MIGRATE}};
+  for (const auto& op : operations) {
+    if (name == op.first) {
+      *operation = op.second;
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename T>
+bool ParseNumber(const char* arg, T* out) {
+  T result;
+  if (!common::ConvertFromString(std::string(arg), &result) || result == 0) {
+    return false;
+  }
+
+  *out = result;
+  return true;
+}
+
+bool ReadScript(const std::string& path, std::string* out) {
+  std::stringstream buffer;
+  if (path == "-") {
+    buffer << std::cin.rdbuf();
+  } else {
+    std::ifstream file(common::file_system::prepare_path(path));
+    if (!file) {
+      return false;
+    }
+    buffer << file.rdbuf();
+  }
+
+  *out = buffer.str();
+  return true;
+}
+
+bool ParseArgs(int argc, char* argv[], std::string* settings_path, fastonosql::cli::BatchRunner::Options* options) {
+  bool have_operation = false;
+  std::string script_path;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const bool have_value = i + 1 < argc;
+    if (arg.compare(0, 2, "--") != 0) {
+      if (have_operation || !ParseOperation(arg, &options->operation)) {
+        return false;
+      }
+      have_operation = true;
+    } else if (!have_value) {
+      return false;
+    } else if (arg == "--settings") {
+      *settings_path = argv[++i];
+    } else if (arg == "--connection") {
+      options->connection = argv[++i];
+    } else if (arg == "--to") {
+      options->destination = argv[++i];
+    } else if (arg == "--file") {
+      script_path = argv[++i];
+    } else if (arg == "--command") {
+      options->command = argv[++i];
+    } else if (arg == "--pattern") {
+      options->pattern = argv[++i];
+    } else if (arg == "--path") {
+      options->path = argv[++i];
+    } else if (arg == "--count") {
+      if (!ParseNumber(argv[++i], &options->count)) {
+        return false;
+      }
+    } else if (arg == "--limit") {
+      if (!ParseNumber(argv[++i], &options->limit)) {
+        return false;
+      }
+    } else if (arg == "--requests") {
+      if (!ParseNumber(argv[++i], &options->requests)) {
+        return false;
+      }
+    } else if (arg == "--window") {
+      if (!ParseNumber(argv[++i], &options->window)) {
+        return false;
+      }
+    } else if (arg == "--workers") {
+      if (!ParseNumber(argv[++i], &options->workers)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+
+  if (!have_operation) {
+    return false;
+  }
+
+  const fastonosql::cli::BatchRunner::Operation operation = options->operation;
+  if (operation != fastonosql::cli::BatchRunner::LIST && options->connection.empty()) {
+    return false;
+  }
+
+  switch (operation) {
+    case fastonosql::cli::BatchRunner::EXEC:
+      if (script_path.empty() || !ReadScript(script_path, &options->script)) {
+        std::cerr << "Can't read script: " << script_path << std::endl;
+        return false;
+      }
+      return true;
+    case fastonosql::cli::BatchRunner::BACKUP:
+      return !options->path.empty();
+    case fastonosql::cli::BatchRunner::MIGRATE:
+      return !options->destination.empty();
+    default:
+      return true;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string settings_path;
+  fastonosql::cli::BatchRunner::Options options;
+  if (!ParseArgs(argc, argv, &settings_path, &options)) {
+    std::cerr << kUsage;
+    return EXIT_FAILURE;
+  }
+
+  // settings keep fonts, so a gui application is required, but nothing is ever shown
+  if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+  }
+
+  QApplication app(argc, argv);
+  app.setOrganizationName(PROJECT_COMPANYNAME);
+  app.setOrganizationDomain(PROJECT_COMPANYNAME_DOMAIN);
+  app.setApplicationName(PROJECT_NAME_TITLE);
+  app.setApplicationVersion(PROJECT_VERSION);
+
+  // warnings and errors only, stdout belongs to the result
+  INIT_LOGGER(PROJECT_NAME_TITLE, common::logging::LOG_LEVEL_WARNING);
+
+  const auto settings_manager = fastonosql::proxy::SettingsManager::GetInstance();
+  if (settings_path.empty()) {
+    settings_manager->Load();
+  } else {
+    settings_manager->ReloadFromPath(common::file_system::prepare_path(settings_path), false);
+  }
+
+  fastonosql::cli::BatchRunner runner(options);
+  VERIFY(QObject::connect(&runner, &fastonosql::cli::BatchRunner::Finished, &app, &QApplication::exit,
+                          Qt::QueuedConnection));
+  QTimer::singleShot(0, &runner, &fastonosql::cli::BatchRunner::Start);
+  return app.exec();
+}
@@ -26,6 +26,11 @@
 
 #include "gui/gui_factory.h"
 
+namespace {
+const QString trOnline = QObject::tr("online");
+const QString trLatencyTemplate_1S = QObject::tr("%1 msec");
+}  // namespace
+
 namespace fastonosql {
 namespace gui {
 
@@ -81,6 +86,42 @@ IConnectionListWidgetItem::itemConnectionType ConnectionListWidgetItem::type() c
   return Common;
 }
 
+void ConnectionListWidgetItem::setHealth(common::Error err, const proxy::ServersManager::HealthInfo& info) {
+  clearHealth();
+  if (err) {
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    setIcon(StateColumn, GuiFactory::GetInstance().failIcon());
+    setText(StateColumn, qerror);
+    setToolTip(StateColumn, qerror);
+    return;
+  }
+
+  setIcon(StateColumn, GuiFactory::GetInstance().successIcon());
+  setText(StateColumn, trOnline);
+  const common::time64_t latency = info.ping_msec != -1 ? info.ping_msec : info.connect_msec;
+  setText(LatencyColumn, trLatencyTemplate_1S.arg(latency));
+
+  QString qtext;
+  if (common::ConvertFromString(info.role, &qtext)) {
+    setText(RoleColumn, qtext);
+  }
+  if (common::ConvertFromString(info.version, &qtext)) {
+    setText(VersionColumn, qtext);
+  }
+  if (common::ConvertFromString(info.used_memory, &qtext)) {
+    setText(MemoryColumn, qtext);
+  }
+}
+
+void ConnectionListWidgetItem::clearHealth() {
+  setIcon(StateColumn, QIcon());
+  setToolTip(StateColumn, QString());
+  for (int column = StateColumn; column <= MemoryColumn; ++column) {
+    setText(column, QString());
+  }
+}
+
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 ConnectionListWidgetItemDiscovered::ConnectionListWidgetItemDiscovered(const core::ServerCommonInfo& info,
                                                                        QTreeWidgetItem* parent)
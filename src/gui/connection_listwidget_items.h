@@ -23,6 +23,7 @@
 #include <fastonosql/core/server/server_discovery_info.h>
 
 #include "proxy/connection_settings/iconnection_settings.h"
+#include "proxy/servers_manager.h"
 
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 #include "proxy/connection_settings/icluster_connection_settings.h"
@@ -60,9 +61,14 @@ class IConnectionListWidgetItem  // base class
 class ConnectionListWidgetItem  // common connection
     : public IConnectionListWidgetItem {
  public:
+  enum HealthColumn { StateColumn = 3, LatencyColumn, RoleColumn, VersionColumn, MemoryColumn };
+
   explicit ConnectionListWidgetItem(QTreeWidgetItem* parent);
   void setConnection(proxy::IConnectionSettingsBaseSPtr cons) override;
   itemConnectionType type() const override;
+
+  void setHealth(common::Error err, const proxy::ServersManager::HealthInfo& info);
+  void clearHealth();
 };
 
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
@@ -0,0 +1,276 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/big_keys_dialog.h"
+
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSortFilterProxyModel>
+#include <QSpinBox>
+#include <QSplitter>
+
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/macros.h>
+
+#include "proxy/database/idatabase.h"
+#include "proxy/server/iserver.h"
+
+#include "gui/models/keys_usage_table_model.h"
+#include "gui/views/fasto_table_view.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trInvalidPattern = QObject::tr("Invalid pattern!");
+const QString trPattern = QObject::tr("Pattern");
+const QString trScanCount = QObject::tr("Scan count");
+const QString trTopPerType = QObject::tr("Top per type");
+const QString trSortBy = QObject::tr("Sort by");
+const QString trMaxOpsPerSec = QObject::tr("Max ops/sec");
+const QString trUnlimited = QObject::tr("Unlimited");
+const QString trFind = QObject::tr("Find");
+const QString trMemoryUsage = QObject::tr("Memory usage");
+const QString trElementsCount = QObject::tr("Elements count");
+const QString trAccessFrequency = QObject::tr("Access frequency (LFU)");
+const QString trScannedTemplate_2S = QObject::tr("Scanned %1 of %2 keys");
+const QString trStoppedTemplate_2S = QObject::tr("Stopped after %1 of %2 keys, top is partial");
+const char* kDefaultPattern = ALL_KEYS_PATTERNS;
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+BigKeysDialog::BigKeysDialog(const QString& title, const QIcon& icon, proxy::IDatabaseSPtr db, QWidget* parent)
+    : base_class(title, parent),
+      pattern_label_(nullptr),
+      pattern_edit_(nullptr),
+      scan_count_label_(nullptr),
+      scan_count_spin_(nullptr),
+      top_limit_label_(nullptr),
+      top_limit_spin_(nullptr),
+      criteria_label_(nullptr),
+      criteria_combo_(nullptr),
+      ops_label_(nullptr),
+      ops_spin_(nullptr),
+      start_button_(nullptr),
+      stop_button_(nullptr),
+      status_label_(nullptr),
+      keys_table_(nullptr),
+      keys_model_(nullptr),
+      proxy_model_(nullptr),
+      db_(db),
+      is_running_(false) {
+  CHECK(db_) << "Must be database.";
+  setWindowIcon(icon);
+
+  proxy::IServerSPtr server = db_->GetServer();
+  VERIFY(connect(server.get(), &proxy::IServer::FindBigKeysStarted, this, &BigKeysDialog::startFindBigKeys));
+  VERIFY(connect(server.get(), &proxy::IServer::FindBigKeysUpdated, this, &BigKeysDialog::updateFindBigKeys));
+  VERIFY(connect(server.get(), &proxy::IServer::FindBigKeysFinished, this, &BigKeysDialog::finishFindBigKeys));
+
+  QHBoxLayout* params_layout = new QHBoxLayout;
+  pattern_label_ = new QLabel;
+  pattern_edit_ = new QLineEdit;
+  pattern_edit_->setText(kDefaultPattern);
+  params_layout->addWidget(pattern_label_);
+  params_layout->addWidget(pattern_edit_);
+
+  scan_count_label_ = new QLabel;
+  scan_count_spin_ = new QSpinBox;
+  scan_count_spin_->setRange(min_scan_count, max_scan_count);
+  scan_count_spin_->setSingleStep(min_scan_count);
+  scan_count_spin_->setValue(default_scan_count);
+  params_layout->addWidget(scan_count_label_);
+  params_layout->addWidget(scan_count_spin_);
+
+  top_limit_label_ = new QLabel;
+  top_limit_spin_ = new QSpinBox;
+  top_limit_spin_->setRange(1, max_top_limit);
+  top_limit_spin_->setValue(default_top_limit);
+  params_layout->addWidget(top_limit_label_);
+  params_layout->addWidget(top_limit_spin_);
+
+  criteria_label_ = new QLabel;
+  criteria_combo_ = new QComboBox;
+  criteria_combo_->addItem(trMemoryUsage, proxy::BY_MEMORY);
+  criteria_combo_->addItem(trElementsCount, proxy::BY_ELEMENTS);
+  criteria_combo_->addItem(trAccessFrequency, proxy::BY_FREQUENCY);
+  params_layout->addWidget(criteria_label_);
+  params_layout->addWidget(criteria_combo_);
+
+  ops_label_ = new QLabel;
+  ops_spin_ = new QSpinBox;
+  ops_spin_->setRange(0, max_ops_per_sec);
+  ops_spin_->setSingleStep(default_ops_per_sec / 10);
+  ops_spin_->setValue(default_ops_per_sec);
+  params_layout->addWidget(ops_label_);
+  params_layout->addWidget(ops_spin_);
+
+  QHBoxLayout* control_layout = new QHBoxLayout;
+  status_label_ = new QLabel;
+  start_button_ = new QPushButton;
+  VERIFY(connect(start_button_, &QPushButton::clicked, this, &BigKeysDialog::startClicked));
+  stop_button_ = new QPushButton;
+  VERIFY(connect(stop_button_, &QPushButton::clicked, this, &BigKeysDialog::stopClicked));
+  control_layout->addWidget(status_label_);
+  control_layout->addWidget(new QSplitter(Qt::Horizontal));
+  control_layout->addWidget(start_button_);
+  control_layout->addWidget(stop_button_);
+
+  keys_model_ = new KeysUsageTableModel(this);
+  proxy_model_ = new QSortFilterProxyModel(this);
+  proxy_model_->setSourceModel(keys_model_);
+  proxy_model_->setDynamicSortFilter(true);
+
+  keys_table_ = new FastoTableView;
+  keys_table_->setSortingEnabled(true);
+  keys_table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+  keys_table_->setSelectionMode(QAbstractItemView::SingleSelection);
+  keys_table_->sortByColumn(KeysUsageTableModel::kMemory, Qt::DescendingOrder);
+  keys_table_->setModel(proxy_model_);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &BigKeysDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(params_layout);
+  main_layout->addLayout(control_layout);
+  main_layout->addWidget(keys_table_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+  setRunning(false);
+}
+
+void BigKeysDialog::startFindBigKeys(const proxy::events_info::FindBigKeysRequest& req) {
+  if (req.initiator() != this) {
+    return;
+  }
+
+  keys_model_->clear();
+  setRunning(true);
+}
+
+void BigKeysDialog::updateFindBigKeys(const proxy::events_info::FindBigKeysResponse& res) {
+  if (res.initiator() != this) {
+    return;
+  }
+
+  keys_model_->setKeys(res.keys);
+  updateStatus(res);
+}
+
+void BigKeysDialog::finishFindBigKeys(const proxy::events_info::FindBigKeysResponse& res) {
+  if (res.initiator() != this) {
+    return;
+  }
+
+  setRunning(false);
+  keys_model_->setKeys(res.keys);
+  common::Error err = res.errorInfo();
+  if (err) {
+    if (err->GetErrorCode() == common::COMMON_EINTR) {
+      status_label_->setText(trStoppedTemplate_2S.arg(res.scanned_keys_count).arg(res.db_keys_count));
+      return;
+    }
+
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    status_label_->setText(qerror);
+    return;
+  }
+
+  updateStatus(res);
+}
+
+void BigKeysDialog::startClicked() {
+  const QString pattern = pattern_edit_->text();
+  if (pattern.isEmpty()) {
+    QMessageBox::warning(this, translations::trError, trInvalidPattern);
+    pattern_edit_->setFocus();
+    return;
+  }
+
+  const proxy::KeysUsageCriteria criteria =
+      static_cast<proxy::KeysUsageCriteria>(criteria_combo_->currentData().toInt());
+  int sort_column = KeysUsageTableModel::kMemory;
+  if (criteria == proxy::BY_ELEMENTS) {
+    sort_column = KeysUsageTableModel::kElements;
+  } else if (criteria == proxy::BY_FREQUENCY) {
+    sort_column = KeysUsageTableModel::kFrequency;
+  }
+  keys_table_->setColumnHidden(KeysUsageTableModel::kFrequency, criteria != proxy::BY_FREQUENCY);
+  keys_table_->sortByColumn(sort_column, Qt::DescendingOrder);
+
+  proxy::IServerSPtr server = db_->GetServer();
+  proxy::events_info::FindBigKeysRequest req(this, db_->GetInfo(), common::ConvertToString(pattern),
+                                             scan_count_spin_->value(), top_limit_spin_->value(), criteria,
+                                             ops_spin_->value());
+  server->FindBigKeys(req);
+}
+
+void BigKeysDialog::stopClicked() {
+  proxy::IServerSPtr server = db_->GetServer();
+  server->StopCurrentEvent();
+}
+
+void BigKeysDialog::reject() {
+  // scan runs on the shared server, it would outlive the dialog
+  if (is_running_) {
+    stopClicked();
+  }
+
+  base_class::reject();
+}
+
+void BigKeysDialog::retranslateUi() {
+  pattern_label_->setText(trPattern + ":");
+  scan_count_label_->setText(trScanCount + ":");
+  top_limit_label_->setText(trTopPerType + ":");
+  criteria_label_->setText(trSortBy + ":");
+  ops_label_->setText(trMaxOpsPerSec + ":");
+  ops_spin_->setSpecialValueText(trUnlimited);
+  start_button_->setText(trFind);
+  stop_button_->setText(translations::trStop);
+  base_class::retranslateUi();
+}
+
+void BigKeysDialog::updateStatus(const proxy::events_info::FindBigKeysResponse& res) {
+  status_label_->setText(trScannedTemplate_2S.arg(res.scanned_keys_count).arg(res.db_keys_count));
+}
+
+void BigKeysDialog::setRunning(bool running) {
+  is_running_ = running;
+  pattern_edit_->setEnabled(!running);
+  scan_count_spin_->setEnabled(!running);
+  top_limit_spin_->setEnabled(!running);
+  criteria_combo_->setEnabled(!running);
+  ops_spin_->setEnabled(!running);
+  start_button_->setEnabled(!running);
+  stop_button_->setEnabled(running);
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,102 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/proxy_fwd.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSortFilterProxyModel;
+class QSpinBox;
+
+namespace fastonosql {
+namespace proxy {
+namespace events_info {
+struct FindBigKeysRequest;
+struct FindBigKeysResponse;
+}  // namespace events_info
+}  // namespace proxy
+namespace gui {
+class FastoTableView;
+class KeysUsageTableModel;
+
+class BigKeysDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+  enum {
+    min_width = 800,
+    min_height = 600,
+    min_scan_count = 10,
+    max_scan_count = 10000,
+    default_scan_count = 100,
+    max_top_limit = 1000,
+    default_top_limit = 10,
+    max_ops_per_sec = 1000000,
+    default_ops_per_sec = 10000
+  };
+
+ private Q_SLOTS:
+  void startFindBigKeys(const proxy::events_info::FindBigKeysRequest& req);
+  void updateFindBigKeys(const proxy::events_info::FindBigKeysResponse& res);
+  void finishFindBigKeys(const proxy::events_info::FindBigKeysResponse& res);
+
+  void startClicked();
+  void stopClicked();
+
+ protected:
+  explicit BigKeysDialog(const QString& title, const QIcon& icon, proxy::IDatabaseSPtr db, QWidget* parent = Q_NULLPTR);
+
+  void reject() override;
+
+  void retranslateUi() override;
+
+ private:
+  void updateStatus(const proxy::events_info::FindBigKeysResponse& res);
+  void setRunning(bool running);
+
+  QLabel* pattern_label_;
+  QLineEdit* pattern_edit_;
+  QLabel* scan_count_label_;
+  QSpinBox* scan_count_spin_;
+  QLabel* top_limit_label_;
+  QSpinBox* top_limit_spin_;
+  QLabel* criteria_label_;
+  QComboBox* criteria_combo_;
+  QLabel* ops_label_;
+  QSpinBox* ops_spin_;
+  QPushButton* start_button_;
+  QPushButton* stop_button_;
+  QLabel* status_label_;
+  FastoTableView* keys_table_;
+  KeysUsageTableModel* keys_model_;
+  QSortFilterProxyModel* proxy_model_;
+  proxy::IDatabaseSPtr db_;
+  bool is_running_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,283 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/bulk_delete_dialog.h"
+
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QSplitter>
+
+#include <common/qt/convert2string.h>
+
+#include "proxy/database/idatabase.h"
+#include "proxy/server/iserver.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trInvalidPattern = QObject::tr("Invalid pattern!");
+const QString trPattern = QObject::tr("Pattern");
+const QString trScanCount = QObject::tr("Scan count");
+const QString trBatchSize = QObject::tr("Keys per UNLINK");
+const QString trMaxOpsPerSec = QObject::tr("Max ops/sec");
+const QString trUnlimited = QObject::tr("Unlimited");
+const QString trDryRun = QObject::tr("Dry run (only count)");
+const QString trDelete = QObject::tr("Delete");
+const QString trCount = QObject::tr("Count");
+const QString trDeleteKeys = QObject::tr("Delete keys");
+const QString trReallyDeleteKeysTemplate_1S = QObject::tr("Really delete all keys matching %1?");
+const QString trProgressTemplate_5S = QObject::tr("Matched %1, removed %2 keys, scanned %3 of %4, ETA %5 sec");
+const QString trFinishedTemplate_3S = QObject::tr("Matched %1, removed %2 keys in %3 sec");
+const QString trStoppedTemplate_3S = QObject::tr("Stopped after matched %1, removed %2 keys in %3 sec");
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+BulkDeleteDialog::BulkDeleteDialog(const QString& title,
+                                   const QIcon& icon,
+                                   proxy::IDatabaseSPtr db,
+                                   const QString& pattern,
+                                   QWidget* parent)
+    : base_class(title, parent),
+      pattern_label_(nullptr),
+      pattern_edit_(nullptr),
+      scan_count_label_(nullptr),
+      scan_count_spin_(nullptr),
+      batch_size_label_(nullptr),
+      batch_size_spin_(nullptr),
+      ops_label_(nullptr),
+      ops_spin_(nullptr),
+      dry_run_check_(nullptr),
+      start_button_(nullptr),
+      stop_button_(nullptr),
+      status_label_(nullptr),
+      progress_bar_(nullptr),
+      elapsed_(),
+      db_(db),
+      is_running_(false) {
+  CHECK(db_) << "Must be database.";
+  setWindowIcon(icon);
+
+  proxy::IServerSPtr server = db_->GetServer();
+  VERIFY(connect(server.get(), &proxy::IServer::BulkDeleteStarted, this, &BulkDeleteDialog::startBulkDelete));
+  VERIFY(connect(server.get(), &proxy::IServer::BulkDeleteUpdated, this, &BulkDeleteDialog::updateBulkDelete));
+  VERIFY(connect(server.get(), &proxy::IServer::BulkDeleteFinished, this, &BulkDeleteDialog::finishBulkDelete));
+
+  QHBoxLayout* pattern_layout = new QHBoxLayout;
+  pattern_label_ = new QLabel;
+  pattern_edit_ = new QLineEdit;
+  pattern_edit_->setText(pattern);
+  pattern_layout->addWidget(pattern_label_);
+  pattern_layout->addWidget(pattern_edit_);
+
+  QHBoxLayout* params_layout = new QHBoxLayout;
+  scan_count_label_ = new QLabel;
+  scan_count_spin_ = new QSpinBox;
+  scan_count_spin_->setRange(min_scan_count, max_scan_count);
+  scan_count_spin_->setSingleStep(min_scan_count);
+  scan_count_spin_->setValue(default_scan_count);
+  params_layout->addWidget(scan_count_label_);
+  params_layout->addWidget(scan_count_spin_);
+
+  batch_size_label_ = new QLabel;
+  batch_size_spin_ = new QSpinBox;
+  batch_size_spin_->setRange(1, max_batch_size);
+  batch_size_spin_->setValue(default_batch_size);
+  params_layout->addWidget(batch_size_label_);
+  params_layout->addWidget(batch_size_spin_);
+
+  ops_label_ = new QLabel;
+  ops_spin_ = new QSpinBox;
+  ops_spin_->setRange(0, max_ops_per_sec);
+  ops_spin_->setSingleStep(default_ops_per_sec / 10);
+  ops_spin_->setValue(default_ops_per_sec);
+  params_layout->addWidget(ops_label_);
+  params_layout->addWidget(ops_spin_);
+
+  dry_run_check_ = new QCheckBox;
+  dry_run_check_->setChecked(true);
+  VERIFY(connect(dry_run_check_, &QCheckBox::toggled, this, &BulkDeleteDialog::changeDryRun));
+  params_layout->addWidget(dry_run_check_);
+
+  QHBoxLayout* control_layout = new QHBoxLayout;
+  status_label_ = new QLabel;
+  start_button_ = new QPushButton;
+  VERIFY(connect(start_button_, &QPushButton::clicked, this, &BulkDeleteDialog::startClicked));
+  stop_button_ = new QPushButton;
+  VERIFY(connect(stop_button_, &QPushButton::clicked, this, &BulkDeleteDialog::stopClicked));
+  control_layout->addWidget(status_label_);
+  control_layout->addWidget(new QSplitter(Qt::Horizontal));
+  control_layout->addWidget(start_button_);
+  control_layout->addWidget(stop_button_);
+
+  progress_bar_ = new QProgressBar;
+  progress_bar_->setRange(0, 100);
+  progress_bar_->setValue(0);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &BulkDeleteDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(pattern_layout);
+  main_layout->addLayout(params_layout);
+  main_layout->addLayout(control_layout);
+  main_layout->addWidget(progress_bar_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+  setRunning(false);
+}
+
+void BulkDeleteDialog::startBulkDelete(const proxy::events_info::BulkDeleteRequest& req) {
+  if (req.initiator() != this) {
+    return;
+  }
+
+  elapsed_.start();
+  progress_bar_->setValue(0);
+  status_label_->clear();
+  setRunning(true);
+}
+
+void BulkDeleteDialog::updateBulkDelete(const proxy::events_info::BulkDeleteResponse& res) {
+  if (res.initiator() != this) {
+    return;
+  }
+
+  updateStatus(res);
+}
+
+void BulkDeleteDialog::finishBulkDelete(const proxy::events_info::BulkDeleteResponse& res) {
+  if (res.initiator() != this) {
+    return;
+  }
+
+  setRunning(false);
+  common::Error err = res.errorInfo();
+  if (err) {
+    if (err->GetErrorCode() == common::COMMON_EINTR) {
+      status_label_->setText(trStoppedTemplate_3S.arg(res.matched_keys_count)
+                                 .arg(res.removed_keys_count)
+                                 .arg(elapsed_.elapsed() / 1000));
+      return;
+    }
+
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    status_label_->setText(qerror);
+    return;
+  }
+
+  progress_bar_->setValue(100);
+  status_label_->setText(trFinishedTemplate_3S.arg(res.matched_keys_count)
+                             .arg(res.removed_keys_count)
+                             .arg(elapsed_.elapsed() / 1000));
+}
+
+void BulkDeleteDialog::startClicked() {
+  const QString pattern = pattern_edit_->text();
+  if (pattern.isEmpty()) {
+    QMessageBox::warning(this, translations::trError, trInvalidPattern);
+    pattern_edit_->setFocus();
+    return;
+  }
+
+  const bool dry_run = dry_run_check_->isChecked();
+  if (!dry_run) {
+    int answer = QMessageBox::question(this, trDeleteKeys, trReallyDeleteKeysTemplate_1S.arg(pattern),
+                                       QMessageBox::Yes, QMessageBox::No, QMessageBox::NoButton);
+    if (answer != QMessageBox::Yes) {
+      return;
+    }
+  }
+
+  proxy::IServerSPtr server = db_->GetServer();
+  proxy::events_info::BulkDeleteRequest req(this, db_->GetInfo(), common::ConvertToString(pattern),
+                                            scan_count_spin_->value(), batch_size_spin_->value(), ops_spin_->value(),
+                                            dry_run);
+  server->BulkDelete(req);
+}
+
+void BulkDeleteDialog::changeDryRun(bool dry_run) {
+  start_button_->setText(dry_run ? trCount : trDelete);
+}
+
+void BulkDeleteDialog::stopClicked() {
+  proxy::IServerSPtr server = db_->GetServer();
+  server->StopCurrentEvent();
+}
+
+void BulkDeleteDialog::reject() {
+  // closing the dialog must not leave unlink batches running on the server
+  if (is_running_) {
+    stopClicked();
+  }
+
+  base_class::reject();
+}
+
+void BulkDeleteDialog::retranslateUi() {
+  pattern_label_->setText(trPattern + ":");
+  scan_count_label_->setText(trScanCount + ":");
+  batch_size_label_->setText(trBatchSize + ":");
+  ops_label_->setText(trMaxOpsPerSec + ":");
+  ops_spin_->setSpecialValueText(trUnlimited);
+  dry_run_check_->setText(trDryRun);
+  changeDryRun(dry_run_check_->isChecked());
+  stop_button_->setText(translations::trStop);
+  base_class::retranslateUi();
+}
+
+void BulkDeleteDialog::updateStatus(const proxy::events_info::BulkDeleteResponse& res) {
+  QString eta("?");
+  if (res.db_keys_count && res.scanned_keys_count) {
+    const size_t db_keys_count = res.db_keys_count;
+    const qint64 eta_msec = elapsed_.elapsed() * (db_keys_count - res.scanned_keys_count) / res.scanned_keys_count;
+    eta = QString::number(eta_msec / 1000);
+    progress_bar_->setValue(static_cast<int>(res.scanned_keys_count * 100 / db_keys_count));
+  }
+
+  status_label_->setText(trProgressTemplate_5S.arg(res.matched_keys_count)
+                             .arg(res.removed_keys_count)
+                             .arg(res.scanned_keys_count)
+                             .arg(res.db_keys_count)
+                             .arg(eta));
+}
+
+void BulkDeleteDialog::setRunning(bool running) {
+  pattern_edit_->setEnabled(!running);
+  scan_count_spin_->setEnabled(!running);
+  batch_size_spin_->setEnabled(!running);
+  ops_spin_->setEnabled(!running);
+  dry_run_check_->setEnabled(!running);
+  start_button_->setEnabled(!running);
+  stop_button_->setEnabled(running);
+  is_running_ = running;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
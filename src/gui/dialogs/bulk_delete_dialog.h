@@ -0,0 +1,106 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/proxy_fwd.h"
+
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QProgressBar;
+class QPushButton;
+class QSpinBox;
+
+namespace fastonosql {
+namespace proxy {
+namespace events_info {
+struct BulkDeleteRequest;
+struct BulkDeleteResponse;
+}  // namespace events_info
+}  // namespace proxy
+namespace gui {
+
+// deletes keys matched by pattern on the server side with SCAN and pipelined UNLINK batches
+class BulkDeleteDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+  enum {
+    min_width = 640,
+    min_height = 200,
+    min_scan_count = 10,
+    max_scan_count = 10000,
+    default_scan_count = 1000,
+    max_batch_size = 10000,
+    default_batch_size = 100,
+    max_ops_per_sec = 1000000,
+    default_ops_per_sec = 10000
+  };
+
+ private Q_SLOTS:
+  void startBulkDelete(const proxy::events_info::BulkDeleteRequest& req);
+  void updateBulkDelete(const proxy::events_info::BulkDeleteResponse& res);
+  void finishBulkDelete(const proxy::events_info::BulkDeleteResponse& res);
+
+  void startClicked();
+  void stopClicked();
+  void changeDryRun(bool dry_run);
+
+ protected:
+  BulkDeleteDialog(const QString& title,
+                   const QIcon& icon,
+                   proxy::IDatabaseSPtr db,
+                   const QString& pattern,
+                   QWidget* parent = Q_NULLPTR);
+
+  void reject() override;
+
+  void retranslateUi() override;
+
+ private:
+  void updateStatus(const proxy::events_info::BulkDeleteResponse& res);
+  void setRunning(bool running);
+
+  QLabel* pattern_label_;
+  QLineEdit* pattern_edit_;
+  QLabel* scan_count_label_;
+  QSpinBox* scan_count_spin_;
+  QLabel* batch_size_label_;
+  QSpinBox* batch_size_spin_;
+  QLabel* ops_label_;
+  QSpinBox* ops_spin_;
+  QCheckBox* dry_run_check_;
+  QPushButton* start_button_;
+  QPushButton* stop_button_;
+  QLabel* status_label_;
+  QProgressBar* progress_bar_;
+  QElapsedTimer elapsed_;
+  proxy::IDatabaseSPtr db_;
+  bool is_running_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
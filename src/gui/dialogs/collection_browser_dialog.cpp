@@ -0,0 +1,495 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/collection_browser_dialog.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QInputDialog>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSplitter>
+#include <QUuid>
+
+#include <common/convert2string.h>
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/macros.h>
+
+#include "proxy/server/iserver.h"
+
+#include "gui/models/collection_table_model.h"
+#include "gui/models/items/collection_table_item.h"
+#include "gui/views/fasto_table_view.h"
+
+#include "translations/global.h"
+
+#define REDIS_HSCAN_COMMAND "HSCAN"
+#define REDIS_SSCAN_COMMAND "SSCAN"
+#define REDIS_ZSCAN_COMMAND "ZSCAN"
+#define REDIS_LRANGE_COMMAND "LRANGE"
+#define REDIS_HSET_COMMAND "HSET"
+#define REDIS_HDEL_COMMAND "HDEL"
+#define REDIS_SADD_COMMAND "SADD"
+#define REDIS_SREM_COMMAND "SREM"
+#define REDIS_ZADD_COMMAND "ZADD"
+#define REDIS_ZREM_COMMAND "ZREM"
+#define REDIS_EVAL_COMMAND "EVAL"
+#define MATCH_ARG "MATCH"
+#define COUNT_ARG "COUNT"
+
+// list elements can only be removed by value, removed ones are overwritten with a per save marker first;
+// KEYS: list, ARGV: marker, edits count, edits as {index, loaded value, new value}..., appended values...
+// every edited element is checked against the loaded value first, so a list changed by another client
+// (indexes shifted by LPUSH, LREM) is rejected as a whole and nothing is written
+#define LIST_SAVE_SCRIPT                                                                                  \
+  "local key = KEYS[1] local n = tonumber(ARGV[2]) local removed = false "                                \
+  "for i = 0, n - 1 do local b = 3 + i * 3 "                                                              \
+  "if redis.call('LINDEX', key, ARGV[b]) ~= ARGV[b + 1] then "                                            \
+  "return redis.error_reply('list was changed by another client, reload it and repeat changes') end end " \
+  "for i = 0, n - 1 do local b = 3 + i * 3 redis.call('LSET', key, ARGV[b], ARGV[b + 2]) "                \
+  "if ARGV[b + 2] == ARGV[1] then removed = true end end "                                                \
+  "if removed then redis.call('LREM', key, 0, ARGV[1]) end "                                              \
+  "for i = 3 + n * 3, #ARGV do redis.call('RPUSH', key, ARGV[i]) end "                                    \
+  "return 'OK'"
+#define LIST_REMOVED_MARKER_PREFIX "__fastonosql_removed_"
+
+namespace {
+const QString trMatch = QObject::tr("Match");
+const QString trAddElement = QObject::tr("Add element");
+const QString trRemoveElement = QObject::tr("Remove element");
+const QString trField = QObject::tr("Field:");
+const QString trMember = QObject::tr("Member:");
+const QString trScore = QObject::tr("Score:");
+const QString trValue = QObject::tr("Value:");
+const QString trInvalidScore = QObject::tr("Score should be a number.");
+const QString trLoadedTemplate_2S = QObject::tr("Loaded %1 of %2 elements");
+const QString trSavingTemplate_2S = QObject::tr("Saving %1 of %2 commands...");
+const QString trNothingToSave = QObject::tr("Nothing to save");
+const QString trDiscardChanges = QObject::tr("Collection has unsaved changes, discard them?");
+const char* kDefaultPattern = ALL_KEYS_PATTERNS;
+
+fastonosql::core::command_buffer_t Argument(const common::Value::string_t& data) {
+  return fastonosql::core::ReadableString(data).GetForCommandLine();
+}
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+CollectionBrowserDialog::CollectionBrowserDialog(const QString& title,
+                                                 const QIcon& icon,
+                                                 proxy::IServerSPtr server,
+                                                 const core::NKey& key,
+                                                 common::Value::Type type,
+                                                 size_t elements_count,
+                                                 QWidget* parent)
+    : base_class(title, parent),
+      match_label_(nullptr),
+      match_edit_(nullptr),
+      filter_button_(nullptr),
+      elements_table_(nullptr),
+      elements_model_(nullptr),
+      status_label_(nullptr),
+      add_button_(nullptr),
+      remove_button_(nullptr),
+      save_button_(nullptr),
+      server_(server),
+      key_(key),
+      type_(type),
+      elements_count_(elements_count),
+      pattern_(kDefaultPattern),
+      cursor_(0),
+      list_offset_(0),
+      generation_(0),
+      pending_(),
+      save_commands_(),
+      save_commands_sent_(0) {
+  CHECK(server_);
+  setWindowIcon(icon);
+
+  VERIFY(connect(server.get(), &proxy::IServer::ExecuteFinished, this,
+                 &CollectionBrowserDialog::finishExecuteCommand));
+
+  QHBoxLayout* filter_layout = new QHBoxLayout;
+  match_label_ = new QLabel;
+  match_edit_ = new QLineEdit;
+  match_edit_->setText(kDefaultPattern);
+  filter_button_ = new QPushButton;
+  VERIFY(connect(filter_button_, &QPushButton::clicked, this, &CollectionBrowserDialog::filterClicked));
+  VERIFY(connect(match_edit_, &QLineEdit::returnPressed, this, &CollectionBrowserDialog::filterClicked));
+  filter_layout->addWidget(match_label_);
+  filter_layout->addWidget(match_edit_);
+  filter_layout->addWidget(filter_button_);
+  // LRANGE has no server side filter
+  match_label_->setVisible(type_ != common::Value::TYPE_ARRAY);
+  match_edit_->setVisible(type_ != common::Value::TYPE_ARRAY);
+  filter_button_->setVisible(type_ != common::Value::TYPE_ARRAY);
+
+  elements_model_ = new CollectionTableModel(type_, this);
+  VERIFY(connect(elements_model_, &CollectionTableModel::fetchRequested, this, &CollectionBrowserDialog::fetchPage));
+
+  elements_table_ = new FastoTableView;
+  elements_table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+  elements_table_->setSelectionMode(QAbstractItemView::SingleSelection);
+  elements_table_->setModel(elements_model_);
+  elements_table_->setColumnHidden(CollectionTableModel::kValue, type_ == common::Value::TYPE_SET);
+  elements_table_->horizontalHeader()->setStretchLastSection(true);
+
+  QHBoxLayout* control_layout = new QHBoxLayout;
+  status_label_ = new QLabel;
+  add_button_ = new QPushButton;
+  VERIFY(connect(add_button_, &QPushButton::clicked, this, &CollectionBrowserDialog::addClicked));
+  remove_button_ = new QPushButton;
+  VERIFY(connect(remove_button_, &QPushButton::clicked, this, &CollectionBrowserDialog::removeClicked));
+  save_button_ = new QPushButton;
+  VERIFY(connect(save_button_, &QPushButton::clicked, this, &CollectionBrowserDialog::saveClicked));
+  control_layout->addWidget(status_label_);
+  control_layout->addWidget(new QSplitter(Qt::Horizontal));
+  control_layout->addWidget(add_button_);
+  control_layout->addWidget(remove_button_);
+  control_layout->addWidget(save_button_);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &CollectionBrowserDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(filter_layout);
+  main_layout->addWidget(elements_table_);
+  main_layout->addLayout(control_layout);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+
+  reload();
+}
+
+void CollectionBrowserDialog::finishExecuteCommand(const proxy::events_info::ExecuteInfoResponse& res) {
+  if (res.initiator() != this || pending_.empty()) {
+    return;
+  }
+
+  const PendingRequest request = pending_.front();
+  pending_.pop_front();
+
+  common::Error err = res.errorInfo();
+  if (request.is_save) {
+    if (err) {
+      status_label_->setText(QString::fromStdString(err->GetDescription()));
+      save_commands_.clear();
+      setBusy(false);
+      return;
+    }
+
+    sendNextCommands();
+    return;
+  }
+
+  if (request.generation != generation_) {
+    return;
+  }
+
+  if (err || res.executed_commands.size() != 1) {
+    if (err) {
+      status_label_->setText(QString::fromStdString(err->GetDescription()));
+    }
+    elements_model_->cancelFetch();
+    return;
+  }
+
+  handlePage(res.executed_commands[0]);
+}
+
+void CollectionBrowserDialog::fetchPage() {
+  core::command_buffer_writer_t wr;
+  const core::command_buffer_t key_str = key_.GetKey().GetForCommandLine();
+  if (type_ == common::Value::TYPE_ARRAY) {
+    wr << REDIS_LRANGE_COMMAND SPACE_STR << key_str << SPACE_STR << common::ConvertToCharBytes(list_offset_)
+       << SPACE_STR << common::ConvertToCharBytes(list_offset_ + page_size - 1);
+  } else {
+    const char* scan_command = REDIS_HSCAN_COMMAND;
+    if (type_ == common::Value::TYPE_SET) {
+      scan_command = REDIS_SSCAN_COMMAND;
+    } else if (type_ == common::Value::TYPE_ZSET) {
+      scan_command = REDIS_ZSCAN_COMMAND;
+    }
+    wr << scan_command << SPACE_STR << key_str << SPACE_STR << common::ConvertToCharBytes(cursor_)
+       << SPACE_STR MATCH_ARG SPACE_STR << Argument(common::ConvertToCharBytes(pattern_))
+       << SPACE_STR COUNT_ARG SPACE_STR << common::ConvertToCharBytes(static_cast<size_t>(page_size));
+  }
+
+  pending_.push_back({false, generation_});
+  proxy::events_info::ExecuteInfoRequest req(this, wr.str(), 0, 0, false, true, core::C_INNER);
+  server_->Execute(req);
+}
+
+void CollectionBrowserDialog::filterClicked() {
+  if (!confirmDiscard()) {
+    return;
+  }
+
+  const QString pattern = match_edit_->text();
+  pattern_ = pattern.isEmpty() ? QString(kDefaultPattern) : pattern;
+
+  reload();
+}
+
+void CollectionBrowserDialog::addClicked() {
+  const bool is_pair = type_ == common::Value::TYPE_HASH || type_ == common::Value::TYPE_ZSET;
+  const QString first_label = type_ == common::Value::TYPE_HASH ? trField : trMember;
+  bool is_ok;
+  QString field;
+  if (type_ != common::Value::TYPE_ARRAY) {
+    field = QInputDialog::getText(this, trAddElement, first_label, QLineEdit::Normal, QString(), &is_ok);
+    if (!is_ok) {
+      return;
+    }
+  }
+
+  QString value;
+  if (is_pair || type_ == common::Value::TYPE_ARRAY) {
+    const QString second_label = type_ == common::Value::TYPE_ZSET ? trScore : trValue;
+    value = QInputDialog::getText(this, trAddElement, second_label, QLineEdit::Normal, QString(), &is_ok);
+    if (!is_ok) {
+      return;
+    }
+  }
+
+  if (type_ == common::Value::TYPE_ZSET) {
+    value.toDouble(&is_ok);
+    if (!is_ok) {
+      QMessageBox::warning(this, translations::trError, trInvalidScore);
+      return;
+    }
+  }
+
+  elements_model_->addElement(common::ConvertToCharBytes(field), common::ConvertToCharBytes(value));
+  elements_table_->scrollToBottom();
+}
+
+void CollectionBrowserDialog::removeClicked() {
+  const QModelIndexList selected = elements_table_->selectionModel()->selectedRows();
+  if (selected.count() != 1) {
+    return;
+  }
+
+  elements_model_->removeElement(selected[0].row());
+}
+
+void CollectionBrowserDialog::saveClicked() {
+  save_commands_ = makeDeltaCommands();
+  if (save_commands_.empty()) {
+    status_label_->setText(trNothingToSave);
+    return;
+  }
+
+  save_commands_sent_ = 0;
+  setBusy(true);
+  sendNextCommands();
+}
+
+void CollectionBrowserDialog::reject() {
+  if (!confirmDiscard()) {
+    return;
+  }
+
+  base_class::reject();
+}
+
+void CollectionBrowserDialog::retranslateUi() {
+  match_label_->setText(trMatch + ":");
+  filter_button_->setText(translations::trFilter);
+  add_button_->setText(trAddElement);
+  remove_button_->setText(trRemoveElement);
+  save_button_->setText(translations::trSave);
+  base_class::retranslateUi();
+}
+
+void CollectionBrowserDialog::reload() {
+  generation_++;
+  cursor_ = 0;
+  list_offset_ = 0;
+  elements_model_->clear();
+  updateStatus();
+  elements_model_->fetchMore(QModelIndex());
+}
+
+void CollectionBrowserDialog::handlePage(core::FastoObjectCommandIPtr cmd) {
+  const auto childs = cmd->GetChildrens();
+  common::ArrayValue* arm = nullptr;
+  if (childs.size() != 1 || !childs[0]->GetValue() || !childs[0]->GetValue()->GetAsList(&arm)) {
+    elements_model_->cancelFetch();
+    return;
+  }
+
+  std::vector<CollectionTableModel::element_t> elements;
+  bool has_more = false;
+  if (type_ == common::Value::TYPE_ARRAY) {
+    for (size_t i = 0; i < arm->GetSize(); ++i) {
+      common::Value::string_t value;
+      if (arm->GetString(i, &value)) {
+        elements.push_back(std::make_pair(common::ConvertToCharBytes(list_offset_ + i), value));
+      }
+    }
+    list_offset_ += arm->GetSize();
+    has_more = arm->GetSize() == page_size;
+  } else {
+    common::ArrayValue* ar = nullptr;
+    if (!arm->GetUInteger32(0, &cursor_) || !arm->GetList(1, &ar)) {
+      elements_model_->cancelFetch();
+      return;
+    }
+
+    // hash and zset replies are flat field/value (member/score) pairs
+    const size_t step = type_ == common::Value::TYPE_SET ? 1 : 2;
+    for (size_t i = 0; i + step <= ar->GetSize(); i += step) {
+      common::Value::string_t field;
+      common::Value::string_t value;
+      if (!ar->GetString(i, &field) || (step == 2 && !ar->GetString(i + 1, &value))) {
+        continue;
+      }
+      elements.push_back(std::make_pair(field, value));
+    }
+    has_more = cursor_ != 0;
+  }
+
+  const int rows = elements_model_->rowCount(QModelIndex());
+  elements_model_->appendPage(elements, has_more);
+  updateStatus();
+
+  // MATCH filters after COUNT so a page can be empty while cursor goes on
+  if (has_more && elements_model_->rowCount(QModelIndex()) == rows) {
+    elements_model_->fetchMore(QModelIndex());
+  }
+}
+
+std::vector<core::command_buffer_t> CollectionBrowserDialog::makeDeltaCommands() const {
+  const core::command_buffer_t key_str = key_.GetKey().GetForCommandLine();
+  std::vector<core::command_buffer_t> commands;
+  const core::command_buffer_t marker = common::ConvertToCharBytes(
+      QString(LIST_REMOVED_MARKER_PREFIX) + QString::fromLatin1(QUuid::createUuid().toRfc4122().toHex()));
+  core::command_buffer_writer_t list_edits;
+  core::command_buffer_writer_t list_appends;
+  size_t list_edits_count = 0;
+  size_t list_appends_count = 0;
+  for (CollectionTableItem* item : elements_model_->changedItems()) {
+    const CollectionTableItem::State state = item->state();
+    const bool renamed = state == CollectionTableItem::kChanged && item->field() != item->originalField();
+    core::command_buffer_writer_t wr;
+    if (type_ == common::Value::TYPE_HASH) {
+      if (state == CollectionTableItem::kRemoved || renamed) {
+        wr << REDIS_HDEL_COMMAND SPACE_STR << key_str << SPACE_STR << Argument(item->originalField()) << "\n";
+      }
+      if (state != CollectionTableItem::kRemoved) {
+        wr << REDIS_HSET_COMMAND SPACE_STR << key_str << SPACE_STR << Argument(item->field()) << SPACE_STR
+           << Argument(item->value()) << "\n";
+      }
+    } else if (type_ == common::Value::TYPE_SET) {
+      if (state == CollectionTableItem::kRemoved || renamed) {
+        wr << REDIS_SREM_COMMAND SPACE_STR << key_str << SPACE_STR << Argument(item->originalField()) << "\n";
+      }
+      if (state == CollectionTableItem::kAdded || renamed) {
+        wr << REDIS_SADD_COMMAND SPACE_STR << key_str << SPACE_STR << Argument(item->field()) << "\n";
+      }
+    } else if (type_ == common::Value::TYPE_ZSET) {
+      if (state == CollectionTableItem::kRemoved || renamed) {
+        wr << REDIS_ZREM_COMMAND SPACE_STR << key_str << SPACE_STR << Argument(item->originalField()) << "\n";
+      }
+      if (state != CollectionTableItem::kRemoved) {
+        wr << REDIS_ZADD_COMMAND SPACE_STR << key_str << SPACE_STR << item->value() << SPACE_STR
+           << Argument(item->field()) << "\n";
+      }
+    } else if (type_ == common::Value::TYPE_ARRAY) {
+      if (state == CollectionTableItem::kAdded) {
+        list_appends << SPACE_STR << Argument(item->value());
+        list_appends_count++;
+        continue;
+      }
+
+      list_edits << SPACE_STR << item->originalField() << SPACE_STR << Argument(item->originalValue()) << SPACE_STR
+                 << (state == CollectionTableItem::kRemoved ? marker : Argument(item->value()));
+      list_edits_count++;
+      continue;
+    }
+    commands.push_back(wr.str());
+  }
+
+  // list changes depend on element indexes, they are checked and written by one atomic script
+  if (list_edits_count || list_appends_count) {
+    core::command_buffer_writer_t wr;
+    wr << REDIS_EVAL_COMMAND SPACE_STR "\"" LIST_SAVE_SCRIPT "\"" SPACE_STR "1" SPACE_STR << key_str << SPACE_STR
+       << marker << SPACE_STR << common::ConvertToCharBytes(list_edits_count) << list_edits.str()
+       << list_appends.str() << "\n";
+    commands.push_back(wr.str());
+  }
+  return commands;
+}
+
+void CollectionBrowserDialog::sendNextCommands() {
+  if (save_commands_sent_ == save_commands_.size()) {
+    save_commands_.clear();
+    setBusy(false);
+    reload();
+    return;
+  }
+
+  const size_t count = std::min<size_t>(commands_per_request, save_commands_.size() - save_commands_sent_);
+  core::command_buffer_writer_t wr;
+  for (size_t i = 0; i != count; ++i) {
+    wr << save_commands_[save_commands_sent_ + i];
+  }
+  save_commands_sent_ += count;
+
+  status_label_->setText(trSavingTemplate_2S.arg(save_commands_sent_).arg(save_commands_.size()));
+  pending_.push_back({true, generation_});
+  proxy::events_info::ExecuteInfoRequest req(this, wr.str(), 0, 0, false, true, core::C_INNER);
+  server_->Execute(req);
+}
+
+bool CollectionBrowserDialog::confirmDiscard() {
+  if (!elements_model_->hasChanges()) {
+    return true;
+  }
+
+  int answer = QMessageBox::question(this, windowTitle(), trDiscardChanges, QMessageBox::Yes, QMessageBox::No,
+                                     QMessageBox::NoButton);
+  return answer == QMessageBox::Yes;
+}
+
+void CollectionBrowserDialog::updateStatus() {
+  status_label_->setText(trLoadedTemplate_2S.arg(elements_model_->rowCount(QModelIndex())).arg(elements_count_));
+}
+
+void CollectionBrowserDialog::setBusy(bool busy) {
+  match_edit_->setEnabled(!busy);
+  filter_button_->setEnabled(!busy);
+  add_button_->setEnabled(!busy);
+  remove_button_->setEnabled(!busy);
+  save_button_->setEnabled(!busy);
+  elements_table_->setEnabled(!busy);
+}
+
+}  // namespace gui
+}  // namespace fastonosql
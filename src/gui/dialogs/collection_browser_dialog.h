@@ -0,0 +1,115 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include <fastonosql/core/db_key.h>
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/proxy_fwd.h"
+
+class QLabel;
+class QLineEdit;
+class QPushButton;
+
+namespace fastonosql {
+namespace proxy {
+namespace events_info {
+struct ExecuteInfoResponse;
+}  // namespace events_info
+}  // namespace proxy
+namespace gui {
+class FastoTableView;
+class CollectionTableModel;
+
+// hash/set/zset/list too big to load at once, paged by HSCAN/SSCAN/ZSCAN/LRANGE and saved as element deltas
+class CollectionBrowserDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+  enum { min_width = 800, min_height = 600, page_size = 500, commands_per_request = 100 };
+
+ private Q_SLOTS:
+  void finishExecuteCommand(const proxy::events_info::ExecuteInfoResponse& res);
+
+  void fetchPage();
+  void filterClicked();
+  void addClicked();
+  void removeClicked();
+  void saveClicked();
+
+ protected:
+  CollectionBrowserDialog(const QString& title,
+                          const QIcon& icon,
+                          proxy::IServerSPtr server,
+                          const core::NKey& key,
+                          common::Value::Type type,
+                          size_t elements_count,
+                          QWidget* parent = Q_NULLPTR);
+
+  void reject() override;
+
+  void retranslateUi() override;
+
+ private:
+  struct PendingRequest {
+    bool is_save;
+    size_t generation;
+  };
+
+  void reload();
+  void handlePage(core::FastoObjectCommandIPtr cmd);
+  std::vector<core::command_buffer_t> makeDeltaCommands() const;
+  void sendNextCommands();
+  bool confirmDiscard();
+  void updateStatus();
+  void setBusy(bool busy);
+
+  QLabel* match_label_;
+  QLineEdit* match_edit_;
+  QPushButton* filter_button_;
+  FastoTableView* elements_table_;
+  CollectionTableModel* elements_model_;
+  QLabel* status_label_;
+  QPushButton* add_button_;
+  QPushButton* remove_button_;
+  QPushButton* save_button_;
+
+  proxy::IServerSPtr server_;
+  const core::NKey key_;
+  const common::Value::Type type_;
+  const size_t elements_count_;
+
+  QString pattern_;
+  core::cursor_t cursor_;
+  size_t list_offset_;
+  size_t generation_;
+  std::deque<PendingRequest> pending_;
+  std::vector<core::command_buffer_t> save_commands_;
+  size_t save_commands_sent_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
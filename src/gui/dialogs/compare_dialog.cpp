@@ -0,0 +1,312 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/compare_dialog.h"
+
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSortFilterProxyModel>
+#include <QSpinBox>
+#include <QSplitter>
+
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/macros.h>
+
+#include "proxy/settings_manager.h"
+
+#include "gui/models/keys_diff_table_model.h"
+#include "gui/views/fasto_table_view.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trLeft = QObject::tr("Left");
+const QString trRight = QObject::tr("Right");
+const QString trPattern = QObject::tr("Pattern");
+const QString trRanges = QObject::tr("Ranges");
+const QString trScanCount = QObject::tr("Scan count");
+const QString trMaxValueElements = QObject::tr("Max value elements");
+const QString trMaxOpsPerSec = QObject::tr("Max keys/sec");
+const QString trUnlimited = QObject::tr("Unlimited");
+const QString trCompare = QObject::tr("Compare");
+const QString trInvalidPattern = QObject::tr("Invalid pattern!");
+const QString trSameConnections = QObject::tr("Left and right must be different connections!");
+const QString trDatabasesEqual = QObject::tr("Databases are equal");
+const QString trStatusTemplate_6S =
+    QObject::tr("Keys %1 / %2, different ranges %3, missing %4, extra %5, different %6");
+const QString trBigKeysTemplate_1S = QObject::tr(" (%1 big values compared by length)");
+const char* kDefaultPattern = ALL_KEYS_PATTERNS;
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+CompareDialog::CompareDialog(const QString& title, const QIcon& icon, const QString& left_name, QWidget* parent)
+    : base_class(title, parent),
+      left_label_(nullptr),
+      left_combo_(nullptr),
+      right_label_(nullptr),
+      right_combo_(nullptr),
+      pattern_label_(nullptr),
+      pattern_edit_(nullptr),
+      ranges_label_(nullptr),
+      ranges_spin_(nullptr),
+      scan_count_label_(nullptr),
+      scan_count_spin_(nullptr),
+      value_elements_label_(nullptr),
+      value_elements_spin_(nullptr),
+      ops_label_(nullptr),
+      ops_spin_(nullptr),
+      start_button_(nullptr),
+      stop_button_(nullptr),
+      status_label_(nullptr),
+      keys_table_(nullptr),
+      keys_model_(nullptr),
+      proxy_model_(nullptr),
+      job_(nullptr) {
+  setWindowIcon(icon);
+
+  left_combo_ = new QComboBox;
+  right_combo_ = new QComboBox;
+  const auto connections = proxy::SettingsManager::GetInstance()->GetConnections();
+  for (size_t i = 0; i < connections.size(); ++i) {
+    const core::ConnectionType type = connections[i]->GetType();
+    if (type != core::REDIS && type != core::KEYDB) {
+      continue;
+    }
+
+    QString name;
+    common::ConvertFromString(connections[i]->GetPath().ToString(), &name);
+    left_combo_->addItem(name, static_cast<int>(i));
+    right_combo_->addItem(name, static_cast<int>(i));
+
+    QString short_name;
+    common::ConvertFromString(connections[i]->GetPath().GetName(), &short_name);
+    if (short_name == left_name) {
+      left_combo_->setCurrentIndex(left_combo_->count() - 1);
+    }
+  }
+  if (right_combo_->count() > 1) {
+    right_combo_->setCurrentIndex(left_combo_->currentIndex() == 0 ? 1 : 0);
+  }
+
+  left_label_ = new QLabel;
+  right_label_ = new QLabel;
+  pattern_label_ = new QLabel;
+  pattern_edit_ = new QLineEdit;
+  pattern_edit_->setText(kDefaultPattern);
+
+  ranges_label_ = new QLabel;
+  ranges_spin_ = new QSpinBox;
+  ranges_spin_->setRange(1, proxy::CompareJob::max_ranges_count);
+  ranges_spin_->setValue(proxy::CompareJob::default_ranges_count);
+
+  scan_count_label_ = new QLabel;
+  scan_count_spin_ = new QSpinBox;
+  scan_count_spin_->setRange(min_scan_count, max_scan_count);
+  scan_count_spin_->setSingleStep(min_scan_count);
+  scan_count_spin_->setValue(proxy::CompareJob::default_scan_count);
+
+  value_elements_label_ = new QLabel;
+  value_elements_spin_ = new QSpinBox;
+  value_elements_spin_->setRange(1, max_value_elements);
+  value_elements_spin_->setValue(proxy::CompareJob::default_max_value_elements);
+
+  ops_label_ = new QLabel;
+  ops_spin_ = new QSpinBox;
+  ops_spin_->setRange(0, max_ops_per_sec);
+  ops_spin_->setSingleStep(proxy::CompareJob::default_ops_per_sec / 10);
+  ops_spin_->setValue(proxy::CompareJob::default_ops_per_sec);
+
+  QGridLayout* params_layout = new QGridLayout;
+  params_layout->addWidget(left_label_, 0, 0);
+  params_layout->addWidget(left_combo_, 0, 1);
+  params_layout->addWidget(right_label_, 0, 2);
+  params_layout->addWidget(right_combo_, 0, 3);
+  params_layout->addWidget(pattern_label_, 1, 0);
+  params_layout->addWidget(pattern_edit_, 1, 1);
+  params_layout->addWidget(ranges_label_, 1, 2);
+  params_layout->addWidget(ranges_spin_, 1, 3);
+  params_layout->addWidget(scan_count_label_, 2, 2);
+  params_layout->addWidget(scan_count_spin_, 2, 3);
+  params_layout->addWidget(value_elements_label_, 2, 0);
+  params_layout->addWidget(value_elements_spin_, 2, 1);
+  params_layout->addWidget(ops_label_, 3, 2);
+  params_layout->addWidget(ops_spin_, 3, 3);
+
+  QHBoxLayout* control_layout = new QHBoxLayout;
+  status_label_ = new QLabel;
+  start_button_ = new QPushButton;
+  VERIFY(connect(start_button_, &QPushButton::clicked, this, &CompareDialog::startClicked));
+  stop_button_ = new QPushButton;
+  VERIFY(connect(stop_button_, &QPushButton::clicked, this, &CompareDialog::stopClicked));
+  control_layout->addWidget(status_label_);
+  control_layout->addWidget(new QSplitter(Qt::Horizontal));
+  control_layout->addWidget(start_button_);
+  control_layout->addWidget(stop_button_);
+
+  keys_model_ = new KeysDiffTableModel(this);
+  proxy_model_ = new QSortFilterProxyModel(this);
+  proxy_model_->setSourceModel(keys_model_);
+  proxy_model_->setDynamicSortFilter(true);
+
+  keys_table_ = new FastoTableView;
+  keys_table_->setSortingEnabled(true);
+  keys_table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+  keys_table_->setSelectionMode(QAbstractItemView::SingleSelection);
+  keys_table_->sortByColumn(KeysDiffTableModel::kKey, Qt::AscendingOrder);
+  keys_table_->setModel(proxy_model_);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &CompareDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(params_layout);
+  main_layout->addLayout(control_layout);
+  main_layout->addWidget(keys_table_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+  setRunning(false);
+}
+
+void CompareDialog::startClicked() {
+  const QString pattern = pattern_edit_->text();
+  if (pattern.isEmpty()) {
+    QMessageBox::warning(this, translations::trError, trInvalidPattern);
+    pattern_edit_->setFocus();
+    return;
+  }
+
+  proxy::IConnectionSettingsBaseSPtr left = selectedConnection(left_combo_);
+  proxy::IConnectionSettingsBaseSPtr right = selectedConnection(right_combo_);
+  if (!left || !right || left == right) {
+    QMessageBox::warning(this, translations::trError, trSameConnections);
+    right_combo_->setFocus();
+    return;
+  }
+
+  delete job_;
+  keys_model_->clear();
+  status_label_->clear();
+  job_ = new proxy::CompareJob(left, right, common::ConvertToString(pattern), ranges_spin_->value(),
+                               scan_count_spin_->value(), value_elements_spin_->value(), ops_spin_->value(), this);
+  VERIFY(connect(job_, &proxy::CompareJob::DifferencesFound, this, &CompareDialog::addDifferences));
+  VERIFY(connect(job_, &proxy::CompareJob::Progressed, this, &CompareDialog::updateProgress));
+  VERIFY(connect(job_, &proxy::CompareJob::Finished, this, &CompareDialog::finishCompare));
+  setRunning(true);
+  job_->Start();
+}
+
+void CompareDialog::stopClicked() {
+  if (job_) {
+    job_->Stop();
+  }
+}
+
+void CompareDialog::addDifferences(const proxy::CompareJob::differences_t& differences) {
+  keys_model_->appendDifferences(differences);
+}
+
+void CompareDialog::updateProgress(const proxy::CompareJob::Statistic& stat) {
+  updateStatus(stat);
+}
+
+void CompareDialog::finishCompare(common::Error err, const proxy::CompareJob::Statistic& stat) {
+  setRunning(false);
+  updateStatus(stat);
+  if (err) {
+    if (err->GetErrorCode() == common::COMMON_EINTR) {
+      return;
+    }
+
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    QMessageBox::critical(this, translations::trError, qerror);
+    return;
+  }
+
+  if (!stat.different_ranges_count) {
+    status_label_->setText(trDatabasesEqual);
+  }
+}
+
+void CompareDialog::retranslateUi() {
+  left_label_->setText(trLeft + ":");
+  right_label_->setText(trRight + ":");
+  pattern_label_->setText(trPattern + ":");
+  ranges_label_->setText(trRanges + ":");
+  scan_count_label_->setText(trScanCount + ":");
+  value_elements_label_->setText(trMaxValueElements + ":");
+  ops_label_->setText(trMaxOpsPerSec + ":");
+  ops_spin_->setSpecialValueText(trUnlimited);
+  start_button_->setText(trCompare);
+  stop_button_->setText(translations::trStop);
+  base_class::retranslateUi();
+}
+
+proxy::IConnectionSettingsBaseSPtr CompareDialog::selectedConnection(QComboBox* combo) const {
+  const QVariant data = combo->currentData();
+  if (!data.isValid()) {
+    return proxy::IConnectionSettingsBaseSPtr();
+  }
+
+  const auto connections = proxy::SettingsManager::GetInstance()->GetConnections();
+  const size_t index = data.toUInt();
+  if (index >= connections.size()) {
+    return proxy::IConnectionSettingsBaseSPtr();
+  }
+
+  return connections[index];
+}
+
+void CompareDialog::updateStatus(const proxy::CompareJob::Statistic& stat) {
+  QString status = trStatusTemplate_6S.arg(stat.left_keys_count)
+                       .arg(stat.right_keys_count)
+                       .arg(stat.different_ranges_count)
+                       .arg(stat.missing_keys_count)
+                       .arg(stat.extra_keys_count)
+                       .arg(stat.different_keys_count);
+  if (stat.big_keys_count) {
+    status += trBigKeysTemplate_1S.arg(stat.big_keys_count);
+  }
+  status_label_->setText(status);
+}
+
+void CompareDialog::setRunning(bool running) {
+  left_combo_->setEnabled(!running);
+  right_combo_->setEnabled(!running);
+  pattern_edit_->setEnabled(!running);
+  ranges_spin_->setEnabled(!running);
+  scan_count_spin_->setEnabled(!running);
+  value_elements_spin_->setEnabled(!running);
+  ops_spin_->setEnabled(!running);
+  start_button_->setEnabled(!running);
+  stop_button_->setEnabled(running);
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,96 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/compare_job.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+class QSortFilterProxyModel;
+class QSpinBox;
+
+namespace fastonosql {
+namespace gui {
+class FastoTableView;
+class KeysDiffTableModel;
+
+class CompareDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+  enum {
+    min_width = 800,
+    min_height = 600,
+    min_scan_count = 10,
+    max_scan_count = 100000,
+    max_value_elements = 1000000,
+    max_ops_per_sec = 1000000
+  };
+
+ private Q_SLOTS:
+  void startClicked();
+  void stopClicked();
+
+  void addDifferences(const proxy::CompareJob::differences_t& differences);
+  void updateProgress(const proxy::CompareJob::Statistic& stat);
+  void finishCompare(common::Error err, const proxy::CompareJob::Statistic& stat);
+
+ protected:
+  CompareDialog(const QString& title, const QIcon& icon, const QString& left_name, QWidget* parent = Q_NULLPTR);
+
+  void retranslateUi() override;
+
+ private:
+  proxy::IConnectionSettingsBaseSPtr selectedConnection(QComboBox* combo) const;
+  void updateStatus(const proxy::CompareJob::Statistic& stat);
+  void setRunning(bool running);
+
+  QLabel* left_label_;
+  QComboBox* left_combo_;
+  QLabel* right_label_;
+  QComboBox* right_combo_;
+  QLabel* pattern_label_;
+  QLineEdit* pattern_edit_;
+  QLabel* ranges_label_;
+  QSpinBox* ranges_spin_;
+  QLabel* scan_count_label_;
+  QSpinBox* scan_count_spin_;
+  QLabel* value_elements_label_;
+  QSpinBox* value_elements_spin_;
+  QLabel* ops_label_;
+  QSpinBox* ops_spin_;
+  QPushButton* start_button_;
+  QPushButton* stop_button_;
+  QLabel* status_label_;
+  FastoTableView* keys_table_;
+  KeysDiffTableModel* keys_model_;
+  QSortFilterProxyModel* proxy_model_;
+
+  proxy::CompareJob* job_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -34,6 +34,8 @@
 
 namespace {
 const QSize kStateIconSize = QSize(64, 64);
+const QString trTlsHandshakeTemplate_1S = QObject::tr("TLS handshake msec: %1");
+const QString trTlsHandshakeResumedTemplate_1S = QObject::tr("TLS handshake msec: %1 (session resumed)");
 }
 
 namespace fastonosql {
@@ -45,6 +47,7 @@ ConnectionDiagnosticDialog::ConnectionDiagnosticDialog(const QString& title,
     : base_class(title, parent),
       glass_widget_(nullptr),
       execute_time_label_(nullptr),
+      handshake_time_label_(nullptr),
       status_label_(nullptr),
       icon_label_(nullptr) {
   setWindowIcon(GuiFactory::GetInstance().icon(connection->GetType()));
@@ -52,6 +55,9 @@ ConnectionDiagnosticDialog::ConnectionDiagnosticDialog(const QString& title,
   execute_time_label_ = new QLabel;
   execute_time_label_->setText(translations::trConnectionStatusTemplate_1S.arg("execute..."));
 
+  handshake_time_label_ = new QLabel;
+  handshake_time_label_->setVisible(false);
+
   status_label_ = new QLabel(translations::trTimeTemplate_1S.arg("calculate..."));
   status_label_->setWordWrap(true);
   icon_label_ = new QLabel;
@@ -63,6 +69,7 @@ ConnectionDiagnosticDialog::ConnectionDiagnosticDialog(const QString& title,
 
   QVBoxLayout* main_layout = new QVBoxLayout;
   main_layout->addWidget(execute_time_label_);
+  main_layout->addWidget(handshake_time_label_);
   main_layout->addWidget(status_label_);
   main_layout->addWidget(icon_label_, 1, Qt::AlignCenter);
   main_layout->addWidget(button_box);
@@ -75,6 +82,12 @@ ConnectionDiagnosticDialog::ConnectionDiagnosticDialog(const QString& title,
   startTestConnection(connection);
 }
 
+void ConnectionDiagnosticDialog::tlsHandshakeReady(qint64 handshake_mstime, bool session_reused) {
+  const QString& text_template = session_reused ? trTlsHandshakeResumedTemplate_1S : trTlsHandshakeTemplate_1S;
+  handshake_time_label_->setText(text_template.arg(handshake_mstime));
+  handshake_time_label_->setVisible(true);
+}
+
 void ConnectionDiagnosticDialog::connectionResultReady(common::Error err, qint64 exec_mstime) {
   glass_widget_->stop();
 
@@ -107,6 +120,7 @@ void ConnectionDiagnosticDialog::startTestConnection(proxy::IConnectionSettingsB
   TestConnection* cheker = new TestConnection(connection);
   cheker->moveToThread(th);
   VERIFY(connect(th, &QThread::started, cheker, &TestConnection::routine));
+  VERIFY(connect(cheker, &TestConnection::tlsHandshake, this, &ConnectionDiagnosticDialog::tlsHandshakeReady));
   VERIFY(connect(cheker, &TestConnection::connectionResult, this, &ConnectionDiagnosticDialog::connectionResultReady));
   VERIFY(connect(cheker, &TestConnection::connectionResult, th, &QThread::quit));
   VERIFY(connect(th, &QThread::finished, cheker, &TestConnection::deleteLater));
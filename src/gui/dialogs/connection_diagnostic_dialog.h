@@ -44,6 +44,7 @@ class ConnectionDiagnosticDialog : public BaseDialog {
   friend T* createDialog(Args&&... args);
 
  private Q_SLOTS:
+  void tlsHandshakeReady(qint64 handshake_mstime, bool session_reused);
   void connectionResultReady(common::Error err, qint64 exec_mstime);
 
  protected:
@@ -59,6 +60,7 @@ class ConnectionDiagnosticDialog : public BaseDialog {
 
   common::qt::gui::GlassWidget* glass_widget_;
   QLabel* execute_time_label_;
+  QLabel* handshake_time_label_;
   QLabel* status_label_;
   QLabel* icon_label_;
 };
@@ -36,24 +36,33 @@
 #include "gui/dialogs/connection_select_type_dialog.h"
 #include "gui/dialogs/sentinel_dialog.h"
 #include "gui/gui_factory.h"
+#include "gui/workers/batch_health_checker.h"
 
 #include "translations/global.h"
 
 namespace {
 const QString trSelectConTypeTitle = QObject::tr("Select connection type");
+const QString trLatency = QObject::tr("Latency");
+const QString trRole = QObject::tr("Role");
+const QString trVersion = QObject::tr("Version");
+const QString trMemory = QObject::tr("Memory");
+const QString trCheckHealth = QObject::tr("Check health of all connections");
+const QString trStopHealthCheck = QObject::tr("Stop health check");
+const QString trChecking = QObject::tr("checking...");
 }
 
 namespace fastonosql {
 namespace gui {
 
 ConnectionsDialog::ConnectionsDialog(const QString& title, const QIcon& icon, QWidget* parent)
-    : base_class(title, parent), list_widget_(nullptr), ok_button_(nullptr) {
+    : base_class(title, parent), list_widget_(nullptr), ok_button_(nullptr), health_checker_(nullptr) {
   setWindowIcon(icon);
 
   list_widget_ = new QTreeWidget;
 
   QStringList colums;
-  colums << translations::trName << translations::trAddress;
+  colums << translations::trName << translations::trAddress << translations::trType << translations::trState << trLatency
+         << trRole << trVersion << trMemory;
   list_widget_->setHeaderLabels(colums);
 
   // list_widget_->header()->setSectionResizeMode(0,
@@ -68,6 +77,12 @@ ConnectionsDialog::ConnectionsDialog(const QString& title, const QIcon& icon, QW
   list_widget_->setSelectionBehavior(QAbstractItemView::SelectRows);
 
   list_widget_->header()->resizeSection(0, min_width / 3);
+  list_widget_->header()->resizeSection(1, min_width / 4);
+
+  health_checker_ = new BatchHealthChecker(BatchHealthChecker::default_workers,
+                                           BatchHealthChecker::default_timeout_msec, this);
+  VERIFY(connect(health_checker_, &BatchHealthChecker::checked, this, &ConnectionsDialog::connectionChecked));
+  VERIFY(connect(health_checker_, &BatchHealthChecker::finished, this, &ConnectionsDialog::healthCheckFinished));
 
   // list_widget_->setDragEnabled(true);
   // list_widget_->setDragDropMode(QAbstractItemView::InternalMove);
@@ -202,6 +217,48 @@ void ConnectionsDialog::itemSelectionChange() {
   ok_button_->setEnabled(!currentItem);
 }
 
+void ConnectionsDialog::checkHealthAction() {
+  if (health_checker_->isRunning()) {
+    health_checker_->stop();
+    healthCheckFinished();
+    return;
+  }
+
+  std::vector<proxy::IConnectionSettingsBaseSPtr> connections;
+  for (ConnectionListWidgetItem* item : connectionItems()) {
+    item->clearHealth();
+    item->setText(ConnectionListWidgetItem::StateColumn, trChecking);
+    connections.push_back(item->connection());
+  }
+
+  check_health_action_->setIcon(GuiFactory::GetInstance().stopIcon());
+  check_health_action_->setToolTip(trStopHealthCheck);
+  health_checker_->start(connections);
+}
+
+void ConnectionsDialog::connectionChecked(proxy::IConnectionSettingsBaseSPtr connection,
+                                          common::Error err,
+                                          const proxy::ServersManager::HealthInfo& info) {
+  // items could be edited or removed while the check was running
+  for (ConnectionListWidgetItem* item : connectionItems()) {
+    if (item->connection() == connection) {
+      item->setHealth(err, info);
+      return;
+    }
+  }
+}
+
+void ConnectionsDialog::healthCheckFinished() {
+  for (ConnectionListWidgetItem* item : connectionItems()) {
+    if (item->text(ConnectionListWidgetItem::StateColumn) == trChecking) {
+      item->clearHealth();
+    }
+  }
+
+  check_health_action_->setIcon(GuiFactory::GetInstance().validateIcon());
+  check_health_action_->setToolTip(trCheckHealth);
+}
+
 void ConnectionsDialog::editItemAction() {
   QTreeWidgetItem* qitem = list_widget_->currentItem();
   if (!qitem) {
@@ -303,6 +360,11 @@ QToolBar* ConnectionsDialog::createToolBar() {
   remove_action_->setIcon(GuiFactory::GetInstance().removeIcon());
   VERIFY(connect(remove_action_, &QAction::triggered, this, &ConnectionsDialog::removeItemAction));
   savebar->addAction(remove_action_);
+
+  check_health_action_ = new QAction;
+  check_health_action_->setIcon(GuiFactory::GetInstance().validateIcon());
+  VERIFY(connect(check_health_action_, &QAction::triggered, this, &ConnectionsDialog::checkHealthAction));
+  savebar->addAction(check_health_action_);
   return savebar;
 }
 
@@ -523,6 +585,7 @@ void ConnectionsDialog::retranslateUi() {
   edit_action_->setToolTip(translations::trEditConnection);
   clone_action_->setToolTip(translations::trCloneConnection);
   remove_action_->setToolTip(translations::trRemoveConnection);
+  check_health_action_->setToolTip(health_checker_->isRunning() ? trStopHealthCheck : trCheckHealth);
 
   ok_button_->setText(translations::trOpen);
   base_class::retranslateUi();
@@ -561,5 +624,27 @@ DirectoryListWidgetItem* ConnectionsDialog::findFolderByPath(const proxy::connec
   return nullptr;
 }
 
+std::vector<ConnectionListWidgetItem*> ConnectionsDialog::connectionItems() const {
+  std::vector<ConnectionListWidgetItem*> result;
+  for (int i = 0; i < list_widget_->topLevelItemCount(); ++i) {
+    QTreeWidgetItem* item = list_widget_->topLevelItem(i);
+    if (DirectoryListWidgetItem* dir_item = dynamic_cast<DirectoryListWidgetItem*>(item)) {  // +
+      for (int j = 0; j < dir_item->childCount(); ++j) {
+        ConnectionListWidgetItem* child = dynamic_cast<ConnectionListWidgetItem*>(dir_item->child(j));  // +
+        if (child && child->type() == IConnectionListWidgetItem::Common) {
+          result.push_back(child);
+        }
+      }
+      continue;
+    }
+
+    ConnectionListWidgetItem* connection_item = dynamic_cast<ConnectionListWidgetItem*>(item);  // +
+    if (connection_item && connection_item->type() == IConnectionListWidgetItem::Common) {
+      result.push_back(connection_item);
+    }
+  }
+  return result;
+}
+
 }  // namespace gui
 }  // namespace fastonosql
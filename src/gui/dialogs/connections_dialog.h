@@ -18,9 +18,12 @@
 
 #pragma once
 
+#include <vector>
+
 #include "gui/dialogs/base_dialog.h"
 
 #include "proxy/connection_settings/iconnection_settings.h"
+#include "proxy/servers_manager.h"
 
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 #include "proxy/connection_settings/icluster_connection_settings.h"
@@ -38,6 +41,7 @@ namespace gui {
 class ClusterConnectionListWidgetItemContainer;
 class SentinelConnectionListWidgetItemContainer;
 #endif
+class BatchHealthChecker;
 class ConnectionListWidgetItem;
 class DirectoryListWidgetItem;
 
@@ -66,6 +70,11 @@ class ConnectionsDialog : public BaseDialog {
   void cloneItemAction();
   void editItemAction();
   void itemSelectionChange();
+  void checkHealthAction();
+  void connectionChecked(proxy::IConnectionSettingsBaseSPtr connection,
+                         common::Error err,
+                         const proxy::ServersManager::HealthInfo& info);
+  void healthCheckFinished();
 
  protected:
   explicit ConnectionsDialog(const QString& title, const QIcon& icon, QWidget* parent = Q_NULLPTR);
@@ -90,6 +99,7 @@ class ConnectionsDialog : public BaseDialog {
 #endif
 
   DirectoryListWidgetItem* findFolderByPath(const proxy::connection_path_t& path) const;
+  std::vector<ConnectionListWidgetItem*> connectionItems() const;
 
   QAction* add_connection_action_;
   QAction* add_cluster_action_;
@@ -97,9 +107,11 @@ class ConnectionsDialog : public BaseDialog {
   QAction* edit_action_;
   QAction* clone_action_;
   QAction* remove_action_;
+  QAction* check_health_action_;
 
   QTreeWidget* list_widget_;
   QPushButton* ok_button_;
+  BatchHealthChecker* health_checker_;
 };
 
 }  // namespace gui
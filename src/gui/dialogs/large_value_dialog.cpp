@@ -0,0 +1,388 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/large_value_dialog.h"
+
+#include <algorithm>
+#include <string>
+
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QSplitter>
+
+#include <common/convert2string.h>
+
+#include <fastonosql/core/types.h>
+
+#include "proxy/server/iserver.h"
+
+#include "gui/widgets/fasto_viewer.h"
+
+#include "translations/global.h"
+
+#define REDIS_GETRANGE_COMMAND "GETRANGE"
+#define REDIS_SETRANGE_COMMAND "SETRANGE"
+
+namespace {
+const QString trWindow = QObject::tr("Window");
+const QString trRangeTemplate_3S = QObject::tr("Bytes %1-%2 of %3");
+const QString trLoadingWindow = QObject::tr("Loading...");
+const QString trSavingTemplate_2S = QObject::tr("Saving %1 of %2 patches...");
+const QString trSaved = QObject::tr("Saved");
+const QString trNothingToSave = QObject::tr("Nothing to save");
+const QString trCantOpenStorage = QObject::tr("Can't create temporary storage for the value.");
+const QString trLengthChanged =
+    QObject::tr("Window length can't be changed, replace bytes in place or append to the last window.");
+const QString trDiscardChanges = QObject::tr("Value has unsaved changes, discard them?");
+
+// editor text goes through QString, only complete valid utf-8 survives that byte for byte;
+// a leading BOM would be dropped by the decoder
+bool IsEditableAsText(const std::string& data) {
+  const unsigned char* str = reinterpret_cast<const unsigned char*>(data.data());
+  const size_t size = data.size();
+  if (size >= 3 && str[0] == 0xEF && str[1] == 0xBB && str[2] == 0xBF) {
+    return false;
+  }
+
+  for (size_t pos = 0; pos < size;) {
+    const unsigned char lead = str[pos];
+    size_t length = 0;
+    uint32_t cp = 0;
+    uint32_t min_cp = 0;
+    if (lead < 0x80) {
+      pos++;
+      continue;
+    } else if ((lead & 0xE0) == 0xC0) {
+      length = 2;
+      cp = lead & 0x1F;
+      min_cp = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+      length = 3;
+      cp = lead & 0x0F;
+      min_cp = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+      length = 4;
+      cp = lead & 0x07;
+      min_cp = 0x10000;
+    } else {
+      return false;
+    }
+
+    // a window may start or end inside a character
+    if (pos + length > size) {
+      return false;
+    }
+
+    for (size_t i = 1; i < length; ++i) {
+      if ((str[pos + i] & 0xC0) != 0x80) {
+        return false;
+      }
+      cp = (cp << 6) | (str[pos + i] & 0x3F);
+    }
+
+    if (cp < min_cp || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+      return false;
+    }
+    pos += length;
+  }
+  return true;
+}
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+LargeValueDialog::LargeValueDialog(const QString& title,
+                                   const QIcon& icon,
+                                   proxy::IServerSPtr server,
+                                   const core::NKey& key,
+                                   size_t value_size,
+                                   QWidget* parent)
+    : base_class(title, parent),
+      window_label_(nullptr),
+      window_spin_(nullptr),
+      range_label_(nullptr),
+      value_viewer_(nullptr),
+      status_label_(nullptr),
+      save_button_(nullptr),
+      server_(server),
+      key_(key),
+      store_(window_size),
+      current_window_(0),
+      pending_(),
+      patches_(),
+      patches_sent_(0) {
+  CHECK(server_);
+  setWindowIcon(icon);
+
+  VERIFY(connect(server.get(), &proxy::IServer::ExecuteFinished, this, &LargeValueDialog::finishExecuteCommand));
+
+  QHBoxLayout* window_layout = new QHBoxLayout;
+  window_label_ = new QLabel;
+  window_spin_ = new QSpinBox;
+  window_spin_->setMinimum(1);
+  VERIFY(connect(window_spin_, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+                 &LargeValueDialog::windowChange));
+  range_label_ = new QLabel;
+  window_layout->addWidget(window_label_);
+  window_layout->addWidget(window_spin_);
+  window_layout->addWidget(range_label_);
+  window_layout->addWidget(new QSplitter(Qt::Horizontal));
+
+  value_viewer_ = createWidget<FastoViewer>();
+  value_viewer_->setView(RAW_VIEW);
+  value_viewer_->setViewChangeEnabled(false);
+
+  QHBoxLayout* control_layout = new QHBoxLayout;
+  status_label_ = new QLabel;
+  save_button_ = new QPushButton;
+  VERIFY(connect(save_button_, &QPushButton::clicked, this, &LargeValueDialog::saveClicked));
+  control_layout->addWidget(status_label_);
+  control_layout->addWidget(new QSplitter(Qt::Horizontal));
+  control_layout->addWidget(save_button_);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &LargeValueDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(window_layout);
+  main_layout->addWidget(value_viewer_);
+  main_layout->addLayout(control_layout);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+
+  if (!store_.Open(value_size)) {
+    status_label_->setText(trCantOpenStorage);
+    window_spin_->setEnabled(false);
+    save_button_->setEnabled(false);
+    value_viewer_->setReadOnly(true);
+    return;
+  }
+
+  window_spin_->setMaximum(static_cast<int>(store_.GetWindowsCount()));
+  showWindow(0);
+}
+
+void LargeValueDialog::finishExecuteCommand(const proxy::events_info::ExecuteInfoResponse& res) {
+  if (res.initiator() != this || pending_.empty()) {
+    return;
+  }
+
+  const PendingRequest request = pending_.front();
+  pending_.pop_front();
+
+  common::Error err = res.errorInfo();
+  if (request.is_save) {
+    if (err) {
+      status_label_->setText(QString::fromStdString(err->GetDescription()));
+      patches_.clear();
+      setBusy(false);
+      return;
+    }
+
+    sendNextPatches();
+    return;
+  }
+
+  if (err || res.executed_commands.empty()) {
+    if (request.window == current_window_) {
+      status_label_->setText(err ? QString::fromStdString(err->GetDescription()) : QString());
+    }
+    return;
+  }
+
+  const auto childs = res.executed_commands[0]->GetChildrens();
+  if (childs.size() != 1) {
+    return;
+  }
+
+  common::Value::string_t data;
+  const auto value = childs[0]->GetValue();
+  if (!value || !value->GetAsString(&data)) {
+    return;
+  }
+
+  store_.SetWindow(request.window, std::string(data.data(), data.size()));
+  if (request.window == current_window_) {
+    showWindow(current_window_);
+  }
+}
+
+void LargeValueDialog::windowChange(int window) {
+  const size_t index = window - 1;
+  if (index == current_window_) {
+    return;
+  }
+
+  if (!commitWindow()) {
+    window_spin_->blockSignals(true);
+    window_spin_->setValue(static_cast<int>(current_window_ + 1));
+    window_spin_->blockSignals(false);
+    return;
+  }
+
+  showWindow(index);
+}
+
+void LargeValueDialog::saveClicked() {
+  if (!commitWindow()) {
+    return;
+  }
+
+  // long patches (appended tail) split so one command never carries more than a window
+  patches_.clear();
+  for (const LargeValueStore::Patch& patch : store_.GetPatches()) {
+    for (size_t pos = 0; pos < patch.data.size(); pos += window_size) {
+      LargeValueStore::Patch part;
+      part.offset = patch.offset + pos;
+      part.data = patch.data.substr(pos, window_size);
+      patches_.push_back(part);
+    }
+  }
+
+  if (patches_.empty()) {
+    status_label_->setText(trNothingToSave);
+    return;
+  }
+
+  patches_sent_ = 0;
+  setBusy(true);
+  sendNextPatches();
+}
+
+void LargeValueDialog::reject() {
+  if (!commitWindow() || store_.HasPatches()) {
+    int answer = QMessageBox::question(this, windowTitle(), trDiscardChanges, QMessageBox::Yes, QMessageBox::No,
+                                       QMessageBox::NoButton);
+    if (answer != QMessageBox::Yes) {
+      return;
+    }
+  }
+
+  base_class::reject();
+}
+
+void LargeValueDialog::retranslateUi() {
+  window_label_->setText(trWindow + ":");
+  save_button_->setText(translations::trSave);
+  base_class::retranslateUi();
+}
+
+void LargeValueDialog::loadWindow(size_t index) {
+  if (index >= store_.GetWindowsCount() || store_.IsWindowLoaded(index)) {
+    return;
+  }
+
+  for (const PendingRequest& request : pending_) {
+    if (!request.is_save && request.window == index) {
+      return;
+    }
+  }
+
+  const size_t start = store_.GetWindowOffset(index);
+  const size_t end = start + store_.GetWindowLength(index) - 1;
+  core::command_buffer_writer_t wr;
+  wr << REDIS_GETRANGE_COMMAND SPACE_STR << key_.GetKey().GetForCommandLine() << SPACE_STR
+     << common::ConvertToCharBytes(start) << SPACE_STR << common::ConvertToCharBytes(end);
+  pending_.push_back({false, index});
+  proxy::events_info::ExecuteInfoRequest req(this, wr.str(), 0, 0, false, true, core::C_INNER);
+  server_->Execute(req);
+}
+
+void LargeValueDialog::showWindow(size_t index) {
+  current_window_ = index;
+  const size_t start = store_.GetWindowOffset(index);
+  range_label_->setText(trRangeTemplate_3S.arg(start)
+                            .arg(start + store_.GetWindowLength(index))
+                            .arg(store_.GetSize()));
+
+  std::string data;
+  if (!store_.GetWindow(index, &data)) {
+    value_viewer_->clear();
+    value_viewer_->setReadOnly(true);
+    status_label_->setText(trLoadingWindow);
+    loadWindow(index);
+    return;
+  }
+
+  // SETRANGE patches are computed from the editor text, so it must give back the exact bytes
+  const OutputView view = IsEditableAsText(data) ? RAW_VIEW : TO_HEX_VIEW;
+  if (value_viewer_->viewMethod() != view) {
+    value_viewer_->setView(view);
+  }
+  value_viewer_->setText(GEN_CMD_STRING_SIZE(data.data(), data.size()));
+  value_viewer_->setReadOnly(!patches_.empty());
+  status_label_->setText(QString());
+  // scrolling forward is the common case
+  loadWindow(index + 1);
+}
+
+bool LargeValueDialog::commitWindow() {
+  if (!store_.IsWindowLoaded(current_window_)) {
+    return true;
+  }
+
+  const core::readable_string_t text = value_viewer_->text();
+  if (!store_.UpdateWindow(current_window_, std::string(text.data(), text.size()))) {
+    status_label_->setText(trLengthChanged);
+    return false;
+  }
+
+  window_spin_->setMaximum(static_cast<int>(store_.GetWindowsCount()));
+  return true;
+}
+
+void LargeValueDialog::sendNextPatches() {
+  if (patches_sent_ == patches_.size()) {
+    patches_.clear();
+    store_.ClearPatches();
+    setBusy(false);
+    status_label_->setText(trSaved);
+    return;
+  }
+
+  const size_t count = std::min<size_t>(patches_per_request, patches_.size() - patches_sent_);
+  core::command_buffer_writer_t wr;
+  for (size_t i = 0; i != count; ++i) {
+    const LargeValueStore::Patch& patch = patches_[patches_sent_ + i];
+    const core::ReadableString data(GEN_CMD_STRING_SIZE(patch.data.data(), patch.data.size()));
+    wr << REDIS_SETRANGE_COMMAND SPACE_STR << key_.GetKey().GetForCommandLine() << SPACE_STR
+       << common::ConvertToCharBytes(patch.offset) << SPACE_STR << data.GetForCommandLine() << "\n";
+  }
+  patches_sent_ += count;
+
+  status_label_->setText(trSavingTemplate_2S.arg(patches_sent_).arg(patches_.size()));
+  pending_.push_back({true, 0});
+  proxy::events_info::ExecuteInfoRequest req(this, wr.str(), 0, 0, false, true, core::C_INNER);
+  server_->Execute(req);
+}
+
+void LargeValueDialog::setBusy(bool busy) {
+  window_spin_->setEnabled(!busy);
+  save_button_->setEnabled(!busy);
+  value_viewer_->setReadOnly(busy);
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,101 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include <fastonosql/core/db_key.h>
+
+#include "gui/dialogs/base_dialog.h"
+#include "gui/large_value_store.h"
+
+#include "proxy/proxy_fwd.h"
+
+class QLabel;
+class QPushButton;
+class QSpinBox;
+
+namespace fastonosql {
+namespace proxy {
+namespace events_info {
+struct ExecuteInfoResponse;
+}  // namespace events_info
+}  // namespace proxy
+namespace gui {
+class FastoViewer;
+
+// string value too big to load at once, shown by GETRANGE windows and saved by SETRANGE patches
+class LargeValueDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+  enum { min_width = 800, min_height = 600, window_size = 1024 * 1024, patches_per_request = 8 };
+
+ private Q_SLOTS:
+  void finishExecuteCommand(const proxy::events_info::ExecuteInfoResponse& res);
+
+  void windowChange(int window);
+  void saveClicked();
+
+ protected:
+  LargeValueDialog(const QString& title,
+                   const QIcon& icon,
+                   proxy::IServerSPtr server,
+                   const core::NKey& key,
+                   size_t value_size,
+                   QWidget* parent = Q_NULLPTR);
+
+  void reject() override;
+
+  void retranslateUi() override;
+
+ private:
+  struct PendingRequest {
+    bool is_save;
+    size_t window;
+  };
+
+  void loadWindow(size_t index);
+  void showWindow(size_t index);
+  bool commitWindow();
+  void sendNextPatches();
+  void setBusy(bool busy);
+
+  QLabel* window_label_;
+  QSpinBox* window_spin_;
+  QLabel* range_label_;
+  FastoViewer* value_viewer_;
+  QLabel* status_label_;
+  QPushButton* save_button_;
+
+  proxy::IServerSPtr server_;
+  const core::NKey key_;
+  LargeValueStore store_;
+  size_t current_window_;
+  std::deque<PendingRequest> pending_;
+  std::vector<LargeValueStore::Patch> patches_;
+  size_t patches_sent_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
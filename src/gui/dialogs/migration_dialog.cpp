@@ -0,0 +1,343 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/migration_dialog.h"
+
+#include <algorithm>
+
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QMessageBox>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QSplitter>
+
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/macros.h>
+
+#include "proxy/settings_manager.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trSource = QObject::tr("Source");
+const QString trDestination = QObject::tr("Destination");
+const QString trPattern = QObject::tr("Pattern");
+const QString trBatchSize = QObject::tr("Batch size");
+const QString trInFlightBatches = QObject::tr("In-flight batches");
+const QString trWorkers = QObject::tr("Writer connections");
+const QString trStart = QObject::tr("Start");
+const QString trResume = QObject::tr("Resume");
+const QString trInvalidPattern = QObject::tr("Invalid pattern!");
+const QString trSameConnections = QObject::tr("Source and destination must be different connections!");
+const QString trMigrationFinished = QObject::tr("Migration finished");
+const QString trMigratedTemplate_4S = QObject::tr("Migrated %1 of %2 keys, %3 keys/sec, ETA %4 sec");
+const QString trSkippedFailedTemplate_2S = QObject::tr(" (skipped %1, failed %2)");
+const char* kDefaultPattern = ALL_KEYS_PATTERNS;
+
+const QString kCursorField = QString("cursor");
+const QString kKeyCursorField = QString("key_cursor");
+const QString kMigratedKeysField = QString("migrated_keys");
+
+QVariantMap CheckpointToMap(const fastonosql::proxy::MigrationJob::Checkpoint& checkpoint) {
+  QVariantMap map;
+  map[kCursorField] = static_cast<qulonglong>(checkpoint.cursor);
+  map[kKeyCursorField] = QByteArray(checkpoint.key_cursor.data(), static_cast<int>(checkpoint.key_cursor.size()));
+  map[kMigratedKeysField] = static_cast<qulonglong>(checkpoint.migrated_keys);
+  return map;
+}
+
+fastonosql::proxy::MigrationJob::Checkpoint CheckpointFromMap(const QVariantMap& map) {
+  fastonosql::proxy::MigrationJob::Checkpoint checkpoint;
+  checkpoint.cursor = map.value(kCursorField).toULongLong();
+  const QByteArray key_cursor = map.value(kKeyCursorField).toByteArray();
+  checkpoint.key_cursor = fastonosql::core::command_buffer_t(key_cursor.begin(), key_cursor.end());
+  checkpoint.migrated_keys = map.value(kMigratedKeysField).toULongLong();
+  return checkpoint;
+}
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+MigrationDialog::MigrationDialog(const QString& title, const QIcon& icon, const QString& source_name, QWidget* parent)
+    : base_class(title, parent),
+      source_label_(nullptr),
+      source_combo_(nullptr),
+      destination_label_(nullptr),
+      destination_combo_(nullptr),
+      pattern_label_(nullptr),
+      pattern_edit_(nullptr),
+      batch_size_label_(nullptr),
+      batch_size_spin_(nullptr),
+      window_label_(nullptr),
+      window_spin_(nullptr),
+      workers_label_(nullptr),
+      workers_spin_(nullptr),
+      progress_bar_(nullptr),
+      status_label_(nullptr),
+      start_button_(nullptr),
+      stop_button_(nullptr),
+      job_(nullptr),
+      checkpoint_() {
+  setWindowIcon(icon);
+
+  source_combo_ = new QComboBox;
+  destination_combo_ = new QComboBox;
+  const auto connections = proxy::SettingsManager::GetInstance()->GetConnections();
+  for (size_t i = 0; i < connections.size(); ++i) {
+    QString name;
+    common::ConvertFromString(connections[i]->GetPath().ToString(), &name);
+    source_combo_->addItem(name, static_cast<int>(i));
+    destination_combo_->addItem(name, static_cast<int>(i));
+  }
+  for (size_t i = 0; i < connections.size(); ++i) {
+    QString name;
+    common::ConvertFromString(connections[i]->GetPath().GetName(), &name);
+    if (name == source_name) {
+      source_combo_->setCurrentIndex(static_cast<int>(i));
+      destination_combo_->setCurrentIndex(i + 1 < connections.size() ? static_cast<int>(i + 1) : 0);
+      break;
+    }
+  }
+
+  source_label_ = new QLabel;
+  destination_label_ = new QLabel;
+  pattern_label_ = new QLabel;
+  pattern_edit_ = new QLineEdit;
+  pattern_edit_->setText(kDefaultPattern);
+
+  batch_size_label_ = new QLabel;
+  batch_size_spin_ = new QSpinBox;
+  batch_size_spin_->setRange(1, max_batch_size);
+  batch_size_spin_->setValue(proxy::MigrationJob::default_batch_size);
+
+  window_label_ = new QLabel;
+  window_spin_ = new QSpinBox;
+  window_spin_->setRange(1, max_window);
+  window_spin_->setValue(proxy::MigrationJob::default_window);
+
+  workers_label_ = new QLabel;
+  workers_spin_ = new QSpinBox;
+  workers_spin_->setRange(1, proxy::MigrationJob::max_workers);
+  workers_spin_->setValue(proxy::MigrationJob::default_workers);
+
+  // a checkpoint belongs to one source/destination/pattern triple and survives restarts
+  VERIFY(connect(source_combo_, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+                 &MigrationDialog::loadCheckpoint));
+  VERIFY(connect(destination_combo_, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this,
+                 &MigrationDialog::loadCheckpoint));
+  VERIFY(connect(pattern_edit_, &QLineEdit::textChanged, this, &MigrationDialog::loadCheckpoint));
+
+  QGridLayout* params_layout = new QGridLayout;
+  params_layout->addWidget(source_label_, 0, 0);
+  params_layout->addWidget(source_combo_, 0, 1);
+  params_layout->addWidget(destination_label_, 0, 2);
+  params_layout->addWidget(destination_combo_, 0, 3);
+  params_layout->addWidget(pattern_label_, 1, 0);
+  params_layout->addWidget(pattern_edit_, 1, 1);
+  params_layout->addWidget(batch_size_label_, 1, 2);
+  params_layout->addWidget(batch_size_spin_, 1, 3);
+  params_layout->addWidget(window_label_, 2, 0);
+  params_layout->addWidget(window_spin_, 2, 1);
+  params_layout->addWidget(workers_label_, 2, 2);
+  params_layout->addWidget(workers_spin_, 2, 3);
+
+  progress_bar_ = new QProgressBar;
+  progress_bar_->setRange(0, 100);
+  progress_bar_->setValue(0);
+
+  QHBoxLayout* control_layout = new QHBoxLayout;
+  status_label_ = new QLabel;
+  start_button_ = new QPushButton;
+  VERIFY(connect(start_button_, &QPushButton::clicked, this, &MigrationDialog::startClicked));
+  stop_button_ = new QPushButton;
+  VERIFY(connect(stop_button_, &QPushButton::clicked, this, &MigrationDialog::stopClicked));
+  control_layout->addWidget(status_label_);
+  control_layout->addWidget(new QSplitter(Qt::Horizontal));
+  control_layout->addWidget(start_button_);
+  control_layout->addWidget(stop_button_);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &MigrationDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(params_layout);
+  main_layout->addWidget(progress_bar_);
+  main_layout->addLayout(control_layout);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+  setRunning(false);
+  loadCheckpoint();
+}
+
+void MigrationDialog::startClicked() {
+  const QString pattern = pattern_edit_->text();
+  if (pattern.isEmpty()) {
+    QMessageBox::warning(this, translations::trError, trInvalidPattern);
+    pattern_edit_->setFocus();
+    return;
+  }
+
+  proxy::IConnectionSettingsBaseSPtr source = selectedConnection(source_combo_);
+  proxy::IConnectionSettingsBaseSPtr destination = selectedConnection(destination_combo_);
+  if (!source || !destination || source == destination) {
+    QMessageBox::warning(this, translations::trError, trSameConnections);
+    destination_combo_->setFocus();
+    return;
+  }
+
+  delete job_;
+  job_ = new proxy::MigrationJob(source, destination, common::ConvertToString(pattern), batch_size_spin_->value(),
+                                 window_spin_->value(), workers_spin_->value(), checkpoint_, this);
+  VERIFY(connect(job_, &proxy::MigrationJob::Progressed, this, &MigrationDialog::updateProgress));
+  VERIFY(connect(job_, &proxy::MigrationJob::Finished, this, &MigrationDialog::finishMigration));
+  setRunning(true);
+  job_->Start();
+}
+
+void MigrationDialog::stopClicked() {
+  if (job_) {
+    job_->Stop();
+  }
+}
+
+void MigrationDialog::loadCheckpoint() {
+  const QString id = checkpointId();
+  checkpoint_ = id.isEmpty() ? proxy::MigrationJob::Checkpoint()
+                             : CheckpointFromMap(proxy::SettingsManager::GetInstance()->GetMigrationCheckpoint(id));
+  progress_bar_->setValue(0);
+  status_label_->clear();
+  retranslateUi();
+}
+
+void MigrationDialog::updateProgress(const proxy::MigrationJob::Statistic& stat,
+                                     const proxy::MigrationJob::Checkpoint& checkpoint) {
+  checkpoint_ = checkpoint;
+  storeCheckpoint();
+  if (stat.total_keys) {
+    const size_t percent = std::min(stat.migrated_keys * 100 / stat.total_keys, size_t(100));
+    progress_bar_->setValue(static_cast<int>(percent));
+  }
+
+  const QString eta = stat.eta_msec < 0 ? QString("?") : QString::number(stat.eta_msec / 1000);
+  QString status = trMigratedTemplate_4S.arg(stat.migrated_keys)
+                       .arg(stat.total_keys)
+                       .arg(static_cast<qulonglong>(stat.keys_per_sec))
+                       .arg(eta);
+  if (stat.skipped_keys || stat.failed_keys) {
+    status += trSkippedFailedTemplate_2S.arg(stat.skipped_keys).arg(stat.failed_keys);
+  }
+  status_label_->setText(status);
+}
+
+void MigrationDialog::finishMigration(common::Error err, const proxy::MigrationJob::Checkpoint& checkpoint) {
+  checkpoint_ = checkpoint;
+  storeCheckpoint();
+  setRunning(false);
+  if (err) {
+    if (err->GetErrorCode() == common::COMMON_EINTR) {
+      return;
+    }
+
+    QString qerror;
+    common::ConvertFromString(err->GetDescription(), &qerror);
+    QMessageBox::critical(this, translations::trError, qerror);
+    return;
+  }
+
+  checkpoint_ = proxy::MigrationJob::Checkpoint();
+  storeCheckpoint();
+  progress_bar_->setValue(100);
+  retranslateUi();
+  QMessageBox::information(this, translations::trInfo, trMigrationFinished);
+}
+
+void MigrationDialog::retranslateUi() {
+  source_label_->setText(trSource + ":");
+  destination_label_->setText(trDestination + ":");
+  pattern_label_->setText(trPattern + ":");
+  batch_size_label_->setText(trBatchSize + ":");
+  window_label_->setText(trInFlightBatches + ":");
+  workers_label_->setText(trWorkers + ":");
+  start_button_->setText(checkpoint_.migrated_keys ? trResume : trStart);
+  stop_button_->setText(translations::trStop);
+  base_class::retranslateUi();
+}
+
+proxy::IConnectionSettingsBaseSPtr MigrationDialog::selectedConnection(QComboBox* combo) const {
+  const QVariant data = combo->currentData();
+  if (!data.isValid()) {
+    return proxy::IConnectionSettingsBaseSPtr();
+  }
+
+  const auto connections = proxy::SettingsManager::GetInstance()->GetConnections();
+  const size_t index = data.toUInt();
+  if (index >= connections.size()) {
+    return proxy::IConnectionSettingsBaseSPtr();
+  }
+
+  return connections[index];
+}
+
+QString MigrationDialog::checkpointId() const {
+  proxy::IConnectionSettingsBaseSPtr source = selectedConnection(source_combo_);
+  proxy::IConnectionSettingsBaseSPtr destination = selectedConnection(destination_combo_);
+  if (!source || !destination) {
+    return QString();
+  }
+
+  QString source_hash;
+  QString destination_hash;
+  common::ConvertFromString(source->GetHash(), &source_hash);
+  common::ConvertFromString(destination->GetHash(), &destination_hash);
+  return source_hash + "/" + destination_hash + "/" + pattern_edit_->text();
+}
+
+void MigrationDialog::storeCheckpoint() {
+  const QString id = checkpointId();
+  if (id.isEmpty()) {
+    return;
+  }
+
+  const QVariantMap checkpoint = checkpoint_.migrated_keys ? CheckpointToMap(checkpoint_) : QVariantMap();
+  proxy::SettingsManager::GetInstance()->SetMigrationCheckpoint(id, checkpoint);
+}
+
+void MigrationDialog::setRunning(bool running) {
+  source_combo_->setEnabled(!running);
+  destination_combo_->setEnabled(!running);
+  pattern_edit_->setEnabled(!running);
+  batch_size_spin_->setEnabled(!running);
+  window_spin_->setEnabled(!running);
+  workers_spin_->setEnabled(!running);
+  start_button_->setEnabled(!running);
+  stop_button_->setEnabled(running);
+  retranslateUi();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
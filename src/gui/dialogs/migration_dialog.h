@@ -0,0 +1,85 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/migration_job.h"
+
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QProgressBar;
+class QPushButton;
+class QSpinBox;
+
+namespace fastonosql {
+namespace gui {
+
+class MigrationDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+  enum { min_width = 640, min_height = 240, max_batch_size = 10000, max_window = 64 };
+
+ private Q_SLOTS:
+  void startClicked();
+  void stopClicked();
+  void loadCheckpoint();
+
+  void updateProgress(const proxy::MigrationJob::Statistic& stat, const proxy::MigrationJob::Checkpoint& checkpoint);
+  void finishMigration(common::Error err, const proxy::MigrationJob::Checkpoint& checkpoint);
+
+ protected:
+  MigrationDialog(const QString& title, const QIcon& icon, const QString& source_name, QWidget* parent = Q_NULLPTR);
+
+  void retranslateUi() override;
+
+ private:
+  proxy::IConnectionSettingsBaseSPtr selectedConnection(QComboBox* combo) const;
+  QString checkpointId() const;
+  void storeCheckpoint();
+  void setRunning(bool running);
+
+  QLabel* source_label_;
+  QComboBox* source_combo_;
+  QLabel* destination_label_;
+  QComboBox* destination_combo_;
+  QLabel* pattern_label_;
+  QLineEdit* pattern_edit_;
+  QLabel* batch_size_label_;
+  QSpinBox* batch_size_spin_;
+  QLabel* window_label_;
+  QSpinBox* window_spin_;
+  QLabel* workers_label_;
+  QSpinBox* workers_spin_;
+  QProgressBar* progress_bar_;
+  QLabel* status_label_;
+  QPushButton* start_button_;
+  QPushButton* stop_button_;
+
+  proxy::MigrationJob* job_;
+  proxy::MigrationJob::Checkpoint checkpoint_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
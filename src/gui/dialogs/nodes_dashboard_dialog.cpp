@@ -0,0 +1,268 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/nodes_dashboard_dialog.h"
+
+#include <algorithm>
+
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QTimerEvent>
+#include <QTreeWidget>
+
+#include <common/convert2string.h>
+#include <common/qt/convert2string.h>
+#include <common/qt/gui/base/graph_widget.h>
+#include <common/time.h>
+
+#include "proxy/server/iserver.h"
+#include "proxy/server/iserver_remote.h"
+
+#include "gui/widgets/heat_map_widget.h"
+#include "gui/workers/nodes_info_poller.h"
+
+#include "translations/global.h"
+
+namespace {
+const QString trRefreshEverySec = QObject::tr("Refresh every (sec)");
+const QString trShard = QObject::tr("Shard");
+const QString trNodes = QObject::tr("Nodes");
+const QString trOpsPerSec = QObject::tr("Ops/sec");
+const QString trMemory = QObject::tr("Memory");
+const QString trHitRatio = QObject::tr("Hit ratio");
+const QString trReplicationLag = QObject::tr("Replication lag");
+const QString trEvictionsPerSec = QObject::tr("Evictions/sec");
+const QString trTotal = QObject::tr("Total");
+const QString trNodesStatusTemplate_2S = QObject::tr("Nodes: %1, not answered: %2");
+const QString trShardTooltipTemplate_4S = QObject::tr("%1<br/>Ops/sec: %2<br/>Memory: %3<br/>Hit ratio: %4");
+
+QString MemoryText(long long bytes) {
+  return QString::number(static_cast<double>(bytes) / (1024 * 1024), 'f', 1) + " MB";
+}
+
+QString RatioText(double ratio) {
+  return ratio < 0 ? QString("-") : QString::number(ratio * 100, 'f', 1) + "%";
+}
+
+QString ShardName(const std::string& name) {
+  QString qname;
+  common::ConvertFromString(name, &qname);
+  return qname;
+}
+
+std::string NodeAddress(fastonosql::proxy::IServerSPtr server) {
+  fastonosql::proxy::IServerRemote* remote = dynamic_cast<fastonosql::proxy::IServerRemote*>(server.get());  // +
+  if (!remote) {
+    return server->GetName();
+  }
+
+  const common::net::HostAndPort host = remote->GetHost();
+  return host.GetHost() + ":" + common::ConvertToString(host.GetPort());
+}
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+NodesDashboardDialog::NodesDashboardDialog(const QString& title,
+                                           const QIcon& icon,
+                                           const std::vector<proxy::IServerSPtr>& nodes,
+                                           QWidget* parent)
+    : base_class(title, parent),
+      refresh_label_(nullptr),
+      refresh_spin_(nullptr),
+      status_label_(nullptr),
+      heat_map_(nullptr),
+      shards_table_(nullptr),
+      graph_widget_(nullptr),
+      poller_(nullptr),
+      nodes_(nodes),
+      series_(),
+      failed_nodes_(),
+      refresh_timer_id_(0) {
+  setWindowIcon(icon);
+
+  poller_ = new NodesInfoPoller(this);
+  VERIFY(connect(poller_, &NodesInfoPoller::sampled, this, &NodesDashboardDialog::nodeSampled));
+  VERIFY(connect(poller_, &NodesInfoPoller::failed, this, &NodesDashboardDialog::nodeFailed));
+
+  QHBoxLayout* params_layout = new QHBoxLayout;
+  refresh_label_ = new QLabel;
+  refresh_spin_ = new QSpinBox;
+  refresh_spin_->setRange(min_refresh_sec, max_refresh_sec);
+  refresh_spin_->setValue(default_refresh_sec);
+  VERIFY(connect(refresh_spin_, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,
+                 &NodesDashboardDialog::refreshRateChanged));
+  status_label_ = new QLabel;
+  params_layout->addWidget(refresh_label_);
+  params_layout->addWidget(refresh_spin_);
+  params_layout->addWidget(new QSplitter(Qt::Horizontal));
+  params_layout->addWidget(status_label_);
+
+  heat_map_ = new HeatMapWidget;
+
+  shards_table_ = new QTreeWidget;
+  shards_table_->setColumnCount(kColumnsCount);
+  shards_table_->setRootIsDecorated(false);
+  shards_table_->setIndentation(0);
+  shards_table_->header()->setSectionResizeMode(QHeaderView::ResizeToContents);
+
+  graph_widget_ = new common::qt::gui::GraphWidget;
+
+  QSplitter* splitter = new QSplitter(Qt::Vertical);
+  splitter->addWidget(heat_map_);
+  splitter->addWidget(shards_table_);
+  splitter->addWidget(graph_widget_);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &NodesDashboardDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addLayout(params_layout);
+  main_layout->addWidget(splitter);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+}
+
+void NodesDashboardDialog::showEvent(QShowEvent* e) {
+  base_class::showEvent(e);
+
+  std::vector<NodesInfoPoller::Node> nodes;
+  for (const proxy::IServerSPtr& server : nodes_) {
+    NodesInfoPoller::Node node;
+    node.name = NodeAddress(server);
+    node.connection = server->CloneSettings();
+    nodes.push_back(node);
+  }
+
+  const int interval_msec = refresh_spin_->value() * 1000;
+  poller_->start(nodes, interval_msec);
+  refresh_timer_id_ = startTimer(interval_msec);
+  updateStatus();
+}
+
+void NodesDashboardDialog::hideEvent(QHideEvent* e) {
+  if (refresh_timer_id_) {
+    killTimer(refresh_timer_id_);
+    refresh_timer_id_ = 0;
+  }
+  poller_->stop();
+  base_class::hideEvent(e);
+}
+
+void NodesDashboardDialog::timerEvent(QTimerEvent* event) {
+  if (event->timerId() != refresh_timer_id_) {
+    base_class::timerEvent(event);
+    return;
+  }
+
+  // rendering is decoupled from replies, a burst of samples costs one repaint
+  render(series_.Aggregate(common::time::current_utc_mstime()));
+}
+
+void NodesDashboardDialog::refreshRateChanged(int value) {
+  const int interval_msec = value * 1000;
+  poller_->setInterval(interval_msec);
+  if (refresh_timer_id_) {
+    killTimer(refresh_timer_id_);
+    refresh_timer_id_ = startTimer(interval_msec);
+  }
+}
+
+void NodesDashboardDialog::nodeSampled(const std::string& node, const proxy::NodeInfoSample& sample) {
+  series_.SetSample(node, sample);
+  auto it = std::find(failed_nodes_.begin(), failed_nodes_.end(), node);
+  if (it != failed_nodes_.end()) {
+    failed_nodes_.erase(it);
+    updateStatus();
+  }
+}
+
+void NodesDashboardDialog::nodeFailed(const std::string& node, common::Error err) {
+  UNUSED(err);
+  // stale numbers of unreachable node would hide the outage in totals
+  series_.RemoveNode(node);
+  if (std::find(failed_nodes_.begin(), failed_nodes_.end(), node) == failed_nodes_.end()) {
+    failed_nodes_.push_back(node);
+    updateStatus();
+  }
+}
+
+void NodesDashboardDialog::render(const proxy::NodesStatsPoint& point) {
+  HeatMapWidget::cells_t cells;
+  shards_table_->clear();
+  std::vector<proxy::ShardStats> rows = point.shards;
+  rows.insert(rows.begin(), point.total);
+  for (size_t i = 0; i < rows.size(); ++i) {
+    const proxy::ShardStats& shard = rows[i];
+    const QString name = i == 0 ? trTotal : ShardName(shard.name);
+    QTreeWidgetItem* item = new QTreeWidgetItem;
+    item->setText(kShard, name);
+    item->setText(kNodes, QString::number(shard.nodes_count));
+    item->setText(kOpsPerSec, QString::number(shard.ops_per_sec));
+    item->setText(kMemory, MemoryText(shard.used_memory));
+    item->setText(kHitRatio, RatioText(shard.hit_ratio));
+    item->setText(kReplicationLag, QString::number(shard.replication_lag));
+    item->setText(kEvictionsPerSec, QString::number(shard.evictions_per_sec, 'f', 1));
+    if (i == 0) {
+      QFont font = item->font(kShard);
+      font.setBold(true);
+      for (int column = 0; column < kColumnsCount; ++column) {
+        item->setFont(column, font);
+      }
+    } else {
+      HeatMapWidget::Cell cell;
+      cell.label = name;
+      cell.value = static_cast<double>(shard.ops_per_sec);
+      cell.tooltip = trShardTooltipTemplate_4S.arg(name)
+                         .arg(shard.ops_per_sec)
+                         .arg(MemoryText(shard.used_memory))
+                         .arg(RatioText(shard.hit_ratio));
+      cells.push_back(cell);
+    }
+    shards_table_->addTopLevelItem(item);
+  }
+  heat_map_->setCells(cells);
+
+  common::qt::gui::GraphWidget::nodes_container_type graph_nodes;
+  for (const proxy::NodesStatsPoint& history_point : series_.GetPoints()) {
+    graph_nodes.push_back(std::make_pair(history_point.timestamp, static_cast<qreal>(history_point.total.ops_per_sec)));
+  }
+  graph_widget_->setNodes(graph_nodes);
+}
+
+void NodesDashboardDialog::updateStatus() {
+  status_label_->setText(trNodesStatusTemplate_2S.arg(nodes_.size()).arg(failed_nodes_.size()));
+}
+
+void NodesDashboardDialog::retranslateUi() {
+  refresh_label_->setText(trRefreshEverySec);
+  shards_table_->setHeaderLabels({trShard, trNodes, trOpsPerSec, trMemory, trHitRatio, trReplicationLag,
+                                  trEvictionsPerSec});
+  updateStatus();
+  base_class::retranslateUi();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
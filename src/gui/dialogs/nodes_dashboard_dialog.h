@@ -0,0 +1,105 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <common/error.h>
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/nodes_stats.h"
+#include "proxy/proxy_fwd.h"
+
+class QLabel;
+class QSpinBox;
+class QTreeWidget;
+
+namespace common {
+namespace qt {
+namespace gui {
+class GraphWidget;
+}  // namespace gui
+}  // namespace qt
+}  // namespace common
+
+namespace fastonosql {
+namespace gui {
+class HeatMapWidget;
+class NodesInfoPoller;
+
+// aggregated INFO of all nodes of a cluster or sentinel: per shard and total throughput,
+// memory, hit ratio, replication lag and evictions, refreshed at a fixed rate
+class NodesDashboardDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+  enum { min_width = 800, min_height = 600, min_refresh_sec = 1, max_refresh_sec = 60, default_refresh_sec = 1 };
+  enum Column {
+    kShard = 0,
+    kNodes,
+    kOpsPerSec,
+    kMemory,
+    kHitRatio,
+    kReplicationLag,
+    kEvictionsPerSec,
+    kColumnsCount
+  };
+
+ private Q_SLOTS:
+  void nodeSampled(const std::string& node, const proxy::NodeInfoSample& sample);
+  void nodeFailed(const std::string& node, common::Error err);
+  void refreshRateChanged(int value);
+
+ protected:
+  NodesDashboardDialog(const QString& title,
+                       const QIcon& icon,
+                       const std::vector<proxy::IServerSPtr>& nodes,
+                       QWidget* parent = Q_NULLPTR);
+
+  void showEvent(QShowEvent* e) override;
+  void hideEvent(QHideEvent* e) override;
+  void timerEvent(QTimerEvent* event) override;
+
+  void retranslateUi() override;
+
+ private:
+  void render(const proxy::NodesStatsPoint& point);
+  void updateStatus();
+
+  QLabel* refresh_label_;
+  QSpinBox* refresh_spin_;
+  QLabel* status_label_;
+  HeatMapWidget* heat_map_;
+  QTreeWidget* shards_table_;
+  common::qt::gui::GraphWidget* graph_widget_;
+
+  NodesInfoPoller* poller_;
+  const std::vector<proxy::IServerSPtr> nodes_;
+  proxy::NodesStatsSeries series_;
+  std::vector<std::string> failed_nodes_;
+  int refresh_timer_id_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,574 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/dialogs/stream_browser_dialog.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <vector>
+
+#include <QDateTime>
+#include <QDateTimeEdit>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QItemSelectionModel>
+#include <QLabel>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTabWidget>
+
+#include <common/convert2string.h>
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/value.h>
+
+#include "proxy/server/iserver.h"
+
+#include "gui/models/records_table_model.h"
+#include "gui/views/fasto_table_view.h"
+
+#include "translations/global.h"
+
+#define REDIS_XRANGE_COMMAND "XRANGE"
+#define REDIS_XREVRANGE_COMMAND "XREVRANGE"
+#define REDIS_XINFO_GROUPS_COMMAND "XINFO GROUPS"
+#define REDIS_XINFO_CONSUMERS_COMMAND "XINFO CONSUMERS"
+#define REDIS_XPENDING_COMMAND "XPENDING"
+#define COUNT_ARG "COUNT"
+#define STREAM_MIN_ID "-"
+#define STREAM_MAX_ID "+"
+
+namespace {
+const QString trEntries = QObject::tr("Entries");
+const QString trGroups = QObject::tr("Consumer groups");
+const QString trFirst = QObject::tr("First");
+const QString trPrevious = QObject::tr("Previous");
+const QString trNext = QObject::tr("Next");
+const QString trLast = QObject::tr("Last");
+const QString trJump = QObject::tr("Jump to time");
+const QString trId = QObject::tr("ID");
+const QString trTime = QObject::tr("Time");
+const QString trFields = QObject::tr("Fields");
+const QString trName = QObject::tr("Name");
+const QString trConsumers = QObject::tr("Consumers");
+const QString trPending = QObject::tr("Pending");
+const QString trLastDelivered = QObject::tr("Last delivered ID");
+const QString trLag = QObject::tr("Lag");
+const QString trIdle = QObject::tr("Idle (msec)");
+const QString trConsumer = QObject::tr("Consumer");
+const QString trDeliveries = QObject::tr("Deliveries");
+const QString trWindowTemplate_3S = QObject::tr("%1 ... %2 of %3 entries");
+const QString trNoEntries = QObject::tr("No entries in this direction");
+const QString trConsumersOfTemplate_1S = QObject::tr("Consumers of %1");
+const QString trPendingOfTemplate_1S = QObject::tr("Pending entries of %1");
+const char* kTimeFormat = "yyyy-MM-dd hh:mm:ss.zzz";
+
+bool ParseStreamId(const QString& id, quint64* ms, quint64* seq) {
+  const int dash = id.indexOf('-');
+  if (dash == -1) {
+    return false;
+  }
+
+  bool ms_ok, seq_ok;
+  *ms = id.left(dash).toULongLong(&ms_ok);
+  *seq = id.mid(dash + 1).toULongLong(&seq_ok);
+  return ms_ok && seq_ok;
+}
+
+QString MakeStreamId(quint64 ms, quint64 seq) {
+  return QString::number(ms) + "-" + QString::number(seq);
+}
+
+// XRANGE exclusive ranges need Redis 6.2, the nearest id keeps windows working on older servers
+bool NextStreamId(const QString& id, QString* out) {
+  quint64 ms, seq;
+  if (!ParseStreamId(id, &ms, &seq)) {
+    return false;
+  }
+
+  if (seq == std::numeric_limits<quint64>::max()) {
+    if (ms == std::numeric_limits<quint64>::max()) {
+      return false;
+    }
+    *out = MakeStreamId(ms + 1, 0);
+    return true;
+  }
+
+  *out = MakeStreamId(ms, seq + 1);
+  return true;
+}
+
+bool PreviousStreamId(const QString& id, QString* out) {
+  quint64 ms, seq;
+  if (!ParseStreamId(id, &ms, &seq)) {
+    return false;
+  }
+
+  if (seq == 0) {
+    if (ms == 0) {
+      return false;
+    }
+    *out = MakeStreamId(ms - 1, std::numeric_limits<quint64>::max());
+    return true;
+  }
+
+  *out = MakeStreamId(ms, seq - 1);
+  return true;
+}
+
+QString ValueText(common::Value* value) {
+  QString text;
+  if (value) {
+    common::ConvertFromBytes(fastonosql::core::ConvertValue(value, fastonosql::core::NValue::default_delimiter),
+                             &text);
+  }
+  return text;
+}
+
+std::vector<common::Value*> ArrayItems(common::ArrayValue* array) {
+  std::vector<common::Value*> items;
+  if (array) {
+    for (auto it = array->begin(); it != array->end(); ++it) {
+      items.push_back(*it);
+    }
+  }
+  return items;
+}
+
+// XINFO replies are flat name/value arrays
+std::map<QString, QString> FlatMap(common::Value* value) {
+  std::map<QString, QString> result;
+  common::ArrayValue* array = nullptr;
+  if (!value || !value->GetAsList(&array)) {
+    return result;
+  }
+
+  const std::vector<common::Value*> items = ArrayItems(array);
+  for (size_t i = 0; i + 1 < items.size(); i += 2) {
+    result[ValueText(items[i])] = ValueText(items[i + 1]);
+  }
+  return result;
+}
+
+QString MapValue(const std::map<QString, QString>& map, const QString& name) {
+  const auto it = map.find(name);
+  return it == map.end() ? QString() : it->second;
+}
+
+fastonosql::core::command_buffer_t Argument(const QString& text) {
+  return fastonosql::core::ReadableString(common::ConvertToCharBytes(text)).GetForCommandLine();
+}
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+StreamBrowserDialog::StreamBrowserDialog(const QString& title,
+                                         const QIcon& icon,
+                                         proxy::IServerSPtr server,
+                                         const core::NKey& key,
+                                         size_t entries_count,
+                                         QWidget* parent)
+    : base_class(title, parent),
+      first_button_(nullptr),
+      previous_button_(nullptr),
+      next_button_(nullptr),
+      last_button_(nullptr),
+      jump_edit_(nullptr),
+      jump_button_(nullptr),
+      window_label_(nullptr),
+      tabs_(nullptr),
+      entries_table_(nullptr),
+      entries_model_(nullptr),
+      refresh_groups_button_(nullptr),
+      groups_table_(nullptr),
+      groups_model_(nullptr),
+      consumers_label_(nullptr),
+      consumers_table_(nullptr),
+      consumers_model_(nullptr),
+      pending_label_(nullptr),
+      pending_table_(nullptr),
+      pending_model_(nullptr),
+      server_(server),
+      key_(key),
+      entries_count_(entries_count),
+      first_id_(),
+      last_id_(),
+      group_(),
+      pending_next_id_(),
+      group_generation_(0),
+      pending_() {
+  CHECK(server_);
+  setWindowIcon(icon);
+
+  VERIFY(connect(server.get(), &proxy::IServer::ExecuteFinished, this, &StreamBrowserDialog::finishExecuteCommand));
+
+  // entries
+  QHBoxLayout* navigation_layout = new QHBoxLayout;
+  first_button_ = new QPushButton;
+  VERIFY(connect(first_button_, &QPushButton::clicked, this, &StreamBrowserDialog::firstClicked));
+  previous_button_ = new QPushButton;
+  VERIFY(connect(previous_button_, &QPushButton::clicked, this, &StreamBrowserDialog::previousClicked));
+  next_button_ = new QPushButton;
+  VERIFY(connect(next_button_, &QPushButton::clicked, this, &StreamBrowserDialog::nextClicked));
+  last_button_ = new QPushButton;
+  VERIFY(connect(last_button_, &QPushButton::clicked, this, &StreamBrowserDialog::lastClicked));
+  jump_edit_ = new QDateTimeEdit(QDateTime::currentDateTime());
+  jump_edit_->setDisplayFormat(kTimeFormat);
+  jump_edit_->setCalendarPopup(true);
+  jump_button_ = new QPushButton;
+  VERIFY(connect(jump_button_, &QPushButton::clicked, this, &StreamBrowserDialog::jumpClicked));
+  window_label_ = new QLabel;
+  navigation_layout->addWidget(first_button_);
+  navigation_layout->addWidget(previous_button_);
+  navigation_layout->addWidget(next_button_);
+  navigation_layout->addWidget(last_button_);
+  navigation_layout->addWidget(window_label_);
+  navigation_layout->addWidget(new QSplitter(Qt::Horizontal));
+  navigation_layout->addWidget(jump_edit_);
+  navigation_layout->addWidget(jump_button_);
+
+  entries_model_ = new RecordsTableModel(QStringList() << trId << trTime << trFields, this);
+  entries_table_ = new FastoTableView;
+  entries_table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+  entries_table_->setModel(entries_model_);
+  entries_table_->horizontalHeader()->setStretchLastSection(true);
+
+  QVBoxLayout* entries_layout = new QVBoxLayout;
+  entries_layout->addLayout(navigation_layout);
+  entries_layout->addWidget(entries_table_);
+  QWidget* entries_widget = new QWidget;
+  entries_widget->setLayout(entries_layout);
+
+  // groups
+  refresh_groups_button_ = new QPushButton;
+  VERIFY(connect(refresh_groups_button_, &QPushButton::clicked, this, &StreamBrowserDialog::refreshGroupsClicked));
+  QHBoxLayout* groups_control_layout = new QHBoxLayout;
+  groups_control_layout->addWidget(new QSplitter(Qt::Horizontal));
+  groups_control_layout->addWidget(refresh_groups_button_);
+
+  groups_model_ = new RecordsTableModel(QStringList() << trName << trConsumers << trPending << trLastDelivered << trLag,
+                                        this);
+  groups_table_ = new FastoTableView;
+  groups_table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+  groups_table_->setSelectionMode(QAbstractItemView::SingleSelection);
+  groups_table_->setModel(groups_model_);
+  VERIFY(connect(groups_table_->selectionModel(), &QItemSelectionModel::currentRowChanged, this,
+                 &StreamBrowserDialog::groupChange));
+
+  consumers_label_ = new QLabel;
+  consumers_model_ = new RecordsTableModel(QStringList() << trName << trPending << trIdle, this);
+  consumers_table_ = new FastoTableView;
+  consumers_table_->setModel(consumers_model_);
+
+  pending_label_ = new QLabel;
+  pending_model_ = new RecordsTableModel(QStringList() << trId << trConsumer << trIdle << trDeliveries, this);
+  VERIFY(connect(pending_model_, &RecordsTableModel::fetchRequested, this, &StreamBrowserDialog::fetchPending));
+  pending_table_ = new FastoTableView;
+  pending_table_->setModel(pending_model_);
+
+  QHBoxLayout* details_layout = new QHBoxLayout;
+  QVBoxLayout* consumers_layout = new QVBoxLayout;
+  consumers_layout->addWidget(consumers_label_);
+  consumers_layout->addWidget(consumers_table_);
+  QVBoxLayout* pending_layout = new QVBoxLayout;
+  pending_layout->addWidget(pending_label_);
+  pending_layout->addWidget(pending_table_);
+  details_layout->addLayout(consumers_layout);
+  details_layout->addLayout(pending_layout);
+
+  QVBoxLayout* groups_layout = new QVBoxLayout;
+  groups_layout->addLayout(groups_control_layout);
+  groups_layout->addWidget(groups_table_);
+  groups_layout->addLayout(details_layout);
+  QWidget* groups_widget = new QWidget;
+  groups_widget->setLayout(groups_layout);
+
+  tabs_ = new QTabWidget;
+  tabs_->addTab(entries_widget, trEntries);
+  tabs_->addTab(groups_widget, trGroups);
+
+  QDialogButtonBox* button_box = new QDialogButtonBox(QDialogButtonBox::Close);
+  button_box->setOrientation(Qt::Horizontal);
+  VERIFY(connect(button_box, &QDialogButtonBox::rejected, this, &StreamBrowserDialog::reject));
+
+  QVBoxLayout* main_layout = new QVBoxLayout;
+  main_layout->addWidget(tabs_);
+  main_layout->addWidget(button_box);
+  setLayout(main_layout);
+  setMinimumSize(QSize(min_width, min_height));
+}
+
+void StreamBrowserDialog::finishExecuteCommand(const proxy::events_info::ExecuteInfoResponse& res) {
+  if (res.initiator() != this || pending_.empty()) {
+    return;
+  }
+
+  const PendingRequest request = pending_.front();
+  pending_.pop_front();
+
+  const bool is_group_request = request.type == kConsumers || request.type == kPending;
+  if (is_group_request && request.generation != group_generation_) {
+    return;
+  }
+
+  common::ArrayValue* reply = nullptr;
+  common::Error err = res.errorInfo();
+  if (!err && res.executed_commands.size() == 1) {
+    const auto childs = res.executed_commands[0]->GetChildrens();
+    if (childs.size() == 1 && childs[0]->GetValue()) {
+      childs[0]->GetValue()->GetAsList(&reply);
+    }
+  }
+
+  if (!reply) {
+    if (request.type == kPending) {
+      pending_model_->cancelFetch();
+    }
+    if (err && (request.type == kEntries || request.type == kEntriesReverse)) {
+      window_label_->setText(QString::fromStdString(err->GetDescription()));
+    }
+    return;
+  }
+
+  if (request.type == kEntries || request.type == kEntriesReverse) {
+    handleEntries(reply, request.type == kEntriesReverse);
+  } else if (request.type == kGroups) {
+    handleGroups(reply);
+  } else if (request.type == kConsumers) {
+    handleConsumers(reply);
+  } else if (request.type == kPending) {
+    handlePending(reply);
+  }
+}
+
+void StreamBrowserDialog::firstClicked() {
+  requestEntries(STREAM_MIN_ID, STREAM_MAX_ID, false);
+}
+
+void StreamBrowserDialog::previousClicked() {
+  QString end;
+  if (!PreviousStreamId(first_id_, &end)) {
+    firstClicked();
+    return;
+  }
+
+  requestEntries(end, STREAM_MIN_ID, true);
+}
+
+void StreamBrowserDialog::nextClicked() {
+  QString start;
+  if (!NextStreamId(last_id_, &start)) {
+    lastClicked();
+    return;
+  }
+
+  requestEntries(start, STREAM_MAX_ID, false);
+}
+
+void StreamBrowserDialog::lastClicked() {
+  requestEntries(STREAM_MAX_ID, STREAM_MIN_ID, true);
+}
+
+void StreamBrowserDialog::jumpClicked() {
+  // entry ids start with the millisecond unix time they were added at
+  const qint64 msec = std::max<qint64>(jump_edit_->dateTime().toMSecsSinceEpoch(), 0);
+  requestEntries(MakeStreamId(msec, 0), STREAM_MAX_ID, false);
+}
+
+void StreamBrowserDialog::refreshGroupsClicked() {
+  core::command_buffer_writer_t wr;
+  wr << REDIS_XINFO_GROUPS_COMMAND SPACE_STR << key_.GetKey().GetForCommandLine();
+  execute(wr.str(), kGroups, group_generation_);
+}
+
+void StreamBrowserDialog::groupChange(const QModelIndex& current, const QModelIndex& previous) {
+  UNUSED(previous);
+
+  group_generation_++;
+  consumers_model_->clear();
+  pending_model_->clear();
+  const QStringList group = groups_model_->record(current.row());
+  if (group.isEmpty()) {
+    group_.clear();
+    consumers_label_->clear();
+    pending_label_->clear();
+    return;
+  }
+
+  group_ = group[0];
+  consumers_label_->setText(trConsumersOfTemplate_1S.arg(group_));
+  pending_label_->setText(trPendingOfTemplate_1S.arg(group_));
+
+  core::command_buffer_writer_t wr;
+  wr << REDIS_XINFO_CONSUMERS_COMMAND SPACE_STR << key_.GetKey().GetForCommandLine() << SPACE_STR
+     << Argument(group_);
+  execute(wr.str(), kConsumers, group_generation_);
+
+  pending_next_id_ = STREAM_MIN_ID;
+  fetchPending();
+}
+
+void StreamBrowserDialog::fetchPending() {
+  if (group_.isEmpty()) {
+    pending_model_->cancelFetch();
+    return;
+  }
+
+  core::command_buffer_writer_t wr;
+  wr << REDIS_XPENDING_COMMAND SPACE_STR << key_.GetKey().GetForCommandLine() << SPACE_STR << Argument(group_)
+     << SPACE_STR << common::ConvertToCharBytes(pending_next_id_) << SPACE_STR STREAM_MAX_ID SPACE_STR
+     << common::ConvertToCharBytes(static_cast<size_t>(pending_page_size));
+  execute(wr.str(), kPending, group_generation_);
+}
+
+void StreamBrowserDialog::showEvent(QShowEvent* e) {
+  base_class::showEvent(e);
+  lastClicked();
+  refreshGroupsClicked();
+}
+
+void StreamBrowserDialog::retranslateUi() {
+  first_button_->setText(trFirst);
+  previous_button_->setText(trPrevious);
+  next_button_->setText(trNext);
+  last_button_->setText(trLast);
+  jump_button_->setText(trJump);
+  refresh_groups_button_->setText(translations::trRefresh);
+  tabs_->setTabText(0, trEntries);
+  tabs_->setTabText(1, trGroups);
+  base_class::retranslateUi();
+}
+
+void StreamBrowserDialog::requestEntries(const QString& start, const QString& end, bool reverse) {
+  core::command_buffer_writer_t wr;
+  wr << (reverse ? REDIS_XREVRANGE_COMMAND : REDIS_XRANGE_COMMAND) << SPACE_STR << key_.GetKey().GetForCommandLine()
+     << SPACE_STR << common::ConvertToCharBytes(start) << SPACE_STR << common::ConvertToCharBytes(end)
+     << SPACE_STR COUNT_ARG SPACE_STR << common::ConvertToCharBytes(static_cast<size_t>(window_size));
+  execute(wr.str(), reverse ? kEntriesReverse : kEntries, 0);
+}
+
+void StreamBrowserDialog::execute(const core::command_buffer_t& cmd, RequestType type, size_t generation) {
+  pending_.push_back({type, generation});
+  proxy::events_info::ExecuteInfoRequest req(this, cmd, 0, 0, false, true, core::C_INNER);
+  server_->Execute(req);
+}
+
+void StreamBrowserDialog::handleEntries(common::ArrayValue* reply, bool reverse) {
+  std::vector<QStringList> records;
+  for (common::Value* item : ArrayItems(reply)) {
+    common::ArrayValue* entry = nullptr;
+    if (!item->GetAsList(&entry)) {
+      continue;
+    }
+
+    const std::vector<common::Value*> parts = ArrayItems(entry);
+    if (parts.size() != 2) {
+      continue;
+    }
+
+    const QString id = ValueText(parts[0]);
+    quint64 ms, seq;
+    QString time;
+    if (ParseStreamId(id, &ms, &seq)) {
+      time = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(ms)).toString(kTimeFormat);
+    }
+
+    QStringList fields;
+    common::ArrayValue* fields_array = nullptr;
+    if (parts[1]->GetAsList(&fields_array)) {
+      const std::vector<common::Value*> pairs = ArrayItems(fields_array);
+      for (size_t i = 0; i + 1 < pairs.size(); i += 2) {
+        fields << ValueText(pairs[i]) + ": " + ValueText(pairs[i + 1]);
+      }
+    }
+    records.push_back(QStringList() << id << time << fields.join(", "));
+  }
+
+  if (records.empty()) {
+    window_label_->setText(trNoEntries);
+    return;
+  }
+
+  // windows are always shown in ascending id order
+  if (reverse) {
+    std::reverse(records.begin(), records.end());
+  }
+  first_id_ = records.front()[0];
+  last_id_ = records.back()[0];
+  entries_model_->setRecords(records);
+  window_label_->setText(trWindowTemplate_3S.arg(first_id_, last_id_).arg(entries_count_));
+}
+
+void StreamBrowserDialog::handleGroups(common::ArrayValue* reply) {
+  std::vector<QStringList> records;
+  for (common::Value* item : ArrayItems(reply)) {
+    const std::map<QString, QString> group = FlatMap(item);
+    // lag is reported since Redis 7.0
+    records.push_back(QStringList() << MapValue(group, "name") << MapValue(group, "consumers")
+                                    << MapValue(group, "pending") << MapValue(group, "last-delivered-id")
+                                    << MapValue(group, "lag"));
+  }
+
+  group_generation_++;
+  group_.clear();
+  consumers_model_->clear();
+  pending_model_->clear();
+  consumers_label_->clear();
+  pending_label_->clear();
+  groups_model_->setRecords(records);
+}
+
+void StreamBrowserDialog::handleConsumers(common::ArrayValue* reply) {
+  std::vector<QStringList> records;
+  for (common::Value* item : ArrayItems(reply)) {
+    const std::map<QString, QString> consumer = FlatMap(item);
+    records.push_back(QStringList() << MapValue(consumer, "name") << MapValue(consumer, "pending")
+                                    << MapValue(consumer, "idle"));
+  }
+  consumers_model_->setRecords(records);
+}
+
+void StreamBrowserDialog::handlePending(common::ArrayValue* reply) {
+  std::vector<QStringList> records;
+  for (common::Value* item : ArrayItems(reply)) {
+    common::ArrayValue* entry = nullptr;
+    if (!item->GetAsList(&entry)) {
+      continue;
+    }
+
+    // id, consumer, idle msec, delivery count
+    const std::vector<common::Value*> parts = ArrayItems(entry);
+    if (parts.size() != 4) {
+      continue;
+    }
+    records.push_back(QStringList() << ValueText(parts[0]) << ValueText(parts[1]) << ValueText(parts[2])
+                                    << ValueText(parts[3]));
+  }
+
+  bool has_more = records.size() == static_cast<size_t>(pending_page_size);
+  if (has_more && !NextStreamId(records.back()[0], &pending_next_id_)) {
+    has_more = false;
+  }
+  pending_model_->appendRecords(records, has_more);
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,127 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+
+#include <fastonosql/core/db_key.h>
+
+#include "gui/dialogs/base_dialog.h"
+
+#include "proxy/proxy_fwd.h"
+
+class QDateTimeEdit;
+class QLabel;
+class QPushButton;
+class QTabWidget;
+
+namespace fastonosql {
+namespace proxy {
+namespace events_info {
+struct ExecuteInfoResponse;
+}  // namespace events_info
+}  // namespace proxy
+namespace gui {
+class FastoTableView;
+class RecordsTableModel;
+
+// stream too big to load at once, entries are shown by XRANGE/XREVRANGE id windows,
+// consumer groups by XINFO and pending entries by ranged XPENDING pages
+class StreamBrowserDialog : public BaseDialog {
+  Q_OBJECT
+
+ public:
+  typedef BaseDialog base_class;
+  template <typename T, typename... Args>
+  friend T* createDialog(Args&&... args);
+  enum { min_width = 900, min_height = 600, window_size = 200, pending_page_size = 200 };
+
+ private Q_SLOTS:
+  void finishExecuteCommand(const proxy::events_info::ExecuteInfoResponse& res);
+
+  void firstClicked();
+  void previousClicked();
+  void nextClicked();
+  void lastClicked();
+  void jumpClicked();
+  void refreshGroupsClicked();
+  void groupChange(const QModelIndex& current, const QModelIndex& previous);
+  void fetchPending();
+
+ protected:
+  StreamBrowserDialog(const QString& title,
+                      const QIcon& icon,
+                      proxy::IServerSPtr server,
+                      const core::NKey& key,
+                      size_t entries_count,
+                      QWidget* parent = Q_NULLPTR);
+
+  void showEvent(QShowEvent* e) override;
+
+  void retranslateUi() override;
+
+ private:
+  enum RequestType { kEntries, kEntriesReverse, kGroups, kConsumers, kPending };
+  struct PendingRequest {
+    RequestType type;
+    size_t generation;
+  };
+
+  void requestEntries(const QString& start, const QString& end, bool reverse);
+  void execute(const core::command_buffer_t& cmd, RequestType type, size_t generation);
+
+  void handleEntries(common::ArrayValue* reply, bool reverse);
+  void handleGroups(common::ArrayValue* reply);
+  void handleConsumers(common::ArrayValue* reply);
+  void handlePending(common::ArrayValue* reply);
+
+  QPushButton* first_button_;
+  QPushButton* previous_button_;
+  QPushButton* next_button_;
+  QPushButton* last_button_;
+  QDateTimeEdit* jump_edit_;
+  QPushButton* jump_button_;
+  QLabel* window_label_;
+  QTabWidget* tabs_;
+  FastoTableView* entries_table_;
+  RecordsTableModel* entries_model_;
+  QPushButton* refresh_groups_button_;
+  FastoTableView* groups_table_;
+  RecordsTableModel* groups_model_;
+  QLabel* consumers_label_;
+  FastoTableView* consumers_table_;
+  RecordsTableModel* consumers_model_;
+  QLabel* pending_label_;
+  FastoTableView* pending_table_;
+  RecordsTableModel* pending_model_;
+
+  proxy::IServerSPtr server_;
+  const core::NKey key_;
+  const size_t entries_count_;
+
+  QString first_id_;
+  QString last_id_;
+  QString group_;
+  QString pending_next_id_;
+  size_t group_generation_;
+  std::deque<PendingRequest> pending_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
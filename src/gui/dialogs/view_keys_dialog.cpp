@@ -46,6 +46,7 @@ const QSize ViewKeysDialog::kIconSize = QSize(24, 24);
 ViewKeysDialog::ViewKeysDialog(const QString& title, proxy::IDatabaseSPtr db, QWidget* parent)
     : base_class(title, parent),
       cursor_stack_(),
+      key_cursor_stack_(),
       cur_pos_(0),
       search_box_(nullptr),
       key_count_label_(nullptr),
@@ -157,6 +158,7 @@ void ViewKeysDialog::finishLoadDatabaseContent(const proxy::events_info::LoadDat
   int curv = current_key_->value();
   if (cursor_stack_.size() == cur_pos_) {
     cursor_stack_.push_back(res.cursor_out);
+    key_cursor_stack_.push_back(res.key_cursor_out);
     current_key_->setValue(curv + size);
   } else {
     current_key_->setValue(curv - size);
@@ -202,18 +204,22 @@ void ViewKeysDialog::search(bool forward) {
 
   if (cursor_stack_.empty()) {
     cursor_stack_.push_back(0);
+    key_cursor_stack_.push_back(core::command_buffer_t());
   }
 
   DCHECK_EQ(cursor_stack_[0], 0);
   if (forward) {
     proxy::events_info::LoadDatabaseContentRequest req(this, db_->GetInfo(), common::ConvertToString(pattern),
-                                                       count_spin_edit_->value(), cursor_stack_[cur_pos_]);
+                                                       count_spin_edit_->value(), cursor_stack_[cur_pos_],
+                                                       key_cursor_stack_[cur_pos_]);
     db_->LoadContent(req);
     ++cur_pos_;
   } else {
     if (cur_pos_ > 0) {
+      --cur_pos_;
       proxy::events_info::LoadDatabaseContentRequest req(this, db_->GetInfo(), common::ConvertToString(pattern),
-                                                         count_spin_edit_->value(), cursor_stack_[--cur_pos_]);
+                                                         count_spin_edit_->value(), cursor_stack_[cur_pos_],
+                                                         key_cursor_stack_[cur_pos_]);
       db_->LoadContent(req);
     }
   }
@@ -223,6 +229,7 @@ void ViewKeysDialog::searchLineChanged(const QString& text) {
   UNUSED(text);
 
   cursor_stack_.clear();
+  key_cursor_stack_.clear();
   cur_pos_ = 0;
   current_key_->setValue(0);
   updateControls();
@@ -86,6 +86,7 @@ class ViewKeysDialog : public BaseDialog {
   size_t keysCount() const;
 
   std::vector<uint64_t> cursor_stack_;
+  std::vector<core::command_buffer_t> key_cursor_stack_;  // seek based engines resume from key
   uint32_t cur_pos_;
   QLineEdit* search_box_;
   QLabel* key_count_label_;
@@ -19,6 +19,7 @@
 #include "gui/explorer/explorer_tree_view.h"
 
 #include <string>
+#include <vector>
 
 #include <QApplication>
 #include <QClipboard>
@@ -36,26 +37,45 @@
 
 #include <common/qt/gui/regexp_input_dialog.h>
 
+#include <fastonosql/core/macros.h>
+#include <fastonosql/core/value.h>
+
 #include "proxy/cluster/icluster.h"
 #include "proxy/sentinel/isentinel.h"
 #include "proxy/server/iserver_remote.h"
 
+#include "gui/dialogs/big_keys_dialog.h"
+#include "gui/dialogs/bulk_delete_dialog.h"
 #include "gui/dialogs/clients_monitor_dialog.h"
+#include "gui/dialogs/collection_browser_dialog.h"
+#include "gui/dialogs/compare_dialog.h"
 #include "gui/dialogs/dbkey_dialog.h"
 #include "gui/dialogs/history_server_dialog.h"
 #include "gui/dialogs/info_server_dialog.h"
+#include "gui/dialogs/large_value_dialog.h"
 #include "gui/dialogs/load_contentdb_dialog.h"
+#include "gui/dialogs/migration_dialog.h"
+#include "gui/dialogs/nodes_dashboard_dialog.h"
 #include "gui/dialogs/property_server_dialog.h"
 #include "gui/dialogs/pub_sub_dialog.h"
+#include "gui/dialogs/stream_browser_dialog.h"
 #include "gui/dialogs/view_keys_dialog.h"
 
 #include "gui/gui_factory.h"
 #include "gui/models/explorer_tree_model.h"
 #include "gui/models/explorer_tree_sort_filter_proxy_model.h"
 #include "gui/models/items/explorer_tree_item.h"
+#include "gui/workers/key_search_index.h"
 
 #include "translations/global.h"
 
+#define REDIS_STRLEN_COMMAND "STRLEN"
+#define REDIS_HLEN_COMMAND "HLEN"
+#define REDIS_SCARD_COMMAND "SCARD"
+#define REDIS_ZCARD_COMMAND "ZCARD"
+#define REDIS_LLEN_COMMAND "LLEN"
+#define REDIS_XLEN_COMMAND "XLEN"
+
 namespace {
 const QString trRemoveDatabaseTemplate_1S = QObject::tr("Really remove database %1?");
 const QString trRealyRemoveAllKeysTemplate_1S = QObject::tr("Really remove all keys from %1 database?");
@@ -64,6 +84,14 @@ const QString trCreateKeyForDbTemplate_1S = QObject::tr("Create key for %1 datab
 const QString trEditKey_1S = QObject::tr("Edit key %1");
 const QString trRemoveAllKeysTemplate_1S = QObject::tr("Really remove all keys from branch %1?");
 const QString trViewKeyTemplate_1S = QObject::tr("View keys in %1 database");
+const QString trFindBigKeys = QObject::tr("Find big keys");
+const QString trFindBigKeysTemplate_1S = QObject::tr("Find big keys in %1 database");
+const QString trDeleteByPattern = QObject::tr("Delete by pattern...");
+const QString trDeleteByPatternTemplate_1S = QObject::tr("Delete keys by pattern in %1 database");
+const QString trMigrateData = QObject::tr("Migrate data...");
+const QString trMigrateDataTemplate_1S = QObject::tr("Migrate data from %1");
+const QString trCompareWith = QObject::tr("Compare with...");
+const QString trCompareTemplate_1S = QObject::tr("Compare %1");
 const QString trViewChannelsTemplate_1S = QObject::tr("View channels in %1 server");
 const QString trViewClientsTemplate_1S = QObject::tr("View clients in %1 server");
 const QString trClearDb = QObject::tr("Clear database");
@@ -81,6 +109,25 @@ const QString trCreateDatabase_1S = QObject::tr("Create database on %1 server");
 const QString trPropertiesTemplate_1S = QObject::tr("%1 properties");
 const QString trHistoryTemplate_1S = QObject::tr("%1 history");
 const QString trCopyToClipboard = QObject::tr("Copy to clipboard");
+const QString trLargeValueTemplate_1S = QObject::tr("Large value of %1 key");
+const QString trLargeCollectionTemplate_1S = QObject::tr("Elements of %1 key");
+const QString trStreamTemplate_1S = QObject::tr("Stream %1");
+const QString trDashboard = QObject::tr("Dashboard");
+const QString trDashboardTemplate_1S = QObject::tr("%1 dashboard");
+const size_t kLargeValueThreshold = 8 * 1024 * 1024;
+const size_t kLargeCollectionThreshold = 10000;
+
+// SCAN MATCH is glob style, branch names may contain its special characters
+QString EscapeGlob(const QString& text) {
+  QString escaped;
+  for (const QChar ch : text) {
+    if (ch == '*' || ch == '?' || ch == '[' || ch == ']' || ch == '\\') {
+      escaped += '\\';
+    }
+    escaped += ch;
+  }
+  return escaped;
+}
 }  // namespace
 
 namespace fastonosql {
@@ -94,6 +141,10 @@ ExplorerTreeView::ExplorerTreeView(QWidget* parent) : QTreeView(parent) {
   proxy_model_->setSortRole(Qt::DisplayRole);
   setModel(proxy_model_);
 
+  search_index_ = new KeySearchIndex(this);
+  VERIFY(connect(search_index_, &KeySearchIndex::matched, proxy_model_,
+                 &ExplorerTreeSortFilterProxyModel::setMatchSet));
+
   setSortingEnabled(true);
   sortByColumn(0, Qt::AscendingOrder);
 
@@ -123,6 +174,7 @@ void ExplorerTreeView::removeServer(proxy::IServerSPtr server) {
   }
 
   unsyncWithServer(server.get());
+  search_index_->removeServer(server.get());
   source_model_->removeServer(server);
   emit serverClosed(server);
 }
@@ -196,8 +248,11 @@ void ExplorerTreeView::removeCluster(proxy::IClusterSPtr cluster) {
 #endif
 
 void ExplorerTreeView::changeTextFilter(const QString& text) {
-  QRegularExpression regExp(text);
-  proxy_model_->setFilterRegularExpression(regExp);
+  search_index_->search(text);
+}
+
+void ExplorerTreeView::setSearchValues(bool search_values) {
+  search_index_->setSearchValues(search_values);
 }
 
 void ExplorerTreeView::showContextMenu(const QPoint& point) {
@@ -251,6 +306,17 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
     info_server_action->setEnabled(is_connected);
     menu.addAction(info_server_action);
 
+    QAction* migrate_action = new QAction(trMigrateData, this);
+    VERIFY(connect(migrate_action, &QAction::triggered, this, &ExplorerTreeView::openMigrationDialog));
+    menu.addAction(migrate_action);
+
+    const core::ConnectionType ct = server->GetType();
+    if (ct == core::REDIS || ct == core::KEYDB) {
+      QAction* compare_action = new QAction(trCompareWith, this);
+      VERIFY(connect(compare_action, &QAction::triggered, this, &ExplorerTreeView::openCompareDialog));
+      menu.addAction(compare_action);
+    }
+
     if (is_redis) {
       QAction* property_server_action = new QAction(translations::trProperty, this);
       VERIFY(connect(property_server_action, &QAction::triggered, this, &ExplorerTreeView::openPropertyServerDialog));
@@ -346,6 +412,19 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
     menu.addAction(view_keys_action);
     view_keys_action->setEnabled(is_default && is_connected);
 
+    const core::ConnectionType ct = server->GetType();
+    if (ct == core::REDIS || ct == core::KEYDB) {
+      QAction* find_big_keys_action = new QAction(trFindBigKeys, this);
+      VERIFY(connect(find_big_keys_action, &QAction::triggered, this, &ExplorerTreeView::findBigKeys));
+      find_big_keys_action->setEnabled(is_default && is_connected);
+      menu.addAction(find_big_keys_action);
+
+      QAction* bulk_delete_action = new QAction(trDeleteByPattern, this);
+      VERIFY(connect(bulk_delete_action, &QAction::triggered, this, &ExplorerTreeView::bulkDeleteKeys));
+      bulk_delete_action->setEnabled(is_default && is_connected);
+      menu.addAction(bulk_delete_action);
+    }
+
     menu.addAction(remove_all_keys_action);
     remove_all_keys_action->setEnabled(is_default && is_connected);
 
@@ -389,6 +468,14 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
     menu.addAction(removeBranchAction);
     removeBranchAction->setEnabled(is_default && is_connected);
 
+    const core::ConnectionType ct = server->GetType();
+    if (ct == core::REDIS || ct == core::KEYDB) {
+      QAction* bulk_delete_action = new QAction(trDeleteByPattern, this);
+      VERIFY(connect(bulk_delete_action, &QAction::triggered, this, &ExplorerTreeView::bulkDeleteBranch));
+      bulk_delete_action->setEnabled(is_default && is_connected);
+      menu.addAction(bulk_delete_action);
+    }
+
     QAction* copy_to_clipboard_action = new QAction(trCopyToClipboard, this);
     VERIFY(connect(copy_to_clipboard_action, &QAction::triggered, this, &ExplorerTreeView::copyToClipboard));
     menu.addAction(copy_to_clipboard_action);
@@ -451,6 +538,10 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   else if (node->type() == IExplorerTreeItem::eCluster) {
     QMenu menu(this);
+    QAction* dashboard_action = new QAction(trDashboard, this);
+    VERIFY(connect(dashboard_action, &QAction::triggered, this, &ExplorerTreeView::openNodesDashboard));
+    menu.addAction(dashboard_action);
+
     QAction* close_cluster_action = new QAction(translations::trClose, this);
     VERIFY(connect(close_cluster_action, &QAction::triggered, this, &ExplorerTreeView::closeClusterConnection));
     menu.addAction(close_cluster_action);
@@ -461,6 +552,10 @@ void ExplorerTreeView::showContextMenu(const QPoint& point) {
     menu.exec(menu_point);
   } else if (node->type() == IExplorerTreeItem::eSentinel) {
     QMenu menu(this);
+    QAction* dashboard_action = new QAction(trDashboard, this);
+    VERIFY(connect(dashboard_action, &QAction::triggered, this, &ExplorerTreeView::openNodesDashboard));
+    menu.addAction(dashboard_action);
+
     QAction* close_sentinel_action = new QAction(translations::trClose, this);
     VERIFY(connect(close_sentinel_action, &QAction::triggered, this, &ExplorerTreeView::closeSentinelConnection));
     menu.addAction(close_sentinel_action);
@@ -581,6 +676,52 @@ void ExplorerTreeView::openInfoServerDialog() {
   }
 }
 
+void ExplorerTreeView::openMigrationDialog() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    if (!server) {
+      continue;
+    }
+
+    QString server_name;
+    common::ConvertFromString(server->GetName(), &server_name);
+    const QIcon dialog_icon = gui::GuiFactory::GetInstance().icon(server->GetType());
+    auto diag =
+        createDialog<MigrationDialog>(trMigrateDataTemplate_1S.arg(server_name), dialog_icon, server_name, this);  // +
+    diag->exec();
+  }
+}
+
+void ExplorerTreeView::openCompareDialog() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerServerItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerServerItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    proxy::IServerSPtr server = node->server();
+    if (!server) {
+      continue;
+    }
+
+    QString server_name;
+    common::ConvertFromString(server->GetName(), &server_name);
+    const QIcon dialog_icon = gui::GuiFactory::GetInstance().icon(server->GetType());
+    auto diag =
+        createDialog<CompareDialog>(trCompareTemplate_1S.arg(server_name), dialog_icon, server_name, this);  // +
+    diag->exec();
+  }
+}
+
 void ExplorerTreeView::openPropertyServerDialog() {
   QModelIndexList selected = selectedEqualTypeIndexes();
   for (QModelIndex ind : selected) {
@@ -701,6 +842,38 @@ void ExplorerTreeView::closeSentinelConnection() {
     }
   }
 }
+
+void ExplorerTreeView::openNodesDashboard() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    IExplorerTreeItem* node = common::qt::item<common::qt::gui::TreeItem*, IExplorerTreeItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    std::vector<proxy::IServerSPtr> nodes;
+    QIcon dialog_icon;
+    if (node->type() == IExplorerTreeItem::eCluster) {
+      proxy::IClusterSPtr cluster = static_cast<ExplorerClusterItem*>(node)->cluster();
+      nodes = cluster->GetNodes();
+      dialog_icon = GuiFactory::GetInstance().clusterIcon();
+    } else if (node->type() == IExplorerTreeItem::eSentinel) {
+      // sentinels themselves have no data, only monitored masters and replicas are polled
+      proxy::ISentinelSPtr sentinel = static_cast<ExplorerSentinelItem*>(node)->sentinel();
+      for (const proxy::Sentinel& sent : sentinel->GetSentinels()) {
+        nodes.insert(nodes.end(), sent.sentinels_nodes.begin(), sent.sentinels_nodes.end());
+      }
+      dialog_icon = GuiFactory::GetInstance().sentinelIcon();
+    } else {
+      continue;
+    }
+
+    auto diag =
+        createDialog<NodesDashboardDialog>(trDashboardTemplate_1S.arg(node->name()), dialog_icon, nodes, this);  // +
+    diag->exec();
+  }
+}
 #endif
 
 void ExplorerTreeView::viewPubSub() {
@@ -989,6 +1162,60 @@ void ExplorerTreeView::viewKeys() {
   }
 }
 
+void ExplorerTreeView::findBigKeys() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerDatabaseItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerDatabaseItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    const QIcon dialog_icon = gui::GuiFactory::GetInstance().icon(node->server()->GetType());
+    auto diag =
+        createDialog<BigKeysDialog>(trFindBigKeysTemplate_1S.arg(node->name()), dialog_icon, node->db(), this);  // +
+    diag->exec();
+  }
+}
+
+void ExplorerTreeView::bulkDeleteKeys() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerDatabaseItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerDatabaseItem*>(ind);
+    if (!node) {
+      DNOTREACHED();
+      continue;
+    }
+
+    const QIcon dialog_icon = gui::GuiFactory::GetInstance().icon(node->server()->GetType());
+    auto diag = createDialog<BulkDeleteDialog>(trDeleteByPatternTemplate_1S.arg(node->name()), dialog_icon,
+                                               node->db(), ALL_KEYS_PATTERNS, this);  // +
+    diag->exec();
+  }
+}
+
+void ExplorerTreeView::bulkDeleteBranch() {
+  QModelIndexList selected = selectedEqualTypeIndexes();
+  for (QModelIndex ind : selected) {
+    ExplorerNSItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerNSItem*>(ind);
+    if (!node) {
+      continue;
+    }
+
+    ExplorerDatabaseItem* db = node->db();
+    if (!db) {
+      continue;
+    }
+
+    QString prefix;
+    common::ConvertFromBytes(node->generateKeyTemplate(IExplorerTreeItem::string_t()), &prefix);
+    const QIcon dialog_icon = gui::GuiFactory::GetInstance().icon(node->server()->GetType());
+    auto diag = createDialog<BulkDeleteDialog>(trDeleteByPatternTemplate_1S.arg(db->name()), dialog_icon, db->db(),
+                                               EscapeGlob(prefix) + "*", this);  // +
+    diag->exec();
+  }
+}
+
 void ExplorerTreeView::loadValue() {
   QModelIndexList selected = selectedEqualTypeIndexes();
   for (QModelIndex ind : selected) {
@@ -997,6 +1224,10 @@ void ExplorerTreeView::loadValue() {
       continue;
     }
 
+    if (checkValueSize(ind)) {
+      continue;
+    }
+
     node->loadValueFromDb();
   }
 }
@@ -1168,6 +1399,7 @@ void ExplorerTreeView::finishLoadDatabaseContent(const proxy::events_info::LoadD
   for (size_t i = 0; i < keys.size(); ++i) {
     core::NDbKValue key = keys[i];
     source_model_->addKey(serv, res.inf, key, ns, ns_strategy);
+    search_index_->addKey(serv, res.inf, key);
   }
 
   source_model_->updateDb(serv, res.inf);
@@ -1178,7 +1410,61 @@ void ExplorerTreeView::startExecuteCommand(const proxy::events_info::ExecuteInfo
 }
 
 void ExplorerTreeView::finishExecuteCommand(const proxy::events_info::ExecuteInfoResponse& res) {
-  UNUSED(res);
+  if (res.initiator() != this) {
+    return;
+  }
+
+  const auto it = pending_value_sizes_.find(common::ConvertToString(res.text));
+  if (it == pending_value_sizes_.end()) {
+    return;
+  }
+
+  const QPersistentModelIndex index = it->second;
+  pending_value_sizes_.erase(it);
+  ExplorerKeyItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerKeyItem*>(index);
+  if (!index.isValid() || !node) {
+    return;
+  }
+
+  int64_t value_size = 0;
+  common::Error err = res.errorInfo();
+  if (!err && res.executed_commands.size() == 1) {
+    const auto childs = res.executed_commands[0]->GetChildrens();
+    if (childs.size() == 1 && childs[0]->GetValue()) {
+      childs[0]->GetValue()->GetAsInteger64(&value_size);
+    }
+  }
+
+  const common::Value::Type type = node->dbv().GetType();
+  const size_t threshold = type == common::Value::TYPE_STRING ? kLargeValueThreshold : kLargeCollectionThreshold;
+  if (value_size <= static_cast<int64_t>(threshold)) {
+    node->loadValueFromDb();
+    return;
+  }
+
+  proxy::IServerSPtr server = node->server();
+  const QIcon dialog_icon = gui::GuiFactory::GetInstance().icon(server->GetType());
+  if (type == common::Value::TYPE_STRING) {
+    auto diag = createDialog<LargeValueDialog>(trLargeValueTemplate_1S.arg(node->name()), dialog_icon, server,
+                                               node->key(), static_cast<size_t>(value_size), this);  // +
+    diag->exec();
+    delete diag;
+    return;
+  }
+
+  if (type == core::StreamValue::TYPE_STREAM) {
+    auto diag = createDialog<StreamBrowserDialog>(trStreamTemplate_1S.arg(node->name()), dialog_icon, server,
+                                                  node->key(), static_cast<size_t>(value_size), this);  // +
+    diag->exec();
+    delete diag;
+    return;
+  }
+
+  auto diag = createDialog<CollectionBrowserDialog>(trLargeCollectionTemplate_1S.arg(node->name()), dialog_icon,
+                                                    server, node->key(), type, static_cast<size_t>(value_size),
+                                                    this);  // +
+  diag->exec();
+  delete diag;
 }
 
 void ExplorerTreeView::createDatabase(core::IDataBaseInfoSPtr db) {
@@ -1192,6 +1478,7 @@ void ExplorerTreeView::removeDatabase(core::IDataBaseInfoSPtr db) {
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   CHECK(serv);
 
+  search_index_->removeDatabase(serv, db);
   source_model_->removeDatabase(serv, db);
 }
 
@@ -1199,6 +1486,7 @@ void ExplorerTreeView::flushDB(core::IDataBaseInfoSPtr db) {
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   CHECK(serv);
 
+  search_index_->removeDatabase(serv, db);
   source_model_->removeAllKeys(serv, db);
 }
 
@@ -1214,9 +1502,20 @@ void ExplorerTreeView::removeKey(core::IDataBaseInfoSPtr db, core::NKey key) {
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   CHECK(serv);
 
+  search_index_->removeKey(serv, db, key);
   source_model_->removeKey(serv, db, key);
 }
 
+void ExplorerTreeView::removeKeys(core::IDataBaseInfoSPtr db, core::NKeys keys) {
+  proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
+  CHECK(serv);
+
+  for (const core::NKey& key : keys) {
+    search_index_->removeKey(serv, db, key);
+  }
+  source_model_->removeKeys(serv, db, keys);
+}
+
 void ExplorerTreeView::addKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
   proxy::IServer* serv = qobject_cast<proxy::IServer*>(sender());
   if (!serv) {
@@ -1226,6 +1525,7 @@ void ExplorerTreeView::addKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
   const std::string ns = serv->GetNsSeparator();
   const proxy::NsDisplayStrategy ns_strategy = serv->GetNsDisplayStrategy();
   source_model_->addKey(serv, db, key, ns, ns_strategy);
+  search_index_->addKey(serv, db, key);
 }
 
 void ExplorerTreeView::renameKey(core::IDataBaseInfoSPtr db, core::NKey key, core::nkey_t new_name) {
@@ -1239,6 +1539,7 @@ void ExplorerTreeView::renameKey(core::IDataBaseInfoSPtr db, core::NKey key, cor
   const std::string ns = serv->GetNsSeparator();
   const proxy::NsDisplayStrategy ns_strategy = serv->GetNsDisplayStrategy();
   source_model_->renameKey(serv, db, key, new_key, ns, ns_strategy);
+  search_index_->renameKey(serv, db, key, new_key);
 }
 
 void ExplorerTreeView::loadKey(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
@@ -1246,6 +1547,7 @@ void ExplorerTreeView::loadKey(core::IDataBaseInfoSPtr db, core::NDbKValue key)
   CHECK(serv);
 
   source_model_->updateValue(serv, db, key);
+  search_index_->addKey(serv, db, key);
 }
 
 void ExplorerTreeView::changeTTLKey(core::IDataBaseInfoSPtr db, core::NKey key, core::ttl_t ttl) {
@@ -1297,6 +1599,7 @@ void ExplorerTreeView::syncWithServer(proxy::IServer* server) {
   VERIFY(connect(server, &proxy::IServer::DatabaseChanged, this, &ExplorerTreeView::currentDataBaseChange));
 
   VERIFY(connect(server, &proxy::IServer::KeyRemoved, this, &ExplorerTreeView::removeKey, Qt::DirectConnection));
+  VERIFY(connect(server, &proxy::IServer::KeysRemoved, this, &ExplorerTreeView::removeKeys, Qt::DirectConnection));
   VERIFY(connect(server, &proxy::IServer::KeyAdded, this, &ExplorerTreeView::addKey, Qt::DirectConnection));
   VERIFY(connect(server, &proxy::IServer::KeyRenamed, this, &ExplorerTreeView::renameKey, Qt::DirectConnection));
   VERIFY(connect(server, &proxy::IServer::KeyLoaded, this, &ExplorerTreeView::loadKey, Qt::DirectConnection));
@@ -1323,6 +1626,7 @@ void ExplorerTreeView::unsyncWithServer(proxy::IServer* server) {
   VERIFY(disconnect(server, &proxy::IServer::DatabaseChanged, this, &ExplorerTreeView::currentDataBaseChange));
 
   VERIFY(disconnect(server, &proxy::IServer::KeyRemoved, this, &ExplorerTreeView::removeKey));
+  VERIFY(disconnect(server, &proxy::IServer::KeysRemoved, this, &ExplorerTreeView::removeKeys));
   VERIFY(disconnect(server, &proxy::IServer::KeyAdded, this, &ExplorerTreeView::addKey));
   VERIFY(disconnect(server, &proxy::IServer::KeyRenamed, this, &ExplorerTreeView::renameKey));
   VERIFY(disconnect(server, &proxy::IServer::KeyLoaded, this, &ExplorerTreeView::loadKey));
@@ -1331,6 +1635,44 @@ void ExplorerTreeView::unsyncWithServer(proxy::IServer* server) {
 
 void ExplorerTreeView::retranslateUi() {}
 
+bool ExplorerTreeView::checkValueSize(const QModelIndex& index) {
+  ExplorerKeyItem* node = common::qt::item<common::qt::gui::TreeItem*, ExplorerKeyItem*>(index);
+  if (!node) {
+    return false;
+  }
+
+  proxy::IServerSPtr server = node->server();
+  if (!server || (server->GetType() != core::REDIS && server->GetType() != core::KEYDB)) {
+    return false;
+  }
+
+  const char* size_command = nullptr;
+  const common::Value::Type type = node->dbv().GetType();
+  if (type == common::Value::TYPE_STRING) {
+    size_command = REDIS_STRLEN_COMMAND;
+  } else if (type == common::Value::TYPE_HASH) {
+    size_command = REDIS_HLEN_COMMAND;
+  } else if (type == common::Value::TYPE_SET) {
+    size_command = REDIS_SCARD_COMMAND;
+  } else if (type == common::Value::TYPE_ZSET) {
+    size_command = REDIS_ZCARD_COMMAND;
+  } else if (type == common::Value::TYPE_ARRAY) {
+    size_command = REDIS_LLEN_COMMAND;
+  } else if (type == core::StreamValue::TYPE_STREAM) {
+    size_command = REDIS_XLEN_COMMAND;
+  } else {
+    return false;
+  }
+
+  core::command_buffer_writer_t wr;
+  wr << size_command << SPACE_STR << node->key().GetKey().GetForCommandLine();
+  const core::command_buffer_t cmd = wr.str();
+  pending_value_sizes_[common::ConvertToString(cmd)] = QPersistentModelIndex(index);
+  proxy::events_info::ExecuteInfoRequest req(this, cmd, 0, 0, false, true, core::C_INNER);
+  server->Execute(req);
+  return true;
+}
+
 QModelIndexList ExplorerTreeView::selectedEqualTypeIndexes() const {
   QModelIndexList indexses = selectionModel()->selectedRows();
   if (indexses.empty()) {
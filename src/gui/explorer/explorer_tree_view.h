@@ -18,6 +18,10 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+
+#include <QPersistentModelIndex>
 #include <QTreeView>
 
 #include "proxy/events/events_info.h"
@@ -25,11 +29,12 @@
 
 class QAction;
 class QPoint;
-class QSortFilterProxyModel;
 
 namespace fastonosql {
 namespace gui {
 class ExplorerTreeModel;
+class ExplorerTreeSortFilterProxyModel;
+class KeySearchIndex;
 
 class ExplorerTreeView : public QTreeView {
   Q_OBJECT
@@ -61,6 +66,7 @@ class ExplorerTreeView : public QTreeView {
 #endif
 
   void changeTextFilter(const QString& text);
+  void setSearchValues(bool search_values);
 
  private Q_SLOTS:
   void showContextMenu(const QPoint& point);
@@ -69,6 +75,8 @@ class ExplorerTreeView : public QTreeView {
   void openConsole();
   void loadDatabases();
   void openInfoServerDialog();
+  void openMigrationDialog();
+  void openCompareDialog();
   void openPropertyServerDialog();
   void openHistoryServerDialog();
   void clearHistory();
@@ -76,6 +84,7 @@ class ExplorerTreeView : public QTreeView {
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
   void closeClusterConnection();
   void closeSentinelConnection();
+  void openNodesDashboard();
 #endif
 
   void importServer();
@@ -92,6 +101,9 @@ class ExplorerTreeView : public QTreeView {
   void createKey();
   void editKey();
   void viewKeys();
+  void findBigKeys();
+  void bulkDeleteKeys();
+  void bulkDeleteBranch();
   void viewPubSub();
   void viewClientsMonitor();
 
@@ -120,6 +132,7 @@ class ExplorerTreeView : public QTreeView {
   void flushDB(core::IDataBaseInfoSPtr db);
   void currentDataBaseChange(core::IDataBaseInfoSPtr db);
   void removeKey(core::IDataBaseInfoSPtr db, core::NKey key);
+  void removeKeys(core::IDataBaseInfoSPtr db, core::NKeys keys);
   void addKey(core::IDataBaseInfoSPtr db, core::NDbKValue key);
   void renameKey(core::IDataBaseInfoSPtr db, core::NKey key, core::nkey_t new_name);
   void loadKey(core::IDataBaseInfoSPtr db, core::NDbKValue key);
@@ -137,8 +150,13 @@ class ExplorerTreeView : public QTreeView {
   void retranslateUi();
   QModelIndexList selectedEqualTypeIndexes() const;
 
+  // strings, collections and streams are sized first, huge ones open in a paged browser dialog
+  bool checkValueSize(const QModelIndex& index);
+
   ExplorerTreeModel* source_model_;
-  QSortFilterProxyModel* proxy_model_;
+  ExplorerTreeSortFilterProxyModel* proxy_model_;
+  KeySearchIndex* search_index_;
+  std::map<std::string, QPersistentModelIndex> pending_value_sizes_;
 };
 
 }  // namespace gui
@@ -18,6 +18,8 @@
 
 #include "gui/explorer/explorer_tree_widget.h"
 
+#include <QCheckBox>
+#include <QHBoxLayout>
 #include <QLineEdit>
 #include <QVBoxLayout>
 
@@ -26,6 +28,11 @@
 
 #include "translations/global.h"
 
+namespace {
+const QString trValues = QObject::tr("Values");
+const QString trSearchValuesToolTip = QObject::tr("Search in loaded string values too");
+}  // namespace
+
 namespace fastonosql {
 namespace gui {
 
@@ -34,8 +41,10 @@ ExplorerTreeWidget::ExplorerTreeWidget(QWidget* parent) : base_class(parent) {
   filter_edit_ = new QLineEdit;
   filter_edit_->setClearButtonEnabled(true);
   filter_edit_->addAction(GuiFactory::GetInstance().search16Icon(), QLineEdit::LeadingPosition);
+  search_values_ = new QCheckBox;
 
   VERIFY(connect(filter_edit_, &QLineEdit::textChanged, view_, &ExplorerTreeView::changeTextFilter));
+  VERIFY(connect(search_values_, &QCheckBox::toggled, view_, &ExplorerTreeView::setSearchValues));
   VERIFY(connect(view_, &ExplorerTreeView::consoleOpened, this, &ExplorerTreeWidget::consoleOpened));
   VERIFY(
       connect(view_, &ExplorerTreeView::consoleOpenedAndExecute, this, &ExplorerTreeWidget::consoleOpenedAndExecute));
@@ -50,7 +59,10 @@ ExplorerTreeWidget::ExplorerTreeWidget(QWidget* parent) : base_class(parent) {
 
   QVBoxLayout* main_layout = new QVBoxLayout;
   main_layout->addWidget(view_);
-  main_layout->addWidget(filter_edit_);
+  QHBoxLayout* filter_layout = new QHBoxLayout;
+  filter_layout->addWidget(filter_edit_);
+  filter_layout->addWidget(search_values_);
+  main_layout->addLayout(filter_layout);
   setLayout(main_layout);
 }
 
@@ -82,6 +94,8 @@ void ExplorerTreeWidget::removeCluster(proxy::IClusterSPtr cluster) {
 
 void ExplorerTreeWidget::retranslateUi() {
   filter_edit_->setPlaceholderText(translations::trSearch + "...");
+  search_values_->setText(trValues);
+  search_values_->setToolTip(trSearchValuesToolTip);
   base_class::retranslateUi();
 }
 
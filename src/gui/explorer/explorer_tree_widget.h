@@ -22,6 +22,7 @@
 
 #include "proxy/proxy_fwd.h"
 
+class QCheckBox;
 class QLineEdit;
 
 namespace fastonosql {
@@ -62,6 +63,7 @@ class ExplorerTreeWidget : public BaseWidget {
 
  private:
   QLineEdit* filter_edit_;
+  QCheckBox* search_values_;
   ExplorerTreeView* view_;
 };
 
@@ -0,0 +1,213 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/large_value_store.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <iterator>
+
+namespace fastonosql {
+namespace gui {
+
+LargeValueStore::LargeValueStore(size_t window_size)
+    : window_size_(window_size), file_(), data_(nullptr), size_(0), loaded_windows_(), dirty_ranges_() {}
+
+LargeValueStore::~LargeValueStore() {
+  Close();
+}
+
+bool LargeValueStore::Open(size_t value_size) {
+  Close();
+  if (!value_size || !file_.open()) {
+    return false;
+  }
+
+  if (!Map(value_size)) {
+    Close();
+    return false;
+  }
+
+  loaded_windows_.assign(GetWindowsCount(), false);
+  return true;
+}
+
+void LargeValueStore::Close() {
+  if (data_) {
+    file_.unmap(data_);
+    data_ = nullptr;
+  }
+
+  if (file_.isOpen()) {
+    file_.close();
+  }
+  size_ = 0;
+  loaded_windows_.clear();
+  dirty_ranges_.clear();
+}
+
+bool LargeValueStore::Map(size_t size) {
+  if (data_) {
+    file_.unmap(data_);
+    data_ = nullptr;
+  }
+
+  if (!file_.resize(static_cast<qint64>(size))) {
+    return false;
+  }
+
+  data_ = file_.map(0, static_cast<qint64>(size));
+  if (!data_) {
+    return false;
+  }
+
+  size_ = size;
+  return true;
+}
+
+size_t LargeValueStore::GetSize() const {
+  return size_;
+}
+
+size_t LargeValueStore::GetWindowSize() const {
+  return window_size_;
+}
+
+size_t LargeValueStore::GetWindowsCount() const {
+  return (size_ + window_size_ - 1) / window_size_;
+}
+
+size_t LargeValueStore::GetWindowOffset(size_t index) const {
+  return index * window_size_;
+}
+
+size_t LargeValueStore::GetWindowLength(size_t index) const {
+  const size_t offset = GetWindowOffset(index);
+  if (offset >= size_) {
+    return 0;
+  }
+
+  return std::min(window_size_, size_ - offset);
+}
+
+bool LargeValueStore::IsWindowLoaded(size_t index) const {
+  return index < loaded_windows_.size() && loaded_windows_[index];
+}
+
+bool LargeValueStore::SetWindow(size_t index, const std::string& data) {
+  if (!data_ || index >= loaded_windows_.size()) {
+    return false;
+  }
+
+  // value could be shrunk on the server since STRLEN, the rest stays zeroed
+  const size_t length = std::min(GetWindowLength(index), data.size());
+  memcpy(data_ + GetWindowOffset(index), data.data(), length);
+  loaded_windows_[index] = true;
+  return true;
+}
+
+bool LargeValueStore::GetWindow(size_t index, std::string* data) const {
+  if (!data_ || !IsWindowLoaded(index)) {
+    return false;
+  }
+
+  data->assign(reinterpret_cast<const char*>(data_ + GetWindowOffset(index)), GetWindowLength(index));
+  return true;
+}
+
+bool LargeValueStore::UpdateWindow(size_t index, const std::string& data) {
+  if (!IsWindowLoaded(index)) {
+    return false;
+  }
+
+  const size_t offset = GetWindowOffset(index);
+  const size_t length = GetWindowLength(index);
+  const bool is_last = index + 1 == loaded_windows_.size();
+  if (data.size() != length && !(is_last && data.size() > length)) {
+    return false;
+  }
+
+  if (data.size() > length) {
+    // appended tail makes new windows, they are loaded by definition
+    if (!Map(offset + data.size())) {
+      return false;
+    }
+    loaded_windows_.resize(GetWindowsCount(), true);
+  }
+
+  // smallest range covering all changed bytes
+  const char* current = reinterpret_cast<const char*>(data_ + offset);
+  size_t begin = 0;
+  while (begin < length && current[begin] == data[begin]) {
+    begin++;
+  }
+  if (begin == data.size()) {
+    return true;
+  }
+
+  size_t end = data.size();
+  if (data.size() == length) {
+    while (end > begin && current[end - 1] == data[end - 1]) {
+      end--;
+    }
+  }
+
+  memcpy(data_ + offset + begin, data.data() + begin, end - begin);
+
+  // merge with touching ranges
+  begin += offset;
+  end += offset;
+  auto it = dirty_ranges_.upper_bound(begin);
+  if (it != dirty_ranges_.begin()) {
+    auto prev = std::prev(it);
+    if (prev->second >= begin) {
+      begin = prev->first;
+      end = std::max(end, prev->second);
+      it = dirty_ranges_.erase(prev);
+    }
+  }
+  while (it != dirty_ranges_.end() && it->first <= end) {
+    end = std::max(end, it->second);
+    it = dirty_ranges_.erase(it);
+  }
+  dirty_ranges_[begin] = end;
+  return true;
+}
+
+bool LargeValueStore::HasPatches() const {
+  return !dirty_ranges_.empty();
+}
+
+std::vector<LargeValueStore::Patch> LargeValueStore::GetPatches() const {
+  std::vector<Patch> patches;
+  for (const auto& range : dirty_ranges_) {
+    Patch patch;
+    patch.offset = range.first;
+    patch.data.assign(reinterpret_cast<const char*>(data_ + range.first), range.second - range.first);
+    patches.push_back(patch);
+  }
+  return patches;
+}
+
+void LargeValueStore::ClearPatches() {
+  dirty_ranges_.clear();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,74 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <QTemporaryFile>
+
+namespace fastonosql {
+namespace gui {
+
+// local copy of a big string value kept in a memory mapped temp file, filled window by window
+// and tracking edited byte ranges to send back as SETRANGE patches
+class LargeValueStore {
+ public:
+  struct Patch {
+    size_t offset;
+    std::string data;
+  };
+
+  explicit LargeValueStore(size_t window_size);
+  ~LargeValueStore();
+
+  bool Open(size_t value_size);
+  void Close();
+
+  size_t GetSize() const;
+  size_t GetWindowSize() const;
+  size_t GetWindowsCount() const;
+  size_t GetWindowOffset(size_t index) const;
+  size_t GetWindowLength(size_t index) const;
+
+  bool IsWindowLoaded(size_t index) const;
+  bool SetWindow(size_t index, const std::string& data);
+  bool GetWindow(size_t index, std::string* data) const;
+
+  // edits keep window length, only the last window may grow since SETRANGE can't shrink a value
+  bool UpdateWindow(size_t index, const std::string& data);
+
+  bool HasPatches() const;
+  std::vector<Patch> GetPatches() const;
+  void ClearPatches();
+
+ private:
+  bool Map(size_t size);
+
+  const size_t window_size_;
+  QTemporaryFile file_;
+  uchar* data_;
+  size_t size_;
+  std::vector<bool> loaded_windows_;
+  std::map<size_t, size_t> dirty_ranges_;  // begin -> end, not overlapping
+};
+
+}  // namespace gui
+}  // namespace fastonosql
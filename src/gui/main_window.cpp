@@ -54,6 +54,7 @@
 #include "proxy/server/iserver.h"
 #include "proxy/servers_manager.h"
 #include "proxy/settings_manager.h"
+#include "proxy/startup_profiler.h"
 
 #include "gui/dialogs/about_dialog.h"
 #include "gui/dialogs/connections_dialog.h"
@@ -284,6 +285,7 @@ void MainWindow::showEvent(QShowEvent* ev) {
   QMainWindow::showEvent(ev);
   static bool statistic_sent = false;
   if (!statistic_sent) {
+    proxy::StartupProfiler::GetInstance().Finish();
     sendStatisticAndCheckVersion();
     statistic_sent = true;
     QTimer::singleShot(0, this, SLOT(open()));
@@ -762,6 +764,7 @@ void MainWindow::createSentinel(proxy::ISentinelSettingsBaseSPtr settings) {
   }
 
   exp_->addSentinel(sent);
+  sent->StartWatch();
   if (!proxy::SettingsManager::GetInstance()->AutoOpenConsole()) {
     return;
   }
@@ -0,0 +1,277 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/models/collection_table_model.h"
+
+#include <QBrush>
+#include <QFont>
+
+#include <common/qt/convert2string.h>
+#include <common/qt/utils_qt.h>
+
+#include "gui/models/items/collection_table_item.h"
+
+namespace {
+const QString trField = QObject::tr("Field");
+const QString trMember = QObject::tr("Member");
+const QString trScore = QObject::tr("Score");
+const QString trIndex = QObject::tr("Index");
+const QString trValue = QObject::tr("Value");
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+CollectionTableModel::CollectionTableModel(common::Value::Type type, QObject* parent)
+    : TableModel(parent), type_(type), has_more_(true), fetching_(false), seen_fields_() {}
+
+QVariant CollectionTableModel::data(const QModelIndex& index, int role) const {
+  if (!index.isValid()) {
+    return QVariant();
+  }
+
+  CollectionTableItem* node = common::qt::item<common::qt::gui::TableItem*, CollectionTableItem*>(index);
+  if (!node) {
+    return QVariant();
+  }
+
+  int col = index.column();
+  QVariant result;
+  if (role == Qt::DisplayRole || role == Qt::EditRole) {
+    QString text;
+    if (col == kField && common::ConvertFromBytes(node->field(), &text)) {
+      result = text;
+    } else if (col == kValue && common::ConvertFromBytes(node->value(), &text)) {
+      result = text;
+    }
+  } else if (role == Qt::FontRole) {
+    if (node->state() == CollectionTableItem::kRemoved) {
+      QFont font;
+      font.setStrikeOut(true);
+      result = font;
+    } else if (node->state() != CollectionTableItem::kLoaded) {
+      QFont font;
+      font.setBold(true);
+      result = font;
+    }
+  } else if (role == Qt::ForegroundRole) {
+    if (node->state() == CollectionTableItem::kRemoved) {
+      result = QBrush(Qt::gray);
+    }
+  }
+
+  return result;
+}
+
+bool CollectionTableModel::setData(const QModelIndex& index, const QVariant& value, int role) {
+  if (!index.isValid() || role != Qt::EditRole) {
+    return false;
+  }
+
+  CollectionTableItem* node = common::qt::item<common::qt::gui::TableItem*, CollectionTableItem*>(index);
+  if (!node || node->state() == CollectionTableItem::kRemoved) {
+    return false;
+  }
+
+  const QString val = value.toString();
+  if (type_ == common::Value::TYPE_ZSET && index.column() == kValue) {
+    bool is_ok;
+    val.toDouble(&is_ok);
+    if (!is_ok) {
+      return false;
+    }
+  }
+
+  const string_t bytes = common::ConvertToCharBytes(val);
+  if (index.column() == kField) {
+    node->setField(bytes);
+  } else if (index.column() == kValue) {
+    node->setValue(bytes);
+  } else {
+    return false;
+  }
+
+  if (node->state() != CollectionTableItem::kAdded) {
+    const bool changed = node->field() != node->originalField() || node->value() != node->originalValue();
+    node->setState(changed ? CollectionTableItem::kChanged : CollectionTableItem::kLoaded);
+  }
+
+  emit dataChanged(this->index(index.row(), kField), this->index(index.row(), kValue));
+  return true;
+}
+
+Qt::ItemFlags CollectionTableModel::flags(const QModelIndex& index) const {
+  if (!index.isValid()) {
+    return Qt::NoItemFlags;
+  }
+
+  Qt::ItemFlags result = Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+  const int col = index.column();
+  if (type_ == common::Value::TYPE_ARRAY) {
+    // index of list element is fixed, new elements are appended
+    if (col == kValue) {
+      result |= Qt::ItemIsEditable;
+    }
+  } else if (type_ == common::Value::TYPE_SET) {
+    if (col == kField) {
+      result |= Qt::ItemIsEditable;
+    }
+  } else {
+    result |= Qt::ItemIsEditable;
+  }
+
+  return result;
+}
+
+QVariant CollectionTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+  if (role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  if (orientation == Qt::Horizontal) {
+    if (section == kField) {
+      if (type_ == common::Value::TYPE_ARRAY) {
+        return trIndex;
+      } else if (type_ == common::Value::TYPE_HASH) {
+        return trField;
+      }
+      return trMember;
+    } else if (section == kValue) {
+      if (type_ == common::Value::TYPE_ZSET) {
+        return trScore;
+      }
+      return trValue;
+    }
+  }
+
+  return TableModel::headerData(section, orientation, role);
+}
+
+int CollectionTableModel::columnCount(const QModelIndex& parent) const {
+  UNUSED(parent);
+  return kCountColumns;
+}
+
+bool CollectionTableModel::canFetchMore(const QModelIndex& parent) const {
+  if (parent.isValid()) {
+    return false;
+  }
+
+  return has_more_ && !fetching_;
+}
+
+void CollectionTableModel::fetchMore(const QModelIndex& parent) {
+  if (!canFetchMore(parent)) {
+    return;
+  }
+
+  fetching_ = true;
+  emit fetchRequested();
+}
+
+common::Value::Type CollectionTableModel::type() const {
+  return type_;
+}
+
+void CollectionTableModel::clear() {
+  beginResetModel();
+  clearData();
+  seen_fields_.clear();
+  has_more_ = true;
+  fetching_ = false;
+  endResetModel();
+}
+
+void CollectionTableModel::appendPage(const std::vector<element_t>& elements, bool has_more) {
+  std::vector<common::qt::gui::TableItem*> items;
+  items.reserve(elements.size());
+  for (const element_t& element : elements) {
+    if (type_ != common::Value::TYPE_ARRAY) {
+      const std::string field(element.first.data(), element.first.size());
+      if (!seen_fields_.insert(field).second) {
+        continue;
+      }
+    }
+    items.push_back(new CollectionTableItem(element.first, element.second, CollectionTableItem::kLoaded));
+  }
+
+  fetching_ = false;
+  has_more_ = has_more;
+  if (items.empty()) {
+    return;
+  }
+
+  const size_t size = data_.size();
+  beginInsertRows(QModelIndex(), size, size + items.size() - 1);
+  data_.insert(data_.end(), items.begin(), items.end());
+  endInsertRows();
+}
+
+void CollectionTableModel::cancelFetch() {
+  fetching_ = false;
+  has_more_ = false;
+}
+
+void CollectionTableModel::addElement(const string_t& field, const string_t& value) {
+  const size_t size = data_.size();
+  beginInsertRows(QModelIndex(), size, size);
+  data_.push_back(new CollectionTableItem(field, value, CollectionTableItem::kAdded));
+  endInsertRows();
+}
+
+void CollectionTableModel::removeElement(int row) {
+  if (row < 0 || static_cast<size_t>(row) >= data_.size()) {
+    return;
+  }
+
+  CollectionTableItem* node = static_cast<CollectionTableItem*>(data_[row]);
+  if (node->state() == CollectionTableItem::kAdded) {
+    beginRemoveRows(QModelIndex(), row, row);
+    data_.erase(data_.begin() + row);
+    delete node;
+    endRemoveRows();
+    return;
+  }
+
+  // loaded rows stay visible until saved
+  node->setState(CollectionTableItem::kRemoved);
+  emit dataChanged(index(row, kField), index(row, kValue));
+}
+
+bool CollectionTableModel::hasChanges() const {
+  for (common::qt::gui::TableItem* item : data_) {
+    if (static_cast<CollectionTableItem*>(item)->state() != CollectionTableItem::kLoaded) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<CollectionTableItem*> CollectionTableModel::changedItems() const {
+  std::vector<CollectionTableItem*> changed;
+  for (common::qt::gui::TableItem* item : data_) {
+    CollectionTableItem* node = static_cast<CollectionTableItem*>(item);
+    if (node->state() != CollectionTableItem::kLoaded) {
+      changed.push_back(node);
+    }
+  }
+  return changed;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
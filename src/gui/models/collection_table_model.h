@@ -0,0 +1,78 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <common/qt/gui/base/table_model.h>
+#include <common/value.h>
+
+namespace fastonosql {
+namespace gui {
+class CollectionTableItem;
+
+// hash/set/zset/list elements loaded page by page as view scrolls, fetchMore asks owner for next page
+class CollectionTableModel : public common::qt::gui::TableModel {
+  Q_OBJECT
+
+ public:
+  typedef common::Value::string_t string_t;
+  typedef std::pair<string_t, string_t> element_t;
+  enum eColumn : uint8_t { kField = 0, kValue = 1, kCountColumns = 2 };
+
+  CollectionTableModel(common::Value::Type type, QObject* parent = Q_NULLPTR);
+
+  QVariant data(const QModelIndex& index, int role) const override;
+  bool setData(const QModelIndex& index, const QVariant& value, int role) override;
+  Qt::ItemFlags flags(const QModelIndex& index) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+  int columnCount(const QModelIndex& parent) const override;
+
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
+
+  common::Value::Type type() const;
+
+  void clear();
+  // elements of one page, SCAN may return some already seen, they are skipped
+  void appendPage(const std::vector<element_t>& elements, bool has_more);
+  void cancelFetch();
+
+  void addElement(const string_t& field, const string_t& value);
+  void removeElement(int row);
+
+  bool hasChanges() const;
+  std::vector<CollectionTableItem*> changedItems() const;
+
+ Q_SIGNALS:
+  void fetchRequested();
+
+ private:
+  const common::Value::Type type_;
+  bool has_more_;
+  bool fetching_;
+  std::set<std::string> seen_fields_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
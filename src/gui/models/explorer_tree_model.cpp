@@ -19,6 +19,7 @@
 #include "gui/models/explorer_tree_model.h"
 
 #include <string>
+#include <unordered_map>
 
 #include <QIcon>
 
@@ -403,6 +404,28 @@ void ExplorerTreeModel::removeKey(proxy::IServer* server, core::IDataBaseInfoSPt
   }
 }
 
+void ExplorerTreeModel::removeKeys(proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NKeys& keys) {
+  ExplorerServerItem* parent = findServerItem(server);
+  if (!parent) {
+    return;
+  }
+
+  int db_index = 0;
+  ExplorerDatabaseItem* dbs = findDatabaseItem(parent, db, &db_index);
+  if (!dbs) {
+    return;
+  }
+
+  std::unordered_map<std::string, const core::NKey*> lookup;
+  lookup.reserve(keys.size());
+  for (const core::NKey& key : keys) {
+    const auto name = key.GetKey().GetHumanReadable();
+    lookup.emplace(std::string(name.begin(), name.end()), &key);
+  }
+
+  removeKeyItems(dbs, lookup);
+}
+
 void ExplorerTreeModel::renameKey(proxy::IServer* server,
                                   core::IDataBaseInfoSPtr db,
                                   const core::NKey& old_key,
@@ -586,6 +609,33 @@ ExplorerKeyItem* ExplorerTreeModel::findKeyItem(IExplorerTreeItem* db_or_ns, con
       }));
 }
 
+void ExplorerTreeModel::removeKeyItems(IExplorerTreeItem* db_or_ns,
+                                       const std::unordered_map<std::string, const core::NKey*>& keys) {
+  // walk children backwards so rows of not yet visited siblings stay valid after removal
+  for (size_t i = db_or_ns->childrenCount(); i > 0; --i) {
+    const int row = static_cast<int>(i - 1);
+    IExplorerTreeItem* child = static_cast<IExplorerTreeItem*>(db_or_ns->child(row));
+    if (child->type() == IExplorerTreeItem::eNamespace) {
+      removeKeyItems(child, keys);
+      if (child->childrenCount() == 0) {
+        removeItem(createIndex(row, 0, child).parent(), child);
+      }
+      continue;
+    }
+
+    if (child->type() != IExplorerTreeItem::eKey) {
+      continue;
+    }
+
+    ExplorerKeyItem* key_item = static_cast<ExplorerKeyItem*>(child);
+    const auto name = key_item->key().GetKey().GetHumanReadable();
+    const auto it = keys.find(std::string(name.begin(), name.end()));
+    if (it != keys.end() && key_item->equalsKey(*it->second)) {
+      removeItem(createIndex(row, 0, key_item).parent(), key_item);
+    }
+  }
+}
+
 ExplorerNSItem* ExplorerTreeModel::findOrCreateNSItem(IExplorerTreeItem* db_or_ns,
                                                       const std::vector<core::readable_string_t>& namespaces,
                                                       const std::string& separator) {
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <common/qt/gui/base/tree_model.h>
@@ -76,6 +77,7 @@ class ExplorerTreeModel : public common::qt::gui::TreeModel {
               const std::string& ns_separator,
               proxy::NsDisplayStrategy ns_strategy);
   void removeKey(proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NKey& key);
+  void removeKeys(proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NKeys& keys);
   void renameKey(proxy::IServer* server,
                  core::IDataBaseInfoSPtr db,
                  const core::NKey& old_key,
@@ -97,6 +99,7 @@ class ExplorerTreeModel : public common::qt::gui::TreeModel {
   ExplorerServerItem* findServerItem(proxy::IServer* server) const;
   ExplorerDatabaseItem* findDatabaseItem(ExplorerServerItem* server, core::IDataBaseInfoSPtr db, int* index) const;
   ExplorerKeyItem* findKeyItem(IExplorerTreeItem* db_or_ns, const core::NKey& key) const;
+  void removeKeyItems(IExplorerTreeItem* db_or_ns, const std::unordered_map<std::string, const core::NKey*>& keys);
   ExplorerNSItem* findOrCreateNSItem(IExplorerTreeItem* db_or_ns,
                                      const std::vector<core::readable_string_t>& namespaces,
                                      const std::string& separator);
@@ -20,12 +20,22 @@
 
 #include <common/qt/utils_qt.h>
 
+#include "proxy/database/idatabase.h"
+
 #include "gui/models/items/explorer_tree_item.h"
 
 namespace fastonosql {
 namespace gui {
 
-ExplorerTreeSortFilterProxyModel::ExplorerTreeSortFilterProxyModel(QObject* parent) : QSortFilterProxyModel(parent) {}
+ExplorerTreeSortFilterProxyModel::ExplorerTreeSortFilterProxyModel(QObject* parent)
+    : QSortFilterProxyModel(parent), matches_() {
+  setRecursiveFilteringEnabled(true);
+}
+
+void ExplorerTreeSortFilterProxyModel::setMatchSet(KeySearchIndex::MatchSetSPtr matches) {
+  matches_ = matches;
+  invalidateFilter();
+}
 
 bool ExplorerTreeSortFilterProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const {
   IExplorerTreeItem* lnode = common::qt::item<common::qt::gui::TreeItem*, IExplorerTreeItem*>(left);
@@ -67,12 +77,29 @@ bool ExplorerTreeSortFilterProxyModel::filterAcceptsRow(int source_row, const QM
     return true;
   }
 
-  if (node->type() < IExplorerTreeItem::eNamespace) {
+  if (!matches_) {
     return true;
   }
 
-  QString name = node->name();
-  return name.contains(filterRegularExpression());
+  // shown through matched keys below it
+  if (node->type() == IExplorerTreeItem::eNamespace) {
+    return false;
+  }
+
+  if (node->type() != IExplorerTreeItem::eKey) {
+    return true;
+  }
+
+  ExplorerKeyItem* key_node = static_cast<ExplorerKeyItem*>(node);
+  ExplorerDatabaseItem* db_node = key_node->db();
+  if (!db_node) {
+    return false;
+  }
+
+  proxy::IDatabaseSPtr db = db_node->db();
+  const KeySearchIndex::key_id_t id =
+      KeySearchIndex::makeKeyId(key_node->server().get(), db->GetName(), key_node->key());
+  return matches_->find(id) != matches_->end();
 }
 
 }  // namespace gui
@@ -20,6 +20,8 @@
 
 #include <QSortFilterProxyModel>
 
+#include "gui/workers/key_search_index.h"
+
 namespace fastonosql {
 namespace gui {
 
@@ -29,9 +31,15 @@ class ExplorerTreeSortFilterProxyModel : public QSortFilterProxyModel {
  public:
   explicit ExplorerTreeSortFilterProxyModel(QObject* parent = Q_NULLPTR);
 
+  // keys are filtered by the precomputed set, namespaces stay while they have matched keys; null shows all
+  void setMatchSet(KeySearchIndex::MatchSetSPtr matches);
+
  protected:
   bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
   bool filterAcceptsRow(int source_row, const QModelIndex& source_parent) const override;
+
+ private:
+  KeySearchIndex::MatchSetSPtr matches_;
 };
 
 }  // namespace gui
@@ -0,0 +1,60 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/models/items/collection_table_item.h"
+
+namespace fastonosql {
+namespace gui {
+
+CollectionTableItem::CollectionTableItem(const string_t& field, const string_t& value, State state)
+    : field_(field), value_(value), original_field_(field), original_value_(value), state_(state) {}
+
+CollectionTableItem::string_t CollectionTableItem::field() const {
+  return field_;
+}
+
+void CollectionTableItem::setField(const string_t& field) {
+  field_ = field;
+}
+
+CollectionTableItem::string_t CollectionTableItem::value() const {
+  return value_;
+}
+
+void CollectionTableItem::setValue(const string_t& value) {
+  value_ = value;
+}
+
+CollectionTableItem::string_t CollectionTableItem::originalField() const {
+  return original_field_;
+}
+
+CollectionTableItem::string_t CollectionTableItem::originalValue() const {
+  return original_value_;
+}
+
+CollectionTableItem::State CollectionTableItem::state() const {
+  return state_;
+}
+
+void CollectionTableItem::setState(State state) {
+  state_ = state;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
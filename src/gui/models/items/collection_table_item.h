@@ -0,0 +1,56 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/qt/gui/base/table_item.h>
+#include <common/value.h>
+
+namespace fastonosql {
+namespace gui {
+
+// element of hash/set/zset/list page, remembers what was loaded so only deltas are written back
+class CollectionTableItem : public common::qt::gui::TableItem {
+ public:
+  typedef common::Value::string_t string_t;
+  enum State : uint8_t { kLoaded = 0, kChanged, kAdded, kRemoved };
+
+  CollectionTableItem(const string_t& field, const string_t& value, State state);
+
+  string_t field() const;
+  void setField(const string_t& field);
+
+  string_t value() const;
+  void setValue(const string_t& value);
+
+  string_t originalField() const;
+  string_t originalValue() const;
+
+  State state() const;
+  void setState(State state);
+
+ private:
+  string_t field_;
+  string_t value_;
+  const string_t original_field_;
+  const string_t original_value_;
+  State state_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,56 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/models/items/key_diff_table_item.h"
+
+#include <common/qt/convert2string.h>
+
+namespace {
+const QString trMissing = QObject::tr("Missing in right");
+const QString trExtra = QObject::tr("Missing in left");
+const QString trDifferent = QObject::tr("Value differs");
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+KeyDiffTableItem::KeyDiffTableItem(const proxy::CompareJob::KeyDifference& difference) : difference_(difference) {}
+
+QString KeyDiffTableItem::keyString() const {
+  QString qkey;
+  const auto raw_key = difference_.key.GetKey();
+  common::ConvertFromBytes(raw_key.GetHumanReadable(), &qkey);
+  return qkey;
+}
+
+QString KeyDiffTableItem::differenceText() const {
+  if (difference_.type == proxy::CompareJob::KEY_MISSING) {
+    return trMissing;
+  } else if (difference_.type == proxy::CompareJob::KEY_EXTRA) {
+    return trExtra;
+  }
+
+  return trDifferent;
+}
+
+proxy::CompareJob::KeyDifference KeyDiffTableItem::difference() const {
+  return difference_;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
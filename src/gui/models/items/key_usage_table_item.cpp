@@ -0,0 +1,47 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/models/items/key_usage_table_item.h"
+
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/value.h>
+
+namespace fastonosql {
+namespace gui {
+
+KeyUsageTableItem::KeyUsageTableItem(const proxy::NDbKeyUsage& usage) : usage_(usage) {}
+
+QString KeyUsageTableItem::keyString() const {
+  QString qkey;
+  const core::NKey key = usage_.GetKey();
+  const auto raw_key = key.GetKey();
+  common::ConvertFromBytes(raw_key.GetHumanReadable(), &qkey);
+  return qkey;
+}
+
+QString KeyUsageTableItem::typeText() const {
+  return core::GetTypeName(usage_.GetType());
+}
+
+proxy::NDbKeyUsage KeyUsageTableItem::usage() const {
+  return usage_;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,100 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/models/keys_diff_table_model.h"
+
+#include <common/qt/utils_qt.h>
+
+#include "gui/models/items/key_diff_table_item.h"
+
+namespace {
+const QString trKey = QObject::tr("Key");
+const QString trDifference = QObject::tr("Difference");
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+KeysDiffTableModel::KeysDiffTableModel(QObject* parent) : TableModel(parent) {}
+
+QVariant KeysDiffTableModel::data(const QModelIndex& index, int role) const {
+  if (!index.isValid()) {
+    return QVariant();
+  }
+
+  KeyDiffTableItem* node = common::qt::item<common::qt::gui::TableItem*, KeyDiffTableItem*>(index);
+  if (!node) {
+    return QVariant();
+  }
+
+  int col = index.column();
+  QVariant result;
+  if (role == Qt::DisplayRole) {
+    if (col == kKey) {
+      result = node->keyString();
+    } else if (col == kDifference) {
+      result = node->differenceText();
+    }
+  }
+
+  return result;
+}
+
+QVariant KeysDiffTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+  if (role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  if (orientation == Qt::Horizontal) {
+    if (section == kKey) {
+      return trKey;
+    } else if (section == kDifference) {
+      return trDifference;
+    }
+  }
+
+  return TableModel::headerData(section, orientation, role);
+}
+
+int KeysDiffTableModel::columnCount(const QModelIndex& parent) const {
+  UNUSED(parent);
+
+  return kCountColumns;
+}
+
+void KeysDiffTableModel::clear() {
+  beginResetModel();
+  clearData();
+  endResetModel();
+}
+
+void KeysDiffTableModel::appendDifferences(const proxy::CompareJob::differences_t& differences) {
+  if (differences.empty()) {
+    return;
+  }
+
+  const int first = static_cast<int>(data_.size());
+  beginInsertRows(QModelIndex(), first, first + static_cast<int>(differences.size()) - 1);
+  for (size_t i = 0; i < differences.size(); ++i) {
+    data_.push_back(new KeyDiffTableItem(differences[i]));
+  }
+  endInsertRows();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,47 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <common/qt/gui/base/table_model.h>
+
+#include "proxy/compare_job.h"
+
+namespace fastonosql {
+namespace gui {
+
+class KeysDiffTableModel : public common::qt::gui::TableModel {
+  Q_OBJECT
+
+ public:
+  enum eColumn { kKey = 0, kDifference = 1, kCountColumns = 2 };
+
+  explicit KeysDiffTableModel(QObject* parent = Q_NULLPTR);
+
+  QVariant data(const QModelIndex& index, int role) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+  int columnCount(const QModelIndex& parent) const override;
+  void clear();
+
+  // differences are streamed, so rows are only appended
+  void appendDifferences(const proxy::CompareJob::differences_t& differences);
+};
+
+}  // namespace gui
+}  // namespace fastonosql
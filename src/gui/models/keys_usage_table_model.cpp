@@ -0,0 +1,112 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/models/keys_usage_table_model.h"
+
+#include <common/qt/utils_qt.h>
+
+#include "gui/models/items/key_usage_table_item.h"
+
+namespace {
+const QString trKey = QObject::tr("Key");
+const QString trType = QObject::tr("Type");
+const QString trElements = QObject::tr("Elements");
+const QString trMemory = QObject::tr("Memory (bytes)");
+const QString trFrequency = QObject::tr("Frequency");
+}  // namespace
+
+namespace fastonosql {
+namespace gui {
+
+KeysUsageTableModel::KeysUsageTableModel(QObject* parent) : TableModel(parent) {}
+
+QVariant KeysUsageTableModel::data(const QModelIndex& index, int role) const {
+  if (!index.isValid()) {
+    return QVariant();
+  }
+
+  KeyUsageTableItem* node = common::qt::item<common::qt::gui::TableItem*, KeyUsageTableItem*>(index);
+  if (!node) {
+    return QVariant();
+  }
+
+  int col = index.column();
+  QVariant result;
+  if (role == Qt::DisplayRole) {
+    const proxy::NDbKeyUsage usage = node->usage();
+    if (col == kKey) {
+      result = node->keyString();
+    } else if (col == kType) {
+      result = node->typeText();
+    } else if (col == kElements) {
+      result = static_cast<qulonglong>(usage.GetElementsCount());
+    } else if (col == kMemory) {
+      result = static_cast<qulonglong>(usage.GetMemoryUsage());
+    } else if (col == kFrequency) {
+      result = usage.GetFrequency();
+    }
+  }
+
+  return result;
+}
+
+QVariant KeysUsageTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+  if (role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  if (orientation == Qt::Horizontal) {
+    if (section == kKey) {
+      return trKey;
+    } else if (section == kType) {
+      return trType;
+    } else if (section == kElements) {
+      return trElements;
+    } else if (section == kMemory) {
+      return trMemory;
+    } else if (section == kFrequency) {
+      return trFrequency;
+    }
+  }
+
+  return TableModel::headerData(section, orientation, role);
+}
+
+int KeysUsageTableModel::columnCount(const QModelIndex& parent) const {
+  UNUSED(parent);
+
+  return kCountColumns;
+}
+
+void KeysUsageTableModel::clear() {
+  beginResetModel();
+  clearData();
+  endResetModel();
+}
+
+void KeysUsageTableModel::setKeys(const std::vector<proxy::NDbKeyUsage>& keys) {
+  beginResetModel();
+  clearData();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    data_.push_back(new KeyUsageTableItem(keys[i]));
+  }
+  endResetModel();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
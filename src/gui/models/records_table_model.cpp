@@ -0,0 +1,136 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/models/records_table_model.h"
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+
+class RecordTableItem : public common::qt::gui::TableItem {
+ public:
+  explicit RecordTableItem(const QStringList& record) : record_(record) {}
+
+  QStringList record() const { return record_; }
+
+ private:
+  const QStringList record_;
+};
+
+}  // namespace
+
+RecordsTableModel::RecordsTableModel(const QStringList& headers, QObject* parent)
+    : base_class(parent), headers_(headers), has_more_(false), fetching_(false) {}
+
+QVariant RecordsTableModel::data(const QModelIndex& index, int role) const {
+  if (!index.isValid() || role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  const QStringList rec = record(index.row());
+  if (index.column() < rec.size()) {
+    return rec[index.column()];
+  }
+
+  return QVariant();
+}
+
+QVariant RecordsTableModel::headerData(int section, Qt::Orientation orientation, int role) const {
+  if (role != Qt::DisplayRole) {
+    return QVariant();
+  }
+
+  if (orientation == Qt::Horizontal && section < headers_.size()) {
+    return headers_[section];
+  }
+
+  return base_class::headerData(section, orientation, role);
+}
+
+int RecordsTableModel::columnCount(const QModelIndex& parent) const {
+  UNUSED(parent);
+  return headers_.size();
+}
+
+bool RecordsTableModel::canFetchMore(const QModelIndex& parent) const {
+  if (parent.isValid()) {
+    return false;
+  }
+
+  return has_more_ && !fetching_;
+}
+
+void RecordsTableModel::fetchMore(const QModelIndex& parent) {
+  if (!canFetchMore(parent)) {
+    return;
+  }
+
+  fetching_ = true;
+  emit fetchRequested();
+}
+
+QStringList RecordsTableModel::record(int row) const {
+  if (row < 0 || static_cast<size_t>(row) >= data_.size()) {
+    return QStringList();
+  }
+
+  return static_cast<RecordTableItem*>(data_[row])->record();
+}
+
+void RecordsTableModel::clear() {
+  beginResetModel();
+  clearData();
+  has_more_ = false;
+  fetching_ = false;
+  endResetModel();
+}
+
+void RecordsTableModel::setRecords(const std::vector<QStringList>& records) {
+  beginResetModel();
+  clearData();
+  for (const QStringList& rec : records) {
+    data_.push_back(new RecordTableItem(rec));
+  }
+  has_more_ = false;
+  fetching_ = false;
+  endResetModel();
+}
+
+void RecordsTableModel::appendRecords(const std::vector<QStringList>& records, bool has_more) {
+  fetching_ = false;
+  has_more_ = has_more;
+  if (records.empty()) {
+    return;
+  }
+
+  const size_t size = data_.size();
+  beginInsertRows(QModelIndex(), size, size + records.size() - 1);
+  for (const QStringList& rec : records) {
+    data_.push_back(new RecordTableItem(rec));
+  }
+  endInsertRows();
+}
+
+void RecordsTableModel::cancelFetch() {
+  fetching_ = false;
+  has_more_ = false;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
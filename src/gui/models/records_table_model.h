@@ -0,0 +1,64 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <QStringList>
+
+#include <common/qt/gui/base/table_model.h>
+
+namespace fastonosql {
+namespace gui {
+
+// read only rows of text with fixed headers, fetchMore asks owner for next page while more rows are expected
+class RecordsTableModel : public common::qt::gui::TableModel {
+  Q_OBJECT
+
+ public:
+  typedef common::qt::gui::TableModel base_class;
+
+  explicit RecordsTableModel(const QStringList& headers, QObject* parent = Q_NULLPTR);
+
+  QVariant data(const QModelIndex& index, int role) const override;
+  QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+  int columnCount(const QModelIndex& parent) const override;
+
+  bool canFetchMore(const QModelIndex& parent) const override;
+  void fetchMore(const QModelIndex& parent) override;
+
+  QStringList record(int row) const;
+
+  void clear();
+  void setRecords(const std::vector<QStringList>& records);
+  void appendRecords(const std::vector<QStringList>& records, bool has_more);
+  void cancelFetch();
+
+ Q_SIGNALS:
+  void fetchRequested();
+
+ private:
+  const QStringList headers_;
+  bool has_more_;
+  bool fetching_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,930 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/pickle_codec.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <common/sprintf.h>
+
+#include <fastonosql/core/types.h>
+
+#include "gui/simd_codecs.h"
+
+// opcodes from python Lib/pickle.py
+#define PICKLE_MARK '('
+#define PICKLE_STOP '.'
+#define PICKLE_POP '0'
+#define PICKLE_POP_MARK '1'
+#define PICKLE_DUP '2'
+#define PICKLE_FLOAT 'F'
+#define PICKLE_INT 'I'
+#define PICKLE_BININT 'J'
+#define PICKLE_BININT1 'K'
+#define PICKLE_LONG 'L'
+#define PICKLE_BININT2 'M'
+#define PICKLE_NONE 'N'
+#define PICKLE_STRING 'S'
+#define PICKLE_BINSTRING 'T'
+#define PICKLE_SHORT_BINSTRING 'U'
+#define PICKLE_UNICODE 'V'
+#define PICKLE_BINUNICODE 'X'
+#define PICKLE_APPEND 'a'
+#define PICKLE_DICT 'd'
+#define PICKLE_EMPTY_DICT '}'
+#define PICKLE_APPENDS 'e'
+#define PICKLE_GET 'g'
+#define PICKLE_BINGET 'h'
+#define PICKLE_LONG_BINGET 'j'
+#define PICKLE_LIST 'l'
+#define PICKLE_EMPTY_LIST ']'
+#define PICKLE_PUT 'p'
+#define PICKLE_BINPUT 'q'
+#define PICKLE_LONG_BINPUT 'r'
+#define PICKLE_SETITEM 's'
+#define PICKLE_TUPLE 't'
+#define PICKLE_EMPTY_TUPLE ')'
+#define PICKLE_SETITEMS 'u'
+#define PICKLE_BINFLOAT 'G'
+#define PICKLE_BINBYTES 'B'
+#define PICKLE_SHORT_BINBYTES 'C'
+#define PICKLE_PROTO '\x80'
+#define PICKLE_TUPLE1 '\x85'
+#define PICKLE_TUPLE2 '\x86'
+#define PICKLE_TUPLE3 '\x87'
+#define PICKLE_NEWTRUE '\x88'
+#define PICKLE_NEWFALSE '\x89'
+#define PICKLE_LONG1 '\x8a'
+#define PICKLE_LONG4 '\x8b'
+#define PICKLE_SHORT_BINUNICODE '\x8c'
+#define PICKLE_BINUNICODE8 '\x8d'
+#define PICKLE_BINBYTES8 '\x8e'
+#define PICKLE_EMPTY_SET '\x8f'
+#define PICKLE_ADDITEMS '\x90'
+#define PICKLE_FROZENSET '\x91'
+#define PICKLE_MEMOIZE '\x94'
+#define PICKLE_FRAME '\x95'
+
+#define PICKLE_HIGHEST_SUPPORTED_PROTOCOL 5
+#define PICKLE_MAX_REPR_DEPTH 64
+#define PICKLE_MAX_REPR_SIZE (16 * 1024 * 1024)
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+
+enum PickleType { P_MARK, P_NONE, P_BOOL, P_INT, P_FLOAT, P_STR, P_BYTES, P_UNICODE, P_LIST, P_TUPLE, P_DICT, P_SET, P_FROZENSET };
+
+struct PickleObject;
+typedef std::shared_ptr<PickleObject> pickle_object_t;
+
+struct PickleObject {
+  explicit PickleObject(PickleType type) : type(type), integer(0), real(0), data(), items() {}
+
+  PickleType type;
+  int64_t integer;  // bool too
+  double real;
+  std::string data;                    // strings, text of big integers
+  std::vector<pickle_object_t> items;  // dict keeps key, value pairs
+};
+
+pickle_object_t MakeObject(PickleType type) {
+  return std::make_shared<PickleObject>(type);
+}
+
+int HexDigit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  } else if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  } else if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+bool ParseHex(const std::string& str, size_t pos, size_t count, uint32_t* out) {
+  if (pos + count > str.size()) {
+    return false;
+  }
+
+  uint32_t result = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const int digit = HexDigit(str[pos + i]);
+    if (digit < 0) {
+      return false;
+    }
+    result = (result << 4) | digit;
+  }
+  *out = result;
+  return true;
+}
+
+// STRING argument: quoted python literal with backslash escapes
+bool DecodeStringLiteral(const std::string& line, std::string* out) {
+  if (line.size() < 2 || (line[0] != '\'' && line[0] != '"') || line[line.size() - 1] != line[0]) {
+    return false;
+  }
+
+  std::string result;
+  const size_t end = line.size() - 1;
+  for (size_t i = 1; i < end; ++i) {
+    char c = line[i];
+    if (c != '\\') {
+      result.push_back(c);
+      continue;
+    }
+
+    if (++i >= end) {
+      return false;
+    }
+    c = line[i];
+    if (c == 'n') {
+      result.push_back('\n');
+    } else if (c == 'r') {
+      result.push_back('\r');
+    } else if (c == 't') {
+      result.push_back('\t');
+    } else if (c == 'a') {
+      result.push_back('\a');
+    } else if (c == 'b') {
+      result.push_back('\b');
+    } else if (c == 'f') {
+      result.push_back('\f');
+    } else if (c == 'v') {
+      result.push_back('\v');
+    } else if (c == 'x') {
+      uint32_t byte = 0;
+      if (!ParseHex(line, i + 1, 2, &byte)) {
+        return false;
+      }
+      result.push_back(static_cast<char>(byte));
+      i += 2;
+    } else if (c >= '0' && c <= '7') {
+      uint32_t byte = 0;
+      size_t digits = 0;
+      while (digits < 3 && i < end && line[i] >= '0' && line[i] <= '7') {
+        byte = byte * 8 + (line[i] - '0');
+        ++i;
+        ++digits;
+      }
+      --i;
+      result.push_back(static_cast<char>(byte & 0xFF));
+    } else {
+      // \\, \', \" and unknown escapes keep the char
+      result.push_back(c);
+    }
+  }
+
+  *out = result;
+  return true;
+}
+
+// UNICODE argument: raw-unicode-escape, latin-1 bytes with \uXXXX and \UXXXXXXXX
+bool DecodeRawUnicodeEscape(const std::string& line, std::string* out) {
+  std::string result;
+  for (size_t i = 0; i < line.size(); ++i) {
+    const unsigned char c = line[i];
+    if (c == '\\' && i + 1 < line.size() && (line[i + 1] == 'u' || line[i + 1] == 'U')) {
+      const size_t digits = line[i + 1] == 'u' ? 4 : 8;
+      uint32_t cp = 0;
+      if (!ParseHex(line, i + 2, digits, &cp)) {
+        return false;
+      }
+      utf8_append(cp, &result);
+      i += 1 + digits;
+      continue;
+    }
+    utf8_append(c, &result);
+  }
+
+  *out = result;
+  return true;
+}
+
+class PickleReader {
+ public:
+  PickleReader(const char* data, size_t size) : data_(data), size_(size), pos_(0), stack_(), marks_(), memo_() {}
+
+  bool Load(pickle_object_t* result) {
+    while (pos_ < size_) {
+      const char op = data_[pos_++];
+      if (op == PICKLE_STOP) {
+        if (stack_.size() != 1 || !marks_.empty()) {
+          return false;
+        }
+        *result = stack_.back();
+        return true;
+      }
+
+      if (!Dispatch(op)) {
+        return false;
+      }
+    }
+
+    return false;
+  }
+
+ private:
+  bool Dispatch(char op) {
+    switch (op) {
+      case PICKLE_PROTO: {
+        uint64_t proto = 0;
+        return ReadUInt(1, &proto) && proto <= PICKLE_HIGHEST_SUPPORTED_PROTOCOL;
+      }
+      case PICKLE_FRAME: {
+        uint64_t frame_size = 0;
+        return ReadUInt(8, &frame_size);
+      }
+      case PICKLE_MARK:
+        marks_.push_back(stack_.size());
+        return true;
+      case PICKLE_POP:
+        if (stack_.empty()) {
+          return false;
+        }
+        stack_.pop_back();
+        return true;
+      case PICKLE_POP_MARK: {
+        std::vector<pickle_object_t> items;
+        return PopMark(&items);
+      }
+      case PICKLE_DUP:
+        if (stack_.empty()) {
+          return false;
+        }
+        stack_.push_back(stack_.back());
+        return true;
+      case PICKLE_NONE:
+        stack_.push_back(MakeObject(P_NONE));
+        return true;
+      case PICKLE_NEWTRUE:
+      case PICKLE_NEWFALSE: {
+        pickle_object_t obj = MakeObject(P_BOOL);
+        obj->integer = op == PICKLE_NEWTRUE;
+        stack_.push_back(obj);
+        return true;
+      }
+      case PICKLE_INT:
+        return LoadTextInt();
+      case PICKLE_LONG:
+        return LoadTextLong();
+      case PICKLE_BININT:
+        return LoadBinInt(4, true);
+      case PICKLE_BININT1:
+        return LoadBinInt(1, false);
+      case PICKLE_BININT2:
+        return LoadBinInt(2, false);
+      case PICKLE_LONG1:
+        return LoadBinLong(1);
+      case PICKLE_LONG4:
+        return LoadBinLong(4);
+      case PICKLE_FLOAT:
+        return LoadTextFloat();
+      case PICKLE_BINFLOAT:
+        return LoadBinFloat();
+      case PICKLE_STRING: {
+        std::string line;
+        std::string str;
+        if (!ReadLine(&line) || !DecodeStringLiteral(line, &str)) {
+          return false;
+        }
+        return PushString(P_STR, str);
+      }
+      case PICKLE_UNICODE: {
+        std::string line;
+        std::string str;
+        if (!ReadLine(&line) || !DecodeRawUnicodeEscape(line, &str)) {
+          return false;
+        }
+        return PushString(P_UNICODE, str);
+      }
+      case PICKLE_SHORT_BINSTRING:
+        return LoadSizedString(1, P_STR);
+      case PICKLE_BINSTRING:
+        return LoadSizedString(4, P_STR);
+      case PICKLE_SHORT_BINUNICODE:
+        return LoadSizedString(1, P_UNICODE);
+      case PICKLE_BINUNICODE:
+        return LoadSizedString(4, P_UNICODE);
+      case PICKLE_BINUNICODE8:
+        return LoadSizedString(8, P_UNICODE);
+      case PICKLE_SHORT_BINBYTES:
+        return LoadSizedString(1, P_BYTES);
+      case PICKLE_BINBYTES:
+        return LoadSizedString(4, P_BYTES);
+      case PICKLE_BINBYTES8:
+        return LoadSizedString(8, P_BYTES);
+      case PICKLE_EMPTY_LIST:
+        stack_.push_back(MakeObject(P_LIST));
+        return true;
+      case PICKLE_EMPTY_TUPLE:
+        stack_.push_back(MakeObject(P_TUPLE));
+        return true;
+      case PICKLE_EMPTY_DICT:
+        stack_.push_back(MakeObject(P_DICT));
+        return true;
+      case PICKLE_EMPTY_SET:
+        stack_.push_back(MakeObject(P_SET));
+        return true;
+      case PICKLE_LIST:
+        return LoadFromMark(P_LIST);
+      case PICKLE_TUPLE:
+        return LoadFromMark(P_TUPLE);
+      case PICKLE_FROZENSET:
+        return LoadFromMark(P_FROZENSET);
+      case PICKLE_DICT:
+        return LoadFromMark(P_DICT);
+      case PICKLE_TUPLE1:
+        return LoadTuple(1);
+      case PICKLE_TUPLE2:
+        return LoadTuple(2);
+      case PICKLE_TUPLE3:
+        return LoadTuple(3);
+      case PICKLE_APPEND:
+        return AddItems(1, P_LIST);
+      case PICKLE_SETITEM:
+        return AddItems(2, P_DICT);
+      case PICKLE_APPENDS:
+        return AddMarkedItems(P_LIST);
+      case PICKLE_SETITEMS:
+        return AddMarkedItems(P_DICT);
+      case PICKLE_ADDITEMS:
+        return AddMarkedItems(P_SET);
+      case PICKLE_PUT: {
+        std::string line;
+        return ReadLine(&line) && Put(strtoull(line.c_str(), nullptr, 10));
+      }
+      case PICKLE_BINPUT: {
+        uint64_t index = 0;
+        return ReadUInt(1, &index) && Put(index);
+      }
+      case PICKLE_LONG_BINPUT: {
+        uint64_t index = 0;
+        return ReadUInt(4, &index) && Put(index);
+      }
+      case PICKLE_MEMOIZE:
+        return Put(memo_.size());
+      case PICKLE_GET: {
+        std::string line;
+        return ReadLine(&line) && Get(strtoull(line.c_str(), nullptr, 10));
+      }
+      case PICKLE_BINGET: {
+        uint64_t index = 0;
+        return ReadUInt(1, &index) && Get(index);
+      }
+      case PICKLE_LONG_BINGET: {
+        uint64_t index = 0;
+        return ReadUInt(4, &index) && Get(index);
+      }
+      default:
+        // globals, reduce, build, persistent ids and so on need python
+        return false;
+    }
+  }
+
+  bool ReadBytes(size_t count, const char** out) {
+    if (count > size_ - pos_) {
+      return false;
+    }
+
+    *out = data_ + pos_;
+    pos_ += count;
+    return true;
+  }
+
+  // little endian as in pickle
+  bool ReadUInt(size_t count, uint64_t* out) {
+    const char* bytes = nullptr;
+    if (!ReadBytes(count, &bytes)) {
+      return false;
+    }
+
+    uint64_t result = 0;
+    for (size_t i = 0; i < count; ++i) {
+      result |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+    }
+    *out = result;
+    return true;
+  }
+
+  bool ReadLine(std::string* out) {
+    const void* nl = memchr(data_ + pos_, '\n', size_ - pos_);
+    if (!nl) {
+      return false;
+    }
+
+    const size_t end = static_cast<const char*>(nl) - data_;
+    out->assign(data_ + pos_, end - pos_);
+    pos_ = end + 1;
+    if (!out->empty() && (*out)[out->size() - 1] == '\r') {
+      out->erase(out->size() - 1);
+    }
+    return true;
+  }
+
+  bool PushString(PickleType type, const std::string& str) {
+    pickle_object_t obj = MakeObject(type);
+    obj->data = str;
+    stack_.push_back(obj);
+    return true;
+  }
+
+  bool LoadSizedString(size_t size_bytes, PickleType type) {
+    uint64_t size = 0;
+    const char* bytes = nullptr;
+    if (!ReadUInt(size_bytes, &size) || !ReadBytes(size, &bytes)) {
+      return false;
+    }
+
+    return PushString(type, std::string(bytes, size));
+  }
+
+  bool LoadTextInt() {
+    std::string line;
+    if (!ReadLine(&line) || line.empty()) {
+      return false;
+    }
+
+    // protocol 0 booleans
+    if (line == "00" || line == "01") {
+      pickle_object_t obj = MakeObject(P_BOOL);
+      obj->integer = line == "01";
+      stack_.push_back(obj);
+      return true;
+    }
+
+    char* end = nullptr;
+    pickle_object_t obj = MakeObject(P_INT);
+    obj->integer = strtoll(line.c_str(), &end, 10);
+    if (*end != 0) {
+      // doesn't fit into int64, keep text
+      obj->data = line;
+    }
+    stack_.push_back(obj);
+    return true;
+  }
+
+  bool LoadTextLong() {
+    std::string line;
+    if (!ReadLine(&line) || line.empty()) {
+      return false;
+    }
+
+    if (line[line.size() - 1] == 'L') {
+      line.erase(line.size() - 1);
+    }
+    pickle_object_t obj = MakeObject(P_INT);
+    obj->data = line;
+    stack_.push_back(obj);
+    return true;
+  }
+
+  bool LoadBinInt(size_t count, bool is_signed) {
+    uint64_t value = 0;
+    if (!ReadUInt(count, &value)) {
+      return false;
+    }
+
+    pickle_object_t obj = MakeObject(P_INT);
+    obj->integer = is_signed ? static_cast<int32_t>(value) : static_cast<int64_t>(value);
+    stack_.push_back(obj);
+    return true;
+  }
+
+  bool LoadBinLong(size_t size_bytes) {
+    uint64_t count = 0;
+    const char* bytes = nullptr;
+    if (!ReadUInt(size_bytes, &count) || !ReadBytes(count, &bytes)) {
+      return false;
+    }
+
+    pickle_object_t obj = MakeObject(P_INT);
+    if (count > sizeof(int64_t)) {
+      obj->data = BigIntToString(reinterpret_cast<const unsigned char*>(bytes), count);
+      stack_.push_back(obj);
+      return true;
+    }
+
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+      value |= static_cast<uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+    }
+    // two's complement sign extension
+    if (count && count < sizeof(int64_t) && (bytes[count - 1] & 0x80)) {
+      value |= ~0ULL << (8 * count);
+    }
+    obj->integer = static_cast<int64_t>(value);
+    stack_.push_back(obj);
+    return true;
+  }
+
+  // little endian two's complement of any length to decimal text
+  static std::string BigIntToString(const unsigned char* bytes, size_t count) {
+    const bool is_negative = bytes[count - 1] & 0x80;
+    // big endian magnitude
+    std::vector<unsigned char> magnitude(bytes, bytes + count);
+    std::reverse(magnitude.begin(), magnitude.end());
+    if (is_negative) {
+      unsigned carry = 1;
+      for (size_t i = magnitude.size(); i-- > 0;) {
+        const unsigned sum = static_cast<unsigned char>(~magnitude[i]) + carry;
+        magnitude[i] = sum & 0xFF;
+        carry = sum >> 8;
+      }
+    }
+
+    std::string digits;
+    bool is_zero = false;
+    while (!is_zero) {
+      unsigned remainder = 0;
+      is_zero = true;
+      for (size_t i = 0; i < magnitude.size(); ++i) {
+        const unsigned current = (remainder << 8) | magnitude[i];
+        magnitude[i] = current / 10;
+        remainder = current % 10;
+        if (magnitude[i]) {
+          is_zero = false;
+        }
+      }
+      digits.push_back('0' + remainder);
+    }
+
+    if (is_negative) {
+      digits.push_back('-');
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+  }
+
+  bool LoadTextFloat() {
+    std::string line;
+    if (!ReadLine(&line)) {
+      return false;
+    }
+
+    pickle_object_t obj = MakeObject(P_FLOAT);
+    obj->real = strtod(line.c_str(), nullptr);
+    stack_.push_back(obj);
+    return true;
+  }
+
+  bool LoadBinFloat() {
+    const char* bytes = nullptr;
+    if (!ReadBytes(sizeof(double), &bytes)) {
+      return false;
+    }
+
+    // big endian
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(double); ++i) {
+      bits = (bits << 8) | static_cast<unsigned char>(bytes[i]);
+    }
+
+    pickle_object_t obj = MakeObject(P_FLOAT);
+    memcpy(&obj->real, &bits, sizeof(double));
+    stack_.push_back(obj);
+    return true;
+  }
+
+  bool PopMark(std::vector<pickle_object_t>* items) {
+    if (marks_.empty() || marks_.back() > stack_.size()) {
+      return false;
+    }
+
+    const size_t mark = marks_.back();
+    marks_.pop_back();
+    items->assign(stack_.begin() + mark, stack_.end());
+    stack_.resize(mark);
+    return true;
+  }
+
+  bool LoadFromMark(PickleType type) {
+    std::vector<pickle_object_t> items;
+    if (!PopMark(&items) || (type == P_DICT && items.size() % 2 != 0)) {
+      return false;
+    }
+
+    pickle_object_t obj = MakeObject(type);
+    obj->items = items;
+    stack_.push_back(obj);
+    return true;
+  }
+
+  bool LoadTuple(size_t count) {
+    if (stack_.size() < count) {
+      return false;
+    }
+
+    pickle_object_t obj = MakeObject(P_TUPLE);
+    obj->items.assign(stack_.end() - count, stack_.end());
+    stack_.resize(stack_.size() - count);
+    stack_.push_back(obj);
+    return true;
+  }
+
+  bool AddItems(size_t count, PickleType type) {
+    if (stack_.size() < count + 1) {
+      return false;
+    }
+
+    pickle_object_t target = stack_[stack_.size() - count - 1];
+    if (target->type != type) {
+      return false;
+    }
+
+    target->items.insert(target->items.end(), stack_.end() - count, stack_.end());
+    stack_.resize(stack_.size() - count);
+    return true;
+  }
+
+  bool AddMarkedItems(PickleType type) {
+    std::vector<pickle_object_t> items;
+    if (!PopMark(&items) || stack_.empty()) {
+      return false;
+    }
+
+    pickle_object_t target = stack_.back();
+    if (target->type != type || (type == P_DICT && items.size() % 2 != 0)) {
+      return false;
+    }
+
+    target->items.insert(target->items.end(), items.begin(), items.end());
+    return true;
+  }
+
+  bool Put(uint64_t index) {
+    if (stack_.empty()) {
+      return false;
+    }
+
+    // indexes come from the payload, sparse storage keeps memory bounded by the input size
+    memo_[index] = stack_.back();
+    return true;
+  }
+
+  bool Get(uint64_t index) {
+    const auto it = memo_.find(index);
+    if (it == memo_.end() || !it->second) {
+      return false;
+    }
+
+    stack_.push_back(it->second);
+    return true;
+  }
+
+  const char* const data_;
+  const size_t size_;
+  size_t pos_;
+  std::vector<pickle_object_t> stack_;
+  std::vector<size_t> marks_;
+  std::unordered_map<uint64_t, pickle_object_t> memo_;
+};
+
+void ReprString(const std::string& str, bool is_bytes, std::string* out) {
+  if (is_bytes) {
+    out->push_back('b');
+  }
+  out->push_back('\'');
+  for (unsigned char c : str) {
+    if (c == '\'' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(c);
+    } else if (c == '\n') {
+      out->append("\\n");
+    } else if (c == '\r') {
+      out->append("\\r");
+    } else if (c == '\t') {
+      out->append("\\t");
+    } else if (c < 0x20 || c == 0x7F || (is_bytes && c >= 0x80)) {
+      out->append(common::MemSPrintf("\\x%02x", c));
+    } else {
+      // utf-8 of text is kept readable
+      out->push_back(c);
+    }
+  }
+  out->push_back('\'');
+}
+
+// shortest text which reads back to the same double, like python does
+void ReprFloat(double value, std::string* out) {
+  std::string text;
+  for (int precision = 1; precision <= 17; ++precision) {
+    text = common::MemSPrintf("%.*g", precision, value);
+    if (strtod(text.c_str(), nullptr) == value) {
+      break;
+    }
+  }
+
+  if (text.find_first_of(".eni") == std::string::npos) {
+    text.append(".0");
+  }
+  out->append(text);
+}
+
+struct ReprState {
+  explicit ReprState(size_t max_size) : visiting(), limit(max_size), is_truncated(false) {}
+
+  std::set<const PickleObject*> visiting;
+  const size_t limit;
+  bool is_truncated;
+};
+
+// every call appends something before descending, so the limit bounds time as well as memory:
+// shared references (DUP, memo GET) can make repr exponentially bigger than the pickle
+void Repr(const pickle_object_t& obj, ReprState* state, std::string* out) {
+  if (out->size() >= state->limit) {
+    state->is_truncated = true;
+    return;
+  }
+
+  std::set<const PickleObject*>* visiting = &state->visiting;
+  const bool is_container =
+      obj->type == P_LIST || obj->type == P_TUPLE || obj->type == P_DICT || obj->type == P_SET || obj->type == P_FROZENSET;
+  if (is_container && (visiting->count(obj.get()) || visiting->size() >= PICKLE_MAX_REPR_DEPTH)) {
+    out->append("...");
+    return;
+  }
+
+  switch (obj->type) {
+    case P_MARK:
+    case P_NONE:
+      out->append("None");
+      return;
+    case P_BOOL:
+      out->append(obj->integer ? "True" : "False");
+      return;
+    case P_INT:
+      out->append(obj->data.empty() ? common::MemSPrintf("%lld", static_cast<long long>(obj->integer)) : obj->data);
+      return;
+    case P_FLOAT:
+      ReprFloat(obj->real, out);
+      return;
+    case P_STR:
+    case P_UNICODE:
+      ReprString(obj->data, false, out);
+      return;
+    case P_BYTES:
+      ReprString(obj->data, true, out);
+      return;
+    default:
+      break;
+  }
+
+  visiting->insert(obj.get());
+  const std::vector<pickle_object_t>& items = obj->items;
+  if (obj->type == P_DICT) {
+    out->push_back('{');
+    for (size_t i = 0; i + 1 < items.size() && !state->is_truncated; i += 2) {
+      if (i) {
+        out->append(", ");
+      }
+      Repr(items[i], state, out);
+      out->append(": ");
+      Repr(items[i + 1], state, out);
+    }
+    out->push_back('}');
+  } else if ((obj->type == P_SET || obj->type == P_FROZENSET) && items.empty()) {
+    out->append(obj->type == P_SET ? "set()" : "frozenset()");
+  } else {
+    const char* open = "[";
+    const char* close = "]";
+    if (obj->type == P_TUPLE) {
+      open = "(";
+      close = items.size() == 1 ? ",)" : ")";
+    } else if (obj->type == P_SET) {
+      open = "{";
+      close = "}";
+    } else if (obj->type == P_FROZENSET) {
+      open = "frozenset({";
+      close = "})";
+    }
+
+    out->append(open);
+    for (size_t i = 0; i < items.size() && !state->is_truncated; ++i) {
+      if (i) {
+        out->append(", ");
+      }
+      Repr(items[i], state, out);
+    }
+    out->append(close);
+  }
+  visiting->erase(obj.get());
+}
+
+bool Loads(const convert_in_t& value, size_t limit, std::string* out, bool* is_truncated) {
+  if (value.empty()) {
+    return false;
+  }
+
+  PickleReader reader(value.data(), value.size());
+  pickle_object_t obj;
+  if (!reader.Load(&obj)) {
+    return false;
+  }
+
+  ReprState state(limit);
+  if (obj->type == P_STR || obj->type == P_UNICODE || obj->type == P_BYTES) {
+    *out = obj->data;
+  } else {
+    Repr(obj, &state, out);
+  }
+
+  // the last scalar may overshoot the limit
+  if (out->size() > limit) {
+    out->resize(limit);
+    state.is_truncated = true;
+  }
+
+  *is_truncated = state.is_truncated;
+  return true;
+}
+
+void AppendUInt32(uint32_t value, std::string* out) {
+  for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+    out->push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+  }
+}
+
+}  // namespace
+
+bool pickle_loads(const convert_in_t& value, convert_out_t* out) {
+  if (!out) {
+    return false;
+  }
+
+  std::string result;
+  bool is_truncated = false;
+  if (!Loads(value, PICKLE_MAX_REPR_SIZE, &result, &is_truncated)) {
+    return false;
+  }
+
+  if (is_truncated) {
+    result.append("...");
+  }
+  *out = GEN_CMD_STRING_SIZE(result.data(), result.size());
+  return true;
+}
+
+bool pickle_loads(const convert_in_t& value, size_t output_limit, convert_out_t* out, bool* is_truncated) {
+  if (!out || !is_truncated) {
+    return false;
+  }
+
+  std::string result;
+  if (!Loads(value, output_limit ? output_limit : PICKLE_MAX_REPR_SIZE, &result, is_truncated)) {
+    return false;
+  }
+
+  *out = GEN_CMD_STRING_SIZE(result.data(), result.size());
+  return true;
+}
+
+bool pickle_dumps(const convert_in_t& data, convert_out_t* out) {
+  if (!out || data.empty()) {
+    return false;
+  }
+
+  std::string result;
+  result.push_back(PICKLE_PROTO);
+  result.push_back(2);
+  if (data.size() < 256) {
+    result.push_back(PICKLE_SHORT_BINSTRING);
+    result.push_back(static_cast<char>(data.size()));
+  } else {
+    result.push_back(PICKLE_BINSTRING);
+    AppendUInt32(static_cast<uint32_t>(data.size()), &result);
+  }
+  result.append(data.data(), data.size());
+  result.push_back(PICKLE_STOP);
+
+  *out = GEN_CMD_STRING_SIZE(result.data(), result.size());
+  return true;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,38 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "gui/text_converter.h"
+
+namespace fastonosql {
+namespace gui {
+
+// native reader of plain data pickles (protocols 0-5): None, bool, numbers, strings, bytes
+// and containers of them, false for anything requiring python (class instances, globals)
+// strings are returned as is, other objects as their python repr cut with "..." at PICKLE_MAX_REPR_SIZE
+bool pickle_loads(const convert_in_t& value, convert_out_t* out);
+
+// same but never produces more than output_limit bytes (0 - PICKLE_MAX_REPR_SIZE)
+bool pickle_loads(const convert_in_t& value, size_t output_limit, convert_out_t* out, bool* is_truncated);
+
+// pickles data as python 2 str with protocol 2
+bool pickle_dumps(const convert_in_t& data, convert_out_t* out);
+
+}  // namespace gui
+}  // namespace fastonosql
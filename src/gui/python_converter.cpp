@@ -16,37 +16,56 @@
     along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
 */
 
+
 #include "gui/python_converter.h"
 
+#if !defined(OS_WIN)
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <mutex>
+#include <string>
+
 #include <common/file_system/string_path_utils.h>
 #include <common/qt/convert2string.h>
 #include <common/sprintf.h>
 
+#include <fastonosql/core/types.h>
+
+#include "gui/pickle_codec.h"
 #include "gui/text_converter.h"
 
 #include "proxy/settings_manager.h"
 
 #define CONVERT_PICKLE_SCRIPT_NAME "convert_pickle.py"
+#define PICKLE_WORKER_TIMEOUT_MSEC 5000
+
+#if defined(MSG_NOSIGNAL)
+#define PICKLE_WORKER_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define PICKLE_WORKER_SEND_FLAGS 0
+#endif
 
 namespace fastonosql {
 namespace gui {
 
-bool string_from_pickle(const convert_in_t& value, convert_out_t* out) {
-  if (!out || value.empty()) {
-    return false;
-  }
-
-  convert_out_t value_xhex;
-  if (!string_to_hex(value, &value_xhex)) {
-    return false;
-  }
+namespace {
 
-  const QString python_path = proxy::SettingsManager::GetInstance()->GetPythonPath();
-  if (python_path.isEmpty()) {
+bool GetPickleScript(std::string* python_path, std::string* script_path) {
+  const QString python_path_qstr = proxy::SettingsManager::GetInstance()->GetPythonPath();
+  if (python_path_qstr.isEmpty()) {
     return false;
   }
 
-  const std::string python_path_str = common::ConvertToString(python_path);
+  const std::string python_path_str = common::ConvertToString(python_path_qstr);
   if (!common::file_system::is_file_exist(python_path_str)) {
     return false;
   }
@@ -57,64 +76,215 @@ bool string_from_pickle(const convert_in_t& value, convert_out_t* out) {
     return false;
   }
 
-  const std::string cmd = common::MemSPrintf("%s %s %s", python_path_str, pickle_script_path, value_xhex.as_string());
-  FILE* fp = popen(cmd.c_str(), "r");
-  if (!fp) {
-    return false;
+  *python_path = python_path_str;
+  *script_path = pickle_script_path;
+  return true;
+}
+
+#if !defined(OS_WIN)
+// long lived "convert_pickle.py --server" process, one interpreter serves all values.
+// request: uint32 count, then per value uint32 size + bytes
+// response: uint32 count, then per value status byte (0 ok) + uint32 size + bytes
+// all integers are big endian
+class PickleWorker {
+ public:
+  static PickleWorker* GetInstance() {
+    static PickleWorker worker;
+    return &worker;
   }
 
-  convert_in_t xhexed_res;
-  char c;
-  do {
-    c = fgetc(fp);
-    if (c == EOF || c == '\n') {
-      break;
+  bool Decode(const std::vector<convert_in_t>& values, std::vector<convert_out_t>* out) {
+    std::lock_guard<std::mutex> lock(lock_);
+    if (!IsRunning() && !Start()) {
+      return false;
     }
-    xhexed_res.append(c);
-  } while (true);
-  pclose(fp);
 
-  if (xhexed_res.empty()) {
-    return false;
+    if (!Exchange(values, out)) {
+      // broken stream or hanged script, next call respawns it
+      Stop();
+      return false;
+    }
+    return true;
   }
 
-  convert_out_t clear_data;
-  if (!string_from_hex(xhexed_res, &clear_data)) {
-    return false;
+ private:
+  PickleWorker() : pid_(-1), fd_(-1) {}
+  ~PickleWorker() { Stop(); }
+
+  bool IsRunning() const { return pid_ > 0 && waitpid(pid_, nullptr, WNOHANG) == 0; }
+
+  bool Start() {
+    Stop();
+
+    std::string python_path;
+    std::string script_path;
+    if (!GetPickleScript(&python_path, &script_path)) {
+      return false;
+    }
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+      return false;
+    }
+
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+#if defined(SO_NOSIGPIPE)
+    int on = 1;
+    setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      return false;
+    }
+
+    if (pid == 0) {
+      dup2(fds[1], STDIN_FILENO);
+      dup2(fds[1], STDOUT_FILENO);
+      close(fds[0]);
+      close(fds[1]);
+      execl(python_path.c_str(), python_path.c_str(), script_path.c_str(), "--server", static_cast<char*>(nullptr));
+      _exit(EXIT_FAILURE);
+    }
+
+    close(fds[1]);
+    pid_ = pid;
+    fd_ = fds[0];
+    return true;
   }
 
-  *out = clear_data;
-  return true;
-}
+  void Stop() {
+    if (fd_ != -1) {
+      close(fd_);
+      fd_ = -1;
+    }
 
-bool string_to_pickle(const convert_in_t& data, convert_out_t* out) {
-  if (!out || data.empty()) {
-    return false;
+    if (pid_ > 0) {
+      kill(pid_, SIGTERM);
+      waitpid(pid_, nullptr, 0);
+      pid_ = -1;
+    }
   }
 
-  convert_out_t value_xhex;
-  if (!string_to_hex(data, &value_xhex)) {
-    return false;
+  bool Exchange(const std::vector<convert_in_t>& values, std::vector<convert_out_t>* out) {
+    std::string request;
+    AppendSize(values.size(), &request);
+    for (size_t i = 0; i < values.size(); ++i) {
+      AppendSize(values[i].size(), &request);
+      request.append(values[i].data(), values[i].size());
+    }
+
+    if (!WriteAll(request.data(), request.size())) {
+      return false;
+    }
+
+    uint32_t count = 0;
+    if (!ReadSize(&count) || count != values.size()) {
+      return false;
+    }
+
+    std::vector<convert_out_t> result(count);
+    std::string buffer;
+    for (uint32_t i = 0; i < count; ++i) {
+      char status = 0;
+      uint32_t size = 0;
+      if (!ReadAll(&status, sizeof(status)) || !ReadSize(&size)) {
+        return false;
+      }
+
+      buffer.resize(size);
+      if (size && !ReadAll(&buffer[0], size)) {
+        return false;
+      }
+
+      if (status == 0) {
+        result[i] = GEN_CMD_STRING_SIZE(buffer.data(), buffer.size());
+      }
+    }
+
+    *out = result;
+    return true;
   }
 
-  const QString python_path = proxy::SettingsManager::GetInstance()->GetPythonPath();
-  if (python_path.isEmpty()) {
-    return false;
+  static void AppendSize(size_t size, std::string* out) {
+    const uint32_t value = static_cast<uint32_t>(size);
+    out->push_back(static_cast<char>((value >> 24) & 0xFF));
+    out->push_back(static_cast<char>((value >> 16) & 0xFF));
+    out->push_back(static_cast<char>((value >> 8) & 0xFF));
+    out->push_back(static_cast<char>(value & 0xFF));
   }
 
-  const std::string python_path_str = common::ConvertToString(python_path);
-  if (!common::file_system::is_file_exist(python_path_str)) {
+  bool ReadSize(uint32_t* size) {
+    unsigned char bytes[4];
+    if (!ReadAll(reinterpret_cast<char*>(bytes), sizeof(bytes))) {
+      return false;
+    }
+
+    *size = (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+            (static_cast<uint32_t>(bytes[2]) << 8) | bytes[3];
+    return true;
+  }
+
+  bool WriteAll(const char* data, size_t size) {
+    while (size) {
+      const ssize_t written = send(fd_, data, size, PICKLE_WORKER_SEND_FLAGS);
+      if (written < 0 && errno == EINTR) {
+        continue;
+      }
+      if (written <= 0) {
+        return false;
+      }
+      data += written;
+      size -= written;
+    }
+    return true;
+  }
+
+  bool ReadAll(char* data, size_t size) {
+    while (size) {
+      struct pollfd pfd = {fd_, POLLIN, 0};
+      const int ready = poll(&pfd, 1, PICKLE_WORKER_TIMEOUT_MSEC);
+      if (ready < 0 && errno == EINTR) {
+        continue;
+      }
+      if (ready <= 0) {
+        return false;
+      }
+
+      const ssize_t readed = recv(fd_, data, size, 0);
+      if (readed < 0 && errno == EINTR) {
+        continue;
+      }
+      if (readed <= 0) {
+        return false;
+      }
+      data += readed;
+      size -= readed;
+    }
+    return true;
+  }
+
+  std::mutex lock_;
+  pid_t pid_;
+  int fd_;
+};
+#else
+// one interpreter per value, payload goes through the command line
+bool string_from_pickle_process(const convert_in_t& value, convert_out_t* out) {
+  std::string python_path;
+  std::string script_path;
+  if (!GetPickleScript(&python_path, &script_path)) {
     return false;
   }
 
-  const std::string converters_path = proxy::SettingsManager::GetInstance()->GetConvertersPath();
-  const std::string pickle_script_path = common::file_system::make_path(converters_path, CONVERT_PICKLE_SCRIPT_NAME);
-  if (!common::file_system::is_file_exist(pickle_script_path)) {
+  convert_out_t value_xhex;
+  if (!string_to_hex(value, &value_xhex)) {
     return false;
   }
 
-  const std::string cmd =
-      common::MemSPrintf("%s %s --encode %s", python_path_str, pickle_script_path, value_xhex.as_string());
+  const std::string cmd = common::MemSPrintf("%s %s %s", python_path, script_path, value_xhex.as_string());
   FILE* fp = popen(cmd.c_str(), "r");
   if (!fp) {
     return false;
@@ -135,14 +305,76 @@ bool string_to_pickle(const convert_in_t& data, convert_out_t* out) {
     return false;
   }
 
-  convert_out_t clear_data;
-  if (!string_from_hex(xhexed_res, &clear_data)) {
+  return string_from_hex(xhexed_res, out);
+}
+#endif
+
+}  // namespace
+
+bool strings_from_pickle(const std::vector<convert_in_t>& values, std::vector<convert_out_t>* out) {
+  if (!out) {
     return false;
   }
 
-  *out = clear_data;
+  std::vector<convert_out_t> result(values.size());
+  std::vector<convert_in_t> fallback_values;
+  std::vector<size_t> fallback_indexes;
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (!pickle_loads(values[i], &result[i]) && !values[i].empty()) {
+      fallback_values.push_back(values[i]);
+      fallback_indexes.push_back(i);
+    }
+  }
+
+  bool is_all_decoded = true;
+  if (!fallback_values.empty()) {
+    std::vector<convert_out_t> decoded;
+#if !defined(OS_WIN)
+    if (!PickleWorker::GetInstance()->Decode(fallback_values, &decoded)) {
+      decoded.clear();
+    }
+#else
+    decoded.resize(fallback_values.size());
+    for (size_t i = 0; i < fallback_values.size(); ++i) {
+      string_from_pickle_process(fallback_values[i], &decoded[i]);
+    }
+#endif
+    for (size_t i = 0; i < fallback_indexes.size(); ++i) {
+      if (i < decoded.size() && !decoded[i].empty()) {
+        result[fallback_indexes[i]] = decoded[i];
+      } else {
+        is_all_decoded = false;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (values[i].empty()) {
+      is_all_decoded = false;
+    }
+  }
+
+  *out = result;
+  return is_all_decoded;
+}
+
+bool string_from_pickle(const convert_in_t& value, convert_out_t* out) {
+  if (!out || value.empty()) {
+    return false;
+  }
+
+  std::vector<convert_out_t> decoded;
+  if (!strings_from_pickle(std::vector<convert_in_t>(1, value), &decoded)) {
+    return false;
+  }
+
+  *out = decoded[0];
   return true;
 }
 
+bool string_to_pickle(const convert_in_t& data, convert_out_t* out) {
+  return pickle_dumps(data, out);
+}
+
 }  // namespace gui
 }  // namespace fastonosql
@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <fastonosql/core/basic_types.h>
 
 namespace fastonosql {
@@ -29,5 +31,9 @@ typedef core::readable_string_t convert_out_t;
 bool string_from_pickle(const convert_in_t& value, convert_out_t* out);
 bool string_to_pickle(const convert_in_t& data, convert_out_t* out);
 
+// decodes many values per python call, entries which can't be decoded are left empty
+// returns false if any value failed
+bool strings_from_pickle(const std::vector<convert_in_t>& values, std::vector<convert_out_t>* out);
+
 }  // namespace gui
 }  // namespace fastonosql
@@ -18,19 +18,64 @@
 
 #include "gui/shell/base_lexer.h"
 
+#include <map>
+
 #include <common/qt/convert2string.h>
 #include <common/sprintf.h>
 
+#include "gui/shell/command_trie.h"
+#include "proxy/startup_profiler.h"
+
 namespace fastonosql {
 namespace gui {
 namespace {
 BaseCommandsQsciLexer::validated_commands_t MakeValidatedCommands(const std::vector<core::CommandHolder>& commands) {
   BaseCommandsQsciLexer::validated_commands_t res;
+  res.reserve(commands.size());
   for (size_t i = 0; i < commands.size(); ++i) {
     res.push_back(commands[i]);
   }
   return res;
 }
+
+struct SharedCommands {
+  std::shared_ptr<const BaseCommandsQsciLexer::validated_commands_t> commands;
+  std::shared_ptr<const CommandTrie> trie;
+};
+
+SharedCommands GetSharedCommands(const std::vector<core::CommandHolder>& commands) {
+  static std::map<const std::vector<core::CommandHolder>*, SharedCommands> tables;  // gui thread only
+  auto it = tables.find(&commands);
+  if (it != tables.end()) {
+    return it->second;
+  }
+
+  proxy::StartupProfiler::ScopedPhase phase("build command table");
+  SharedCommands table;
+  table.commands = std::make_shared<const BaseCommandsQsciLexer::validated_commands_t>(MakeValidatedCommands(commands));
+  std::vector<std::string> names;
+  names.reserve(table.commands->size());
+  for (const core::CommandInfo& cmd : *table.commands) {
+    names.push_back(std::string(cmd.name.begin(), cmd.name.end()));
+  }
+  table.trie = std::make_shared<const CommandTrie>(names);
+  tables[&commands] = table;
+  return table;
+}
+
+// a name can be listed for several versions, prefer the entry valid for the connected server
+size_t PickCommand(const BaseQsciApi* api,
+                   const BaseCommandsQsciLexer::validated_commands_t& commands,
+                   const CommandTrie::indexes_t& indexes) {
+  if (api) {
+    for (size_t index : indexes) {
+      if (!api->canSkipCommand(commands[index])) {
+        return index;
+      }
+    }
+  }
+  return indexes.front();
+}
 }  // namespace
 
 BaseQsciApi::BaseQsciApi(QsciLexer* lexer) : QsciAbstractAPIs(lexer), filtered_version_(UNDEFINED_SINCE) {}
@@ -55,20 +100,19 @@ BaseCommandsQsciApi::BaseCommandsQsciApi(BaseCommandsQsciLexer* lexer) : BaseQsc
 
 void BaseCommandsQsciApi::updateAutoCompletionList(const QStringList& context, QStringList& list) {
   BaseCommandsQsciLexer* lex = static_cast<BaseCommandsQsciLexer*>(lexer());
-  auto commands = lex->commands();
+  const auto& commands = lex->commands();
+  const CommandTrie& trie = lex->commandsTrie();
   for (auto it = context.begin(); it != context.end(); ++it) {
-    QString val = *it;
-    for (size_t i = 0; i < commands.size(); ++i) {
-      core::CommandInfo cmd = commands[i];
+    const CommandTrie::indexes_t& found = trie.FindByPrefix(common::ConvertToString(*it));
+    for (size_t index : found) {
+      const core::CommandInfo& cmd = commands[index];
       if (canSkipCommand(cmd)) {
         continue;
       }
 
       QString jval;
       common::ConvertFromBytes(cmd.name, &jval);
-      if (jval.startsWith(val, Qt::CaseInsensitive)) {
-        list.append(jval + "?1");
-      }
+      list.append(jval + "?1");
     }
   }
 }
@@ -81,17 +125,12 @@ QStringList BaseCommandsQsciApi::callTips(const QStringList& context,
   UNUSED(style);
   UNUSED(shifts);
   BaseCommandsQsciLexer* lex = static_cast<BaseCommandsQsciLexer*>(lexer());
-  auto commands = lex->commands();
+  const auto& commands = lex->commands();
+  const CommandTrie& trie = lex->commandsTrie();
   for (auto it = context.begin(); it != context.end(); ++it) {
-    QString val = *it;
-    for (size_t i = 0; i < commands.size(); ++i) {
-      core::CommandInfo cmd = commands[i];
-
-      QString jval;
-      common::ConvertFromBytes(cmd.name, &jval);
-      if (QString::compare(jval, val, Qt::CaseInsensitive) == 0) {
-        return QStringList() << makeCallTip(cmd);
-      }
+    const CommandTrie::indexes_t* indexes = nullptr;
+    if (trie.Find(common::ConvertToString(*it), &indexes)) {
+      return QStringList() << makeCallTip(commands[PickCommand(this, commands, *indexes)]);
     }
   }
 
@@ -133,12 +172,13 @@ BaseQsciApi* BaseQsciLexer::apis() const {
 }
 
 BaseCommandsQsciLexer::BaseCommandsQsciLexer(const std::vector<core::CommandHolder>& commands, QObject* parent)
-    : BaseQsciLexer(parent), commands_(MakeValidatedCommands(commands)) {}
+    : BaseQsciLexer(parent), source_commands_(commands), commands_(), trie_() {}
 
 std::vector<uint32_t> BaseCommandsQsciLexer::supportedVersions() const {
+  const validated_commands_t& commands = this->commands();
   std::vector<uint32_t> result;
-  for (size_t i = 0; i < commands_.size(); ++i) {
-    core::CommandInfo cmd = commands_[i];
+  for (size_t i = 0; i < commands.size(); ++i) {
+    const core::CommandInfo& cmd = commands[i];
 
     bool needed_insert = true;
     for (size_t j = 0; j < result.size(); ++j) {
@@ -159,11 +199,27 @@ std::vector<uint32_t> BaseCommandsQsciLexer::supportedVersions() const {
 }
 
 const BaseCommandsQsciLexer::validated_commands_t& BaseCommandsQsciLexer::commands() const {
-  return commands_;
+  loadCommands();
+  return *commands_;
+}
+
+const CommandTrie& BaseCommandsQsciLexer::commandsTrie() const {
+  loadCommands();
+  return *trie_;
+}
+
+void BaseCommandsQsciLexer::loadCommands() const {
+  if (commands_) {
+    return;
+  }
+
+  const SharedCommands shared = GetSharedCommands(source_commands_);
+  commands_ = shared.commands;
+  trie_ = shared.trie;
 }
 
 size_t BaseCommandsQsciLexer::commandsCount() const {
-  return commands_.size();
+  return source_commands_.size();
 }
 
 void BaseCommandsQsciLexer::styleText(int start, int end) {
@@ -171,35 +227,54 @@ void BaseCommandsQsciLexer::styleText(int start, int end) {
     return;
   }
 
-  char* data = new char[end - start + 1];
-  editor()->SendScintilla(QsciScintilla::SCI_GETTEXTRANGE, start, end, data);
-  QString source(data);
-  delete[] data;
-
-  if (source.isEmpty()) {
+  // dirty range can start inside a command, restyle from the beginning of its line
+  int line = 0;
+  int index = 0;
+  editor()->lineIndexFromPosition(start, &line, &index);
+  start = editor()->positionFromLineIndex(line, 0);
+  if (end <= start) {
     return;
   }
 
+  std::string source(end - start + 1, 0);
+  editor()->SendScintilla(QsciScintilla::SCI_GETTEXTRANGE, start, end, &source[0]);
+  source.resize(end - start);
   paintCommands(source, start);
 }
 
-void BaseCommandsQsciLexer::paintCommands(const QString& source, int start) {
-  for (size_t i = 0; i < commands_.size(); ++i) {
-    core::CommandInfo cmd = commands_[i];
-    QString word;
-    if (common::ConvertFromBytes(cmd.name, &word)) {
-      int index = 0;
-      int begin = 0;
-
-      int st = cmd.type == core::CommandInfo::Native ? Command : ExCommand;
-      while ((begin = source.indexOf(word, index, Qt::CaseInsensitive)) != -1) {
-        index = begin + word.length();
-
-        startStyling(start + begin);
-        setStyling(word.length(), st);
-        startStyling(start + begin);
+void BaseCommandsQsciLexer::paintCommands(const std::string& source, int start) {
+  const validated_commands_t& commands = this->commands();
+  const CommandTrie& trie = commandsTrie();
+  const BaseQsciApi* api = dynamic_cast<const BaseQsciApi*>(QsciLexerCustom::apis());
+  startStyling(start);
+  size_t plain = 0;
+  size_t pos = 0;
+  while (pos < source.size()) {
+    const CommandTrie::indexes_t* indexes = nullptr;
+    const size_t length = trie.Match(source.data(), source.size(), pos, &indexes);
+    if (!length) {
+      size_t next = pos + 1;
+      if (CommandTrie::IsWordChar(source[pos])) {
+        while (next < source.size() && CommandTrie::IsWordChar(source[next])) {
+          ++next;
+        }
       }
+      plain += next - pos;
+      pos = next;
+      continue;
     }
+
+    if (plain) {
+      setStyling(static_cast<int>(plain), Default);
+      plain = 0;
+    }
+    const core::CommandInfo& cmd = commands[PickCommand(api, commands, *indexes)];
+    setStyling(static_cast<int>(length), cmd.type == core::CommandInfo::Native ? Command : ExCommand);
+    pos += length;
+  }
+
+  if (plain) {
+    setStyling(static_cast<int>(plain), Default);
   }
 }
 
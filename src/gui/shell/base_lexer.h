@@ -18,6 +18,10 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <Qsci/qsciabstractapis.h>
 #include <Qsci/qscilexercustom.h>
 
@@ -26,14 +30,14 @@
 namespace fastonosql {
 namespace gui {
 
+class CommandTrie;
+
 class BaseQsciApi : public QsciAbstractAPIs {
   Q_OBJECT
 
  public:
   explicit BaseQsciApi(QsciLexer* lexer);
   void setFilteredVersion(uint32_t version);
-
- protected:
   bool canSkipCommand(const core::CommandInfo& info) const;
 
  private:
@@ -75,15 +79,20 @@ class BaseCommandsQsciLexer : public BaseQsciLexer {
   std::vector<uint32_t> supportedVersions() const override;
   size_t commandsCount() const override;
   const validated_commands_t& commands() const;
+  const CommandTrie& commandsTrie() const;
 
  protected:
   explicit BaseCommandsQsciLexer(const std::vector<core::CommandHolder>& commands, QObject* parent = Q_NULLPTR);
 
  private:
   void styleText(int start, int end) override;
-  void paintCommands(const QString& source, int start);
+  void paintCommands(const std::string& source, int start);
+  void loadCommands() const;
 
-  const validated_commands_t commands_;
+  // lexers of one database type share the table, it is built on first use
+  const std::vector<core::CommandHolder>& source_commands_;
+  mutable std::shared_ptr<const validated_commands_t> commands_;
+  mutable std::shared_ptr<const CommandTrie> trie_;
 };
 
 class BaseCommandsQsciApi : public BaseQsciApi {
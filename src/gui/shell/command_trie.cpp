@@ -0,0 +1,148 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/shell/command_trie.h"
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+inline unsigned char ToLower(char c) {
+  const unsigned char uc = static_cast<unsigned char>(c);
+  return uc >= 'A' && uc <= 'Z' ? uc + ('a' - 'A') : uc;
+}
+}  // namespace
+
+CommandTrie::CommandTrie(const std::vector<std::string>& words)
+    : classes_(), classes_count_(1), transitions_(), words_(), prefixed_(), words_count_(words.size()) {
+  for (const std::string& word : words) {
+    for (char c : word) {
+      const unsigned char lc = ToLower(c);
+      if (!classes_[lc]) {
+        classes_[lc] = static_cast<uint8_t>(classes_count_++);
+      }
+    }
+  }
+  for (unsigned char c = 'a'; c <= 'z'; ++c) {
+    classes_[c - ('a' - 'A')] = classes_[c];
+  }
+
+  transitions_.assign(classes_count_, 0);
+  words_.resize(1);
+  prefixed_.resize(1);
+  for (size_t i = 0; i < words.size(); ++i) {
+    const std::string& word = words[i];
+    if (word.empty()) {
+      continue;
+    }
+
+    // indexes grow with i, so every list stays ascending without sorting
+    int32_t node = 0;
+    prefixed_[node].push_back(i);
+    for (char c : word) {
+      const size_t cell = node * classes_count_ + classes_[static_cast<unsigned char>(c)];
+      if (!transitions_[cell]) {
+        const int32_t child = static_cast<int32_t>(words_.size());
+        transitions_.resize(transitions_.size() + classes_count_, 0);
+        words_.emplace_back();
+        prefixed_.emplace_back();
+        transitions_[cell] = child;
+      }
+      node = transitions_[cell];
+      prefixed_[node].push_back(i);
+    }
+
+    words_[node].push_back(i);
+  }
+}
+
+size_t CommandTrie::Match(const char* text, size_t size, size_t pos, const indexes_t** indexes) const {
+  if (pos >= size || (pos != 0 && IsWordChar(text[pos - 1]))) {
+    return 0;
+  }
+
+  size_t best = 0;
+  int32_t node = 0;
+  for (size_t i = pos; i < size; ++i) {
+    node = Next(node, text[i]);
+    if (!node) {
+      break;
+    }
+
+    if (!words_[node].empty() && (i + 1 == size || !IsWordChar(text[i + 1]))) {
+      best = i + 1 - pos;
+      *indexes = &words_[node];
+    }
+  }
+  return best;
+}
+
+bool CommandTrie::Find(const std::string& word, const indexes_t** indexes) const {
+  int32_t node = 0;
+  for (char c : word) {
+    node = Next(node, c);
+    if (!node) {
+      return false;
+    }
+  }
+
+  if (words_[node].empty()) {
+    return false;
+  }
+
+  *indexes = &words_[node];
+  return true;
+}
+
+const CommandTrie::indexes_t& CommandTrie::FindByPrefix(const std::string& prefix) const {
+  static const indexes_t empty;
+  int32_t node = 0;
+  for (char c : prefix) {
+    node = Next(node, c);
+    if (!node) {
+      return empty;
+    }
+  }
+
+  return prefixed_[node];
+}
+
+size_t CommandTrie::GetWordsCount() const {
+  return words_count_;
+}
+
+size_t CommandTrie::GetNodesCount() const {
+  return words_.size();
+}
+
+bool CommandTrie::IsWordChar(char c) {
+  const unsigned char uc = static_cast<unsigned char>(c);
+  return (uc >= 'a' && uc <= 'z') || (uc >= 'A' && uc <= 'Z') || (uc >= '0' && uc <= '9') || uc == '_' || uc == '.' ||
+         uc == '-' || uc >= 0x80;
+}
+
+int32_t CommandTrie::Next(int32_t node, char c) const {
+  const uint8_t column = classes_[static_cast<unsigned char>(c)];
+  if (!column) {
+    return 0;
+  }
+  return transitions_[node * classes_count_ + column];
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,62 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace fastonosql {
+namespace gui {
+
+// case insensitive DFA over command names, the alphabet is folded to the bytes
+// that appear in names so every node is a small flat row of transitions
+// a name may repeat (same command for several server versions), so lookups give every index
+// of it in ascending order and the caller picks the one valid for its server
+class CommandTrie {
+ public:
+  typedef std::vector<size_t> indexes_t;
+
+  explicit CommandTrie(const std::vector<std::string>& words);
+
+  // length of the longest word at pos which starts and ends on word boundaries, 0 if none
+  size_t Match(const char* text, size_t size, size_t pos, const indexes_t** indexes) const;
+  bool Find(const std::string& word, const indexes_t** indexes) const;
+  // indexes of words starting with prefix, ascending, precomputed so completion doesn't allocate
+  const indexes_t& FindByPrefix(const std::string& prefix) const;
+
+  size_t GetWordsCount() const;
+  size_t GetNodesCount() const;
+
+  static bool IsWordChar(char c);
+
+ private:
+  int32_t Next(int32_t node, char c) const;
+
+  uint8_t classes_[256];  // byte -> column of transitions_, 0 is not used in any word
+  size_t classes_count_;
+  std::vector<int32_t> transitions_;  // node * classes_count_ + column -> node, 0 is no transition
+  std::vector<indexes_t> words_;      // node -> indexes of words ending here, empty for inner nodes
+  std::vector<indexes_t> prefixed_;   // node -> indexes of words passing through it
+  size_t words_count_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,439 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/simd_codecs.h"
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_CODECS_X86
+#include <immintrin.h>
+#endif
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+
+const char kLowerHexDigits[] = "0123456789abcdef";
+const char kUpperHexDigits[] = "0123456789ABCDEF";
+const char kBase64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+#define XHEX_CHARS_PER_BYTE 4
+#define BASE64_INVALID 0xFF
+#define BASE64_SKIP 0xFE
+
+struct Base64DecodeTable {
+  Base64DecodeTable() {
+    memset(values, BASE64_INVALID, sizeof(values));
+    for (unsigned char i = 0; i < 64; ++i) {
+      values[static_cast<unsigned char>(kBase64Alphabet[i])] = i;
+    }
+    values[static_cast<unsigned char>('\r')] = BASE64_SKIP;
+    values[static_cast<unsigned char>('\n')] = BASE64_SKIP;
+    values[static_cast<unsigned char>('\t')] = BASE64_SKIP;
+    values[static_cast<unsigned char>(' ')] = BASE64_SKIP;
+  }
+
+  unsigned char values[256];
+};
+
+const Base64DecodeTable& GetBase64DecodeTable() {
+  static const Base64DecodeTable table;
+  return table;
+}
+
+inline int HexValue(unsigned char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+
+  c |= 0x20;
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+// scalar tails, used for the whole input when no simd is available
+
+size_t XHexEncodeScalar(const unsigned char* src, size_t size, bool is_lower, char* dst) {
+  const char* digits = is_lower ? kLowerHexDigits : kUpperHexDigits;
+  for (size_t i = 0; i < size; ++i) {
+    *dst++ = '\\';
+    *dst++ = 'x';
+    *dst++ = digits[src[i] >> 4];
+    *dst++ = digits[src[i] & 0x0F];
+  }
+  return size;
+}
+
+bool XHexDecodeScalar(const unsigned char* src, size_t size, char* dst) {
+  for (size_t i = 0; i < size; i += XHEX_CHARS_PER_BYTE) {
+    const int hi = HexValue(src[i + 2]);
+    const int lo = HexValue(src[i + 3]);
+    if (src[i] != '\\' || (src[i + 1] | 0x20) != 'x' || hi < 0 || lo < 0) {
+      return false;
+    }
+    *dst++ = static_cast<char>((hi << 4) | lo);
+  }
+  return true;
+}
+
+size_t Base64EncodeScalar(const unsigned char* src, size_t size, char* dst) {
+  char* start = dst;
+  size_t i = 0;
+  for (; i + 3 <= size; i += 3) {
+    const uint32_t triple = (src[i] << 16) | (src[i + 1] << 8) | src[i + 2];
+    *dst++ = kBase64Alphabet[(triple >> 18) & 0x3F];
+    *dst++ = kBase64Alphabet[(triple >> 12) & 0x3F];
+    *dst++ = kBase64Alphabet[(triple >> 6) & 0x3F];
+    *dst++ = kBase64Alphabet[triple & 0x3F];
+  }
+
+  const size_t rest = size - i;
+  if (rest) {
+    const uint32_t triple = (src[i] << 16) | (rest == 2 ? src[i + 1] << 8 : 0);
+    *dst++ = kBase64Alphabet[(triple >> 18) & 0x3F];
+    *dst++ = kBase64Alphabet[(triple >> 12) & 0x3F];
+    *dst++ = rest == 2 ? kBase64Alphabet[(triple >> 6) & 0x3F] : '=';
+    *dst++ = '=';
+  }
+  return dst - start;
+}
+
+// returns decoded size or -1, padding is accepted only at the end
+ptrdiff_t Base64DecodeScalar(const unsigned char* src, size_t size, char* dst) {
+  const unsigned char* values = GetBase64DecodeTable().values;
+  char* start = dst;
+  uint32_t accumulator = 0;
+  size_t quantum = 0;
+  size_t padding = 0;
+  for (size_t i = 0; i < size; ++i) {
+    const unsigned char c = src[i];
+    if (c == '=') {
+      ++padding;
+      continue;
+    }
+
+    const unsigned char value = values[c];
+    if (value == BASE64_SKIP) {
+      continue;
+    }
+    if (value == BASE64_INVALID || padding) {
+      return -1;
+    }
+
+    accumulator = (accumulator << 6) | value;
+    if (++quantum == 4) {
+      *dst++ = static_cast<char>(accumulator >> 16);
+      *dst++ = static_cast<char>(accumulator >> 8);
+      *dst++ = static_cast<char>(accumulator);
+      accumulator = 0;
+      quantum = 0;
+    }
+  }
+
+  if (quantum == 1 || padding > 2) {
+    return -1;
+  }
+  if (quantum == 2) {
+    *dst++ = static_cast<char>(accumulator >> 4);
+  } else if (quantum == 3) {
+    *dst++ = static_cast<char>(accumulator >> 10);
+    *dst++ = static_cast<char>(accumulator >> 2);
+  }
+  return dst - start;
+}
+
+#if defined(SIMD_CODECS_X86)
+bool HasSsse3() {
+  static const bool has = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("ssse3") != 0;
+  }();
+  return has;
+}
+
+bool HasAvx2() {
+  static const bool has = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }();
+  return has;
+}
+
+__attribute__((target("ssse3"))) size_t XHexEncodeSsse3(const unsigned char* src,
+                                                         size_t size,
+                                                         bool is_lower,
+                                                         char* dst) {
+  const __m128i lut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(is_lower ? kLowerHexDigits : kUpperHexDigits));
+  const __m128i nibble_mask = _mm_set1_epi8(0x0F);
+  const __m128i prefix = _mm_set1_epi16(static_cast<short>('\\' | ('x' << 8)));
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), nibble_mask));
+    const __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, nibble_mask));
+    const __m128i pairs_lo = _mm_unpacklo_epi8(hi, lo);
+    const __m128i pairs_hi = _mm_unpackhi_epi8(hi, lo);
+    __m128i* out = reinterpret_cast<__m128i*>(dst + i * XHEX_CHARS_PER_BYTE);
+    _mm_storeu_si128(out, _mm_unpacklo_epi16(prefix, pairs_lo));
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(prefix, pairs_lo));
+    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(prefix, pairs_hi));
+    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(prefix, pairs_hi));
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) size_t XHexEncodeAvx2(const unsigned char* src,
+                                                       size_t size,
+                                                       bool is_lower,
+                                                       char* dst) {
+  const __m256i lut = _mm256_broadcastsi128_si256(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(is_lower ? kLowerHexDigits : kUpperHexDigits)));
+  const __m256i nibble_mask = _mm256_set1_epi8(0x0F);
+  const __m256i prefix = _mm256_set1_epi16(static_cast<short>('\\' | ('x' << 8)));
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    const __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble_mask));
+    const __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(in, nibble_mask));
+    // unpacks work inside 128 bit lanes, so the lane halves are swapped back at store
+    const __m256i pairs_lo = _mm256_unpacklo_epi8(hi, lo);
+    const __m256i pairs_hi = _mm256_unpackhi_epi8(hi, lo);
+    const __m256i a0 = _mm256_unpacklo_epi16(prefix, pairs_lo);
+    const __m256i a1 = _mm256_unpackhi_epi16(prefix, pairs_lo);
+    const __m256i b0 = _mm256_unpacklo_epi16(prefix, pairs_hi);
+    const __m256i b1 = _mm256_unpackhi_epi16(prefix, pairs_hi);
+    __m256i* out = reinterpret_cast<__m256i*>(dst + i * XHEX_CHARS_PER_BYTE);
+    _mm256_storeu_si256(out, _mm256_permute2x128_si256(a0, a1, 0x20));
+    _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(b0, b1, 0x20));
+    _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(a0, a1, 0x31));
+    _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(b0, b1, 0x31));
+  }
+  return i;
+}
+
+// 16 chars, four "\xHH" groups, to 4 bytes per step
+__attribute__((target("ssse3"))) bool XHexDecodeSsse3(const unsigned char* src, size_t size, char* dst) {
+  const __m128i prefix_mask = _mm_set1_epi32(0x0000FFFF);
+  const __m128i prefix = _mm_set1_epi32('\\' | ('x' << 8));
+  const __m128i case_bit = _mm_set1_epi8(0x20);
+  const __m128i prefix_case_bit = _mm_set1_epi32(0x2000);
+  const __m128i below_digits = _mm_set1_epi8('0' - 1);
+  const __m128i above_digits = _mm_set1_epi8('9' + 1);
+  const __m128i below_alpha = _mm_set1_epi8('a' - 1);
+  const __m128i above_alpha = _mm_set1_epi8('f' + 1);
+  const __m128i hi_shuffle = _mm_setr_epi8(2, 6, 10, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+  const __m128i lo_shuffle = _mm_setr_epi8(3, 7, 11, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+  for (size_t i = 0; i < size; i += 16) {
+    const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i lower = _mm_or_si128(in, case_bit);
+    // 'x' and 'X' are both accepted
+    const __m128i is_prefix = _mm_cmpeq_epi8(_mm_and_si128(_mm_or_si128(in, prefix_case_bit), prefix_mask), prefix);
+    const __m128i is_digit = _mm_and_si128(_mm_cmpgt_epi8(in, below_digits), _mm_cmpgt_epi8(above_digits, in));
+    const __m128i is_alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, below_alpha), _mm_cmpgt_epi8(above_alpha, lower));
+    const __m128i is_hex = _mm_andnot_si128(prefix_mask, _mm_or_si128(is_digit, is_alpha));
+    const __m128i is_valid = _mm_or_si128(_mm_and_si128(is_prefix, prefix_mask), is_hex);
+    if (_mm_movemask_epi8(is_valid) != 0xFFFF) {
+      return false;
+    }
+
+    const __m128i values =
+        _mm_or_si128(_mm_and_si128(is_digit, _mm_sub_epi8(in, _mm_set1_epi8('0'))),
+                     _mm_andnot_si128(is_digit, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+    const __m128i hi = _mm_shuffle_epi8(values, hi_shuffle);
+    const __m128i lo = _mm_shuffle_epi8(values, lo_shuffle);
+    const int bytes = _mm_cvtsi128_si32(_mm_or_si128(_mm_slli_epi16(hi, 4), lo));
+    memcpy(dst + i / XHEX_CHARS_PER_BYTE, &bytes, sizeof(bytes));
+  }
+  return true;
+}
+
+// 12 bytes to 16 chars per step, needs 16 readable bytes
+__attribute__((target("ssse3"))) size_t Base64EncodeSsse3(const unsigned char* src, size_t size, char* dst) {
+  const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+  const __m128i shift_lut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+  size_t i = 0;
+  char* out = dst;
+  for (; i + 16 <= size; i += 12) {
+    __m128i in = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), shuffle);
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003F03F0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+
+    __m128i lut_index = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    lut_index = _mm_or_si128(lut_index, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+    in = _mm_add_epi8(_mm_shuffle_epi8(shift_lut, lut_index), indices);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), in);
+    out += 16;
+  }
+  return i;
+}
+
+// 16 chars to 12 bytes per step, stops at the first block with padding, line breaks or garbage
+__attribute__((target("ssse3"))) size_t Base64DecodeSsse3(const unsigned char* src,
+                                                           size_t size,
+                                                           char* dst,
+                                                           size_t* written) {
+  const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B,
+                                       0x1B, 0x1B, 0x1A);
+  const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                       0x10, 0x10, 0x10);
+  const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+  const __m128i mask_2f = _mm_set1_epi8(0x2F);
+  const __m128i pack_shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  size_t i = 0;
+  char* out = dst;
+  // the store writes 16 bytes, keep a block in reserve for it
+  for (; i + 24 <= size; i += 16) {
+    __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+    const __m128i lo = _mm_shuffle_epi8(lut_lo, _mm_and_si128(in, mask_2f));
+    const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF) {
+      break;
+    }
+
+    const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(_mm_cmpeq_epi8(in, mask_2f), hi_nibbles));
+    in = _mm_add_epi8(in, roll);
+    const __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(merged, pack_shuffle));
+    out += 12;
+  }
+
+  *written = out - dst;
+  return i;
+}
+#endif
+
+}  // namespace
+
+void xhex_encode(const char* data, size_t size, bool is_lower, std::string* out) {
+  out->resize(size * XHEX_CHARS_PER_BYTE);
+  if (!size) {
+    return;
+  }
+
+  const unsigned char* src = reinterpret_cast<const unsigned char*>(data);
+  char* dst = &(*out)[0];
+  size_t done = 0;
+#if defined(SIMD_CODECS_X86)
+  if (HasAvx2()) {
+    done = XHexEncodeAvx2(src, size, is_lower, dst);
+  }
+  if (HasSsse3()) {
+    done += XHexEncodeSsse3(src + done, size - done, is_lower, dst + done * XHEX_CHARS_PER_BYTE);
+  }
+#endif
+  XHexEncodeScalar(src + done, size - done, is_lower, dst + done * XHEX_CHARS_PER_BYTE);
+}
+
+bool xhex_decode(const char* data, size_t size, std::string* out) {
+  if (size % XHEX_CHARS_PER_BYTE != 0) {
+    return false;
+  }
+
+  std::string result(size / XHEX_CHARS_PER_BYTE, 0);
+  if (!size) {
+    *out = result;
+    return true;
+  }
+
+  const unsigned char* src = reinterpret_cast<const unsigned char*>(data);
+  char* dst = &result[0];
+  size_t done = 0;
+#if defined(SIMD_CODECS_X86)
+  if (HasSsse3()) {
+    done = size / 16 * 16;
+    if (!XHexDecodeSsse3(src, done, dst)) {
+      return false;
+    }
+  }
+#endif
+  if (!XHexDecodeScalar(src + done, size - done, dst + done / XHEX_CHARS_PER_BYTE)) {
+    return false;
+  }
+
+  out->swap(result);
+  return true;
+}
+
+void base64_encode(const char* data, size_t size, std::string* out) {
+  out->resize((size + 2) / 3 * 4);
+  if (!size) {
+    return;
+  }
+
+  const unsigned char* src = reinterpret_cast<const unsigned char*>(data);
+  char* dst = &(*out)[0];
+  size_t done = 0;
+#if defined(SIMD_CODECS_X86)
+  if (HasSsse3()) {
+    done = Base64EncodeSsse3(src, size, dst);
+  }
+#endif
+  Base64EncodeScalar(src + done, size - done, dst + done / 3 * 4);
+}
+
+bool base64_decode(const char* data, size_t size, std::string* out) {
+  std::string result(size / 4 * 3 + 3, 0);
+  const unsigned char* src = reinterpret_cast<const unsigned char*>(data);
+  char* dst = &result[0];
+  size_t done = 0;
+  size_t written = 0;
+#if defined(SIMD_CODECS_X86)
+  if (HasSsse3()) {
+    done = Base64DecodeSsse3(src, size, dst, &written);
+  }
+#endif
+  const ptrdiff_t rest = Base64DecodeScalar(src + done, size - done, dst + written);
+  if (rest < 0) {
+    return false;
+  }
+
+  result.resize(written + rest);
+  out->swap(result);
+  return true;
+}
+
+void utf8_append(uint32_t cp, std::string* out) {
+  if (cp < 0x80) {
+    out->push_back(static_cast<char>(cp));
+  } else if (cp < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (cp >> 6)));
+    out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else if (cp < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (cp >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (cp >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+  }
+}
+
+}  // namespace gui
+}  // namespace fastonosql
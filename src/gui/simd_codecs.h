@@ -0,0 +1,42 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+
+namespace fastonosql {
+namespace gui {
+
+// kernels behind the value views, picks ssse3 or avx2 at runtime and falls back to scalar code
+
+// "\xHH" per byte, same as common::XHexEDcoder
+void xhex_encode(const char* data, size_t size, bool is_lower, std::string* out);
+bool xhex_decode(const char* data, size_t size, std::string* out);
+
+// standard alphabet with padding, line breaks are skipped on decode
+void base64_encode(const char* data, size_t size, std::string* out);
+bool base64_decode(const char* data, size_t size, std::string* out);
+
+// appends code point as utf-8, shared by the unicode and pickle decoders
+void utf8_append(uint32_t cp, std::string* out);
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -18,13 +18,106 @@
 
 #include "gui/socket_tls.h"
 
+#include <map>
+#include <mutex>
+#include <string>
+
 #include <openssl/err.h>
 #include <openssl/ssl.h>
 
+#include <common/convert2string.h>
+#include <common/time.h>
+
 namespace common {
 namespace net {
 
-SocketTls::SocketTls(const HostAndPort& host) : hs_(host), ssl_(nullptr) {}
+namespace {
+SSL_CTX* GetClientContext() {
+  // one context for all sockets, creating it is much more expensive than SSL_new
+  static SSL_CTX* ctx = []() -> SSL_CTX* {
+#if OPENSSL_VERSION_NUMBER < 0x10100000L
+    const SSL_METHOD* method = TLSv1_2_client_method();
+#else
+    const SSL_METHOD* method = TLS_client_method();
+#endif
+    if (!method) {
+      return nullptr;
+    }
+    SSL_CTX* result = SSL_CTX_new(method);
+    if (result) {
+      SSL_CTX_set_session_cache_mode(result, SSL_SESS_CACHE_CLIENT);
+    }
+    return result;
+  }();
+  return ctx;
+}
+
+class SessionCache {
+ public:
+  static SessionCache& GetInstance() {
+    static SessionCache cache;
+    return cache;
+  }
+
+  // SSL_set_session takes its own reference, so it is done under the lock
+  bool Resume(const std::string& endpoint, SSL* ssl) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(endpoint);
+    if (it == sessions_.end()) {
+      return false;
+    }
+
+    return SSL_set_session(ssl, it->second) == 1;
+  }
+
+  // takes ownership of session
+  void Put(const std::string& endpoint, SSL_SESSION* session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(endpoint);
+    if (it != sessions_.end()) {
+      SSL_SESSION_free(it->second);
+      it->second = session;
+      return;
+    }
+    sessions_[endpoint] = session;
+  }
+
+  void Remove(const std::string& endpoint) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sessions_.find(endpoint);
+    if (it != sessions_.end()) {
+      SSL_SESSION_free(it->second);
+      sessions_.erase(it);
+    }
+  }
+
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = sessions_.begin(); it != sessions_.end(); ++it) {
+      SSL_SESSION_free(it->second);
+    }
+    sessions_.clear();
+  }
+
+ private:
+  SessionCache() : mutex_(), sessions_() {}
+  ~SessionCache() { Clear(); }
+
+  std::mutex mutex_;
+  std::map<std::string, SSL_SESSION*> sessions_;
+};
+}  // namespace
+
+SocketTls::SocketTls(const HostAndPort& host)
+    : hs_(host), ssl_(nullptr), handshake_msec_(0), session_reused_(false) {}
+
+time64_t SocketTls::GetHandshakeTime() const {
+  return handshake_msec_;
+}
+
+bool SocketTls::IsSessionReused() const {
+  return session_reused_;
+}
 
 common::ErrnoError SocketTls::Connect(struct timeval* tv) {
   common::net::ClientSocketTcp hs(hs_.GetHost());
@@ -33,41 +126,35 @@ common::ErrnoError SocketTls::Connect(struct timeval* tv) {
     return err;
   }
 
-#if OPENSSL_VERSION_NUMBER < 0x10100000L
-  const SSL_METHOD* method = TLSv1_2_client_method();
-#else
-  const SSL_METHOD* method = TLS_client_method();
-#endif
-  if (!method) {
-    hs.Disconnect();
-    return common::make_errno_error_inval();
-  }
-
-  SSL_CTX* ctx = SSL_CTX_new(method);
+  SSL_CTX* ctx = GetClientContext();
   if (!ctx) {
     hs.Disconnect();
     return common::make_errno_error_inval();
   }
 
   SSL* ssl = SSL_new(ctx);
-  SSL_CTX_free(ctx);
-  ctx = nullptr;
   if (!ssl) {
-    SSL_free(ssl);
     hs.Disconnect();
     return common::make_errno_error_inval();
   }
 
+  const std::string endpoint = common::ConvertToString(hs_.GetHost());
+  SessionCache::GetInstance().Resume(endpoint, ssl);
   SSL_set_fd(ssl, hs.GetFd());
+  const time64_t start_msec = common::time::current_utc_mstime();
   int e = SSL_connect(ssl);
-  if (e < 0) {
+  if (e <= 0) {
     int err = SSL_get_error(ssl, e);
     char* str = ERR_error_string(err, nullptr);
     SSL_free(ssl);
     hs.Disconnect();
+    // stale ticket could be the reason, next attempt does a full handshake
+    SessionCache::GetInstance().Remove(endpoint);
     return common::make_errno_error(str, EINTR);
   }
 
+  handshake_msec_ = common::time::current_utc_mstime() - start_msec;
+  session_reused_ = SSL_session_reused(ssl);
   hs_.SetInfo(hs.GetInfo());
   ssl_ = ssl;
   return common::ErrnoError();
@@ -115,6 +202,11 @@ common::ErrnoError SocketTls::ReadImpl(void* out_data, size_t max_size, size_t*
 
 common::ErrnoError SocketTls::CloseImpl() {
   if (ssl_) {
+    // tls 1.3 tickets arrive after the handshake, so the session is taken on close
+    SSL_SESSION* session = SSL_get1_session(ssl_);
+    if (session) {
+      SessionCache::GetInstance().Put(common::ConvertToString(hs_.GetHost()), session);
+    }
     SSL_free(ssl_);
     ssl_ = nullptr;
   }
@@ -20,18 +20,25 @@
 
 #include <common/net/isocket.h>
 #include <common/net/socket_tcp.h>
+#include <common/types.h>
 
 typedef struct ssl_st SSL;
 
 namespace common {
 namespace net {
 
+// sessions are cached per host:port for the whole process, so the next
+// Connect to the same endpoint resumes instead of doing a full handshake
 class SocketTls : public ISocket {
  public:
   explicit SocketTls(const HostAndPort& host);
 
   ErrnoError Connect(struct timeval* tv = nullptr) WARN_UNUSED_RESULT;
 
+  // of the last Connect, tcp connect excluded
+  time64_t GetHandshakeTime() const;
+  bool IsSessionReused() const;
+
   ErrnoError Disconnect() WARN_UNUSED_RESULT;
   bool IsConnected() const;
   net::HostAndPort GetHost() const;
@@ -44,6 +51,8 @@ class SocketTls : public ISocket {
 
   ClientSocketTcp hs_;
   SSL* ssl_;
+  time64_t handshake_msec_;
+  bool session_reused_;
 };
 
 }  // namespace net
@@ -33,6 +33,8 @@
 
 #include <fastonosql/core/types.h>
 
+#include "gui/simd_codecs.h"
+
 namespace {
 struct json_object* json_tokener_parse_hacked(const char* str, int len) {
   struct json_tokener* tok = json_tokener_new();
@@ -51,6 +53,94 @@ struct json_object* json_tokener_parse_hacked(const char* str, int len) {
   json_tokener_free(tok);
   return obj;
 }
+
+const char kLowerHexDigits[] = "0123456789abcdef";
+
+#define UNICODE_ESCAPE_SIZE 6
+#define UNICODE_REPLACEMENT_CHAR 0xFFFD
+
+// next code point of utf-8 text, malformed sequences give U+FFFD and are skipped by one byte
+uint32_t NextCodePoint(const unsigned char* str, size_t size, size_t* pos) {
+  const unsigned char lead = str[*pos];
+  size_t length = 0;
+  uint32_t cp = 0;
+  uint32_t min_cp = 0;
+  if (lead < 0x80) {
+    *pos += 1;
+    return lead;
+  } else if ((lead & 0xE0) == 0xC0) {
+    length = 2;
+    cp = lead & 0x1F;
+    min_cp = 0x80;
+  } else if ((lead & 0xF0) == 0xE0) {
+    length = 3;
+    cp = lead & 0x0F;
+    min_cp = 0x800;
+  } else if ((lead & 0xF8) == 0xF0) {
+    length = 4;
+    cp = lead & 0x07;
+    min_cp = 0x10000;
+  } else {
+    *pos += 1;
+    return UNICODE_REPLACEMENT_CHAR;
+  }
+
+  if (*pos + length > size) {
+    *pos += 1;
+    return UNICODE_REPLACEMENT_CHAR;
+  }
+
+  for (size_t i = 1; i < length; ++i) {
+    const unsigned char c = str[*pos + i];
+    if ((c & 0xC0) != 0x80) {
+      *pos += 1;
+      return UNICODE_REPLACEMENT_CHAR;
+    }
+    cp = (cp << 6) | (c & 0x3F);
+  }
+
+  if (cp < min_cp || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+    *pos += 1;
+    return UNICODE_REPLACEMENT_CHAR;
+  }
+
+  *pos += length;
+  return cp;
+}
+
+inline void WriteUnicodeEscape(uint32_t unit, char* dst) {
+  dst[0] = '\\';
+  dst[1] = 'u';
+  dst[2] = kLowerHexDigits[(unit >> 12) & 0x0F];
+  dst[3] = kLowerHexDigits[(unit >> 8) & 0x0F];
+  dst[4] = kLowerHexDigits[(unit >> 4) & 0x0F];
+  dst[5] = kLowerHexDigits[unit & 0x0F];
+}
+
+bool ReadUnicodeEscape(const char* src, uint32_t* unit) {
+  if (src[0] != '\\' || src[1] != 'u') {
+    return false;
+  }
+
+  uint32_t result = 0;
+  for (size_t i = 2; i < UNICODE_ESCAPE_SIZE; ++i) {
+    const char c = src[i];
+    uint32_t digit = 0;
+    if (c >= '0' && c <= '9') {
+      digit = c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      digit = c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      digit = c - 'A' + 10;
+    } else {
+      return false;
+    }
+    result = (result << 4) | digit;
+  }
+
+  *unit = result;
+  return true;
+}
 }  // namespace
 
 namespace fastonosql {
@@ -91,6 +181,13 @@ bool string_to_json(const convert_in_t& data, convert_out_t* out) {
 }
 
 bool string_from_hex(const convert_in_t& value, convert_out_t* out) {
+  std::string decoded;
+  if (xhex_decode(value.data(), value.size(), &decoded)) {
+    *out = GEN_CMD_STRING_SIZE(decoded.data(), decoded.size());
+    return true;
+  }
+
+  // anything the fast path doesn't know goes to the generic decoder
   common::XHexEDcoder enc(core::ReadableString::is_lower_hex);
 
   convert_out_t sout;
@@ -104,15 +201,9 @@ bool string_from_hex(const convert_in_t& value, convert_out_t* out) {
 }
 
 bool string_to_hex(const convert_in_t& data, convert_out_t* out) {
-  common::XHexEDcoder enc(core::ReadableString::is_lower_hex);
-
-  convert_out_t sout;
-  common::Error err = enc.Encode(data, &sout);
-  if (err) {
-    return false;
-  }
-
-  *out = sout;
+  std::string encoded;
+  xhex_encode(data.data(), data.size(), core::ReadableString::is_lower_hex, &encoded);
+  *out = GEN_CMD_STRING_SIZE(encoded.data(), encoded.size());
   return true;
 }
 
@@ -121,51 +212,63 @@ bool string_to_unicode(const convert_in_t& data, convert_out_t* out) {
     return false;
   }
 
-  core::command_buffer_writer_t wr;
-  const common::string16 s16 = common::ConvertToString16(data);
-  convert_out_t unicoded;
-  common::utils::unicode::encode(s16, true, &unicoded);
-  for (size_t i = 0; i < unicoded.size(); i += 4) {
-    wr << "\\u";
-    wr << unicoded[i];
-    wr << unicoded[i + 1];
-    wr << unicoded[i + 2];
-    wr << unicoded[i + 3];
-  }
-
-  core::command_buffer_t result = wr.str();
-  if (result.size() % 6 != 0) {
-    return false;
+  // one "\uXXXX" per utf-16 code unit, written straight from utf-8 without a string16 copy
+  const unsigned char* str = reinterpret_cast<const unsigned char*>(data.data());
+  const size_t size = data.size();
+  // 6 bytes per input byte at most: one escape per ascii or invalid byte, two per 4 byte sequence
+  std::string result(size * UNICODE_ESCAPE_SIZE, 0);
+  char* dst = size ? &result[0] : nullptr;
+  size_t written = 0;
+  for (size_t pos = 0; pos < size;) {
+    const uint32_t cp = NextCodePoint(str, size, &pos);
+    if (cp < 0x10000) {
+      WriteUnicodeEscape(cp, dst + written);
+      written += UNICODE_ESCAPE_SIZE;
+    } else {
+      const uint32_t offset = cp - 0x10000;
+      WriteUnicodeEscape(0xD800 | (offset >> 10), dst + written);
+      WriteUnicodeEscape(0xDC00 | (offset & 0x3FF), dst + written + UNICODE_ESCAPE_SIZE);
+      written += UNICODE_ESCAPE_SIZE * 2;
+    }
   }
 
-  *out = result;
+  *out = GEN_CMD_STRING_SIZE(result.data(), written);
   return true;
 }
 
 bool string_from_unicode(const convert_in_t& value, convert_out_t* out) {
   const size_t len = value.size();
-  if (!out || len % 6 != 0) {
+  if (!out || len % UNICODE_ESCAPE_SIZE != 0) {
     return false;
   }
 
-  std::string unicode_digits;
-  for (size_t i = 0; i < len; i += 6) {
-    auto c1 = value[i];
-    auto c2 = value[i + 1];
-    if (c1 == '\\' && c2 == 'u') {
-      unicode_digits += value[i + 2];
-      unicode_digits += value[i + 3];
-      unicode_digits += value[i + 4];
-      unicode_digits += value[i + 5];
-    } else {
+  std::string result;
+  result.reserve(len / 2);
+  const char* str = value.data();
+  for (size_t i = 0; i < len; i += UNICODE_ESCAPE_SIZE) {
+    uint32_t unit = 0;
+    if (!ReadUnicodeEscape(str + i, &unit)) {
       return false;
     }
+
+    if (unit >= 0xD800 && unit <= 0xDBFF && i + UNICODE_ESCAPE_SIZE < len) {
+      uint32_t low = 0;
+      if (!ReadUnicodeEscape(str + i + UNICODE_ESCAPE_SIZE, &low)) {
+        return false;
+      }
+
+      if (low >= 0xDC00 && low <= 0xDFFF) {
+        utf8_append(0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00), &result);
+        i += UNICODE_ESCAPE_SIZE;
+        continue;
+      }
+    }
+
+    // unpaired surrogates can't be stored in utf-8
+    utf8_append(unit >= 0xD800 && unit <= 0xDFFF ? UNICODE_REPLACEMENT_CHAR : unit, &result);
   }
 
-  common::string16 s16;
-  bool is_ok = common::utils::unicode::decode(unicode_digits, &s16);
-  DCHECK(is_ok) << "Can't un unicoded: " << unicode_digits;
-  *out = common::ConvertToCharBytes(s16);
+  *out = GEN_CMD_STRING_SIZE(result.data(), result.size());
   return true;
 }
 
@@ -304,6 +407,12 @@ bool string_to_bzip2(const convert_in_t& data, convert_out_t* out) {
 }
 
 bool string_from_base64(const convert_in_t& value, convert_out_t* out) {
+  std::string decoded;
+  if (base64_decode(value.data(), value.size(), &decoded)) {
+    *out = GEN_CMD_STRING_SIZE(decoded.data(), decoded.size());
+    return true;
+  }
+
   common::Base64EDcoder enc;
 
   convert_out_t sout;
@@ -317,15 +426,9 @@ bool string_from_base64(const convert_in_t& value, convert_out_t* out) {
 }
 
 bool string_to_base64(const convert_in_t& data, convert_out_t* out) {
-  common::Base64EDcoder enc;
-
-  convert_out_t sout;
-  common::Error err = enc.Encode(data, &sout);
-  if (err) {
-    return false;
-  }
-
-  *out = sout;
+  std::string encoded;
+  base64_encode(data.data(), data.size(), &encoded);
+  *out = GEN_CMD_STRING_SIZE(encoded.data(), encoded.size());
   return true;
 }
 
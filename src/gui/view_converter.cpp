@@ -0,0 +1,349 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/view_converter.h"
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#if defined(HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(HAVE_BZIP2)
+#include <bzlib.h>
+#endif
+
+#include <common/macros.h>
+
+#include <fastonosql/core/types.h>
+
+#include "gui/pickle_codec.h"
+#include "gui/python_converter.h"
+
+#define STREAM_CHUNK_SIZE (64 * 1024)
+#define XHEX_CHARS_PER_BYTE 4
+#define UNICODE_ESCAPE_MAX_CHARS_PER_BYTE 6
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+
+bool IsCanceled(const ViewConvertControl& control) {
+  return control.canceled && control.canceled->load();
+}
+
+void ReportProgress(const ViewConvertControl& control, size_t done, size_t total) {
+  if (control.progress && total) {
+    control.progress(static_cast<int>(done * 100 / total));
+  }
+}
+
+// cut at utf-8 char boundary, so a preview doesn't end with a broken sequence
+size_t Utf8Prefix(const convert_in_t& text, size_t size) {
+  if (size >= text.size()) {
+    return text.size();
+  }
+
+  while (size && (static_cast<unsigned char>(text[size]) & 0xC0) == 0x80) {
+    size--;
+  }
+  return size;
+}
+
+bool ConvertPrefix(OutputView view_method,
+                   const convert_in_t& text,
+                   size_t prefix_size,
+                   convert_out_t* out,
+                   bool* is_truncated) {
+  if (prefix_size >= text.size()) {
+    return convert_to_view(view_method, text, out);
+  }
+
+  *is_truncated = true;
+  return convert_to_view(view_method, GEN_CMD_STRING_SIZE(text.data(), prefix_size), out);
+}
+
+#if defined(HAVE_ZLIB)
+bool InflateLimited(const convert_in_t& value,
+                    int window_bits,
+                    const ViewConvertControl& control,
+                    std::string* out,
+                    bool* is_truncated) {
+  z_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, window_bits) != Z_OK) {
+    return false;
+  }
+
+  std::vector<Bytef> chunk(STREAM_CHUNK_SIZE);
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(value.data()));
+  stream.avail_in = static_cast<uInt>(value.size());
+  int ret = Z_OK;
+  while (ret != Z_STREAM_END) {
+    if (IsCanceled(control)) {
+      inflateEnd(&stream);
+      return false;
+    }
+
+    stream.next_out = chunk.data();
+    stream.avail_out = static_cast<uInt>(chunk.size());
+    ret = inflate(&stream, Z_NO_FLUSH);
+    if (ret != Z_OK && ret != Z_STREAM_END) {
+      // broken or incomplete stream
+      inflateEnd(&stream);
+      return false;
+    }
+
+    const size_t produced = chunk.size() - stream.avail_out;
+    if (control.output_limit && out->size() + produced > control.output_limit) {
+      out->append(reinterpret_cast<const char*>(chunk.data()), control.output_limit - out->size());
+      *is_truncated = true;
+      break;
+    }
+
+    out->append(reinterpret_cast<const char*>(chunk.data()), produced);
+    ReportProgress(control, value.size() - stream.avail_in, value.size());
+  }
+
+  inflateEnd(&stream);
+  return true;
+}
+#endif
+
+#if defined(HAVE_BZIP2)
+bool Bunzip2Limited(const convert_in_t& value, const ViewConvertControl& control, std::string* out, bool* is_truncated) {
+  bz_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  if (BZ2_bzDecompressInit(&stream, 0, 0) != BZ_OK) {
+    return false;
+  }
+
+  std::vector<char> chunk(STREAM_CHUNK_SIZE);
+  stream.next_in = const_cast<char*>(value.data());
+  stream.avail_in = static_cast<unsigned int>(value.size());
+  int ret = BZ_OK;
+  while (ret != BZ_STREAM_END) {
+    if (IsCanceled(control)) {
+      BZ2_bzDecompressEnd(&stream);
+      return false;
+    }
+
+    stream.next_out = chunk.data();
+    stream.avail_out = static_cast<unsigned int>(chunk.size());
+    ret = BZ2_bzDecompress(&stream);
+    const size_t produced = chunk.size() - stream.avail_out;
+    if ((ret != BZ_OK && ret != BZ_STREAM_END) || (ret == BZ_OK && !produced && !stream.avail_in)) {
+      BZ2_bzDecompressEnd(&stream);
+      return false;
+    }
+
+    if (control.output_limit && out->size() + produced > control.output_limit) {
+      out->append(chunk.data(), control.output_limit - out->size());
+      *is_truncated = true;
+      break;
+    }
+
+    out->append(chunk.data(), produced);
+    ReportProgress(control, value.size() - stream.avail_in, value.size());
+  }
+
+  BZ2_bzDecompressEnd(&stream);
+  return true;
+}
+#endif
+
+bool DecompressLimited(OutputView view_method,
+                       const convert_in_t& text,
+                       const ViewConvertControl& control,
+                       convert_out_t* out,
+                       bool* is_truncated) {
+  UNUSED(view_method);
+  UNUSED(text);
+  UNUSED(is_truncated);
+  std::string result;
+  bool is_streamed = false;
+#if defined(HAVE_ZLIB)
+  if (view_method == ZLIB_VIEW || view_method == GZIP_VIEW) {
+    // 16 asks zlib for the gzip wrapper
+    is_streamed = InflateLimited(text, view_method == GZIP_VIEW ? MAX_WBITS + 16 : MAX_WBITS, control, &result,
+                                 is_truncated);
+  }
+#endif
+#if defined(HAVE_BZIP2)
+  if (view_method == BZIP2_VIEW) {
+    is_streamed = Bunzip2Limited(text, control, &result, is_truncated);
+  }
+#endif
+  // not a plain stream or no streaming decoder in this build: decoding the whole value
+  // would bypass the limit, so a decompression bomb is reported as a conversion error
+  if (!is_streamed || IsCanceled(control)) {
+    return false;
+  }
+
+  *out = GEN_CMD_STRING_SIZE(result.data(), result.size());
+  return true;
+}
+
+}  // namespace
+
+ViewConvertControl::ViewConvertControl() : output_limit(0), canceled(nullptr), progress() {}
+
+bool convert_from_view(OutputView view_method, const convert_in_t& val, convert_out_t* out) {
+  if (!out || val.empty()) {
+    return false;
+  }
+
+  if (view_method == JSON_VIEW) {
+    return string_from_json(val, out);
+  } else if (view_method == RAW_VIEW) {
+    *out = val;
+    return true;
+  } else if (view_method == TO_HEX_VIEW) {
+    return string_from_hex(val, out);
+  } else if (view_method == FROM_HEX_VIEW) {
+    return string_to_hex(val, out);
+  } else if (view_method == TO_BASE64_VIEW) {
+    return string_from_base64(val, out);
+  } else if (view_method == FROM_BASE64_VIEW) {
+    return string_to_base64(val, out);
+  } else if (view_method == TO_UNICODE_VIEW) {
+    return string_from_unicode(val, out);
+  } else if (view_method == FROM_UNICODE_VIEW) {
+    return string_to_unicode(val, out);
+  } else if (view_method == TO_PICKLE_VIEW) {
+    return string_from_pickle(val, out);
+  } else if (view_method == FROM_PICKLE_VIEW) {
+    return string_to_pickle(val, out);
+  } else if (view_method == ZLIB_VIEW) {
+    return string_to_zlib(val, out);
+  } else if (view_method == GZIP_VIEW) {
+    return string_to_gzip(val, out);
+  } else if (view_method == LZ4_VIEW) {
+    return string_to_lz4(val, out);
+  } else if (view_method == BZIP2_VIEW) {
+    return string_to_bzip2(val, out);
+  } else if (view_method == SNAPPY_VIEW) {
+    return string_to_snappy(val, out);
+  } else if (view_method == XML_VIEW) {
+    *out = val;
+    return true;
+  }
+
+  NOTREACHED() << "Please handle all types!";
+  return false;
+}
+
+bool convert_to_view(OutputView view_method, const convert_in_t& text, convert_out_t* out) {
+  if (!out || text.empty()) {
+    return false;
+  }
+
+  if (view_method == JSON_VIEW) {  // raw
+    return string_to_json(text, out);
+  } else if (view_method == RAW_VIEW) {  // raw
+    *out = text;
+    return true;
+  } else if (view_method == TO_HEX_VIEW) {
+    return string_to_hex(text, out);
+  } else if (view_method == FROM_HEX_VIEW) {
+    return string_from_hex(text, out);
+  } else if (view_method == TO_BASE64_VIEW) {
+    return string_to_base64(text, out);
+  } else if (view_method == FROM_BASE64_VIEW) {
+    return string_from_base64(text, out);
+  } else if (view_method == TO_UNICODE_VIEW) {
+    return string_to_unicode(text, out);
+  } else if (view_method == FROM_UNICODE_VIEW) {
+    return string_from_unicode(text, out);
+  } else if (view_method == TO_PICKLE_VIEW) {
+    return string_to_pickle(text, out);
+  } else if (view_method == FROM_PICKLE_VIEW) {
+    return string_from_pickle(text, out);
+  } else if (view_method == ZLIB_VIEW) {
+    return string_from_zlib(text, out);
+  } else if (view_method == GZIP_VIEW) {
+    return string_from_gzip(text, out);
+  } else if (view_method == LZ4_VIEW) {
+    return string_from_lz4(text, out);
+  } else if (view_method == BZIP2_VIEW) {
+    return string_from_bzip2(text, out);
+  } else if (view_method == SNAPPY_VIEW) {
+    return string_from_snappy(text, out);
+  } else if (view_method == XML_VIEW) {  // raw
+    *out = text;
+    return true;
+  }
+
+  NOTREACHED() << "Please handle all types!";
+  return false;
+}
+
+bool convert_to_view_limited(OutputView view_method,
+                             const convert_in_t& text,
+                             const ViewConvertControl& control,
+                             convert_out_t* out,
+                             bool* is_truncated) {
+  if (!out || !is_truncated || text.empty() || IsCanceled(control)) {
+    return false;
+  }
+
+  *is_truncated = false;
+  const size_t limit = control.output_limit;
+  if (!limit) {
+    return convert_to_view(view_method, text, out);
+  }
+
+  if (view_method == RAW_VIEW || view_method == XML_VIEW) {
+    return ConvertPrefix(view_method, text, limit, out, is_truncated);
+  } else if (view_method == TO_HEX_VIEW) {
+    return ConvertPrefix(view_method, text, limit / XHEX_CHARS_PER_BYTE, out, is_truncated);
+  } else if (view_method == TO_BASE64_VIEW) {
+    return ConvertPrefix(view_method, text, limit / 4 * 3, out, is_truncated);
+  } else if (view_method == TO_UNICODE_VIEW) {
+    return ConvertPrefix(view_method, text, Utf8Prefix(text, limit / UNICODE_ESCAPE_MAX_CHARS_PER_BYTE), out,
+                         is_truncated);
+  } else if (view_method == ZLIB_VIEW || view_method == GZIP_VIEW || view_method == BZIP2_VIEW) {
+    return DecompressLimited(view_method, text, control, out, is_truncated);
+  } else if (view_method == FROM_PICKLE_VIEW && pickle_loads(text, limit, out, is_truncated)) {
+    // repr of shared references grows exponentially, render it up to the limit only;
+    // pickles the native reader can't decode go to python below
+    return true;
+  }
+
+  // json, decoders and block compressions need the whole input, only the result is cut
+  convert_out_t full;
+  if (!convert_to_view(view_method, text, &full)) {
+    return false;
+  }
+
+  if (full.size() > limit) {
+    *out = GEN_CMD_STRING_SIZE(full.data(), limit);
+    *is_truncated = true;
+    return true;
+  }
+
+  *out = full;
+  return true;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,76 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include "gui/text_converter.h"
+
+namespace fastonosql {
+namespace gui {
+
+enum OutputView : uint8_t {
+  RAW_VIEW = 0,  // raw
+  JSON_VIEW,     // raw
+
+  TO_HEX_VIEW,
+  FROM_HEX_VIEW,
+
+  TO_BASE64_VIEW,
+  FROM_BASE64_VIEW,
+
+  TO_UNICODE_VIEW,
+  FROM_UNICODE_VIEW,
+
+  TO_PICKLE_VIEW,
+  FROM_PICKLE_VIEW,
+
+  ZLIB_VIEW,    // from
+  GZIP_VIEW,    // from
+  LZ4_VIEW,     // from
+  BZIP2_VIEW,   // from
+  SNAPPY_VIEW,  // from
+  XML_VIEW      // raw
+};
+
+typedef std::function<void(int percent)> convert_progress_callback_t;
+
+struct ViewConvertControl {
+  ViewConvertControl();
+
+  size_t output_limit;  // 0 means unlimited
+  const std::atomic<bool>* canceled;
+  convert_progress_callback_t progress;
+};
+
+bool convert_to_view(OutputView view_method, const convert_in_t& text, convert_out_t* out);
+bool convert_from_view(OutputView view_method, const convert_in_t& val, convert_out_t* out);
+
+// same as convert_to_view but never produces more than output_limit bytes: encoders get a prefix
+// of the input, zlib/gzip/bzip2 are inflated by chunks and stop at the limit, pickles are rendered
+// up to the limit, returns false if conversion failed or was canceled
+bool convert_to_view_limited(OutputView view_method,
+                             const convert_in_t& text,
+                             const ViewConvertControl& control,
+                             convert_out_t* out,
+                             bool* is_truncated);
+
+}  // namespace gui
+}  // namespace fastonosql
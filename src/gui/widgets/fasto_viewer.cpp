@@ -18,12 +18,18 @@
 
 #include "gui/widgets/fasto_viewer.h"
 
+#include <string.h>
+
 #include <vector>
 
 #include <QComboBox>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
 #include <QSplitter>
+#include <QStringList>
+#include <QThread>
 
 #include <Qsci/qscilexerjson.h>
 #include <Qsci/qscilexerxml.h>
@@ -34,111 +40,30 @@
 
 #include <fastonosql/core/types.h>
 
-#include "gui/python_converter.h"
-#include "gui/text_converter.h"
 #include "translations/global.h"
 
+// views are rendered up to preview size, the rest is loaded on demand
+#define VALUE_PREVIEW_SIZE (4 * 1024 * 1024)
+// guards against decompression bombs when the full value is requested
+#define VALUE_FULL_SIZE_LIMIT (512 * 1024 * 1024)
+#define VALUE_VIEWS_CACHE_SIZE (64 * 1024 * 1024)
+
 namespace {
 const QString trNoteInHexedView = QObject::tr("Note: value is hexed (contains unreadable symbols).");
-}
+const QString trNotePreview_1S = QObject::tr("Preview: first %1 MB shown, value is read-only.");
+const QString trShowFullValue = QObject::tr("Show full value");
+const QString trCancel = QObject::tr("Cancel");
+const QString trConversionCanceled = QObject::tr("Conversion canceled.");
+const QString trRetryView_1S = QObject::tr("Retry %1");
+}  // namespace
 
 namespace fastonosql {
 namespace gui {
 
 namespace {
 
-bool convertFromViewImplRoutine(OutputView view_method, const convert_in_t& val, convert_in_t* out) {
-  if (!out || val.empty()) {
-    return false;
-  }
-
-  if (view_method == JSON_VIEW) {
-    return string_from_json(val, out);
-  } else if (view_method == RAW_VIEW) {
-    *out = val;
-    return true;
-  } else if (view_method == TO_HEX_VIEW) {
-    return string_from_hex(val, out);
-  } else if (view_method == FROM_HEX_VIEW) {
-    return string_to_hex(val, out);
-  } else if (view_method == TO_BASE64_VIEW) {
-    return string_from_base64(val, out);
-  } else if (view_method == FROM_BASE64_VIEW) {
-    return string_to_base64(val, out);
-  } else if (view_method == TO_UNICODE_VIEW) {
-    return string_from_unicode(val, out);
-  } else if (view_method == FROM_UNICODE_VIEW) {
-    return string_to_unicode(val, out);
-  } else if (view_method == TO_PICKLE_VIEW) {
-    return string_from_pickle(val, out);
-  } else if (view_method == FROM_PICKLE_VIEW) {
-    return string_to_pickle(val, out);
-  } else if (view_method == ZLIB_VIEW) {
-    return string_to_zlib(val, out);
-  } else if (view_method == GZIP_VIEW) {
-    return string_to_gzip(val, out);
-  } else if (view_method == LZ4_VIEW) {
-    return string_to_lz4(val, out);
-  } else if (view_method == BZIP2_VIEW) {
-    return string_to_bzip2(val, out);
-  } else if (view_method == SNAPPY_VIEW) {
-    return string_to_snappy(val, out);
-  } else if (view_method == XML_VIEW) {
-    *out = val;
-    return true;
-  }
-
-  NOTREACHED() << "Please handle all types!";
-  return false;
-}
-
-bool convertFromViewImpl(OutputView view_method, const convert_out_t& val, convert_in_t* out) {
-  return convertFromViewImplRoutine(view_method, val, out);
-}
-
-bool convertToViewImpl(OutputView view_method, const convert_in_t& text, convert_out_t* out) {
-  if (!out || text.empty()) {
-    return false;
-  }
-
-  if (view_method == JSON_VIEW) {  // raw
-    return string_to_json(text, out);
-  } else if (view_method == RAW_VIEW) {  // raw
-    *out = text;
-    return true;
-  } else if (view_method == TO_HEX_VIEW) {
-    return string_to_hex(text, out);
-  } else if (view_method == FROM_HEX_VIEW) {
-    return string_from_hex(text, out);
-  } else if (view_method == TO_BASE64_VIEW) {
-    return string_to_base64(text, out);
-  } else if (view_method == FROM_BASE64_VIEW) {
-    return string_from_base64(text, out);
-  } else if (view_method == TO_UNICODE_VIEW) {
-    return string_to_unicode(text, out);
-  } else if (view_method == FROM_UNICODE_VIEW) {
-    return string_from_unicode(text, out);
-  } else if (view_method == TO_PICKLE_VIEW) {
-    return string_to_pickle(text, out);
-  } else if (view_method == FROM_PICKLE_VIEW) {
-    return string_from_pickle(text, out);
-  } else if (view_method == ZLIB_VIEW) {
-    return string_from_zlib(text, out);
-  } else if (view_method == GZIP_VIEW) {
-    return string_from_gzip(text, out);
-  } else if (view_method == LZ4_VIEW) {
-    return string_from_lz4(text, out);
-  } else if (view_method == BZIP2_VIEW) {
-    return string_from_bzip2(text, out);
-  } else if (view_method == SNAPPY_VIEW) {
-    return string_from_snappy(text, out);
-  } else if (view_method == XML_VIEW) {  // raw
-    *out = text;
-    return true;
-  }
-
-  NOTREACHED() << "Please handle all types!";
-  return false;
+bool isSameValue(const FastoViewer::view_input_text_t& left, const FastoViewer::view_input_text_t& right) {
+  return left.size() == right.size() && (left.empty() || memcmp(left.data(), right.data(), left.size()) == 0);
 }
 
 }  // namespace
@@ -152,8 +77,21 @@ FastoViewer::FastoViewer(QWidget* parent)
       view_method_(RAW_VIEW),
       error_box_(nullptr),
       note_box_(nullptr),
+      convert_progress_(nullptr),
+      cancel_convert_button_(nullptr),
+      retry_convert_button_(nullptr),
+      full_value_button_(nullptr),
       last_valid_text_(),
-      is_binary_(false) {
+      pending_text_(),
+      is_binary_(false),
+      is_preview_(false),
+      is_read_only_(false),
+      is_view_updating_(false),
+      converter_(),
+      retry_view_(RAW_VIEW),
+      convert_canceled_(),
+      views_cache_(),
+      views_cache_size_(0) {
   text_json_editor_ = createWidget<FastoEditor>();
   json_lexer_ = new QsciLexerJSON(this);
   xml_lexer_ = new QsciLexerXML(this);
@@ -166,6 +104,22 @@ FastoViewer::FastoViewer(QWidget* parent)
   note_box_ = new QLabel(trNoteInHexedView);
   note_box_->setVisible(false);
 
+  full_value_button_ = new QPushButton;
+  full_value_button_->setVisible(false);
+  VERIFY(connect(full_value_button_, &QPushButton::clicked, this, &FastoViewer::loadFullValue));
+
+  convert_progress_ = new QProgressBar;
+  convert_progress_->setRange(0, 100);
+  convert_progress_->setVisible(false);
+
+  cancel_convert_button_ = new QPushButton;
+  cancel_convert_button_->setVisible(false);
+  VERIFY(connect(cancel_convert_button_, &QPushButton::clicked, this, &FastoViewer::cancelConvert));
+
+  retry_convert_button_ = new QPushButton;
+  retry_convert_button_->setVisible(false);
+  VERIFY(connect(retry_convert_button_, &QPushButton::clicked, this, &FastoViewer::retryConvert));
+
   views_label_ = new QLabel;
   views_combo_box_ = new QComboBox;
   for (unsigned i = 0; i < g_output_views_text.size(); ++i) {
@@ -183,7 +137,11 @@ FastoViewer::FastoViewer(QWidget* parent)
 
   QHBoxLayout* ehlayout = new QHBoxLayout;
   ehlayout->addWidget(note_box_);
+  ehlayout->addWidget(full_value_button_);
   ehlayout->addWidget(error_box_);
+  ehlayout->addWidget(convert_progress_);
+  ehlayout->addWidget(cancel_convert_button_);
+  ehlayout->addWidget(retry_convert_button_);
   ehlayout->addLayout(hlayout);
 
   QVBoxLayout* main = new QVBoxLayout;
@@ -194,6 +152,10 @@ FastoViewer::FastoViewer(QWidget* parent)
   syncEditors();
 }
 
+FastoViewer::~FastoViewer() {
+  stopConvert();
+}
+
 void FastoViewer::syncEditors() {
   if (view_method_ == JSON_VIEW) {
     text_json_editor_->setLexer(json_lexer_);
@@ -204,6 +166,10 @@ void FastoViewer::syncEditors() {
   }
 }
 
+void FastoViewer::syncReadOnly() {
+  text_json_editor_->setReadOnly(is_read_only_ || is_preview_);
+}
+
 void FastoViewer::setView(int view_method) {
   views_combo_box_->setCurrentIndex(view_method);
 }
@@ -213,30 +179,44 @@ void FastoViewer::setViewChangeEnabled(bool enable) {
 }
 
 void FastoViewer::setReadOnly(bool ro) {
-  text_json_editor_->setReadOnly(ro);
+  is_read_only_ = ro;
+  syncReadOnly();
 }
 
 void FastoViewer::viewChange(int view_method) {
   view_method_ = static_cast<OutputView>(view_method);
+  retry_convert_button_->setVisible(false);
   syncEditors();
-  setText(last_valid_text_);
+  setText(converter_ ? pending_text_ : last_valid_text_);
   emit viewChanged(view_method);
 }
 
 void FastoViewer::textChange() {
-  view_output_text_t str_text;
-  if (convertFromView(&str_text)) {
-    clearError();
-    last_valid_text_ = str_text;
+  // text set by a view switch is already in last_valid_text_, a cut preview must not replace it
+  if (!is_view_updating_ && !is_preview_) {
+    view_output_text_t str_text;
+    if (convertFromView(&str_text)) {
+      clearError();
+      last_valid_text_ = str_text;
+      clearViewsCache();
+    }
   }
   emit textChanged();
 }
 
 void FastoViewer::clear() {
+  stopConvert();
   text_json_editor_->clear();
   clearError();
   last_valid_text_.clear();
+  pending_text_.clear();
+  clearViewsCache();
   is_binary_ = false;
+  is_preview_ = false;
+  note_box_->setVisible(false);
+  full_value_button_->setVisible(false);
+  retry_convert_button_->setVisible(false);
+  syncReadOnly();
 }
 
 OutputView FastoViewer::viewMethod() const {
@@ -244,38 +224,170 @@ OutputView FastoViewer::viewMethod() const {
 }
 
 FastoViewer::view_input_text_t FastoViewer::text() const {
+  if (converter_) {
+    return pending_text_;
+  }
+
   return last_valid_text_;
 }
 
 bool FastoViewer::setText(const view_input_text_t& text) {
-  view_output_text_t result_str;
-  if (!convertToView(text, &result_str)) {
-    QString method_text = g_output_views_text[view_method_];
+  if (isSameValue(text, last_valid_text_)) {
+    const auto it = views_cache_.find(view_method_);
+    if (it != views_cache_.end()) {
+      stopConvert();
+      setViewText(it->second);
+      return true;
+    }
+  }
+
+  startConvert(text, VALUE_PREVIEW_SIZE);
+  return true;
+}
+
+void FastoViewer::startConvert(const view_input_text_t& text, size_t output_limit) {
+  stopConvert();
+  pending_text_ = text;
+  convert_canceled_ = std::make_shared<std::atomic<bool>>(false);
+
+  QThread* th = new QThread;
+  ValueConverter* converter = new ValueConverter(view_method_, text, output_limit, convert_canceled_);
+  converter->moveToThread(th);
+  VERIFY(connect(th, &QThread::started, converter, &ValueConverter::routine));
+  VERIFY(connect(converter, &ValueConverter::progressChanged, this, &FastoViewer::convertProgressChange));
+  VERIFY(connect(converter, &ValueConverter::converted, this, &FastoViewer::valueConvert));
+  VERIFY(connect(converter, &ValueConverter::finished, th, &QThread::quit));
+  VERIFY(connect(th, &QThread::finished, converter, &ValueConverter::deleteLater));
+  VERIFY(connect(th, &QThread::finished, th, &QThread::deleteLater));
+  converter_ = converter;
+
+  convert_progress_->setValue(0);
+  convert_progress_->setVisible(true);
+  cancel_convert_button_->setVisible(true);
+  th->start();
+}
+
+void FastoViewer::stopConvert() {
+  if (convert_canceled_) {
+    convert_canceled_->store(true);
+    convert_canceled_.reset();
+  }
+
+  converter_ = nullptr;
+  convert_progress_->setVisible(false);
+  cancel_convert_button_->setVisible(false);
+}
+
+void FastoViewer::convertProgressChange(int percent) {
+  if (sender() != converter_) {
+    return;
+  }
+
+  convert_progress_->setValue(percent);
+}
+
+void FastoViewer::valueConvert(fastonosql::gui::ConvertedValue value) {
+  if (sender() != converter_) {
+    return;
+  }
+
+  const view_input_text_t text = pending_text_;
+  stopConvert();
+  pending_text_.clear();
+  if (!value.is_ok) {
+    QString method_text = g_output_views_text[value.view_method];
     setError(translations::trCannotConvertPattern_1S.arg(method_text));
     note_box_->setVisible(false);
-    return false;
+    return;
   }
 
-  last_valid_text_ = text;
-  setViewText(result_str);
-  return true;
+  if (!isSameValue(text, last_valid_text_)) {
+    clearViewsCache();
+    last_valid_text_ = text;
+  }
+  cacheView(value);
+  setViewText(value);
+}
+
+void FastoViewer::cancelConvert() {
+  // the opened value stays the current one, it is shown raw and can still be saved or converted again
+  const view_input_text_t text = pending_text_;
+  const OutputView canceled_view = view_method_;
+  stopConvert();
+  pending_text_.clear();
+  if (!isSameValue(text, last_valid_text_)) {
+    clearViewsCache();
+    last_valid_text_ = text;
+  }
+
+  if (canceled_view != RAW_VIEW) {
+    setView(RAW_VIEW);
+  }
+  setError(trConversionCanceled);
+  retry_view_ = canceled_view;
+  retry_convert_button_->setText(trRetryView_1S.arg(g_output_views_text[retry_view_]));
+  retry_convert_button_->setVisible(true);
+}
+
+void FastoViewer::retryConvert() {
+  retry_convert_button_->setVisible(false);
+  if (retry_view_ != view_method_) {
+    setView(retry_view_);
+    return;
+  }
+
+  startConvert(last_valid_text_, VALUE_PREVIEW_SIZE);
 }
 
-void FastoViewer::setViewText(const view_input_text_t& text) {
+void FastoViewer::loadFullValue() {
+  startConvert(last_valid_text_, VALUE_FULL_SIZE_LIMIT);
+}
+
+void FastoViewer::cacheView(const ConvertedValue& value) {
+  const size_t value_size = value.text.size() * sizeof(QChar);
+  if (value_size > VALUE_VIEWS_CACHE_SIZE) {
+    return;
+  }
+
+  const auto it = views_cache_.find(value.view_method);
+  if (it != views_cache_.end()) {
+    views_cache_size_ -= it->second.text.size() * sizeof(QChar);
+    views_cache_.erase(it);
+  }
+
+  if (views_cache_size_ + value_size > VALUE_VIEWS_CACHE_SIZE) {
+    clearViewsCache();
+  }
+
+  views_cache_[value.view_method] = value;
+  views_cache_size_ += value_size;
+}
+
+void FastoViewer::clearViewsCache() {
+  views_cache_.clear();
+  views_cache_size_ = 0;
+}
+
+void FastoViewer::setViewText(const ConvertedValue& value) {
   clearError();
-  QString qtext;
-  is_binary_ = core::detail::is_binary_data(text);
+  is_binary_ = value.is_binary;
+  is_preview_ = value.is_truncated;
+
+  QStringList notes;
   if (is_binary_) {
-    convert_in_t hexed;
-    bool is_ok = common::utils::xhex::encode(text, is_lower_hex, &hexed);
-    DCHECK(is_ok) << "Can't hexed: " << text;
-    common::ConvertFromBytes(hexed, &qtext);
-    note_box_->setVisible(true);
-  } else {
-    common::ConvertFromBytes(text, &qtext);
-    note_box_->setVisible(false);
+    notes << trNoteInHexedView;
+  }
+  if (is_preview_) {
+    notes << trNotePreview_1S.arg(value.output_limit / (1024 * 1024));
   }
-  text_json_editor_->setText(qtext);
+  note_box_->setText(notes.join(" "));
+  note_box_->setVisible(!notes.isEmpty());
+  full_value_button_->setVisible(is_preview_);
+
+  is_view_updating_ = true;
+  text_json_editor_->setText(value.text);
+  is_view_updating_ = false;
+  syncReadOnly();
 }
 
 bool FastoViewer::isReadOnly() const {
@@ -284,6 +396,8 @@ bool FastoViewer::isReadOnly() const {
 
 void FastoViewer::retranslateUi() {
   views_label_->setText(translations::trViews + ":");
+  full_value_button_->setText(trShowFullValue);
+  cancel_convert_button_->setText(trCancel);
   base_class::retranslateUi();
 }
 
@@ -301,10 +415,6 @@ bool FastoViewer::isError() const {
   return error_box_->isVisible();
 }
 
-bool FastoViewer::convertToView(const view_input_text_t& text, view_output_text_t* out) const {
-  return convertToViewImpl(view_method_, text, out);
-}
-
 bool FastoViewer::convertFromView(view_output_text_t* out) const {
   QString cur_text = text_json_editor_->text();
   convert_out_t cout;
@@ -315,7 +425,7 @@ bool FastoViewer::convertFromView(view_output_text_t* out) const {
     cout = common::ConvertToCharBytes(cur_text);
   }
 
-  return convertFromViewImpl(view_method_, cout, out);
+  return convert_from_view(view_method_, cout, out);
 }
 
 }  // namespace gui
@@ -18,43 +18,26 @@
 
 #pragma once
 
+#include <map>
 #include <vector>
 
+#include <QPointer>
+
 #include <fastonosql/core/basic_types.h>
 
+#include "gui/view_converter.h"
 #include "gui/widgets/base_widget.h"
 #include "gui/widgets/fasto_editor.h"
+#include "gui/workers/value_converter.h"
 
 class QLabel;
 class QComboBox;
+class QProgressBar;
+class QPushButton;
 
 namespace fastonosql {
 namespace gui {
 
-enum OutputView : uint8_t {
-  RAW_VIEW = 0,  // raw
-  JSON_VIEW,     // raw
-
-  TO_HEX_VIEW,
-  FROM_HEX_VIEW,
-
-  TO_BASE64_VIEW,
-  FROM_BASE64_VIEW,
-
-  TO_UNICODE_VIEW,
-  FROM_UNICODE_VIEW,
-
-  TO_PICKLE_VIEW,
-  FROM_PICKLE_VIEW,
-
-  ZLIB_VIEW,    // from
-  GZIP_VIEW,    // from
-  LZ4_VIEW,     // from
-  BZIP2_VIEW,   // from
-  SNAPPY_VIEW,  // from
-  XML_VIEW      // raw
-};
-
 extern const std::vector<const char*> g_output_views_text;
 
 class FastoViewer : public BaseWidget {
@@ -69,6 +52,8 @@ class FastoViewer : public BaseWidget {
   typedef core::readable_string_t view_input_text_t;
   typedef core::readable_string_t view_output_text_t;
 
+  ~FastoViewer() override;
+
   OutputView viewMethod() const;
   view_input_text_t text() const;
 
@@ -94,19 +79,31 @@ class FastoViewer : public BaseWidget {
   void viewChange(int view_method);
   void textChange();
 
+  void convertProgressChange(int percent);
+  void valueConvert(fastonosql::gui::ConvertedValue value);
+  void cancelConvert();
+  void retryConvert();
+  void loadFullValue();
+
  protected:
   explicit FastoViewer(QWidget* parent = Q_NULLPTR);
   void retranslateUi() override;
 
  private:
-  void setViewText(const view_input_text_t& text);
+  void setViewText(const ConvertedValue& value);
 
   bool isError() const;
 
-  bool convertToView(const view_input_text_t& text, view_output_text_t* out) const;
+  // conversion runs on a worker thread, result comes to valueConvert
+  void startConvert(const view_input_text_t& text, size_t output_limit);
+  void stopConvert();
   bool convertFromView(view_output_text_t* out) const;
 
+  void cacheView(const ConvertedValue& value);
+  void clearViewsCache();
+
   void syncEditors();
+  void syncReadOnly();
 
   FastoEditor* text_json_editor_;
   QsciLexer* json_lexer_;
@@ -118,9 +115,25 @@ class FastoViewer : public BaseWidget {
   QComboBox* views_combo_box_;
   QLabel* error_box_;
   QLabel* note_box_;
+  QProgressBar* convert_progress_;
+  QPushButton* cancel_convert_button_;
+  QPushButton* retry_convert_button_;
+  QPushButton* full_value_button_;
 
   view_input_text_t last_valid_text_;
+  view_input_text_t pending_text_;
   bool is_binary_;
+  bool is_preview_;
+  bool is_read_only_;
+  bool is_view_updating_;
+
+  QPointer<ValueConverter> converter_;
+  OutputView retry_view_;  // view whose conversion was canceled
+  ValueConverter::cancel_flag_t convert_canceled_;
+
+  // rendered views of last_valid_text_
+  std::map<OutputView, ConvertedValue> views_cache_;
+  size_t views_cache_size_;
 };
 
 }  // namespace gui
@@ -0,0 +1,115 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/widgets/heat_map_widget.h"
+
+#include <math.h>
+
+#include <algorithm>
+
+#include <QHelpEvent>
+#include <QPainter>
+#include <QToolTip>
+
+#include <common/macros.h>
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+QColor HeatColor(double ratio) {
+  // hue 120 green for idle down to 0 red for the hottest
+  const int hue = static_cast<int>(120 * (1.0 - std::min(std::max(ratio, 0.0), 1.0)));
+  return QColor::fromHsv(hue, 200, 230);
+}
+}  // namespace
+
+HeatMapWidget::HeatMapWidget(QWidget* parent) : base_class(parent), cells_() {
+  setMouseTracking(true);
+  setMinimumHeight(min_cell_size);
+}
+
+void HeatMapWidget::setCells(const cells_t& cells) {
+  cells_ = cells;
+  updateGeometry();
+  update();
+}
+
+QSize HeatMapWidget::sizeHint() const {
+  const int columns = columnsCount();
+  const int rows = cells_.empty() ? 1 : static_cast<int>((cells_.size() + columns - 1) / columns);
+  return QSize(columns * min_cell_size, rows * min_cell_size);
+}
+
+int HeatMapWidget::columnsCount() const {
+  if (cells_.empty()) {
+    return 1;
+  }
+
+  // close to a square grid, but never narrower than a cell
+  const int by_width = std::max(1, width() / min_cell_size);
+  const int square = static_cast<int>(ceil(sqrt(static_cast<double>(cells_.size()))));
+  return std::min(by_width, std::max(square, 1));
+}
+
+QRect HeatMapWidget::cellRect(size_t index) const {
+  const int columns = columnsCount();
+  const int rows = static_cast<int>((cells_.size() + columns - 1) / columns);
+  const int cell_width = width() / columns;
+  const int cell_height = std::max(static_cast<int>(min_cell_size), height() / std::max(rows, 1));
+  const int row = static_cast<int>(index) / columns;
+  const int column = static_cast<int>(index) % columns;
+  return QRect(column * cell_width, row * cell_height, cell_width - 1, cell_height - 1);
+}
+
+void HeatMapWidget::paintEvent(QPaintEvent* event) {
+  UNUSED(event);
+  QPainter painter(this);
+  double max_value = 0;
+  for (const Cell& cell : cells_) {
+    max_value = std::max(max_value, cell.value);
+  }
+
+  for (size_t i = 0; i < cells_.size(); ++i) {
+    const QRect rect = cellRect(i);
+    const Cell& cell = cells_[i];
+    painter.fillRect(rect, HeatColor(max_value > 0 ? cell.value / max_value : 0));
+    painter.setPen(Qt::black);
+    painter.drawText(rect, Qt::AlignCenter | Qt::TextWordWrap, cell.label);
+  }
+}
+
+bool HeatMapWidget::event(QEvent* event) {
+  if (event->type() == QEvent::ToolTip) {
+    QHelpEvent* help_event = static_cast<QHelpEvent*>(event);
+    for (size_t i = 0; i < cells_.size(); ++i) {
+      if (cellRect(i).contains(help_event->pos())) {
+        QToolTip::showText(help_event->globalPos(), cells_[i].tooltip, this);
+        return true;
+      }
+    }
+    QToolTip::hideText();
+    event->ignore();
+    return true;
+  }
+
+  return base_class::event(event);
+}
+
+}  // namespace gui
+}  // namespace fastonosql
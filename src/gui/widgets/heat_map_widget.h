@@ -0,0 +1,60 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <QWidget>
+
+namespace fastonosql {
+namespace gui {
+
+// grid of cells colored from cold to hot relative to the hottest cell
+class HeatMapWidget : public QWidget {
+  Q_OBJECT
+
+ public:
+  typedef QWidget base_class;
+  enum { min_cell_size = 48 };
+
+  struct Cell {
+    QString label;
+    double value;
+    QString tooltip;
+  };
+  typedef std::vector<Cell> cells_t;
+
+  explicit HeatMapWidget(QWidget* parent = Q_NULLPTR);
+
+  void setCells(const cells_t& cells);
+  QSize sizeHint() const override;
+
+ protected:
+  void paintEvent(QPaintEvent* event) override;
+  bool event(QEvent* event) override;
+
+ private:
+  int columnsCount() const;
+  QRect cellRect(size_t index) const;
+
+  cells_t cells_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
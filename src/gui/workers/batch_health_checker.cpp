@@ -0,0 +1,99 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/workers/batch_health_checker.h"
+
+namespace fastonosql {
+namespace gui {
+
+BatchHealthChecker::Batch::Batch(quint64 generation) : generation(generation), tasks() {}
+
+BatchHealthChecker::BatchHealthChecker(int workers, common::time64_t timeout_msec, QObject* parent)
+    : QObject(parent),
+      queue_(std::make_shared<WorkerQueue>(this, workers)),
+      timeout_msec_(timeout_msec),
+      batch_(),
+      generation_(0),
+      done_(0) {}
+
+BatchHealthChecker::~BatchHealthChecker() {
+  queue_->detach();
+}
+
+void BatchHealthChecker::start(const std::vector<proxy::IConnectionSettingsBaseSPtr>& connections) {
+  stop();
+
+  batch_ = std::make_shared<Batch>(++generation_);
+  done_ = 0;
+  for (const auto& connection : connections) {
+    Task task;
+    task.connection = connection;
+    batch_->tasks.push_back(task);
+  }
+
+  if (batch_->tasks.empty()) {
+    batch_.reset();
+    emit finished();
+    return;
+  }
+
+  const std::shared_ptr<Batch> batch = batch_;
+  const common::time64_t timeout_msec = timeout_msec_;
+  for (size_t i = 0; i < batch->tasks.size(); ++i) {
+    const int index = static_cast<int>(i);
+    queue_->post([batch, index, timeout_msec](WorkerQueue* queue) {
+      Task& task = batch->tasks[index];
+      task.err = proxy::ServersManager::GetInstance().CheckHealth(task.connection, timeout_msec, &task.info);
+      queue->deliver("handleChecked", Q_ARG(quint64, batch->generation), Q_ARG(int, index));
+    });
+  }
+}
+
+void BatchHealthChecker::stop() {
+  if (!batch_) {
+    return;
+  }
+
+  // hosts already being checked finish in background, their results are dropped by generation
+  queue_->clear();
+  batch_.reset();
+}
+
+bool BatchHealthChecker::isRunning() const {
+  return batch_ != nullptr;
+}
+
+void BatchHealthChecker::handleChecked(quint64 generation, int index) {
+  if (!batch_ || batch_->generation != generation) {
+    return;
+  }
+
+  const Task task = batch_->tasks[index];
+  const bool last = ++done_ == batch_->tasks.size();
+  if (last) {
+    batch_.reset();
+  }
+
+  emit checked(task.connection, task.err, task.info);
+  if (last) {
+    emit finished();
+  }
+}
+
+}  // namespace gui
+}  // namespace fastonosql
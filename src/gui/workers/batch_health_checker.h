@@ -0,0 +1,81 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <QObject>
+
+#include "gui/workers/worker_queue.h"
+#include "proxy/servers_manager.h"
+
+namespace fastonosql {
+namespace gui {
+
+// runs ServersManager::CheckHealth for many connections with bounded concurrency,
+// results come back in the gui thread as soon as each host answers
+class BatchHealthChecker : public QObject {
+  Q_OBJECT
+
+ public:
+  enum { default_workers = 16, default_timeout_msec = 3000 };
+
+  struct Task {
+    proxy::IConnectionSettingsBaseSPtr connection;
+    common::Error err;
+    proxy::ServersManager::HealthInfo info;
+  };
+
+  struct Batch {
+    explicit Batch(quint64 generation);
+
+    const quint64 generation;
+    std::vector<Task> tasks;  // each entry is written by one task only
+  };
+
+  explicit BatchHealthChecker(int workers = default_workers,
+                              common::time64_t timeout_msec = default_timeout_msec,
+                              QObject* parent = Q_NULLPTR);
+  ~BatchHealthChecker() override;
+
+  // stops the previous batch if it is still running
+  void start(const std::vector<proxy::IConnectionSettingsBaseSPtr>& connections);
+  void stop();
+  bool isRunning() const;
+
+ Q_SIGNALS:
+  void checked(proxy::IConnectionSettingsBaseSPtr connection,
+               common::Error err,
+               const proxy::ServersManager::HealthInfo& info);
+  void finished();
+
+ private Q_SLOTS:
+  void handleChecked(quint64 generation, int index);
+
+ private:
+  const WorkerQueueSPtr queue_;
+  const common::time64_t timeout_msec_;
+  std::shared_ptr<Batch> batch_;
+  quint64 generation_;
+  size_t done_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
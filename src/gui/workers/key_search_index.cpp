@@ -0,0 +1,433 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/workers/key_search_index.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+const char kIdSeparator = '\x1F';
+const size_t kTrigramSize = 3;
+const size_t kMinDeadToCompact = 4096;
+
+template <typename T>
+std::string ToStdString(const T& str) {
+  return std::string(str.begin(), str.end());
+}
+
+std::string ToLowerAscii(const std::string& str) {
+  std::string result(str);
+  for (char& c : result) {
+    if (c >= 'A' && c <= 'Z') {
+      c = static_cast<char>(c - 'A' + 'a');
+    }
+  }
+  return result;
+}
+
+std::vector<uint32_t> MakeTrigrams(const std::string& text) {
+  std::vector<uint32_t> trigrams;
+  if (text.size() < kTrigramSize) {
+    return trigrams;
+  }
+
+  trigrams.reserve(text.size() - kTrigramSize + 1);
+  for (size_t i = 0; i + kTrigramSize <= text.size(); ++i) {
+    const uint32_t trigram = static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << 16 |
+                             static_cast<uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8 |
+                             static_cast<uint32_t>(static_cast<unsigned char>(text[i + 2]));
+    trigrams.push_back(trigram);
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+  return trigrams;
+}
+
+// applies queued operations and reruns the query until nothing is left
+void RunIndex(const std::shared_ptr<KeySearchIndex::State>& state, WorkerQueue* queue) {
+  while (true) {
+    std::vector<KeySearchIndex::Operation> operations;
+    KeySearchIndex::Query query;
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->operations.empty() && !state->query.dirty) {
+        state->scheduled = false;
+        return;
+      }
+
+      operations.swap(state->operations);
+      if (!operations.empty() && !state->query.text.empty()) {
+        state->query.dirty = true;
+      }
+      query = state->query;
+      state->query.dirty = false;
+    }
+
+    for (const KeySearchIndex::Operation& operation : operations) {
+      if (operation.type == KeySearchIndex::Operation::INSERT) {
+        state->index.insert(operation.id, operation.name, operation.value);
+      } else if (operation.type == KeySearchIndex::Operation::REMOVE) {
+        state->index.remove(operation.id);
+      } else if (operation.type == KeySearchIndex::Operation::RENAME) {
+        state->index.rename(operation.id, operation.new_id, operation.name);
+      } else {
+        state->index.removeByPrefix(operation.id);
+      }
+    }
+
+    if (!query.dirty) {
+      continue;
+    }
+
+    KeySearchIndex::MatchSetSPtr result =
+        std::make_shared<KeySearchIndex::match_set_t>(state->index.search(query.text, query.with_values));
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->result = result;
+      state->result_generation = query.generation;
+    }
+    queue->deliver("handleSearched", Q_ARG(quint64, query.generation));
+  }
+}
+}  // namespace
+
+KeyTrigramIndex::KeyTrigramIndex() : docs_(), ids_(), names_(), values_(), dead_(0) {}
+
+void KeyTrigramIndex::insert(const key_id_t& id, const std::string& name, const std::string& value) {
+  remove(id);
+
+  const doc_t doc = static_cast<doc_t>(docs_.size());
+  docs_.push_back({id, ToLowerAscii(name), ToLowerAscii(value), true});
+  ids_[id] = doc;
+  addPostings(doc, docs_.back().name, &names_);
+  if (!docs_.back().value.empty()) {
+    addPostings(doc, docs_.back().value, &values_);
+  }
+}
+
+void KeyTrigramIndex::remove(const key_id_t& id) {
+  const auto it = ids_.find(id);
+  if (it == ids_.end()) {
+    return;
+  }
+
+  Document& doc = docs_[it->second];
+  doc.alive = false;
+  std::string().swap(doc.name);
+  std::string().swap(doc.value);
+  ids_.erase(it);
+  ++dead_;
+  if (dead_ >= kMinDeadToCompact && dead_ > ids_.size()) {
+    compact();
+  }
+}
+
+void KeyTrigramIndex::rename(const key_id_t& id, const key_id_t& new_id, const std::string& new_name) {
+  const auto it = ids_.find(id);
+  const std::string value = it == ids_.end() ? std::string() : docs_[it->second].value;
+  remove(id);
+  insert(new_id, new_name, value);
+}
+
+void KeyTrigramIndex::removeByPrefix(const std::string& prefix) {
+  std::vector<key_id_t> removed;
+  for (const auto& id : ids_) {
+    if (id.first.compare(0, prefix.size(), prefix) == 0) {
+      removed.push_back(id.first);
+    }
+  }
+
+  if (removed.size() == ids_.size()) {
+    clear();
+    return;
+  }
+
+  for (const key_id_t& id : removed) {
+    remove(id);
+  }
+}
+
+void KeyTrigramIndex::clear() {
+  docs_.clear();
+  ids_.clear();
+  names_.clear();
+  values_.clear();
+  dead_ = 0;
+}
+
+size_t KeyTrigramIndex::size() const {
+  return ids_.size();
+}
+
+KeyTrigramIndex::match_set_t KeyTrigramIndex::search(const std::string& text, bool with_values) const {
+  match_set_t matches;
+  const std::string needle = ToLowerAscii(text);
+  if (needle.empty()) {
+    return matches;
+  }
+
+  searchIn(needle, names_, &Document::name, &matches);
+  if (with_values) {
+    searchIn(needle, values_, &Document::value, &matches);
+  }
+  return matches;
+}
+
+void KeyTrigramIndex::addPostings(doc_t doc, const std::string& text, postings_t* postings) {
+  for (trigram_t trigram : MakeTrigrams(text)) {
+    (*postings)[trigram].push_back(doc);
+  }
+}
+
+void KeyTrigramIndex::searchIn(const std::string& needle,
+                               const postings_t& postings,
+                               std::string Document::*field,
+                               match_set_t* matches) const {
+  // too short for a trigram, a plain scan is still cheaper than regexing tree rows
+  if (needle.size() < kTrigramSize) {
+    for (const Document& doc : docs_) {
+      if (doc.alive && (doc.*field).find(needle) != std::string::npos) {
+        matches->insert(doc.id);
+      }
+    }
+    return;
+  }
+
+  std::vector<const std::vector<doc_t>*> lists;
+  for (trigram_t trigram : MakeTrigrams(needle)) {
+    const auto it = postings.find(trigram);
+    if (it == postings.end()) {
+      return;
+    }
+    lists.push_back(&it->second);
+  }
+
+  std::sort(lists.begin(), lists.end(), [](const std::vector<doc_t>* left, const std::vector<doc_t>* right) {
+    return left->size() < right->size();
+  });
+  std::vector<doc_t> candidates(*lists[0]);
+  std::vector<doc_t> intersection;
+  for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+    intersection.clear();
+    std::set_intersection(candidates.begin(), candidates.end(), lists[i]->begin(), lists[i]->end(),
+                          std::back_inserter(intersection));
+    candidates.swap(intersection);
+  }
+
+  // trigrams match in any order, the substring check confirms
+  for (doc_t candidate : candidates) {
+    const Document& doc = docs_[candidate];
+    if (doc.alive && (doc.*field).find(needle) != std::string::npos) {
+      matches->insert(doc.id);
+    }
+  }
+}
+
+void KeyTrigramIndex::compact() {
+  std::vector<Document> docs;
+  docs.reserve(ids_.size());
+  for (Document& doc : docs_) {
+    if (doc.alive) {
+      docs.push_back(std::move(doc));
+    }
+  }
+
+  clear();
+  docs_.swap(docs);
+  for (size_t i = 0; i < docs_.size(); ++i) {
+    const doc_t doc = static_cast<doc_t>(i);
+    ids_[docs_[i].id] = doc;
+    addPostings(doc, docs_[i].name, &names_);
+    if (!docs_[i].value.empty()) {
+      addPostings(doc, docs_[i].value, &values_);
+    }
+  }
+}
+
+KeySearchIndex::State::State()
+    : mutex(), operations(), query({0, std::string(), false, false}), result(), result_generation(0), scheduled(false),
+      index() {}
+
+KeySearchIndex::KeySearchIndex(QObject* parent)
+    : QObject(parent),
+      queue_(std::make_shared<WorkerQueue>(this, 1)),  // one worker keeps mutations ordered
+      state_(std::make_shared<State>()),
+      generation_(0),
+      search_values_(false),
+      text_() {}
+
+KeySearchIndex::~KeySearchIndex() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->operations.clear();
+    state_->query.text.clear();
+    state_->query.dirty = false;
+  }
+  queue_->detach();
+}
+
+KeySearchIndex::key_id_t KeySearchIndex::makeKeyId(const proxy::IServer* server,
+                                                   const core::readable_string_t& db_name,
+                                                   const core::NKey& key) {
+  return makeDatabasePrefix(server, db_name) + ToStdString(key.GetKey().GetHumanReadable());
+}
+
+std::string KeySearchIndex::makeServerPrefix(const proxy::IServer* server) {
+  return std::to_string(reinterpret_cast<uintptr_t>(server)) + kIdSeparator;
+}
+
+std::string KeySearchIndex::makeDatabasePrefix(const proxy::IServer* server, const core::readable_string_t& db_name) {
+  return makeServerPrefix(server) + ToStdString(db_name) + kIdSeparator;
+}
+
+void KeySearchIndex::addKey(const proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NDbKValue& dbv) {
+  if (!server || !db) {
+    DNOTREACHED();
+    return;
+  }
+
+  const core::NKey key = dbv.GetKey();
+  Operation operation;
+  operation.type = Operation::INSERT;
+  operation.id = makeKeyId(server, db->GetName(), key);
+  operation.name = ToStdString(key.GetKey().GetHumanReadable());
+  const core::NValue value = dbv.GetValue();
+  common::Value::string_t str;
+  if (value.get() && value->GetType() == common::Value::TYPE_STRING && value->GetAsString(&str) &&
+      str.size() <= max_indexed_value_size) {
+    operation.value = ToStdString(str);
+  }
+  post(operation);
+}
+
+void KeySearchIndex::removeKey(const proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NKey& key) {
+  if (!server || !db) {
+    DNOTREACHED();
+    return;
+  }
+
+  Operation operation;
+  operation.type = Operation::REMOVE;
+  operation.id = makeKeyId(server, db->GetName(), key);
+  post(operation);
+}
+
+void KeySearchIndex::renameKey(const proxy::IServer* server,
+                               core::IDataBaseInfoSPtr db,
+                               const core::NKey& key,
+                               const core::NKey& new_key) {
+  if (!server || !db) {
+    DNOTREACHED();
+    return;
+  }
+
+  Operation operation;
+  operation.type = Operation::RENAME;
+  operation.id = makeKeyId(server, db->GetName(), key);
+  operation.new_id = makeKeyId(server, db->GetName(), new_key);
+  operation.name = ToStdString(new_key.GetKey().GetHumanReadable());
+  post(operation);
+}
+
+void KeySearchIndex::removeDatabase(const proxy::IServer* server, core::IDataBaseInfoSPtr db) {
+  if (!server || !db) {
+    DNOTREACHED();
+    return;
+  }
+
+  Operation operation;
+  operation.type = Operation::REMOVE_PREFIX;
+  operation.id = makeDatabasePrefix(server, db->GetName());
+  post(operation);
+}
+
+void KeySearchIndex::removeServer(const proxy::IServer* server) {
+  if (!server) {
+    DNOTREACHED();
+    return;
+  }
+
+  Operation operation;
+  operation.type = Operation::REMOVE_PREFIX;
+  operation.id = makeServerPrefix(server);
+  post(operation);
+}
+
+void KeySearchIndex::search(const QString& text) {
+  text_ = text;
+  const quint64 generation = ++generation_;
+  const std::string needle = text.toStdString();
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->query = {generation, needle, search_values_, !needle.empty()};
+    state_->result.reset();
+    if (!needle.empty()) {
+      schedule();
+    }
+  }
+
+  if (needle.empty()) {
+    emit matched(MatchSetSPtr());
+  }
+}
+
+void KeySearchIndex::setSearchValues(bool search_values) {
+  if (search_values_ == search_values) {
+    return;
+  }
+
+  search_values_ = search_values;
+  search(text_);
+}
+
+void KeySearchIndex::handleSearched(quint64 generation) {
+  MatchSetSPtr result;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (generation != generation_ || state_->result_generation != generation || !state_->result) {
+      return;
+    }
+    result.swap(state_->result);
+  }
+
+  emit matched(result);
+}
+
+void KeySearchIndex::post(const Operation& operation) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->operations.push_back(operation);
+  schedule();
+}
+
+void KeySearchIndex::schedule() {
+  if (state_->scheduled) {
+    return;
+  }
+
+  state_->scheduled = true;
+  const std::shared_ptr<State> state = state_;
+  queue_->post([state](WorkerQueue* queue) { RunIndex(state, queue); });
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,168 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <QObject>
+
+#include <fastonosql/core/database/idatabase_info.h>
+#include <fastonosql/core/db_key.h>
+
+#include "gui/workers/worker_queue.h"
+#include "proxy/proxy_fwd.h"
+
+namespace fastonosql {
+namespace gui {
+
+// inverted trigram index over key names and short string values, ascii case insensitive;
+// document slots are never reused so postings stay sorted, removed ones are skipped until compaction
+class KeyTrigramIndex {
+ public:
+  typedef std::string key_id_t;
+  typedef std::unordered_set<key_id_t> match_set_t;
+
+  KeyTrigramIndex();
+
+  // replaces the previous document with the same id
+  void insert(const key_id_t& id, const std::string& name, const std::string& value);
+  void remove(const key_id_t& id);
+  // indexed value moves to the new id
+  void rename(const key_id_t& id, const key_id_t& new_id, const std::string& new_name);
+  void removeByPrefix(const std::string& prefix);
+  void clear();
+
+  size_t size() const;
+  match_set_t search(const std::string& text, bool with_values) const;
+
+ private:
+  typedef uint32_t doc_t;
+  typedef uint32_t trigram_t;
+  typedef std::unordered_map<trigram_t, std::vector<doc_t>> postings_t;
+
+  struct Document {
+    key_id_t id;
+    std::string name;   // lowered
+    std::string value;  // lowered, empty if not indexed
+    bool alive;
+  };
+
+  void addPostings(doc_t doc, const std::string& text, postings_t* postings);
+  void searchIn(const std::string& needle,
+                const postings_t& postings,
+                std::string Document::*field,
+                match_set_t* matches) const;
+  void compact();
+
+  std::vector<Document> docs_;
+  std::unordered_map<key_id_t, doc_t> ids_;
+  postings_t names_;
+  postings_t values_;
+  size_t dead_;
+};
+
+// keeps KeyTrigramIndex in sync with keys loaded in explorer on a single background thread,
+// mutations are applied in order and the active query is rerun after them
+class KeySearchIndex : public QObject {
+  Q_OBJECT
+
+ public:
+  typedef KeyTrigramIndex::key_id_t key_id_t;
+  typedef KeyTrigramIndex::match_set_t match_set_t;
+  typedef std::shared_ptr<const match_set_t> MatchSetSPtr;
+
+  enum { max_indexed_value_size = 4 * 1024 };
+
+  struct Operation {
+    enum Type { INSERT, REMOVE, RENAME, REMOVE_PREFIX };
+
+    Type type;
+    key_id_t id;
+    key_id_t new_id;  // RENAME only
+    std::string name;
+    std::string value;
+  };
+
+  struct Query {
+    quint64 generation;
+    std::string text;
+    bool with_values;
+    bool dirty;  // not searched since the text or the index changed
+  };
+
+  struct State {
+    State();
+
+    std::mutex mutex;
+    std::vector<Operation> operations;
+    Query query;
+    MatchSetSPtr result;
+    quint64 result_generation;
+    bool scheduled;
+
+    KeyTrigramIndex index;  // touched only by the worker
+  };
+
+  explicit KeySearchIndex(QObject* parent = Q_NULLPTR);
+  ~KeySearchIndex() override;
+
+  static key_id_t makeKeyId(const proxy::IServer* server,
+                            const core::readable_string_t& db_name,
+                            const core::NKey& key);
+  static std::string makeServerPrefix(const proxy::IServer* server);
+  static std::string makeDatabasePrefix(const proxy::IServer* server, const core::readable_string_t& db_name);
+
+  // also used for reloaded values, only string values up to max_indexed_value_size are searchable
+  void addKey(const proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NDbKValue& dbv);
+  void removeKey(const proxy::IServer* server, core::IDataBaseInfoSPtr db, const core::NKey& key);
+  void renameKey(const proxy::IServer* server,
+                 core::IDataBaseInfoSPtr db,
+                 const core::NKey& key,
+                 const core::NKey& new_key);
+  void removeDatabase(const proxy::IServer* server, core::IDataBaseInfoSPtr db);
+  void removeServer(const proxy::IServer* server);
+
+  // empty text drops the match set
+  void search(const QString& text);
+  void setSearchValues(bool search_values);
+
+ Q_SIGNALS:
+  void matched(fastonosql::gui::KeySearchIndex::MatchSetSPtr matches);  // null if nothing is searched
+
+ private Q_SLOTS:
+  void handleSearched(quint64 generation);
+
+ private:
+  void post(const Operation& operation);
+  void schedule();  // under state mutex
+
+  const WorkerQueueSPtr queue_;
+  const std::shared_ptr<State> state_;
+  quint64 generation_;
+  bool search_values_;
+  QString text_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,149 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/workers/nodes_info_poller.h"
+
+#include <algorithm>
+
+#include <QTimerEvent>
+
+#include <common/time.h>
+
+namespace fastonosql {
+namespace gui {
+
+NodesInfoPoller::Session::Session(quint64 generation) : generation(generation), nodes() {}
+
+NodesInfoPoller::NodesInfoPoller(QObject* parent)
+    : QObject(parent),
+      queue_(std::make_shared<WorkerQueue>(this, static_cast<int>(max_workers))),
+      session_(),
+      generation_(0),
+      timer_id_(0) {}
+
+NodesInfoPoller::~NodesInfoPoller() {
+  queue_->detach();
+}
+
+void NodesInfoPoller::start(const std::vector<Node>& nodes, int interval_msec) {
+  stop();
+
+  session_ = std::make_shared<Session>(++generation_);
+  for (const Node& node : nodes) {
+    proxy::IInfoSamplerSPtr sampler(proxy::IInfoSampler::Create(node.connection, sample_timeout_msec));
+    if (!sampler) {
+      continue;
+    }
+
+    Slot slot;
+    slot.name = node.name;
+    slot.sampler = sampler;
+    slot.timestamp = 0;
+    slot.busy = false;
+    session_->nodes.push_back(slot);
+  }
+
+  // every node gets own thread while possible, one slow shard doesn't delay others
+  queue_->setMaxRunning(std::max(1, std::min(static_cast<int>(session_->nodes.size()), static_cast<int>(max_workers))));
+  timer_id_ = startTimer(interval_msec);
+  poll();
+}
+
+void NodesInfoPoller::stop() {
+  if (timer_id_) {
+    killTimer(timer_id_);
+    timer_id_ = 0;
+  }
+
+  if (!session_) {
+    return;
+  }
+
+  // requests in flight finish in background, connections close with the last task
+  queue_->clear();
+  session_.reset();
+}
+
+bool NodesInfoPoller::isRunning() const {
+  return session_ != nullptr;
+}
+
+void NodesInfoPoller::setInterval(int interval_msec) {
+  if (!timer_id_) {
+    return;
+  }
+
+  killTimer(timer_id_);
+  timer_id_ = startTimer(interval_msec);
+}
+
+void NodesInfoPoller::timerEvent(QTimerEvent* event) {
+  if (event->timerId() == timer_id_) {
+    poll();
+    return;
+  }
+
+  QObject::timerEvent(event);
+}
+
+void NodesInfoPoller::poll() {
+  if (!session_) {
+    return;
+  }
+
+  const std::shared_ptr<Session> session = session_;
+  for (size_t i = 0; i < session->nodes.size(); ++i) {
+    if (session->nodes[i].busy) {
+      continue;
+    }
+
+    session->nodes[i].busy = true;
+    const int index = static_cast<int>(i);
+    queue_->post([session, index](WorkerQueue* queue) {
+      Slot& slot = session->nodes[index];
+      slot.info.clear();
+      slot.err = slot.sampler->Sample(&slot.info);
+      slot.timestamp = common::time::current_utc_mstime();
+      queue->deliver("handleSampled", Q_ARG(quint64, session->generation), Q_ARG(int, index));
+    });
+  }
+}
+
+void NodesInfoPoller::handleSampled(quint64 generation, int index) {
+  if (!session_ || session_->generation != generation) {
+    return;
+  }
+
+  Slot& slot = session_->nodes[index];
+  slot.busy = false;
+  if (slot.err) {
+    emit failed(slot.name, slot.err);
+    return;
+  }
+
+  proxy::NodeInfoSample sample;
+  if (!proxy::ParseNodeInfoSample(slot.info, slot.timestamp, &sample)) {
+    emit failed(slot.name, common::make_error("Invalid INFO reply"));
+    return;
+  }
+
+  emit sampled(slot.name, sample);
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,93 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <QObject>
+
+#include <common/error.h>
+
+#include "gui/workers/worker_queue.h"
+#include "proxy/info_sampler.h"
+#include "proxy/nodes_stats.h"
+
+namespace fastonosql {
+namespace gui {
+
+// samples INFO of many nodes concurrently over own connections at a fixed interval,
+// a node still answering the previous request is skipped instead of queued
+class NodesInfoPoller : public QObject {
+  Q_OBJECT
+
+ public:
+  enum { max_workers = 32, default_interval_msec = 1000, sample_timeout_msec = 5000 };
+
+  struct Node {
+    std::string name;  // host:port
+    proxy::IConnectionSettingsBaseSPtr connection;
+  };
+
+  struct Slot {
+    std::string name;
+    proxy::IInfoSamplerSPtr sampler;
+    common::Error err;
+    std::string info;
+    common::time64_t timestamp;
+    bool busy;  // changed only in gui thread
+  };
+
+  struct Session {
+    explicit Session(quint64 generation);
+
+    const quint64 generation;
+    std::vector<Slot> nodes;
+  };
+
+  explicit NodesInfoPoller(QObject* parent = Q_NULLPTR);
+  ~NodesInfoPoller() override;
+
+  void start(const std::vector<Node>& nodes, int interval_msec = default_interval_msec);
+  void stop();
+  bool isRunning() const;
+  void setInterval(int interval_msec);
+
+ Q_SIGNALS:
+  void sampled(const std::string& node, const proxy::NodeInfoSample& sample);
+  void failed(const std::string& node, common::Error err);
+
+ private Q_SLOTS:
+  void handleSampled(quint64 generation, int index);
+
+ protected:
+  void timerEvent(QTimerEvent* event) override;
+
+ private:
+  void poll();
+
+  const WorkerQueueSPtr queue_;
+  std::shared_ptr<Session> session_;
+  quint64 generation_;
+  int timer_id_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
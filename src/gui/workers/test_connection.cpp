@@ -18,13 +18,57 @@
 
 #include "gui/workers/test_connection.h"
 
+#include <memory>
+#include <string>
+
 #include <common/time.h>
 
+#include "gui/socket_tls.h"
+#include "proxy/deadline_caller.h"
+#include "proxy/resp_client.h"
 #include "proxy/servers_manager.h"
 
 namespace fastonosql {
 namespace gui {
 
+namespace {
+struct TlsProbe {
+  TlsProbe() : handshake_msec(0), session_reused(false) {}
+
+  common::time64_t handshake_msec;
+  bool session_reused;
+};
+
+// the core connection doesn't tell its handshake time, so an own socket measures it; the PING reply
+// brings tls 1.3 session tickets in before close, so the next probe of the endpoint resumes
+common::Error ProbeTls(const common::net::HostAndPort& host, common::time64_t timeout_msec, TlsProbe* probe) {
+  common::net::SocketTls socket(host);
+  struct timeval tv;
+  tv.tv_sec = timeout_msec / 1000;
+  tv.tv_usec = (timeout_msec % 1000) * 1000;
+  common::ErrnoError errn = socket.Connect(&tv);
+  if (errn) {
+    return common::make_error_from_errno(errn);
+  }
+  probe->handshake_msec = socket.GetHandshakeTime();
+  probe->session_reused = socket.IsSessionReused();
+
+  const std::string ping = proxy::MakeRespCommand({"PING"});
+  size_t nwrite = 0;
+  errn = socket.Write(ping.data(), ping.size(), &nwrite);
+  if (!errn) {
+    common::char_buffer_t reply;
+    errn = socket.ReadToBuffer(&reply, 512);
+  }
+  common::ErrnoError close_errn = socket.Disconnect();
+  UNUSED(close_errn);
+  if (errn) {
+    return common::make_error_from_errno(errn);
+  }
+  return common::Error();
+}
+}  // namespace
+
 TestConnection::TestConnection(proxy::IConnectionSettingsBaseSPtr conn, QObject* parent)
     : QObject(parent), connection_(conn), start_time_(common::time::current_utc_mstime()) {
   qRegisterMetaType<common::Error>("common::Error");
@@ -42,6 +86,17 @@ void TestConnection::routine() {
 
   const common::Error err = proxy::ServersManager::GetInstance().TestConnection(connection_);
   const qint64 msec_exec = elipsedTime();
+  common::net::HostAndPort tls_host;
+  if (!err && proxy::GetTlsEndpoint(connection_, &tls_host)) {
+    // the handshake can hang as the core one does, the probe is abandoned after its timeout
+    std::shared_ptr<TlsProbe> probe = std::make_shared<TlsProbe>();
+    proxy::DeadlineCaller caller(tls_probe_timeout_msec);
+    const common::Error probe_err =
+        caller.Call([tls_host, probe]() { return ProbeTls(tls_host, tls_probe_timeout_msec, probe.get()); });
+    if (!probe_err) {
+      emit tlsHandshake(probe->handshake_msec, probe->session_reused);
+    }
+  }
   emit connectionResult(err, msec_exec);
 }
 
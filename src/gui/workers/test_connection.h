@@ -29,9 +29,13 @@ class TestConnection : public QObject {
   Q_OBJECT
 
  public:
+  enum { tls_probe_timeout_msec = 10000 };
+
   explicit TestConnection(proxy::IConnectionSettingsBaseSPtr conn, QObject* parent = Q_NULLPTR);
 
  Q_SIGNALS:
+  // tls connections only, before connectionResult
+  void tlsHandshake(qint64 handshake_mstime, bool session_reused);
   void connectionResult(common::Error err, qint64 mstime_exec);
 
  public Q_SLOTS:
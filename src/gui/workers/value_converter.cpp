@@ -0,0 +1,90 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/workers/value_converter.h"
+
+#include <common/convert2string.h>
+#include <common/qt/convert2string.h>
+
+#include <fastonosql/core/types.h>
+
+#define XHEX_CHARS_PER_BYTE 4
+
+namespace fastonosql {
+namespace gui {
+
+ConvertedValue::ConvertedValue()
+    : view_method(RAW_VIEW), is_ok(false), is_binary(false), is_truncated(false), output_limit(0), text() {}
+
+ValueConverter::ValueConverter(OutputView view_method,
+                               const convert_in_t& value,
+                               size_t output_limit,
+                               cancel_flag_t canceled,
+                               QObject* parent)
+    : QObject(parent), view_method_(view_method), value_(value), output_limit_(output_limit), canceled_(canceled) {
+  qRegisterMetaType<ConvertedValue>("fastonosql::gui::ConvertedValue");
+}
+
+void ValueConverter::routine() {
+  ConvertedValue result;
+  result.view_method = view_method_;
+  result.output_limit = output_limit_;
+
+  ViewConvertControl control;
+  control.output_limit = output_limit_;
+  control.canceled = canceled_.get();
+  control.progress = [this](int percent) { emit progressChanged(percent); };
+
+  convert_out_t converted_text;
+  if (!convert_to_view_limited(view_method_, value_, control, &converted_text, &result.is_truncated) ||
+      canceled_->load()) {
+    if (!canceled_->load()) {
+      emit converted(result);
+    }
+    emit finished();
+    return;
+  }
+
+  // rendering for the editor happens here too, hexing a big binary blob is not cheap
+  result.is_binary = core::detail::is_binary_data(converted_text);
+  if (result.is_binary) {
+    if (output_limit_ && converted_text.size() * XHEX_CHARS_PER_BYTE > output_limit_) {
+      converted_text = GEN_CMD_STRING_SIZE(converted_text.data(), output_limit_ / XHEX_CHARS_PER_BYTE);
+      result.is_truncated = true;
+    }
+
+    convert_out_t hexed;
+    if (!string_to_hex(converted_text, &hexed)) {
+      emit converted(result);
+      emit finished();
+      return;
+    }
+    common::ConvertFromBytes(hexed, &result.text);
+  } else {
+    common::ConvertFromBytes(converted_text, &result.text);
+  }
+
+  result.is_ok = !canceled_->load();
+  if (result.is_ok) {
+    emit converted(result);
+  }
+  emit finished();
+}
+
+}  // namespace gui
+}  // namespace fastonosql
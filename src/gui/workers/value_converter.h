@@ -0,0 +1,73 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include <QObject>
+#include <QString>
+
+#include "gui/view_converter.h"
+
+namespace fastonosql {
+namespace gui {
+
+struct ConvertedValue {
+  ConvertedValue();
+
+  OutputView view_method;
+  bool is_ok;
+  bool is_binary;  // text is hexed
+  bool is_truncated;
+  size_t output_limit;
+  QString text;
+};
+
+class ValueConverter : public QObject {
+  Q_OBJECT
+
+ public:
+  typedef std::shared_ptr<std::atomic<bool>> cancel_flag_t;
+
+  ValueConverter(OutputView view_method,
+                 const convert_in_t& value,
+                 size_t output_limit,
+                 cancel_flag_t canceled,
+                 QObject* parent = Q_NULLPTR);
+
+ Q_SIGNALS:
+  void progressChanged(int percent);
+  void converted(fastonosql::gui::ConvertedValue value);
+  void finished();
+
+ public Q_SLOTS:
+  void routine();
+
+ private:
+  const OutputView view_method_;
+  const convert_in_t value_;
+  const size_t output_limit_;
+  const cancel_flag_t canceled_;
+};
+
+}  // namespace gui
+}  // namespace fastonosql
+
+Q_DECLARE_METATYPE(fastonosql::gui::ConvertedValue)
@@ -0,0 +1,114 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gui/workers/worker_queue.h"
+
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QThreadPool>
+
+namespace fastonosql {
+namespace gui {
+
+namespace {
+class QueueRunnable : public QRunnable {
+ public:
+  explicit QueueRunnable(std::function<void()> routine) : routine_(routine) {}
+
+  void run() override { routine_(); }
+
+ private:
+  const std::function<void()> routine_;
+};
+}  // namespace
+
+WorkerQueue::WorkerQueue(QObject* receiver, int max_running)
+    : mutex_(), receiver_(receiver), tasks_(), max_running_(max_running), running_(0) {}
+
+void WorkerQueue::post(task_t task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!receiver_) {
+    return;
+  }
+
+  tasks_.push_back(task);
+  if (running_ >= max_running_) {
+    return;
+  }
+
+  running_++;
+  std::shared_ptr<WorkerQueue> self = shared_from_this();
+  pool()->start(new QueueRunnable([self]() { self->runQueued(); }));
+}
+
+void WorkerQueue::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tasks_.clear();
+}
+
+void WorkerQueue::setMaxRunning(int max_running) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_running_ = max_running;
+}
+
+void WorkerQueue::detach() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  receiver_ = nullptr;
+  tasks_.clear();
+}
+
+bool WorkerQueue::deliver(const char* member, QGenericArgument val0, QGenericArgument val1) {
+  // receiver is destroyed only after detach, which waits for this lock;
+  // events posted before that are discarded by QObject destructor
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!receiver_) {
+    return false;
+  }
+
+  return QMetaObject::invokeMethod(receiver_, member, Qt::QueuedConnection, val0, val1);
+}
+
+void WorkerQueue::runQueued() {
+  while (true) {
+    task_t task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (tasks_.empty() || running_ > max_running_) {
+        running_--;
+        return;
+      }
+
+      task = tasks_.front();
+      tasks_.pop_front();
+    }
+    task(this);
+  }
+}
+
+QThreadPool* WorkerQueue::pool() {
+  // owned by application, joined on quit when no widget is left to wait for results
+  static QThreadPool* pool = []() {
+    QThreadPool* result = new QThreadPool(QCoreApplication::instance());
+    result->setMaxThreadCount(max_pool_threads);
+    return result;
+  }();
+  return pool;
+}
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,68 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include <QObject>
+
+class QThreadPool;
+
+namespace fastonosql {
+namespace gui {
+
+// background tasks of one gui object on the process wide worker pool, at most max_running
+// of them at a time in post order; the owner never waits for tasks: it detaches in destructor,
+// queued tasks are dropped and running ones finish in background without delivering results
+class WorkerQueue : public std::enable_shared_from_this<WorkerQueue> {
+ public:
+  enum { max_pool_threads = 64 };
+  typedef std::function<void(WorkerQueue* queue)> task_t;
+
+  WorkerQueue(QObject* receiver, int max_running);
+
+  void post(task_t task);
+  void clear();  // drops queued tasks
+  void setMaxRunning(int max_running);
+  void detach();
+
+  // from tasks, queued call of receiver slot, false if receiver is gone
+  bool deliver(const char* member,
+               QGenericArgument val0 = QGenericArgument(Q_NULLPTR),
+               QGenericArgument val1 = QGenericArgument());
+
+ private:
+  void runQueued();
+
+  static QThreadPool* pool();
+
+  std::mutex mutex_;
+  QObject* receiver_;
+  std::deque<task_t> tasks_;
+  int max_running_;
+  int running_;
+};
+
+typedef std::shared_ptr<WorkerQueue> WorkerQueueSPtr;
+
+}  // namespace gui
+}  // namespace fastonosql
@@ -0,0 +1,357 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/compare_job.h"
+
+#include <algorithm>
+
+#include <common/convert2string.h>
+
+#include "proxy/server/iserver.h"
+#include "proxy/servers_manager.h"
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+std::string GetKeyId(const core::NKey& key) {
+  return common::ConvertToString(key.GetKey().GetForCommandLine());
+}
+}  // namespace
+
+CompareJob::KeyDifference::KeyDifference() : key(), type(KEY_DIFFERENT) {}
+
+CompareJob::KeyDifference::KeyDifference(const core::NKey& key, DifferenceType type) : key(key), type(type) {}
+
+CompareJob::Statistic::Statistic()
+    : left_keys_count(0),
+      right_keys_count(0),
+      different_ranges_count(0),
+      missing_keys_count(0),
+      extra_keys_count(0),
+      different_keys_count(0),
+      big_keys_count(0) {}
+
+CompareJob::CompareJob(IConnectionSettingsBaseSPtr left,
+                       IConnectionSettingsBaseSPtr right,
+                       const core::pattern_t& pattern,
+                       NDbKeysRangeDigest::range_t ranges_count,
+                       core::keys_limit_t scan_count,
+                       size_t max_value_elements,
+                       size_t max_ops_per_sec,
+                       QObject* parent)
+    : QObject(parent),
+      left_settings_(left),
+      right_settings_(right),
+      pattern_(pattern),
+      ranges_count_(std::min(std::max(ranges_count, NDbKeysRangeDigest::range_t(1)),
+                             NDbKeysRangeDigest::range_t(max_ranges_count))),
+      scan_count_(std::max(scan_count, core::keys_limit_t(1))),
+      max_value_elements_(max_value_elements),
+      max_ops_per_sec_(max_ops_per_sec),
+      sides_(),
+      phase_(CONNECTING),
+      ready_servers_(0),
+      running_(false),
+      stat_() {
+  CHECK(left_settings_ && right_settings_);
+}
+
+CompareJob::~CompareJob() {
+  CloseServers();
+}
+
+void CompareJob::Start() {
+  if (running_) {
+    DNOTREACHED() << "Compare already started.";
+    return;
+  }
+
+  running_ = true;
+  phase_ = CONNECTING;
+  ready_servers_ = 0;
+  stat_ = Statistic();
+
+  ServersManager& manager = ServersManager::GetInstance();
+  sides_[0].server = manager.CreateServer(left_settings_);
+  sides_[1].server = manager.CreateServer(right_settings_);
+  for (Side& side : sides_) {
+    if (!side.server) {
+      Finish(common::make_error("Invalid connection settings"));
+      return;
+    }
+  }
+
+  for (Side& side : sides_) {
+    IServer* server = side.server.get();
+    VERIFY(connect(server, &IServer::ConnectFinished, this, &CompareJob::HandleConnectFinished));
+    VERIFY(connect(server, &IServer::LoadDiscoveryInfoFinished, this, &CompareJob::HandleDiscoveryFinished));
+    VERIFY(connect(server, &IServer::LoadKeysDigestUpdated, this, &CompareJob::HandleDigestUpdated));
+    VERIFY(connect(server, &IServer::LoadKeysDigestFinished, this, &CompareJob::HandleDigestFinished));
+  }
+
+  for (Side& side : sides_) {
+    events_info::ConnectInfoRequest req(this);
+    side.server->Connect(req);
+  }
+}
+
+void CompareJob::Stop() {
+  if (!running_) {
+    return;
+  }
+
+  if (phase_ == CONNECTING) {
+    Finish(common::make_error(common::COMMON_EINTR));
+    return;
+  }
+
+  // interrupted drivers reply with error which finishes the job
+  for (Side& side : sides_) {
+    if (side.server) {
+      side.server->StopCurrentEvent();
+    }
+  }
+}
+
+bool CompareJob::IsRunning() const {
+  return running_;
+}
+
+void CompareJob::HandleConnectFinished(const events_info::ConnectInfoResponse& res) {
+  if (res.initiator() != this) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+  }
+}
+
+void CompareJob::HandleDiscoveryFinished(const events_info::DiscoveryInfoResponse& res) {
+  if (!running_ || phase_ != CONNECTING) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  ready_servers_++;
+  if (ready_servers_ == SIZEOFMASS(sides_)) {
+    phase_ = RANGES;
+    RequestDigests(std::vector<NDbKeysRangeDigest::range_t>());
+  }
+}
+
+void CompareJob::HandleDigestUpdated(const events_info::KeysDigestResponse& res) {
+  if (res.initiator() != this || !running_) {
+    return;
+  }
+
+  size_t index = 0;
+  if (!FindSide(sender(), &index)) {
+    DNOTREACHED();
+    return;
+  }
+
+  if (phase_ == KEYS) {
+    MatchKeys(index, res.keys);
+  }
+}
+
+void CompareJob::HandleDigestFinished(const events_info::KeysDigestResponse& res) {
+  if (res.initiator() != this || !running_) {
+    return;
+  }
+
+  size_t index = 0;
+  Side* side = FindSide(sender(), &index);
+  if (!side) {
+    DNOTREACHED();
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  side->finished = true;
+  if (phase_ == RANGES) {
+    size_t keys_count = 0;
+    for (const NDbKeysRangeDigest& range : res.ranges_digests) {
+      side->ranges[range.GetRange()] = range;
+      keys_count += range.GetKeysCount();
+    }
+    if (index == 0) {
+      stat_.left_keys_count = keys_count;
+    } else {
+      stat_.right_keys_count = keys_count;
+    }
+    stat_.big_keys_count += res.big_keys_count;
+  } else {
+    MatchKeys(index, res.keys);
+  }
+
+  if (!sides_[0].finished || !sides_[1].finished) {
+    return;
+  }
+
+  if (phase_ == RANGES) {
+    CompareRanges();
+    return;
+  }
+
+  FlushUnmatchedKeys();
+  Finish(common::Error());
+}
+
+void CompareJob::RequestDigests(const std::vector<NDbKeysRangeDigest::range_t>& ranges) {
+  for (Side& side : sides_) {
+    core::IDataBaseInfoSPtr inf = side.server->GetCurrentDatabaseInfo();
+    if (!inf) {
+      Finish(common::make_error("Database not discovered"));
+      return;
+    }
+  }
+
+  for (Side& side : sides_) {
+    side.finished = false;
+    events_info::KeysDigestRequest req(this, side.server->GetCurrentDatabaseInfo(), pattern_, scan_count_,
+                                       ranges_count_, max_value_elements_, max_string_bytes, max_ops_per_sec_,
+                                       ranges);
+    side.server->LoadKeysDigest(req);
+  }
+}
+
+void CompareJob::CompareRanges() {
+  std::vector<NDbKeysRangeDigest::range_t> different;
+  const auto& left = sides_[0].ranges;
+  const auto& right = sides_[1].ranges;
+  for (auto it = left.begin(); it != left.end(); ++it) {
+    auto rit = right.find(it->first);
+    if (rit == right.end() || !it->second.Equals(rit->second)) {
+      different.push_back(it->first);
+    }
+  }
+  for (auto it = right.begin(); it != right.end(); ++it) {
+    if (left.find(it->first) == left.end()) {
+      different.push_back(it->first);
+    }
+  }
+
+  stat_.different_ranges_count = different.size();
+  emit Progressed(stat_);
+  if (different.empty()) {
+    Finish(common::Error());
+    return;
+  }
+
+  // drill down only into ranges which differ
+  std::sort(different.begin(), different.end());
+  phase_ = KEYS;
+  RequestDigests(different);
+}
+
+void CompareJob::MatchKeys(size_t side, const std::vector<NDbKeyDigest>& keys) {
+  Side& self = sides_[side];
+  Side& other = sides_[side ^ 1];
+  differences_t differences;
+  for (const NDbKeyDigest& key : keys) {
+    const std::string id = GetKeyId(key.GetKey());
+    auto it = other.unmatched_keys.find(id);
+    if (it == other.unmatched_keys.end()) {
+      self.unmatched_keys[id] = key;
+      continue;
+    }
+
+    if (it->second.GetDigest() != key.GetDigest()) {
+      differences.push_back(KeyDifference(key.GetKey(), KEY_DIFFERENT));
+      stat_.different_keys_count++;
+    }
+    other.unmatched_keys.erase(it);
+  }
+
+  if (!differences.empty()) {
+    emit DifferencesFound(differences);
+    emit Progressed(stat_);
+  }
+}
+
+void CompareJob::FlushUnmatchedKeys() {
+  differences_t differences;
+  for (size_t i = 0; i < SIZEOFMASS(sides_); ++i) {
+    const DifferenceType type = i == 0 ? KEY_MISSING : KEY_EXTRA;
+    for (auto it = sides_[i].unmatched_keys.begin(); it != sides_[i].unmatched_keys.end(); ++it) {
+      differences.push_back(KeyDifference(it->second.GetKey(), type));
+    }
+    if (i == 0) {
+      stat_.missing_keys_count += sides_[i].unmatched_keys.size();
+    } else {
+      stat_.extra_keys_count += sides_[i].unmatched_keys.size();
+    }
+    sides_[i].unmatched_keys.clear();
+  }
+
+  if (!differences.empty()) {
+    emit DifferencesFound(differences);
+  }
+}
+
+CompareJob::Side* CompareJob::FindSide(QObject* server, size_t* index) {
+  for (size_t i = 0; i < SIZEOFMASS(sides_); ++i) {
+    if (sides_[i].server.get() == server) {
+      *index = i;
+      return &sides_[i];
+    }
+  }
+
+  return nullptr;
+}
+
+void CompareJob::Finish(common::Error err) {
+  if (!running_) {
+    return;
+  }
+
+  CloseServers();
+  emit Finished(err, stat_);
+}
+
+void CompareJob::CloseServers() {
+  running_ = false;
+  ServersManager& manager = ServersManager::GetInstance();
+  for (Side& side : sides_) {
+    if (side.server) {
+      disconnect(side.server.get(), nullptr, this, nullptr);
+      manager.CloseServer(side.server);
+      side.server.reset();
+    }
+    side.finished = false;
+    side.ranges.clear();
+    side.unmatched_keys.clear();
+  }
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
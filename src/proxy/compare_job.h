@@ -0,0 +1,140 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <QObject>
+
+#include <common/error.h>
+
+#include "proxy/connection_settings/iconnection_settings.h"
+#include "proxy/db_keys_digest.h"
+#include "proxy/proxy_fwd.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace events_info {
+struct ConnectInfoResponse;
+struct DiscoveryInfoResponse;
+struct KeysDigestResponse;
+}  // namespace events_info
+
+// Compares databases of two connections without transferring values: both servers hash
+// every key into one of "ranges_count" ranges and compute order independent range digests
+// in parallel, only keys of ranges with different digests are listed with per key digests.
+// Values bigger than "max_value_elements" are compared by type and length only and the
+// servers are paced to "max_ops_per_sec" scanned keys, so a comparison stays low impact.
+class CompareJob : public QObject {
+  Q_OBJECT
+
+ public:
+  enum {
+    default_ranges_count = 1024,
+    max_ranges_count = 65536,
+    default_scan_count = 100,
+    default_max_value_elements = 1024,
+    max_string_bytes = 1024 * 1024,
+    default_ops_per_sec = 10000
+  };
+  enum DifferenceType : unsigned char { KEY_MISSING = 0, KEY_EXTRA = 1, KEY_DIFFERENT = 2 };
+
+  struct KeyDifference {
+    KeyDifference();
+    KeyDifference(const core::NKey& key, DifferenceType type);
+
+    core::NKey key;
+    DifferenceType type;  // missing - only in left, extra - only in right
+  };
+  typedef std::vector<KeyDifference> differences_t;
+
+  struct Statistic {
+    Statistic();
+
+    size_t left_keys_count;
+    size_t right_keys_count;
+    size_t different_ranges_count;
+    size_t missing_keys_count;
+    size_t extra_keys_count;
+    size_t different_keys_count;
+    size_t big_keys_count;  // compared by type and length only
+  };
+
+  CompareJob(IConnectionSettingsBaseSPtr left,
+             IConnectionSettingsBaseSPtr right,
+             const core::pattern_t& pattern,
+             NDbKeysRangeDigest::range_t ranges_count = default_ranges_count,
+             core::keys_limit_t scan_count = default_scan_count,
+             size_t max_value_elements = default_max_value_elements,
+             size_t max_ops_per_sec = default_ops_per_sec,
+             QObject* parent = Q_NULLPTR);
+  ~CompareJob() override;
+
+  void Start();
+  void Stop();
+  bool IsRunning() const;
+
+ Q_SIGNALS:
+  void DifferencesFound(const proxy::CompareJob::differences_t& differences);
+  void Progressed(const proxy::CompareJob::Statistic& stat);
+  void Finished(common::Error err, const proxy::CompareJob::Statistic& stat);
+
+ private Q_SLOTS:
+  void HandleConnectFinished(const events_info::ConnectInfoResponse& res);
+  void HandleDiscoveryFinished(const events_info::DiscoveryInfoResponse& res);
+  void HandleDigestUpdated(const events_info::KeysDigestResponse& res);
+  void HandleDigestFinished(const events_info::KeysDigestResponse& res);
+
+ private:
+  enum Phase { CONNECTING, RANGES, KEYS };
+
+  struct Side {
+    IServerSPtr server;
+    bool finished;
+    std::map<NDbKeysRangeDigest::range_t, NDbKeysRangeDigest> ranges;
+    std::map<std::string, NDbKeyDigest> unmatched_keys;  // keys not seen on the other side yet
+  };
+
+  void RequestDigests(const std::vector<NDbKeysRangeDigest::range_t>& ranges);
+  void CompareRanges();
+  void MatchKeys(size_t side, const std::vector<NDbKeyDigest>& keys);
+  void FlushUnmatchedKeys();
+  Side* FindSide(QObject* server, size_t* index);
+  void Finish(common::Error err);
+  void CloseServers();
+
+  const IConnectionSettingsBaseSPtr left_settings_;
+  const IConnectionSettingsBaseSPtr right_settings_;
+  const core::pattern_t pattern_;
+  const NDbKeysRangeDigest::range_t ranges_count_;
+  const core::keys_limit_t scan_count_;
+  const size_t max_value_elements_;
+  const size_t max_ops_per_sec_;
+
+  Side sides_[2];
+  Phase phase_;
+  size_t ready_servers_;
+  bool running_;
+  Statistic stat_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
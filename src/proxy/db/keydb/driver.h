@@ -94,6 +94,9 @@ class Driver : public IDriverRemote {
   void HandleRestoreEvent(events::RestoreRequestEvent* ev) override;
 
   void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) override;
+  void HandleFindBigKeysEvent(events::FindBigKeysRequestEvent* ev) override;
+  void HandleKeysDigestEvent(events::KeysDigestRequestEvent* ev) override;
+  void HandleBulkDeleteEvent(events::BulkDeleteRequestEvent* ev) override;
 
   core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
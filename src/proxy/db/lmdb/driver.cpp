@@ -128,6 +128,13 @@ common::Error Driver::GetCurrentDataBaseInfo(core::IDataBaseInfo** info) {
   return impl_->Select(impl_->GetCurrentDBName(), info);
 }
 
+void Driver::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) {
+  // keys only, values are read when the key is opened; MDB_env and its read
+  // transactions are private to core::lmdb::DBConnection, so a page can't keep
+  // mapped views pinned and every shown key is copied once
+  LoadDatabaseContentBySeek(ev);
+}
+
 core::IServerInfoSPtr Driver::MakeServerInfoFromString(const std::string& val) {
   return core::IServerInfoSPtr(impl_->MakeServerInfo(val));
 }
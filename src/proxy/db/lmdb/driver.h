@@ -72,6 +72,8 @@ class Driver : public IDriverLocal {
   common::Error GetServerCommands(std::vector<const core::CommandInfo*>* commands) override;
   common::Error GetCurrentDataBaseInfo(core::IDataBaseInfo** info) override;
 
+  void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) override;
+
   core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
   core::lmdb::DBConnection* const impl_;
@@ -18,7 +18,19 @@
 
 #include "proxy/db/memcached/driver.h"
 
+#if defined(OS_WIN)
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
+#include <deque>
+
 #include <common/convert2string.h>
+#include <common/logger.h>
+#include <common/net/socket_tcp.h>
+#include <common/string_util.h>
+#include <common/time.h>
 
 #include <fastonosql/core/db/memcached/db_connection.h>
 #include <fastonosql/core/value.h>
@@ -27,15 +39,149 @@
 #include "proxy/command/command_logger.h"
 #include "proxy/db/memcached/command.h"
 #include "proxy/db/memcached/connection_settings.h"
+#include "proxy/db/memcached/meta_protocol.h"
 
 #define MEMCACHED_INFO_REQUEST "STATS"
+#define MEMCACHED_METADUMP_REQUEST "lru_crawler metadump all"
+#define MEMCACHED_META_GET_TTL_REQUEST "mg"
+#define MEMCACHED_META_NOOP_REQUEST "mn"
+#define MEMCACHED_META_NOOP_REPLY "MN"
 
 namespace fastonosql {
 namespace proxy {
 namespace memcached {
 
+namespace {
+
+typedef common::net::SocketGuard<common::net::ClientSocketTcp> ClientSocket;
+const size_t kReadChunkSize = 64 * 1024;
+const time_t kTextProtocolTimeoutSec = 10;
+// crawler of the server is paused while the dump isn't read, so a stream is kept between pages only for a while
+const common::time64_t kMetadumpIdleMsec = 30 * 1000;
+
+common::Error ConnectTextProtocol(ClientSocket* client) {
+  struct timeval tv;
+  tv.tv_sec = kTextProtocolTimeoutSec;
+  tv.tv_usec = 0;
+  common::ErrnoError err = client->Connect(&tv);
+  if (err) {
+    return common::make_error_from_errno(err);
+  }
+  return common::Error();
+}
+
+common::Error WriteRequest(ClientSocket* client, const std::string& request) {
+  size_t total = 0;
+  while (total < request.size()) {
+    size_t nwrite = 0;
+    common::ErrnoError err = client->Write(request.data() + total, request.size() - total, &nwrite);
+    if (err) {
+      return common::make_error_from_errno(err);
+    }
+    total += nwrite;
+  }
+  return common::Error();
+}
+
+common::Error ReadChunk(ClientSocket* client, common::char_buffer_t* chunk) {
+  chunk->clear();
+  const auto fd = client->GetFd();
+  fd_set read_set;
+  FD_ZERO(&read_set);
+  FD_SET(fd, &read_set);
+  struct timeval wait;
+  wait.tv_sec = kTextProtocolTimeoutSec;
+  wait.tv_usec = 0;
+  const int ready = select(static_cast<int>(fd) + 1, &read_set, nullptr, nullptr, &wait);
+  if (ready < 0) {
+    return common::make_error("Memcached socket wait failed");
+  }
+  if (ready == 0) {
+    return common::make_error("Memcached server reply timed out");
+  }
+
+  common::ErrnoError err = client->ReadToBuffer(chunk, kReadChunkSize);
+  if (err) {
+    return common::make_error_from_errno(err);
+  }
+  if (chunk->empty()) {
+    return common::make_error("Connection closed by memcached server");
+  }
+  return common::Error();
+}
+
+// one pipelined batch of "mg <key> t" closed by "mn", ttls are in the same order as keys
+common::Error ResolveTTLs(const common::net::HostAndPort& host,
+                          const std::vector<std::string>& keys,
+                          std::vector<core::ttl_t>* ttls,
+                          bool* unsupported) {
+  *unsupported = false;
+  ClientSocket client(host);
+  common::Error err = ConnectTextProtocol(&client);
+  if (err) {
+    return err;
+  }
+
+  std::string request;
+  for (const std::string& key : keys) {
+    request += MEMCACHED_META_GET_TTL_REQUEST " " + key + " t\r\n";
+  }
+  request += MEMCACHED_META_NOOP_REQUEST "\r\n";
+  err = WriteRequest(&client, request);
+  if (err) {
+    return err;
+  }
+
+  std::vector<core::ttl_t> result;
+  result.reserve(keys.size());
+  LineBuffer lines;
+  common::char_buffer_t chunk;
+  while (true) {
+    err = ReadChunk(&client, &chunk);
+    if (err) {
+      return err;
+    }
+
+    lines.Append(chunk.data(), chunk.size());
+    std::string line;
+    while (lines.PopLine(&line)) {
+      if (line == MEMCACHED_META_NOOP_REPLY) {
+        if (result.size() != keys.size()) {
+          return common::make_error("Unexpected meta get replies count");
+        }
+        *ttls = result;
+        return common::Error();
+      }
+
+      bool found = false;
+      long long ttl = NO_TTL;
+      if (!ParseMetaGetTTL(line, &found, &ttl)) {
+        // servers older than 1.6 answer ERROR to meta commands
+        *unsupported = true;
+        return common::make_error(line);
+      }
+      // missing keys keep no ttl as GetTTL errors did before
+      result.push_back(found && ttl >= 0 ? static_cast<core::ttl_t>(ttl) : NO_TTL);
+    }
+  }
+}
+
+}  // namespace
+
+struct Driver::MetadumpCursor {
+  MetadumpCursor(const common::net::HostAndPort& host, const std::string& pattern)
+      : client(host), parser(), entries(), pattern(pattern), position(0), last_used_msec(0) {}
+
+  ClientSocket client;
+  MetadumpParser parser;
+  std::deque<MetadumpEntry> entries;  // parsed but not looked at yet
+  const std::string pattern;
+  core::cursor_t position;  // matched entries before the next one
+  common::time64_t last_used_msec;
+};
+
 Driver::Driver(IConnectionSettingsBaseSPtr settings)
-    : IDriverRemote(settings), impl_(new core::memcached::DBConnection(this)) {
+    : IDriverRemote(settings), impl_(new core::memcached::DBConnection(this)), metadump_() {
   COMPILE_ASSERT(core::memcached::DBConnection::GetConnectionType() == core::MEMCACHED,
                  "DBConnection must be the same type as Driver!");
   CHECK(GetType() == core::MEMCACHED);
@@ -89,6 +235,7 @@ common::Error Driver::SyncConnect() {
 }
 
 common::Error Driver::SyncDisconnect() {
+  metadump_.reset();
   return impl_->Disconnect();
 }
 
@@ -136,69 +283,201 @@ void Driver::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEv
   QObject* sender = ev->sender();
   NotifyProgress(sender, 0);
   events::LoadDatabaseContentResponseEvent::value_type res(ev->value());
-  const core::command_buffer_t pattern_result = core::GetKeysPattern(res.cursor_in, res.pattern, res.keys_count);
-  core::FastoObjectCommandIPtr cmd = CreateCommandFast(pattern_result, core::C_INNER);
+  // metadump walks the whole cache in one stream with expirations inline,
+  // instead of a key listing followed by a ttl request per key
+  bool unavailable = false;
+  common::Error err = LoadKeysByMetadump(&res, &unavailable);
+  if (err && unavailable) {
+    DEBUG_LOG() << "Memcached metadump unavailable (" << err->GetDescription() << "), fallback to keys listing.";
+    res.keys.clear();
+    err = LoadKeysByPattern(&res);
+  }
   NotifyProgress(sender, 50);
-  common::Error err = Execute(cmd);
+
   if (err) {
     res.setErrorInfo(err);
   } else {
-    core::FastoObject::childs_t rchildrens = cmd->GetChildrens();
-    if (rchildrens.size()) {
-      CHECK_EQ(rchildrens.size(), 1);
-      core::FastoObject* array = rchildrens[0].get();
-      if (array) {
-        auto array_value = array->GetValue();
-        common::ArrayValue* arm = nullptr;
-        if (!array_value->GetAsList(&arm)) {
-          goto done;
-        }
+    common::Error count_err = DBkcountImpl(&res.db_keys_count);
+    DCHECK(!count_err);
+  }
 
-        CHECK_EQ(arm->GetSize(), 2);
-        core::cursor_t cursor;
-        bool isok = arm->GetUInteger32(0, &cursor);
-        if (!isok) {
-          goto done;
-        }
-        res.cursor_out = cursor;
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::LoadDatabaseContentResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
 
-        common::ArrayValue* ar = nullptr;
-        isok = arm->GetList(1, &ar);
-        if (!isok) {
-          goto done;
-        }
+common::Error Driver::LoadKeysByMetadump(events::LoadDatabaseContentResponseEvent::value_type* res, bool* unavailable) {
+  *unavailable = true;
+  const core::memcached::Config config = GetSpecificSettings<ConnectionSettings>()->GetInfo();
+  if (!config.user.empty()) {
+    // sasl authentication works only over the binary protocol
+    return common::make_error("Metadump requires text protocol");
+  }
 
-        for (size_t i = 0; i < ar->GetSize(); ++i) {
-          core::command_buffer_t key_str;
-          if (ar->GetString(i, &key_str)) {
-            const core::nkey_t key(key_str);
-            core::NKey k(key);
-            core::command_buffer_writer_t wr;
-            wr << DB_GET_TTL_COMMAND " " << key.GetHumanReadable();  // emulate log execution
-            core::FastoObjectCommandIPtr cmd_ttl = CreateCommandFast(wr.str(), core::C_INNER);
-            LOG_COMMAND(cmd_ttl);
-            core::ttl_t ttl = NO_TTL;
-            common::Error err = impl_->GetTTL(k, &ttl);
-            if (err) {
-              k.SetTTL(NO_TTL);
-            } else {
-              k.SetTTL(ttl);
-            }
-            core::NValue empty_val(core::CreateEmptyValueFromType(common::Value::TYPE_STRING));
-            core::NDbKValue ress(k, empty_val);
-            res.keys.push_back(ress);
-          }
-        }
+  // next page continues the stream of the previous one instead of reading the dump from the start again
+  const common::time64_t now_msec = common::time::current_utc_mstime();
+  if (metadump_ && (metadump_->pattern != res->pattern || metadump_->position != res->cursor_in ||
+                    now_msec - metadump_->last_used_msec > kMetadumpIdleMsec)) {
+    metadump_.reset();
+  }
+
+  if (!metadump_) {
+    std::unique_ptr<MetadumpCursor> cursor(new MetadumpCursor(config.host, res->pattern));
+    common::Error err = ConnectTextProtocol(&cursor->client);
+    if (err) {
+      return err;
+    }
+
+    core::FastoObjectCommandIPtr cmd = CreateCommandFast(MEMCACHED_METADUMP_REQUEST, core::C_INNER);
+    LOG_COMMAND(cmd);
+    err = WriteRequest(&cursor->client, MEMCACHED_METADUMP_REQUEST "\r\n");
+    if (err) {
+      return err;
+    }
+    metadump_ = std::move(cursor);
+  }
+
+  MetadumpCursor* cursor = metadump_.get();
+  const core::cursor_t start_position = cursor->position;
+  const long long now_sec = now_msec / 1000;
+  bool has_more = false;
+  common::char_buffer_t chunk;
+  std::vector<MetadumpEntry> entries;
+  while (true) {
+    while (!cursor->entries.empty()) {
+      const MetadumpEntry& entry = cursor->entries.front();
+      if ((entry.expiration != -1 && entry.expiration <= now_sec) || !common::MatchPattern(entry.key, res->pattern)) {
+        cursor->entries.pop_front();
+        continue;
+      }
+
+      if (cursor->position < res->cursor_in) {
+        // new stream for a page in the middle
+        cursor->position++;
+        cursor->entries.pop_front();
+        continue;
+      }
 
-        common::Error err = DBkcountImpl(&res.db_keys_count);
-        DCHECK(!err);
+      if (res->keys.size() == res->keys_count) {
+        has_more = true;
+        break;
       }
+
+      core::NKey k(core::nkey_t(common::ConvertToCharBytes(entry.key)));
+      k.SetTTL(entry.expiration == -1 ? NO_TTL : static_cast<core::ttl_t>(entry.expiration - now_sec));
+      core::NValue empty_val(core::CreateEmptyValueFromType(common::Value::TYPE_STRING));
+      res->keys.push_back(core::NDbKValue(k, empty_val));
+      cursor->position++;
+      cursor->entries.pop_front();
+    }
+
+    if (has_more || cursor->parser.GetState() != MetadumpParser::InProgress) {
+      break;
+    }
+
+    if (IsInterrupted()) {
+      metadump_.reset();
+      *unavailable = false;
+      return common::make_error("Interrupted metadump");
+    }
+
+    common::Error err = ReadChunk(&cursor->client, &chunk);
+    if (err) {
+      *unavailable = res->keys.empty() && start_position == 0;
+      metadump_.reset();
+      return err;
     }
+
+    entries.clear();
+    MetadumpParser::State state = cursor->parser.Feed(chunk.data(), chunk.size(), &entries);
+    if (state == MetadumpParser::Unavailable) {
+      const std::string error = cursor->parser.GetError();
+      metadump_.reset();
+      return common::make_error(error);
+    }
+    cursor->entries.insert(cursor->entries.end(), entries.begin(), entries.end());
   }
-done:
-  NotifyProgress(sender, 75);
-  Reply(sender, new events::LoadDatabaseContentResponseEvent(this, res));
-  NotifyProgress(sender, 100);
+
+  *unavailable = false;
+  if (!has_more) {
+    metadump_.reset();
+    res->cursor_out = 0;
+    return common::Error();
+  }
+
+  cursor->last_used_msec = now_msec;
+  res->cursor_out = cursor->position;
+  return common::Error();
+}
+
+common::Error Driver::LoadKeysByPattern(events::LoadDatabaseContentResponseEvent::value_type* res) {
+  const core::command_buffer_t pattern_result = core::GetKeysPattern(res->cursor_in, res->pattern, res->keys_count);
+  core::FastoObjectCommandIPtr cmd = CreateCommandFast(pattern_result, core::C_INNER);
+  common::Error err = Execute(cmd);
+  if (err) {
+    return err;
+  }
+
+  core::FastoObject::childs_t rchildrens = cmd->GetChildrens();
+  if (rchildrens.size() != 1 || !rchildrens[0]) {
+    return common::Error();
+  }
+
+  common::ArrayValue* arm = nullptr;
+  if (!rchildrens[0]->GetValue()->GetAsList(&arm)) {
+    return common::Error();
+  }
+
+  CHECK_EQ(arm->GetSize(), 2);
+  core::cursor_t cursor;
+  if (!arm->GetUInteger32(0, &cursor)) {
+    return common::Error();
+  }
+  res->cursor_out = cursor;
+
+  common::ArrayValue* ar = nullptr;
+  if (!arm->GetList(1, &ar)) {
+    return common::Error();
+  }
+
+  std::vector<core::NKey> keys;
+  std::vector<std::string> raw_keys;
+  for (size_t i = 0; i < ar->GetSize(); ++i) {
+    core::command_buffer_t key_str;
+    if (ar->GetString(i, &key_str)) {
+      keys.push_back(core::NKey(core::nkey_t(key_str)));
+      raw_keys.push_back(key_str.as_string());
+    }
+  }
+
+  std::vector<core::ttl_t> ttls;
+  bool unsupported = true;
+  const core::memcached::Config config = GetSpecificSettings<ConnectionSettings>()->GetInfo();
+  if (!keys.empty() && config.user.empty()) {
+    core::command_buffer_writer_t wr;
+    wr << MEMCACHED_META_GET_TTL_REQUEST " <" << common::ConvertToCharBytes(raw_keys.size()) << " keys> t";
+    core::FastoObjectCommandIPtr cmd_ttl = CreateCommandFast(wr.str(), core::C_INNER);
+    LOG_COMMAND(cmd_ttl);
+    common::Error ttl_err = ResolveTTLs(config.host, raw_keys, &ttls, &unsupported);
+    if (ttl_err) {
+      DEBUG_LOG() << "Memcached meta get failed: " << ttl_err->GetDescription();
+    }
+  }
+
+  for (size_t i = 0; i < keys.size(); ++i) {
+    core::NKey k = keys[i];
+    if (i < ttls.size()) {
+      k.SetTTL(ttls[i]);
+    } else {
+      // no meta commands, resolve one by one through the binary connection
+      core::ttl_t ttl = NO_TTL;
+      common::Error ttl_err = impl_->GetTTL(k, &ttl);
+      k.SetTTL(ttl_err ? NO_TTL : ttl);
+    }
+    core::NValue empty_val(core::CreateEmptyValueFromType(common::Value::TYPE_STRING));
+    res->keys.push_back(core::NDbKValue(k, empty_val));
+  }
+  return common::Error();
 }
 
 core::IServerInfoSPtr Driver::MakeServerInfoFromString(const std::string& val) {
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -73,9 +74,14 @@ class Driver : public IDriverRemote {
   common::Error GetCurrentDataBaseInfo(core::IDataBaseInfo** info) override;
 
   void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) override;
+  common::Error LoadKeysByMetadump(events::LoadDatabaseContentResponseEvent::value_type* res, bool* unavailable);
+  common::Error LoadKeysByPattern(events::LoadDatabaseContentResponseEvent::value_type* res);
   core::IServerInfoSPtr MakeServerInfoFromString(const std::string& val) override;
 
+  struct MetadumpCursor;
+
   core::memcached::DBConnection* const impl_;
+  std::unique_ptr<MetadumpCursor> metadump_;  // stream of the last page, continued by the next one
 };
 
 }  // namespace memcached
@@ -0,0 +1,217 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/memcached/meta_protocol.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace fastonosql {
+namespace proxy {
+namespace memcached {
+
+namespace {
+int HexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+bool ParseLongLong(const std::string& str, long long* out) {
+  if (str.empty()) {
+    return false;
+  }
+
+  char* end = nullptr;
+  const long long value = strtoll(str.c_str(), &end, 10);
+  if (*end != '\0') {
+    return false;
+  }
+
+  *out = value;
+  return true;
+}
+
+bool StartsWith(const std::string& line, const char* prefix) {
+  return line.compare(0, strlen(prefix), prefix) == 0;
+}
+}  // namespace
+
+LineBuffer::LineBuffer() : buffer_(), pos_(0) {}
+
+void LineBuffer::Append(const char* data, size_t size) {
+  // drop consumed lines before growing, keeps the buffer at about one chunk
+  if (pos_ != 0) {
+    buffer_.erase(0, pos_);
+    pos_ = 0;
+  }
+  buffer_.append(data, size);
+}
+
+bool LineBuffer::PopLine(std::string* line) {
+  const size_t end = buffer_.find('\n', pos_);
+  if (end == std::string::npos) {
+    return false;
+  }
+
+  size_t line_end = end;
+  if (line_end > pos_ && buffer_[line_end - 1] == '\r') {
+    --line_end;
+  }
+  line->assign(buffer_, pos_, line_end - pos_);
+  pos_ = end + 1;
+  return true;
+}
+
+MetadumpEntry::MetadumpEntry() : key(), expiration(-1), last_access(0), size(0) {}
+
+MetadumpParser::MetadumpParser() : lines_(), state_(InProgress), error_() {}
+
+MetadumpParser::State MetadumpParser::Feed(const char* data, size_t size, std::vector<MetadumpEntry>* entries) {
+  if (state_ != InProgress) {
+    return state_;
+  }
+
+  lines_.Append(data, size);
+  std::string line;
+  while (lines_.PopLine(&line)) {
+    if (line == "END") {
+      state_ = Finished;
+      break;
+    }
+
+    MetadumpEntry entry;
+    if (ParseMetadumpLine(line, &entry)) {
+      entries->push_back(entry);
+      continue;
+    }
+
+    // BUSY, ERROR or CLIENT_ERROR, crawler is disabled, busy or unknown to this server
+    if (StartsWith(line, "BUSY") || StartsWith(line, "ERROR") || StartsWith(line, "CLIENT_ERROR") ||
+        StartsWith(line, "SERVER_ERROR")) {
+      state_ = Unavailable;
+      error_ = line;
+      break;
+    }
+  }
+  return state_;
+}
+
+MetadumpParser::State MetadumpParser::GetState() const {
+  return state_;
+}
+
+const std::string& MetadumpParser::GetError() const {
+  return error_;
+}
+
+bool ParseMetadumpLine(const std::string& line, MetadumpEntry* entry) {
+  if (!StartsWith(line, "key=")) {
+    return false;
+  }
+
+  MetadumpEntry result;
+  size_t start = 0;
+  while (start < line.size()) {
+    size_t end = line.find(' ', start);
+    if (end == std::string::npos) {
+      end = line.size();
+    }
+
+    const std::string token = line.substr(start, end - start);
+    start = end + 1;
+    const size_t eq = token.find('=');
+    if (eq == std::string::npos) {
+      continue;
+    }
+
+    const std::string name = token.substr(0, eq);
+    const std::string value = token.substr(eq + 1);
+    long long number = 0;
+    if (name == "key") {
+      result.key = DecodeMetadumpKey(value);
+    } else if (name == "exp" && ParseLongLong(value, &number)) {
+      result.expiration = number;
+    } else if (name == "la" && ParseLongLong(value, &number)) {
+      result.last_access = number;
+    } else if (name == "size" && ParseLongLong(value, &number) && number >= 0) {
+      result.size = static_cast<size_t>(number);
+    }
+  }
+
+  if (result.key.empty()) {
+    return false;
+  }
+
+  *entry = result;
+  return true;
+}
+
+std::string DecodeMetadumpKey(const std::string& key) {
+  std::string result;
+  result.reserve(key.size());
+  for (size_t i = 0; i < key.size(); ++i) {
+    if (key[i] == '%' && i + 2 < key.size()) {
+      const int hi = HexValue(key[i + 1]);
+      const int lo = HexValue(key[i + 2]);
+      if (hi != -1 && lo != -1) {
+        result += static_cast<char>(hi * 16 + lo);
+        i += 2;
+        continue;
+      }
+    }
+    result += key[i];
+  }
+  return result;
+}
+
+bool ParseMetaGetTTL(const std::string& line, bool* found, long long* ttl) {
+  if (line == "EN") {
+    *found = false;
+    return true;
+  }
+
+  if (!StartsWith(line, "HD") && !StartsWith(line, "VA")) {
+    return false;
+  }
+
+  *found = true;
+  *ttl = -1;
+  size_t start = line.find(' ');
+  while (start != std::string::npos) {
+    const size_t end = line.find(' ', start + 1);
+    const std::string flag = line.substr(start + 1, end == std::string::npos ? std::string::npos : end - start - 1);
+    long long value = 0;
+    if (!flag.empty() && flag[0] == 't' && ParseLongLong(flag.substr(1), &value)) {
+      *ttl = value;
+    }
+    start = end;
+  }
+  return true;
+}
+
+}  // namespace memcached
+}  // namespace proxy
+}  // namespace fastonosql
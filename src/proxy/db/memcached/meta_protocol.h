@@ -0,0 +1,77 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace fastonosql {
+namespace proxy {
+namespace memcached {
+
+// splits text protocol replies received in arbitrary chunks into lines without \r\n
+class LineBuffer {
+ public:
+  LineBuffer();
+
+  void Append(const char* data, size_t size);
+  bool PopLine(std::string* line);
+
+ private:
+  std::string buffer_;
+  size_t pos_;
+};
+
+struct MetadumpEntry {
+  MetadumpEntry();
+
+  std::string key;
+  long long expiration;   // unix time, -1 never expires
+  long long last_access;  // unix time
+  size_t size;
+};
+
+// lru_crawler metadump streams one line per item and END at the end,
+// complete lines are parsed as soon as they are fed
+class MetadumpParser {
+ public:
+  enum State { InProgress, Finished, Unavailable };
+
+  MetadumpParser();
+
+  State Feed(const char* data, size_t size, std::vector<MetadumpEntry>* entries);
+  State GetState() const;
+  const std::string& GetError() const;  // server reply for Unavailable
+
+ private:
+  LineBuffer lines_;
+  State state_;
+  std::string error_;
+};
+
+bool ParseMetadumpLine(const std::string& line, MetadumpEntry* entry);
+// metadump keys are uri encoded
+std::string DecodeMetadumpKey(const std::string& key);
+
+// reply of "mg <key> t": HD t<seconds> (t-1 no ttl) or EN for missing key, false for anything else
+bool ParseMetaGetTTL(const std::string& line, bool* found, long long* ttl);
+
+}  // namespace memcached
+}  // namespace proxy
+}  // namespace fastonosql
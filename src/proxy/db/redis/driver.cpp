@@ -36,7 +36,12 @@
 #include "proxy/command/command_logger.h"
 #include "proxy/db/redis/command.h"
 #include "proxy/db/redis/connection_settings.h"
+#include "proxy/db/redis_compatible/keys_digest.h"
+#include "proxy/db/redis_compatible/keys_removal.h"
+#include "proxy/db/redis_compatible/keys_usage.h"
+#include "proxy/db/redis_compatible/scan_throttle.h"
 #include "proxy/db_client.h"
+#include "proxy/db_key_usage.h"
 
 #define REDIS_TYPE_COMMAND "TYPE"
 #define REDIS_SHUTDOWN_COMMAND "SHUTDOWN"
@@ -48,6 +53,7 @@
 #define REDIS_PUBSUB_NUMSUB_COMMAND "PUBSUB NUMSUB"
 #define REDIS_CLIENT_LIST_COMMAND "CLIENT LIST"
 #define REDIS_GET_COMMANDS "COMMAND"
+#define REDIS_GET_MAXMEMORY_POLICY_COMMAND "CONFIG GET maxmemory-policy"
 
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 #include <fastonosql/core/imodule_connection_client.h>
@@ -61,6 +67,10 @@
 
 #define REDIS_NEW_LINE_MARKER "\n"
 
+#define FIND_BIG_KEYS_UPDATE_INTERVAL_MSEC 500
+#define KEYS_DIGEST_UPDATE_INTERVAL_MSEC 500
+#define BULK_DELETE_UPDATE_INTERVAL_MSEC 500
+
 namespace fastonosql {
 namespace core {
 namespace {
@@ -702,6 +712,383 @@ done:
   NotifyProgress(sender, 100);
 }
 
+void Driver::HandleFindBigKeysEvent(events::FindBigKeysRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::FindBigKeysResponseEvent::value_type res(ev->value());
+  res.is_finished = true;
+  const auto serv = GetCurrentServerInfoIfConnected();
+  if (!serv) {
+    res.setErrorInfo(common::make_error("Not connected"));
+    NotifyProgress(sender, 75);
+    Reply(sender, new events::FindBigKeysResponseEvent(this, res));
+    NotifyProgress(sender, 100);
+    return;
+  }
+
+  const uint32_t version = serv->GetVersion();
+  const bool is_memory_usage_supported = version >= PROJECT_VERSION_GENERATE(4, 0, 0);
+  common::Error err;
+  if (version < PROJECT_VERSION_GENERATE(2, 8, 0)) {
+    err = common::make_error("Big keys search requires SCAN command, server version 2.8.0 or newer");
+  } else if (res.criteria != BY_ELEMENTS && !is_memory_usage_supported) {
+    err = common::make_error("MEMORY USAGE and OBJECT FREQ commands requires server version 4.0.0 or newer");
+  } else if (res.criteria == BY_FREQUENCY) {
+    // OBJECT FREQ replies error for every key if policy is not LFU
+    core::FastoObjectCommandIPtr cmd =
+        CreateCommandFast(GEN_CMD_STRING(REDIS_GET_MAXMEMORY_POLICY_COMMAND), core::C_INNER);
+    err = Execute(cmd);
+    if (!err) {
+      common::Value::string_t policy;
+      core::FastoObject::childs_t ch = cmd->GetChildrens();
+      common::ArrayValue* arr = nullptr;
+      if (ch.size() != 1 || !ch[0]->GetValue()->GetAsList(&arr) || !arr->GetString(1, &policy) ||
+          common::ConvertToString(policy).find("lfu") == std::string::npos) {
+        err = common::make_error("Hot keys search requires LFU maxmemory-policy");
+      }
+    }
+  }
+
+  if (!err) {
+    err = DBkcountImpl(&res.db_keys_count);
+  }
+
+  if (err) {
+    res.setErrorInfo(err);
+    NotifyProgress(sender, 75);
+    Reply(sender, new events::FindBigKeysResponseEvent(this, res));
+    NotifyProgress(sender, 100);
+    return;
+  }
+
+  struct KeyUsageCommands {
+    NDbKeyUsage usage;
+    core::FastoObjectCommandIPtr elements_count;
+    core::FastoObjectCommandIPtr memory_usage;
+    core::FastoObjectCommandIPtr frequency;
+  };
+
+  KeysUsageTop top(res.top_limit, res.criteria);
+  core::cursor_t cursor = 0;
+  redis_compatible::ScanThrottle throttle(res.max_ops_per_sec, FIND_BIG_KEYS_UPDATE_INTERVAL_MSEC,
+                                          [this]() { return IsInterrupted(); });
+  do {
+    throttle.StartBatch();
+    core::FastoObjectCommandIPtr scan_cmd =
+        CreateCommandFast(core::GetKeysPattern(cursor, res.pattern, res.scan_count), core::C_INNER);
+    err = Execute(scan_cmd);
+    if (err) {
+      res.setErrorInfo(err);
+      break;
+    }
+
+    core::FastoObject::childs_t rchildrens = scan_cmd->GetChildrens();
+    common::ArrayValue* arm = nullptr;
+    common::ArrayValue* ar = nullptr;
+    if (rchildrens.size() != 1 || !rchildrens[0]->GetValue()->GetAsList(&arm) || !arm->GetUInteger32(0, &cursor) ||
+        !arm->GetList(1, &ar)) {
+      res.setErrorInfo(common::make_error("Invalid SCAN reply"));
+      break;
+    }
+
+    std::vector<core::nkey_t> keys;
+    std::vector<core::FastoObjectCommandIPtr> type_cmds;
+    type_cmds.reserve(ar->GetSize());
+    for (size_t i = 0; i < ar->GetSize(); ++i) {
+      common::Value::string_t key;
+      if (ar->GetString(i, &key)) {
+        const core::nkey_t key_str(key);
+        core::command_buffer_writer_t wr_type;
+        wr_type << REDIS_TYPE_COMMAND " " << key_str.GetForCommandLine();
+        type_cmds.push_back(CreateCommandFast(wr_type.str(), core::C_INNER));
+        keys.push_back(key_str);
+      }
+    }
+
+    size_t ops = 1 + type_cmds.size();
+    if (!type_cmds.empty()) {
+      err = impl_->ExecuteAsPipeline(type_cmds, &LOG_COMMAND);
+      if (err) {
+        res.setErrorInfo(err);
+        break;
+      }
+
+      std::vector<KeyUsageCommands> usages;
+      std::vector<core::FastoObjectCommandIPtr> cmds;
+      usages.reserve(keys.size());
+      for (size_t i = 0; i < keys.size(); ++i) {
+        core::FastoObject::childs_t tchildrens = type_cmds[i]->GetChildrens();
+        if (tchildrens.size() != 1) {
+          continue;
+        }
+
+        common::Value::Type ctype;
+        core::redis_compatible::ConvertFromString(tchildrens[0]->ToString(), &ctype);
+        KeyUsageCommands usage_cmds;
+        usage_cmds.usage = NDbKeyUsage(core::NKey(keys[i]), ctype);
+        core::command_buffer_t count_cmd;
+        if (redis_compatible::GetElementsCountCommand(ctype, keys[i], &count_cmd)) {
+          usage_cmds.elements_count = CreateCommandFast(count_cmd, core::C_INNER);
+          cmds.push_back(usage_cmds.elements_count);
+        }
+        if (is_memory_usage_supported) {
+          usage_cmds.memory_usage =
+              CreateCommandFast(redis_compatible::GetMemoryUsageCommand(keys[i]), core::C_INNER);
+          cmds.push_back(usage_cmds.memory_usage);
+        }
+        if (res.criteria == BY_FREQUENCY) {
+          usage_cmds.frequency = CreateCommandFast(redis_compatible::GetObjectFreqCommand(keys[i]), core::C_INNER);
+          cmds.push_back(usage_cmds.frequency);
+        }
+        usages.push_back(usage_cmds);
+      }
+
+      if (!cmds.empty()) {
+        err = impl_->ExecuteAsPipeline(cmds, &LOG_COMMAND);
+        if (err) {
+          res.setErrorInfo(err);
+          break;
+        }
+        ops += cmds.size();
+      }
+
+      for (size_t i = 0; i < usages.size(); ++i) {
+        NDbKeyUsage usage = usages[i].usage;
+        int64_t value = 0;
+        if (redis_compatible::GetIntegerReply(usages[i].elements_count, &value)) {
+          usage.SetElementsCount(value);
+        }
+        if (redis_compatible::GetIntegerReply(usages[i].memory_usage, &value)) {
+          usage.SetMemoryUsage(value);
+        }
+        if (redis_compatible::GetIntegerReply(usages[i].frequency, &value)) {
+          usage.SetFrequency(value);
+        }
+        top.Insert(usage);
+      }
+      res.scanned_keys_count += keys.size();
+    }
+
+    // keep load on server under max_ops_per_sec
+    throttle.FinishBatch(ops, cursor == 0, [this, sender, &res, &top]() {
+      events::FindBigKeysResponseEvent::value_type interim(res);
+      interim.keys = top.GetTop();
+      interim.is_finished = false;
+      Reply(sender, new events::FindBigKeysResponseEvent(this, interim));
+      if (res.db_keys_count) {
+        NotifyProgress(sender, std::min<size_t>(99, res.scanned_keys_count * 100 / res.db_keys_count));
+      }
+    });
+  } while (cursor != 0 && !IsInterrupted());
+
+  if (!res.errorInfo() && cursor != 0) {
+    res.setErrorInfo(common::make_error(common::COMMON_EINTR));
+  }
+
+  res.keys = top.GetTop();
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::FindBigKeysResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+void Driver::HandleKeysDigestEvent(events::KeysDigestRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::KeysDigestResponseEvent::value_type res(ev->value());
+  res.is_finished = true;
+  const auto serv = GetCurrentServerInfoIfConnected();
+  common::Error err;
+  if (!serv) {
+    err = common::make_error("Not connected");
+  } else if (serv->GetVersion() < PROJECT_VERSION_GENERATE(2, 8, 0)) {
+    err = common::make_error("Keys digest requires SCAN command, server version 2.8.0 or newer");
+  } else if (!res.ranges_count) {
+    err = common::make_error("Invalid ranges count");
+  }
+
+  std::string script_sha;
+  if (!err) {
+    core::FastoObjectCommandIPtr load_cmd =
+        CreateCommandFast(redis_compatible::GetKeysDigestScriptLoadCommand(), core::C_INNER);
+    err = Execute(load_cmd);
+    if (!err && !redis_compatible::GetStringReply(load_cmd, &script_sha)) {
+      err = common::make_error("Invalid SCRIPT LOAD reply");
+    }
+  }
+
+  if (!err) {
+    err = DBkcountImpl(&res.db_keys_count);
+  }
+
+  if (err) {
+    res.setErrorInfo(err);
+    NotifyProgress(sender, 75);
+    Reply(sender, new events::KeysDigestResponseEvent(this, res));
+    NotifyProgress(sender, 100);
+    return;
+  }
+
+  const bool is_keys_mode = !res.ranges.empty();
+  redis_compatible::keys_ranges_digest_t ranges;
+  core::cursor_t cursor = 0;
+  redis_compatible::ScanThrottle throttle(res.max_ops_per_sec, KEYS_DIGEST_UPDATE_INTERVAL_MSEC,
+                                          [this]() { return IsInterrupted(); });
+  do {
+    throttle.StartBatch();
+    const size_t scanned_before = res.scanned_keys_count;
+    core::FastoObjectCommandIPtr cmd = CreateCommandFast(
+        redis_compatible::GetKeysDigestCommand(script_sha, cursor, res.pattern, res.scan_count, res.ranges_count,
+                                               res.max_value_elements, res.max_string_bytes, res.ranges),
+        core::C_INNER);
+    err = Execute(cmd);
+    if (err) {
+      res.setErrorInfo(err);
+      break;
+    }
+
+    if (!redis_compatible::ParseKeysDigestReply(cmd, is_keys_mode, &cursor, &ranges, &res.keys,
+                                                &res.scanned_keys_count, &res.big_keys_count)) {
+      res.setErrorInfo(common::make_error("Invalid keys digest reply"));
+      break;
+    }
+
+    // every script call blocks the server, keep scanned keys under max_ops_per_sec between calls;
+    // stream found keys, ranges digests are meaningful only when the whole keyspace is scanned
+    throttle.FinishBatch(res.scanned_keys_count - scanned_before, cursor == 0, [this, sender, &res]() {
+      events::KeysDigestResponseEvent::value_type interim(res);
+      interim.is_finished = false;
+      Reply(sender, new events::KeysDigestResponseEvent(this, interim));
+      res.keys.clear();
+      if (res.db_keys_count) {
+        NotifyProgress(sender, std::min<size_t>(99, res.scanned_keys_count * 100 / res.db_keys_count));
+      }
+    });
+  } while (cursor != 0 && !IsInterrupted());
+
+  if (!res.errorInfo() && cursor != 0) {
+    res.setErrorInfo(common::make_error(common::COMMON_EINTR));
+  }
+
+  for (auto it = ranges.begin(); it != ranges.end(); ++it) {
+    res.ranges_digests.push_back(it->second);
+  }
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::KeysDigestResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+void Driver::HandleBulkDeleteEvent(events::BulkDeleteRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::BulkDeleteResponseEvent::value_type res(ev->value());
+  res.is_finished = true;
+  const auto serv = GetCurrentServerInfoIfConnected();
+  common::Error err;
+  if (!serv) {
+    err = common::make_error("Not connected");
+  } else if (serv->GetVersion() < PROJECT_VERSION_GENERATE(2, 8, 0)) {
+    err = common::make_error("Bulk delete requires SCAN command, server version 2.8.0 or newer");
+  } else if (!res.batch_size || !res.scan_count) {
+    err = common::make_error("Invalid batch size");
+  } else {
+    err = DBkcountImpl(&res.db_keys_count);
+  }
+
+  if (err) {
+    res.setErrorInfo(err);
+    NotifyProgress(sender, 75);
+    Reply(sender, new events::BulkDeleteResponseEvent(this, res));
+    NotifyProgress(sender, 100);
+    return;
+  }
+
+  const bool is_unlink_supported = serv->GetVersion() >= PROJECT_VERSION_GENERATE(4, 0, 0);
+
+  core::NKeys removed_keys;  // since previous update
+  core::cursor_t cursor = 0;
+  redis_compatible::ScanThrottle throttle(res.max_ops_per_sec, BULK_DELETE_UPDATE_INTERVAL_MSEC,
+                                          [this]() { return IsInterrupted(); });
+  do {
+    throttle.StartBatch();
+    core::FastoObjectCommandIPtr scan_cmd =
+        CreateCommandFast(core::GetKeysPattern(cursor, res.pattern, res.scan_count), core::C_INNER);
+    err = Execute(scan_cmd);
+    if (err) {
+      res.setErrorInfo(err);
+      break;
+    }
+
+    core::FastoObject::childs_t rchildrens = scan_cmd->GetChildrens();
+    common::ArrayValue* arm = nullptr;
+    common::ArrayValue* ar = nullptr;
+    if (rchildrens.size() != 1 || !rchildrens[0]->GetValue()->GetAsList(&arm) || !arm->GetUInteger32(0, &cursor) ||
+        !arm->GetList(1, &ar)) {
+      res.setErrorInfo(common::make_error("Invalid SCAN reply"));
+      break;
+    }
+
+    std::vector<core::nkey_t> keys;
+    keys.reserve(ar->GetSize());
+    for (size_t i = 0; i < ar->GetSize(); ++i) {
+      common::Value::string_t key;
+      if (ar->GetString(i, &key)) {
+        keys.push_back(core::nkey_t(key));
+      }
+    }
+    res.matched_keys_count += keys.size();
+    // SCAN may return a key twice, keep the count within the keyspace for the ETA
+    res.scanned_keys_count = std::min<size_t>(res.scanned_keys_count + ar->GetSize(), res.db_keys_count);
+
+    size_t ops = 1;
+    if (!res.dry_run && !keys.empty()) {
+      std::vector<core::FastoObjectCommandIPtr> remove_cmds;
+      for (size_t i = 0; i < keys.size(); i += res.batch_size) {
+        const std::vector<core::nkey_t> batch(keys.begin() + i,
+                                              keys.begin() + std::min(keys.size(), i + res.batch_size));
+        remove_cmds.push_back(
+            CreateCommandFast(redis_compatible::GetRemoveKeysCommand(batch, is_unlink_supported), core::C_INNER));
+      }
+
+      err = impl_->ExecuteAsPipeline(remove_cmds, &LOG_COMMAND);
+      if (err) {
+        res.setErrorInfo(err);
+        break;
+      }
+
+      for (size_t i = 0; i < remove_cmds.size(); ++i) {
+        int64_t removed = 0;
+        if (redis_compatible::GetIntegerReply(remove_cmds[i], &removed)) {
+          res.removed_keys_count += removed;
+        }
+      }
+      for (size_t i = 0; i < keys.size(); ++i) {
+        removed_keys.push_back(core::NKey(keys[i]));
+      }
+      ops += keys.size();
+    }
+
+    // keep load on server under max_ops_per_sec, every removed key counts as op
+    throttle.FinishBatch(ops, cursor == 0, [this, sender, &res, &removed_keys]() {
+      events::BulkDeleteResponseEvent::value_type interim(res);
+      interim.removed_keys.swap(removed_keys);
+      interim.is_finished = false;
+      Reply(sender, new events::BulkDeleteResponseEvent(this, interim));
+      if (res.db_keys_count) {
+        NotifyProgress(sender, std::min<size_t>(99, res.scanned_keys_count * 100 / res.db_keys_count));
+      }
+    });
+  } while (cursor != 0 && !IsInterrupted());
+
+  if (!res.errorInfo() && cursor != 0) {
+    res.setErrorInfo(common::make_error(common::COMMON_EINTR));
+  }
+
+  res.removed_keys.swap(removed_keys);
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::BulkDeleteResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
 core::IServerInfoSPtr Driver::MakeServerInfoFromString(const std::string& val) {
   return core::IServerInfoSPtr(impl_->MakeServerInfo(val));
 }
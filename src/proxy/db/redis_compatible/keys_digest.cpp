@@ -0,0 +1,200 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/redis_compatible/keys_digest.h"
+
+#include <common/convert2string.h>
+
+#define REDIS_SCRIPT_LOAD_COMMAND "SCRIPT LOAD"
+#define REDIS_EVALSHA_COMMAND "EVALSHA"
+
+// ARGV: cursor, pattern, count, ranges count, max elements, max string bytes[, ranges...]
+// returns {cursor, scanned, big, range, keys count, digest, ...} or {cursor, scanned, big, key, digest, ...}
+// values are read by type in a canonical order, so equal data gives equal digests on any server version;
+// values over the limits are not read, their digest covers type and length only and they are counted as big
+#define KEYS_DIGEST_SCRIPT                                                                                           \
+  "local s = string.char(0) local cap = tonumber(ARGV[5]) local cap_bytes = tonumber(ARGV[6]) local big = 0 "        \
+  "local function entries(m) local f = {} for _, e in ipairs(m) do f[#f + 1] = e[1] "                                \
+  "for _, x in ipairs(e[2]) do f[#f + 1] = x end end return f end "                                                  \
+  "local function digest(k) "                                                                                        \
+  "local t = redis.call('TYPE', k)['ok'] local n local v "                                                           \
+  "if t == 'none' then return nil "                                                                                  \
+  "elseif t == 'string' then n = redis.call('STRLEN', k) if n <= cap_bytes then v = redis.call('GET', k) end "       \
+  "elseif t == 'list' then n = redis.call('LLEN', k) "                                                               \
+  "if n <= cap then v = table.concat(redis.call('LRANGE', k, 0, -1), s) end "                                        \
+  "elseif t == 'set' then n = redis.call('SCARD', k) "                                                               \
+  "if n <= cap then local m = redis.call('SMEMBERS', k) table.sort(m) v = table.concat(m, s) end "                   \
+  "elseif t == 'zset' then n = redis.call('ZCARD', k) "                                                              \
+  "if n <= cap then v = table.concat(redis.call('ZRANGE', k, 0, -1, 'WITHSCORES'), s) end "                          \
+  "elseif t == 'hash' then n = redis.call('HLEN', k) "                                                               \
+  "if n <= cap then local m = redis.call('HGETALL', k) local f = {} "                                                \
+  "for i = 1, #m, 2 do f[#f + 1] = m[i] .. s .. m[i + 1] end table.sort(f) v = table.concat(f, s) end "              \
+  "elseif t == 'stream' then n = redis.call('XLEN', k) "                                                             \
+  "if n <= cap then v = table.concat(entries(redis.call('XRANGE', k, '-', '+')), s) end end "                        \
+  "if v then v = '=' .. v else big = big + 1 v = '#' .. tostring(n or '?') end "                                     \
+  "return redis.sha1hex(k .. s .. t .. s .. v) end "                                                                 \
+  "local r = redis.call('SCAN', ARGV[1], 'MATCH', ARGV[2], 'COUNT', ARGV[3]) "                                       \
+  "local n = tonumber(ARGV[4]) local keys_mode = #ARGV > 6 local want = {} "                                         \
+  "for i = 7, #ARGV do want[tonumber(ARGV[i])] = true end "                                                          \
+  "local out = {r[1], #r[2], 0} local acc = {} "                                                                     \
+  "for _, k in ipairs(r[2]) do "                                                                                     \
+  "local b = tonumber(string.sub(redis.sha1hex(k), 1, 8), 16) % n "                                                  \
+  "if not keys_mode or want[b] then local d = digest(k) if d then "                                                  \
+  "if keys_mode then out[#out + 1] = k out[#out + 1] = d else "                                                      \
+  "local a = acc[b] if not a then a = {0, 0, 0, 0, 0, 0} acc[b] = a end a[6] = a[6] + 1 "                            \
+  "for j = 1, 5 do a[j] = bit.bxor(a[j], tonumber(string.sub(d, j * 8 - 7, j * 8), 16)) end "                        \
+  "end end end end "                                                                                                 \
+  "for b, a in pairs(acc) do out[#out + 1] = b out[#out + 1] = a[6] "                                                \
+  "out[#out + 1] = bit.tohex(a[1]) .. bit.tohex(a[2]) .. bit.tohex(a[3]) .. bit.tohex(a[4]) .. bit.tohex(a[5]) end " \
+  "out[3] = big return out"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+namespace {
+bool GetReplyArray(core::FastoObjectCommandIPtr cmd, common::ArrayValue** out) {
+  if (!cmd) {
+    return false;
+  }
+
+  core::FastoObject::childs_t childrens = cmd->GetChildrens();
+  if (childrens.size() != 1) {
+    return false;
+  }
+
+  auto value = childrens[0]->GetValue();
+  return value && value->GetAsList(out);
+}
+
+bool GetArrayString(common::ArrayValue* array, size_t index, std::string* out) {
+  common::Value::string_t str;
+  if (!array->GetString(index, &str)) {
+    return false;
+  }
+
+  *out = common::ConvertToString(str);
+  return true;
+}
+
+bool GetArrayInteger(common::ArrayValue* array, size_t index, int64_t* out) {
+  common::Value* value = nullptr;
+  return array->Get(index, &value) && value->GetAsInteger64(out);
+}
+}  // namespace
+
+core::command_buffer_t GetKeysDigestScriptLoadCommand() {
+  return GEN_CMD_STRING(REDIS_SCRIPT_LOAD_COMMAND " \"" KEYS_DIGEST_SCRIPT "\"");
+}
+
+core::command_buffer_t GetKeysDigestCommand(const std::string& script_sha,
+                                            core::cursor_t cursor,
+                                            const core::pattern_t& pattern,
+                                            core::keys_limit_t scan_count,
+                                            NDbKeysRangeDigest::range_t ranges_count,
+                                            size_t max_value_elements,
+                                            size_t max_string_bytes,
+                                            const std::vector<NDbKeysRangeDigest::range_t>& ranges) {
+  core::command_buffer_writer_t wr;
+  wr << REDIS_EVALSHA_COMMAND " " << script_sha << " 0 " << common::ConvertToString(cursor) << " " << pattern << " "
+     << common::ConvertToString(scan_count) << " " << common::ConvertToString(ranges_count) << " "
+     << common::ConvertToString(max_value_elements) << " " << common::ConvertToString(max_string_bytes);
+  for (NDbKeysRangeDigest::range_t range : ranges) {
+    wr << " " << common::ConvertToString(range);
+  }
+  return wr.str();
+}
+
+bool GetStringReply(core::FastoObjectCommandIPtr cmd, std::string* out) {
+  if (!cmd || !out) {
+    return false;
+  }
+
+  core::FastoObject::childs_t childrens = cmd->GetChildrens();
+  if (childrens.size() != 1) {
+    return false;
+  }
+
+  auto value = childrens[0]->GetValue();
+  common::Value::string_t str;
+  if (!value || !value->GetAsString(&str)) {
+    return false;
+  }
+
+  *out = common::ConvertToString(str);
+  return true;
+}
+
+bool ParseKeysDigestReply(core::FastoObjectCommandIPtr cmd,
+                          bool is_keys_mode,
+                          core::cursor_t* cursor,
+                          keys_ranges_digest_t* ranges,
+                          std::vector<NDbKeyDigest>* keys,
+                          size_t* scanned_keys,
+                          size_t* big_keys) {
+  if (!cursor || !ranges || !keys || !scanned_keys || !big_keys) {
+    return false;
+  }
+
+  common::ArrayValue* array = nullptr;
+  std::string cursor_str;
+  int64_t scanned = 0;
+  int64_t big = 0;
+  if (!GetReplyArray(cmd, &array) || array->GetSize() < 3 || !GetArrayString(array, 0, &cursor_str) ||
+      !common::ConvertFromString(cursor_str, cursor) || !GetArrayInteger(array, 1, &scanned) ||
+      !GetArrayInteger(array, 2, &big)) {
+    return false;
+  }
+
+  *scanned_keys += scanned;
+  *big_keys += big;
+  if (is_keys_mode) {
+    for (size_t i = 3; i + 1 < array->GetSize(); i += 2) {
+      common::Value::string_t key;
+      std::string digest;
+      if (!array->GetString(i, &key) || !GetArrayString(array, i + 1, &digest)) {
+        return false;
+      }
+      keys->push_back(NDbKeyDigest(core::NKey(core::nkey_t(key)), digest));
+    }
+    return true;
+  }
+
+  for (size_t i = 3; i + 2 < array->GetSize(); i += 3) {
+    int64_t range = 0;
+    int64_t keys_count = 0;
+    std::string hex;
+    KeysDigest digest;
+    if (!GetArrayInteger(array, i, &range) || !GetArrayInteger(array, i + 1, &keys_count) ||
+        !GetArrayString(array, i + 2, &hex) || !digest.MergeHex(hex)) {
+      return false;
+    }
+
+    const NDbKeysRangeDigest::range_t range_id = static_cast<NDbKeysRangeDigest::range_t>(range);
+    auto it = ranges->find(range_id);
+    if (it == ranges->end()) {
+      it = ranges->insert(std::make_pair(range_id, NDbKeysRangeDigest(range_id))).first;
+    }
+    it->second.Merge(keys_count, digest);
+  }
+  return true;
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
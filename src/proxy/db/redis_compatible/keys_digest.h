@@ -0,0 +1,63 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <fastonosql/core/db_key.h>
+#include <fastonosql/core/global.h>
+
+#include "proxy/db_keys_digest.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+typedef std::map<NDbKeysRangeDigest::range_t, NDbKeysRangeDigest> keys_ranges_digest_t;
+
+// loads server side script, digests are computed by Lua so only hashes cross the network
+core::command_buffer_t GetKeysDigestScriptLoadCommand();
+
+// one SCAN iteration of the script, empty ranges - per range digests, otherwise key digests of these ranges;
+// values with more elements (bytes for strings) than the limits are digested by type and length only
+core::command_buffer_t GetKeysDigestCommand(const std::string& script_sha,
+                                            core::cursor_t cursor,
+                                            const core::pattern_t& pattern,
+                                            core::keys_limit_t scan_count,
+                                            NDbKeysRangeDigest::range_t ranges_count,
+                                            size_t max_value_elements,
+                                            size_t max_string_bytes,
+                                            const std::vector<NDbKeysRangeDigest::range_t>& ranges);
+
+bool GetStringReply(core::FastoObjectCommandIPtr cmd, std::string* out);
+
+// merges range digests into ranges or appends key digests into keys
+bool ParseKeysDigestReply(core::FastoObjectCommandIPtr cmd,
+                          bool is_keys_mode,
+                          core::cursor_t* cursor,
+                          keys_ranges_digest_t* ranges,
+                          std::vector<NDbKeyDigest>* keys,
+                          size_t* scanned_keys,
+                          size_t* big_keys);
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,39 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/redis_compatible/keys_removal.h"
+
+#define REDIS_UNLINK_COMMAND "UNLINK"
+#define REDIS_DEL_COMMAND "DEL"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+core::command_buffer_t GetRemoveKeysCommand(const std::vector<core::nkey_t>& keys, bool is_unlink_supported) {
+  core::command_buffer_writer_t wr;
+  wr << (is_unlink_supported ? REDIS_UNLINK_COMMAND : REDIS_DEL_COMMAND);
+  for (const core::nkey_t& key : keys) {
+    wr << " " << key.GetForCommandLine();
+  }
+  return wr.str();
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,34 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <fastonosql/core/db_key.h>
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+// UNLINK frees values in a background server thread, DEL blocks on big values but is the only choice before 4.0
+core::command_buffer_t GetRemoveKeysCommand(const std::vector<core::nkey_t>& keys, bool is_unlink_supported);
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,92 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db/redis_compatible/keys_usage.h"
+
+#include <fastonosql/core/value.h>
+
+#define REDIS_MEMORY_USAGE_COMMAND "MEMORY USAGE"
+#define REDIS_OBJECT_FREQ_COMMAND "OBJECT FREQ"
+#define REDIS_STRLEN_COMMAND "STRLEN"
+#define REDIS_LLEN_COMMAND "LLEN"
+#define REDIS_SCARD_COMMAND "SCARD"
+#define REDIS_ZCARD_COMMAND "ZCARD"
+#define REDIS_HLEN_COMMAND "HLEN"
+#define REDIS_XLEN_COMMAND "XLEN"
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+core::command_buffer_t GetMemoryUsageCommand(const core::nkey_t& key) {
+  core::command_buffer_writer_t wr;
+  wr << REDIS_MEMORY_USAGE_COMMAND " " << key.GetForCommandLine();
+  return wr.str();
+}
+
+core::command_buffer_t GetObjectFreqCommand(const core::nkey_t& key) {
+  core::command_buffer_writer_t wr;
+  wr << REDIS_OBJECT_FREQ_COMMAND " " << key.GetForCommandLine();
+  return wr.str();
+}
+
+bool GetElementsCountCommand(common::Value::Type type, const core::nkey_t& key, core::command_buffer_t* cmd) {
+  if (!cmd) {
+    return false;
+  }
+
+  const char* len_command = nullptr;
+  if (type == common::Value::TYPE_STRING) {
+    len_command = REDIS_STRLEN_COMMAND;
+  } else if (type == common::Value::TYPE_ARRAY) {
+    len_command = REDIS_LLEN_COMMAND;
+  } else if (type == common::Value::TYPE_SET) {
+    len_command = REDIS_SCARD_COMMAND;
+  } else if (type == common::Value::TYPE_ZSET) {
+    len_command = REDIS_ZCARD_COMMAND;
+  } else if (type == common::Value::TYPE_HASH) {
+    len_command = REDIS_HLEN_COMMAND;
+  } else if (type == core::StreamValue::TYPE_STREAM) {
+    len_command = REDIS_XLEN_COMMAND;
+  } else {
+    return false;
+  }
+
+  core::command_buffer_writer_t wr;
+  wr << len_command << " " << key.GetForCommandLine();
+  *cmd = wr.str();
+  return true;
+}
+
+bool GetIntegerReply(core::FastoObjectCommandIPtr cmd, int64_t* out) {
+  if (!cmd || !out) {
+    return false;
+  }
+
+  core::FastoObject::childs_t childrens = cmd->GetChildrens();
+  if (childrens.size() != 1) {
+    return false;
+  }
+
+  auto value = childrens[0]->GetValue();
+  return value && value->GetAsInteger64(out);
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,39 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <fastonosql/core/db_key.h>
+#include <fastonosql/core/global.h>
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+core::command_buffer_t GetMemoryUsageCommand(const core::nkey_t& key);
+core::command_buffer_t GetObjectFreqCommand(const core::nkey_t& key);
+
+// STRLEN, LLEN, SCARD, ZCARD, HLEN or XLEN depending on type, false for types without size command
+bool GetElementsCountCommand(common::Value::Type type, const core::nkey_t& key, core::command_buffer_t* cmd);
+
+// integer reply of executed command, false for nil (key expired between SCAN and pipeline) or error
+bool GetIntegerReply(core::FastoObjectCommandIPtr cmd, int64_t* out);
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
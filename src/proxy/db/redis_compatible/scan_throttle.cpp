@@ -0,0 +1,63 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "proxy/db/redis_compatible/scan_throttle.h"
+
+#include <algorithm>
+
+#include <common/threads/platform_thread.h>
+#include <common/time.h>
+
+#define SCAN_THROTTLE_SLEEP_SLICE_MSEC 100
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+ScanThrottle::ScanThrottle(size_t max_ops_per_sec, common::time64_t update_interval_msec, interrupted_t interrupted)
+    : max_ops_per_sec_(max_ops_per_sec),
+      update_interval_msec_(update_interval_msec),
+      interrupted_(interrupted),
+      batch_start_ts_(common::time::current_utc_mstime()),
+      last_update_ts_(batch_start_ts_) {}
+
+void ScanThrottle::StartBatch() {
+  batch_start_ts_ = common::time::current_utc_mstime();
+}
+
+void ScanThrottle::FinishBatch(size_t ops, bool is_last, interim_reply_t reply) {
+  if (max_ops_per_sec_) {
+    // sleep in slices so Stop doesn't wait for the whole batch budget
+    const common::time64_t deadline_ts = batch_start_ts_ + ops * 1000 / max_ops_per_sec_;
+    while (!interrupted_() && common::time::current_utc_mstime() < deadline_ts) {
+      common::threads::PlatformThread::Sleep(std::min<common::time64_t>(
+          SCAN_THROTTLE_SLEEP_SLICE_MSEC, deadline_ts - common::time::current_utc_mstime()));
+    }
+  }
+
+  const common::time64_t cur_ts = common::time::current_utc_mstime();
+  if (!is_last && cur_ts - last_update_ts_ >= update_interval_msec_) {
+    last_update_ts_ = cur_ts;
+    reply();
+  }
+}
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,55 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <functional>
+
+#include <common/types.h>
+
+namespace fastonosql {
+namespace proxy {
+namespace redis_compatible {
+
+// paces SCAN driven jobs (big keys, digest, bulk delete) under max ops/sec and posts interim results
+class ScanThrottle {
+ public:
+  typedef std::function<bool()> interrupted_t;
+  typedef std::function<void()> interim_reply_t;
+
+  // max_ops_per_sec 0 - unlimited
+  ScanThrottle(size_t max_ops_per_sec, common::time64_t update_interval_msec, interrupted_t interrupted);
+
+  void StartBatch();
+
+  // sleeps in short slices until ops of the batch fit under max_ops_per_sec or the job is interrupted,
+  // then calls reply if the scan goes on and update interval passed since previous interim result
+  void FinishBatch(size_t ops, bool is_last, interim_reply_t reply);
+
+ private:
+  const size_t max_ops_per_sec_;
+  const common::time64_t update_interval_msec_;
+  const interrupted_t interrupted_;
+  common::time64_t batch_start_ts_;
+  common::time64_t last_update_ts_;
+};
+
+}  // namespace redis_compatible
+}  // namespace proxy
+}  // namespace fastonosql
@@ -128,6 +128,10 @@ common::Error Driver::GetCurrentDataBaseInfo(core::IDataBaseInfo** info) {
   return impl_->Select(impl_->GetCurrentDBName(), info);
 }
 
+void Driver::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev) {
+  LoadDatabaseContentBySeek(ev);
+}
+
 core::IServerInfoSPtr Driver::MakeServerInfoFromString(const std::string& val) {
   return core::IServerInfoSPtr(impl_->MakeServerInfo(val));
 }
@@ -0,0 +1,127 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db_key_usage.h"
+
+#include <algorithm>
+
+namespace fastonosql {
+namespace proxy {
+
+NDbKeyUsage::NDbKeyUsage()
+    : key_(), type_(common::Value::TYPE_NULL), memory_usage_(0), elements_count_(0), frequency_(0) {}
+
+NDbKeyUsage::NDbKeyUsage(const core::NKey& key, common::Value::Type type)
+    : key_(key), type_(type), memory_usage_(0), elements_count_(0), frequency_(0) {}
+
+core::NKey NDbKeyUsage::GetKey() const {
+  return key_;
+}
+
+void NDbKeyUsage::SetKey(const core::NKey& key) {
+  key_ = key;
+}
+
+common::Value::Type NDbKeyUsage::GetType() const {
+  return type_;
+}
+
+void NDbKeyUsage::SetType(common::Value::Type type) {
+  type_ = type;
+}
+
+NDbKeyUsage::memory_usage_t NDbKeyUsage::GetMemoryUsage() const {
+  return memory_usage_;
+}
+
+void NDbKeyUsage::SetMemoryUsage(memory_usage_t usage) {
+  memory_usage_ = usage;
+}
+
+NDbKeyUsage::elements_count_t NDbKeyUsage::GetElementsCount() const {
+  return elements_count_;
+}
+
+void NDbKeyUsage::SetElementsCount(elements_count_t count) {
+  elements_count_ = count;
+}
+
+NDbKeyUsage::frequency_t NDbKeyUsage::GetFrequency() const {
+  return frequency_;
+}
+
+void NDbKeyUsage::SetFrequency(frequency_t freq) {
+  frequency_ = freq;
+}
+
+size_t NDbKeyUsage::GetWeight(KeysUsageCriteria criteria) const {
+  if (criteria == BY_ELEMENTS) {
+    return elements_count_;
+  } else if (criteria == BY_FREQUENCY) {
+    return frequency_;
+  }
+
+  return memory_usage_;
+}
+
+KeysUsageTop::KeysUsageTop(size_t limit, KeysUsageCriteria criteria) : limit_(limit), criteria_(criteria), heaps_() {}
+
+void KeysUsageTop::Insert(const NDbKeyUsage& usage) {
+  if (!limit_) {
+    return;
+  }
+
+  // min-heap, the lightest key of the type is always at the front
+  const auto comp = [this](const NDbKeyUsage& lhs, const NDbKeyUsage& rhs) { return IsLighter(rhs, lhs); };
+  keys_container_t& heap = heaps_[usage.GetType()];
+  if (heap.size() < limit_) {
+    heap.push_back(usage);
+    std::push_heap(heap.begin(), heap.end(), comp);
+    return;
+  }
+
+  if (!IsLighter(heap.front(), usage)) {
+    return;
+  }
+
+  std::pop_heap(heap.begin(), heap.end(), comp);
+  heap.back() = usage;
+  std::push_heap(heap.begin(), heap.end(), comp);
+}
+
+void KeysUsageTop::Clear() {
+  heaps_.clear();
+}
+
+KeysUsageTop::keys_container_t KeysUsageTop::GetTop() const {
+  keys_container_t result;
+  for (auto it = heaps_.begin(); it != heaps_.end(); ++it) {
+    result.insert(result.end(), it->second.begin(), it->second.end());
+  }
+
+  std::sort(result.begin(), result.end(),
+            [this](const NDbKeyUsage& lhs, const NDbKeyUsage& rhs) { return IsLighter(rhs, lhs); });
+  return result;
+}
+
+bool KeysUsageTop::IsLighter(const NDbKeyUsage& lhs, const NDbKeyUsage& rhs) const {
+  return lhs.GetWeight(criteria_) < rhs.GetWeight(criteria_);
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
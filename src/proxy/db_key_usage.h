@@ -0,0 +1,87 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <fastonosql/core/db_key.h>
+
+namespace fastonosql {
+namespace proxy {
+
+enum KeysUsageCriteria : unsigned char { BY_MEMORY = 0, BY_ELEMENTS = 1, BY_FREQUENCY = 2 };
+
+class NDbKeyUsage {
+ public:
+  typedef size_t memory_usage_t;
+  typedef size_t elements_count_t;
+  typedef uint32_t frequency_t;
+
+  NDbKeyUsage();
+  NDbKeyUsage(const core::NKey& key, common::Value::Type type);
+
+  core::NKey GetKey() const;
+  void SetKey(const core::NKey& key);
+
+  common::Value::Type GetType() const;
+  void SetType(common::Value::Type type);
+
+  memory_usage_t GetMemoryUsage() const;
+  void SetMemoryUsage(memory_usage_t usage);
+
+  elements_count_t GetElementsCount() const;
+  void SetElementsCount(elements_count_t count);
+
+  frequency_t GetFrequency() const;
+  void SetFrequency(frequency_t freq);
+
+  size_t GetWeight(KeysUsageCriteria criteria) const;
+
+ private:
+  core::NKey key_;
+  common::Value::Type type_;
+  memory_usage_t memory_usage_;
+  elements_count_t elements_count_;
+  frequency_t frequency_;
+};
+
+// keeps at most limit heaviest keys per value type, memory is bounded by limit * types count
+class KeysUsageTop {
+ public:
+  typedef std::vector<NDbKeyUsage> keys_container_t;
+
+  KeysUsageTop(size_t limit, KeysUsageCriteria criteria);
+
+  void Insert(const NDbKeyUsage& usage);
+  void Clear();
+
+  // sorted from heaviest to lightest
+  keys_container_t GetTop() const;
+
+ private:
+  bool IsLighter(const NDbKeyUsage& lhs, const NDbKeyUsage& rhs) const;
+
+  const size_t limit_;
+  const KeysUsageCriteria criteria_;
+  std::map<common::Value::Type, keys_container_t> heaps_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,121 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/db_keys_digest.h"
+
+#include <common/sprintf.h>
+
+namespace fastonosql {
+namespace proxy {
+
+KeysDigest::KeysDigest() : words_() {}
+
+bool KeysDigest::MergeHex(const std::string& hex) {
+  static const size_t word_hex_size = sizeof(uint32_t) * 2;
+  if (hex.size() != words_count * word_hex_size) {
+    return false;
+  }
+
+  uint32_t words[words_count];
+  for (size_t i = 0; i < words_count; ++i) {
+    uint32_t word = 0;
+    for (size_t j = 0; j < word_hex_size; ++j) {
+      const char c = hex[i * word_hex_size + j];
+      uint32_t nibble = 0;
+      if (c >= '0' && c <= '9') {
+        nibble = c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        nibble = c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        nibble = c - 'A' + 10;
+      } else {
+        return false;
+      }
+      word = (word << 4) | nibble;
+    }
+    words[i] = word;
+  }
+
+  for (size_t i = 0; i < words_count; ++i) {
+    words_[i] ^= words[i];
+  }
+  return true;
+}
+
+void KeysDigest::Merge(const KeysDigest& other) {
+  for (size_t i = 0; i < words_count; ++i) {
+    words_[i] ^= other.words_[i];
+  }
+}
+
+std::string KeysDigest::GetHex() const {
+  std::string hex;
+  for (size_t i = 0; i < words_count; ++i) {
+    hex += common::MemSPrintf("%08x", words_[i]);
+  }
+  return hex;
+}
+
+bool KeysDigest::Equals(const KeysDigest& other) const {
+  for (size_t i = 0; i < words_count; ++i) {
+    if (words_[i] != other.words_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+NDbKeysRangeDigest::NDbKeysRangeDigest() : range_(0), keys_count_(0), digest_() {}
+
+NDbKeysRangeDigest::NDbKeysRangeDigest(range_t range) : range_(range), keys_count_(0), digest_() {}
+
+NDbKeysRangeDigest::range_t NDbKeysRangeDigest::GetRange() const {
+  return range_;
+}
+
+size_t NDbKeysRangeDigest::GetKeysCount() const {
+  return keys_count_;
+}
+
+KeysDigest NDbKeysRangeDigest::GetDigest() const {
+  return digest_;
+}
+
+void NDbKeysRangeDigest::Merge(size_t keys_count, const KeysDigest& digest) {
+  keys_count_ += keys_count;
+  digest_.Merge(digest);
+}
+
+bool NDbKeysRangeDigest::Equals(const NDbKeysRangeDigest& other) const {
+  return range_ == other.range_ && keys_count_ == other.keys_count_ && digest_ == other.digest_;
+}
+
+NDbKeyDigest::NDbKeyDigest() : key_(), digest_() {}
+
+NDbKeyDigest::NDbKeyDigest(const core::NKey& key, const std::string& digest) : key_(key), digest_(digest) {}
+
+core::NKey NDbKeyDigest::GetKey() const {
+  return key_;
+}
+
+std::string NDbKeyDigest::GetDigest() const {
+  return digest_;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
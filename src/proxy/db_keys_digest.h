@@ -0,0 +1,88 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <fastonosql/core/db_key.h>
+
+namespace fastonosql {
+namespace proxy {
+
+// order independent 160 bit digest, xor of sha1 digests of every key in a range
+class KeysDigest {
+ public:
+  enum { words_count = 5 };
+
+  KeysDigest();
+
+  bool MergeHex(const std::string& hex);  // 40 hex chars
+  void Merge(const KeysDigest& other);
+
+  std::string GetHex() const;
+  bool Equals(const KeysDigest& other) const;
+
+ private:
+  uint32_t words_[words_count];
+};
+
+inline bool operator==(const KeysDigest& r, const KeysDigest& l) {
+  return r.Equals(l);
+}
+
+inline bool operator!=(const KeysDigest& r, const KeysDigest& l) {
+  return !r.Equals(l);
+}
+
+class NDbKeysRangeDigest {
+ public:
+  typedef uint32_t range_t;
+
+  NDbKeysRangeDigest();
+  explicit NDbKeysRangeDigest(range_t range);
+
+  range_t GetRange() const;
+
+  size_t GetKeysCount() const;
+  KeysDigest GetDigest() const;
+
+  void Merge(size_t keys_count, const KeysDigest& digest);
+  bool Equals(const NDbKeysRangeDigest& other) const;
+
+ private:
+  range_t range_;
+  size_t keys_count_;
+  KeysDigest digest_;
+};
+
+class NDbKeyDigest {
+ public:
+  NDbKeyDigest();
+  NDbKeyDigest(const core::NKey& key, const std::string& digest);
+
+  core::NKey GetKey() const;
+  std::string GetDigest() const;
+
+ private:
+  core::NKey key_;
+  std::string digest_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
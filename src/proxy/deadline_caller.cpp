@@ -0,0 +1,74 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "proxy/deadline_caller.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace fastonosql {
+namespace proxy {
+
+struct DeadlineCaller::State {
+  State() : mutex(), finished(), is_finished(false), err() {}
+
+  std::mutex mutex;
+  std::condition_variable finished;
+  bool is_finished;
+  common::Error err;
+};
+
+DeadlineCaller::DeadlineCaller(common::time64_t timeout_msec) : timeout_msec_(timeout_msec), abandoned_() {}
+
+common::Error DeadlineCaller::Call(call_t call) {
+  if (abandoned_) {
+    bool is_finished = false;
+    {
+      std::lock_guard<std::mutex> lock(abandoned_->mutex);
+      is_finished = abandoned_->is_finished;
+    }
+    if (!is_finished) {
+      return common::make_error("Previous request still waits for the server");
+    }
+    abandoned_.reset();
+  }
+
+  std::shared_ptr<State> state = std::make_shared<State>();
+  std::thread([state, call]() {
+    common::Error err = call();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->err = err;
+    state->is_finished = true;
+    state->finished.notify_all();
+  }).detach();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  if (!state->finished.wait_for(lock, std::chrono::milliseconds(timeout_msec_),
+                                [state]() { return state->is_finished; })) {
+    abandoned_ = state;
+    return common::make_error("Operation timed out");
+  }
+
+  return state->err;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,50 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <common/error.h>
+#include <common/types.h>
+
+namespace fastonosql {
+namespace proxy {
+
+// core connections have no timeouts, so calls through them run on an own detached thread and the
+// caller waits at most timeout_msec; a call past the deadline is abandoned and finishes on its own,
+// so it must own everything it touches; no new call starts while an abandoned one still runs
+class DeadlineCaller {
+ public:
+  typedef std::function<common::Error()> call_t;
+
+  explicit DeadlineCaller(common::time64_t timeout_msec);
+
+  common::Error Call(call_t call) WARN_UNUSED_RESULT;
+
+ private:
+  struct State;
+
+  const common::time64_t timeout_msec_;
+  std::shared_ptr<State> abandoned_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -18,6 +18,7 @@
 
 #include "proxy/driver/idriver.h"
 
+#include <chrono>
 #include <string>
 #include <vector>
 
@@ -34,6 +35,8 @@
 
 #include "proxy/command/command_logger.h"
 #include "proxy/driver/first_child_update_root_locker.h"
+#include "proxy/metrics_registry.h"
+#include "proxy/request_tracer.h"
 
 namespace {
 
@@ -68,6 +71,38 @@ bool GetStamp(std::string stamp, common::time64_t* time_out) {
   *time_out = ltime_out;
   return ltime_out != 0;
 }
+
+// payload of string values, other scalars count as one machine word
+size_t GetReplyValueSize(common::Value* value) {
+  if (!value) {
+    return 0;
+  }
+
+  common::ArrayValue* array = nullptr;
+  if (value->GetAsList(&array)) {
+    size_t size = 0;
+    for (auto it = array->begin(); it != array->end(); ++it) {
+      size += GetReplyValueSize(*it);
+    }
+    return size;
+  }
+
+  common::Value::string_t str;
+  if (value->GetAsString(&str)) {
+    return str.size();
+  }
+  return sizeof(int64_t);
+}
+
+// walks the reply tree instead of rendering it to text, the command itself isn't counted
+size_t GetReplySize(fastonosql::core::FastoObject* obj) {
+  size_t size = 0;
+  const auto childs = obj->GetChildrens();
+  for (const auto& child : childs) {
+    size += GetReplyValueSize(child->GetValue().get()) + GetReplySize(child.get());
+  }
+  return size;
+}
 }  // namespace
 
 namespace fastonosql {
@@ -130,11 +165,21 @@ common::Error IDriver::Execute(core::FastoObjectCommandIPtr cmd) {
   }
 
   LOG_COMMAND(cmd);
-  common::Error err = ExecuteImpl(cmd->GetInputCommand(), cmd.get());
+  RequestTracer::ScopedNetwork network;
+  const core::command_buffer_t command = cmd->GetInputCommand();
+  const auto start = std::chrono::steady_clock::now();
+  common::Error err = ExecuteImpl(command, cmd.get());
+  MetricsRegistry& metrics = MetricsRegistry::GetInstance();
+  if (metrics.IsEnabled()) {
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    // drivers don't expose raw protocol sizes, replies are counted by their payload
+    metrics.ObserveCommand(settings_->GetPath().ToString(), elapsed.count(), command.size(), GetReplySize(cmd.get()));
+  }
   return err;
 }
 
 void IDriver::Reply(QObject* reciver, QEvent* ev) {
+  RequestTracer::GetInstance().TracePost(ev, true);
   qApp->postEvent(reciver, ev);
 }
 
@@ -150,6 +195,10 @@ connection_path_t IDriver::GetConnectionPath() const {
   return settings_->GetPath();
 }
 
+IConnectionSettingsBaseSPtr IDriver::CloneSettings() const {
+  return IConnectionSettingsBaseSPtr(settings_->Clone());
+}
+
 std::string IDriver::GetDelimiter() const {
   return settings_->GetDelimiter();
 }
@@ -176,6 +225,7 @@ void IDriver::Interrupt() {
 }
 
 void IDriver::Init() {
+  RequestTracer::GetInstance().SetThreadName("driver " + settings_->GetPath().ToString());
   if (settings_->IsHistoryEnabled()) {
     int interval = settings_->GetLoggingMsTimeInterval();
     timer_info_id_ = startTimer(interval);
@@ -205,6 +255,8 @@ core::IServerInfoSPtr IDriver::GetCurrentServerInfoIfConnected() const {
 }
 
 void IDriver::customEvent(QEvent* event) {
+  RequestTracer::ScopedHandling handling(event, true);
+  MetricsRegistry::GetInstance().RequestDequeued(settings_->GetPath().ToString());
   SetInterrupted(false);
 
   QEvent::Type type = event->type();
@@ -251,6 +303,15 @@ void IDriver::customEvent(QEvent* event) {
   } else if (type == static_cast<QEvent::Type>(events::LoadDatabaseContentRequestEvent::EventType)) {
     events::LoadDatabaseContentRequestEvent* ev = static_cast<events::LoadDatabaseContentRequestEvent*>(event);
     HandleLoadDatabaseContentEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::FindBigKeysRequestEvent::EventType)) {
+    events::FindBigKeysRequestEvent* ev = static_cast<events::FindBigKeysRequestEvent*>(event);
+    HandleFindBigKeysEvent(ev);  // ni
+  } else if (type == static_cast<QEvent::Type>(events::KeysDigestRequestEvent::EventType)) {
+    events::KeysDigestRequestEvent* ev = static_cast<events::KeysDigestRequestEvent*>(event);
+    HandleKeysDigestEvent(ev);  // ni
+  } else if (type == static_cast<QEvent::Type>(events::BulkDeleteRequestEvent::EventType)) {
+    events::BulkDeleteRequestEvent* ev = static_cast<events::BulkDeleteRequestEvent*>(event);
+    HandleBulkDeleteEvent(ev);  // ni
   } else if (type == static_cast<QEvent::Type>(events::DiscoveryInfoRequestEvent::EventType)) {
     events::DiscoveryInfoRequestEvent* ev = static_cast<events::DiscoveryInfoRequestEvent*>(event);
     HandleDiscoveryInfoEvent(ev);  //
@@ -289,6 +350,7 @@ void IDriver::timerEvent(QTimerEvent* event) {
       }
 
       core::ServerInfoSnapShoot shot(time, core::IServerInfoSPtr(info));
+      MetricsRegistry::GetInstance().SetServerInfo(settings_->GetPath().ToString(), GetType(), shot.info);
       emit ServerInfoSnapShooted(shot);
 
       log_file_->Write(stamp);
@@ -326,6 +388,7 @@ void IDriver::HandleDisconnectEvent(events::DisconnectRequestEvent* ev) {
   if (err) {
     res.setErrorInfo(err);
   }
+  MetricsRegistry::GetInstance().RemoveServerInfo(settings_->GetPath().ToString());
 
   Reply(sender, new events::DisconnectResponseEvent(this, res));
   NotifyProgress(sender, 100);
@@ -450,6 +513,19 @@ done:
   NotifyProgress(sender, 100);
 }
 
+void IDriver::HandleFindBigKeysEvent(events::FindBigKeysRequestEvent* ev) {
+  ReplyNotImplementedYet<events::FindBigKeysRequestEvent, events::FindBigKeysResponseEvent>(this, ev,
+                                                                                            "find big keys");
+}
+
+void IDriver::HandleKeysDigestEvent(events::KeysDigestRequestEvent* ev) {
+  ReplyNotImplementedYet<events::KeysDigestRequestEvent, events::KeysDigestResponseEvent>(this, ev, "keys digest");
+}
+
+void IDriver::HandleBulkDeleteEvent(events::BulkDeleteRequestEvent* ev) {
+  ReplyNotImplementedYet<events::BulkDeleteRequestEvent, events::BulkDeleteResponseEvent>(this, ev, "bulk delete");
+}
+
 void IDriver::HandleLoadServerPropertyEvent(events::ServerPropertyInfoRequestEvent* ev) {
   ReplyNotImplementedYet<events::ServerPropertyInfoRequestEvent, events::ServerPropertyInfoResponseEvent>(
       this, ev, "server property");
@@ -565,10 +641,12 @@ void IDriver::HandleLoadServerInfoEvent(events::ServerInfoRequestEvent* ev) {
   if (err) {
     res.setErrorInfo(err);
     server_info_.reset();
+    MetricsRegistry::GetInstance().RemoveServerInfo(settings_->GetPath().ToString());
   } else {
     core::IServerInfoSPtr mem(info);
     res.SetInfo(mem);
     server_info_ = mem;
+    MetricsRegistry::GetInstance().SetServerInfo(settings_->GetPath().ToString(), GetType(), mem);
   }
   NotifyProgress(sender, 75);
   Reply(sender, new events::ServerInfoResponseEvent(this, res));
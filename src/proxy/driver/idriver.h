@@ -54,6 +54,7 @@ class IDriver : public QObject, public core::CDBConnectionClient {
   void PrepareSettings();
   core::ConnectionType GetType() const;
   connection_path_t GetConnectionPath() const;
+  IConnectionSettingsBaseSPtr CloneSettings() const;
   std::string GetDelimiter() const;
   std::string GetNsSeparator() const;
   NsDisplayStrategy GetNsDisplayStrategy() const;
@@ -111,6 +112,9 @@ class IDriver : public QObject, public core::CDBConnectionClient {
   virtual void HandleExecuteEvent(events::ExecuteRequestEvent* ev);
 
   virtual void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentRequestEvent* ev);
+  virtual void HandleFindBigKeysEvent(events::FindBigKeysRequestEvent* ev);
+  virtual void HandleKeysDigestEvent(events::KeysDigestRequestEvent* ev);
+  virtual void HandleBulkDeleteEvent(events::BulkDeleteRequestEvent* ev);
 
   virtual void HandleLoadServerPropertyEvent(events::ServerPropertyInfoRequestEvent* ev);
   virtual void HandleServerPropertyChangeEvent(events::ChangeServerPropertyInfoRequestEvent* ev);
@@ -18,10 +18,54 @@
 
 #include "proxy/driver/idriver_local.h"
 
+#include <algorithm>
+#include <string>
+
+#include <common/convert2string.h>
+#include <common/string_util.h>
+
+#include <fastonosql/core/macros.h>
+
 #include "proxy/connection_settings/iconnection_settings_local.h"
 
+#define LOCAL_KEYS_RANGE_COMMAND "KEYS"
+#define MIN_SEEK_BATCH_SIZE 100
+#define UNBOUNDED_KEY_END_SIZE 64
+
 namespace fastonosql {
 namespace proxy {
+namespace {
+
+bool IsGlobSpecialChar(char c) {
+  return c == '*' || c == '?' || c == '[' || c == '\\';
+}
+
+// "user:1*" -> "user:1"
+std::string GetLiteralPrefix(const core::pattern_t& pattern) {
+  const auto it = std::find_if(pattern.begin(), pattern.end(), IsGlobSpecialChar);
+  return std::string(pattern.begin(), it);
+}
+
+// smallest key which is greater than all keys started with prefix, empty if there is no such key
+core::command_buffer_t GetPrefixUpperBound(const std::string& prefix) {
+  core::command_buffer_t bound(prefix.begin(), prefix.end());
+  while (!bound.empty() && static_cast<unsigned char>(bound.back()) == 0xff) {
+    bound.pop_back();
+  }
+  if (!bound.empty()) {
+    bound.back() = static_cast<char>(static_cast<unsigned char>(bound.back()) + 1);
+  }
+  return bound;
+}
+
+// smallest key which is greater than key
+core::command_buffer_t GetKeySuccessor(const core::command_buffer_t& key) {
+  core::command_buffer_t next = key;
+  next.push_back(0);
+  return next;
+}
+
+}  // namespace
 
 IDriverLocal::IDriverLocal(IConnectionSettingsBaseSPtr settings) : IDriver(settings) {
   CHECK(IsLocalType(GetType()));
@@ -32,5 +76,130 @@ std::string IDriverLocal::GetPath() const {
   return local_settings->GetDBPath();
 }
 
+void IDriverLocal::LoadDatabaseContentBySeek(events::LoadDatabaseContentRequestEvent* ev) {
+  QObject* sender = ev->sender();
+  NotifyProgress(sender, 0);
+  events::LoadDatabaseContentResponseEvent::value_type res(ev->value());
+
+  const std::string prefix = GetLiteralPrefix(res.pattern);
+  const bool is_prefix_pattern = res.pattern == prefix + ALL_KEYS_PATTERNS;
+  core::command_buffer_t key_start = res.key_cursor_in;
+  if (key_start.empty()) {
+    key_start = core::command_buffer_t(prefix.begin(), prefix.end());
+  }
+  // range KEYS needs an end, with no upper bound an all 0xff key stands in and the keys past it are
+  // looked up when the range runs out
+  core::command_buffer_t key_end = GetPrefixUpperBound(prefix);
+  const bool is_unbounded = key_end.empty();
+  if (is_unbounded) {
+    key_end = core::command_buffer_t(UNBOUNDED_KEY_END_SIZE, static_cast<char>(0xff));
+    // a page resumed past the stand-in starts with it, grow the end beyond the resume key
+    while (key_start.size() >= key_end.size() && std::equal(key_end.begin(), key_end.end(), key_start.begin())) {
+      key_end.resize(key_end.size() * 2, static_cast<char>(0xff));
+    }
+  }
+
+  NotifyProgress(sender, 50);
+  bool is_exhausted = false;
+  while (!is_exhausted && res.keys.size() < res.keys_count) {
+    if (IsInterrupted()) {
+      res.setErrorInfo(common::make_error(common::COMMON_EINTR));
+      break;
+    }
+
+    // glob tail filters keys out, so read ahead a little instead of one round trip per key
+    const core::keys_limit_t remaining = res.keys_count - res.keys.size();
+    const core::keys_limit_t batch =
+        is_prefix_pattern ? remaining : std::max<core::keys_limit_t>(remaining, MIN_SEEK_BATCH_SIZE);
+    const core::nkey_t key_start_str(key_start);
+    const core::nkey_t key_end_str(key_end);
+    core::command_buffer_writer_t wr;
+    wr << LOCAL_KEYS_RANGE_COMMAND " " << key_start_str.GetForCommandLine() << " " << key_end_str.GetForCommandLine()
+       << " " << common::ConvertToCharBytes(batch);
+    core::FastoObjectCommandIPtr cmd = CreateCommandFast(wr.str(), core::C_INNER);
+    common::Error err = Execute(cmd);
+    if (err) {
+      res.setErrorInfo(err);
+      break;
+    }
+
+    core::FastoObject::childs_t rchildrens = cmd->GetChildrens();
+    common::ArrayValue* ar = nullptr;
+    if (rchildrens.size() != 1 || !rchildrens[0]->GetValue()->GetAsList(&ar)) {
+      break;
+    }
+
+    size_t i = 0;
+    for (; i < ar->GetSize() && res.keys.size() < res.keys_count; ++i) {
+      core::command_buffer_t key_str;
+      if (!ar->GetString(i, &key_str)) {
+        continue;
+      }
+
+      key_start = GetKeySuccessor(key_str);
+      if (!is_prefix_pattern && !common::MatchPattern(common::ConvertToString(key_str), res.pattern)) {
+        continue;
+      }
+
+      const core::nkey_t key(key_str);
+      const core::NValue empty_val(common::Value::CreateEmptyStringValue());
+      res.keys.push_back(core::NDbKValue(core::NKey(key), empty_val));
+    }
+    is_exhausted = i == ar->GetSize() && ar->GetSize() < batch;
+    if (is_exhausted && is_unbounded) {
+      bool has_more = false;
+      err = HasKeysFrom(key_end, &has_more);
+      if (err) {
+        res.setErrorInfo(err);
+        is_exhausted = false;
+        break;
+      }
+
+      if (has_more) {
+        key_start = key_end;
+        key_end.resize(key_end.size() * 2, static_cast<char>(0xff));
+        is_exhausted = false;
+      }
+    }
+  }
+
+  if (!is_exhausted) {
+    res.key_cursor_out = key_start;
+    res.cursor_out = res.cursor_in + res.keys.size();
+  }
+
+  common::Error err = DBkcountImpl(&res.db_keys_count);
+  DCHECK(!err) << "can't get db keys count!";
+
+  NotifyProgress(sender, 75);
+  Reply(sender, new events::LoadDatabaseContentResponseEvent(this, res));
+  NotifyProgress(sender, 100);
+}
+
+common::Error IDriverLocal::HasKeysFrom(const core::command_buffer_t& key_end, bool* has_more) {
+  // every key from an all 0xff key on starts with it, so a prefix SCAN finds them; it walks the whole
+  // db but only runs once an unbounded listing has reached its end
+  const std::string tail = std::string(key_end.begin(), key_end.end()) + ALL_KEYS_PATTERNS;
+  const core::pattern_t tail_pattern(tail.begin(), tail.end());
+  core::FastoObjectCommandIPtr cmd = CreateCommandFast(core::GetKeysPattern(0, tail_pattern, 1), core::C_INNER);
+  common::Error err = Execute(cmd);
+  if (err) {
+    return err;
+  }
+
+  *has_more = false;
+  core::FastoObject::childs_t rchildrens = cmd->GetChildrens();
+  common::ArrayValue* arm = nullptr;
+  if (rchildrens.size() != 1 || !rchildrens[0]->GetValue()->GetAsList(&arm) || arm->GetSize() != 2) {
+    return common::Error();
+  }
+
+  common::ArrayValue* ar = nullptr;
+  if (arm->GetList(1, &ar)) {
+    *has_more = ar->GetSize() != 0;
+  }
+  return common::Error();
+}
+
 }  // namespace proxy
 }  // namespace fastonosql
@@ -41,6 +41,13 @@ class IDriverLocal : public IDriver {
 
  protected:
   explicit IDriverLocal(IConnectionSettingsBaseSPtr settings);
+
+  // key loading for ordered engines (LevelDB, RocksDB, LMDB): seeks to the literal prefix of the pattern via
+  // range KEYS command and resumes from the last returned key instead of re-iterating cursor offset keys
+  void LoadDatabaseContentBySeek(events::LoadDatabaseContentRequestEvent* ev);
+
+ private:
+  common::Error HasKeysFrom(const core::command_buffer_t& key_end, bool* has_more);
 };
 
 }  // namespace proxy
@@ -32,5 +32,10 @@ common::net::HostAndPort IDriverRemote::GetHost() const {
   return remote_settings->GetHost();
 }
 
+void IDriverRemote::SetHost(const common::net::HostAndPort& host) {
+  auto remote_settings = GetSpecificSettings<IConnectionSettingsRemote>();
+  remote_settings->SetHost(host);
+}
+
 }  // namespace proxy
 }  // namespace fastonosql
@@ -31,6 +31,7 @@ class IDriverRemote : public IDriver {
 
  public:
   common::net::HostAndPort GetHost() const;
+  void SetHost(const common::net::HostAndPort& host);
 
   core::translator_t GetTranslator() const override = 0;
 
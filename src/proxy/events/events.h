@@ -77,6 +77,15 @@ typedef common::qt::Event<events_info::LoadDatabaseContentResponse, QEvent::User
 typedef common::qt::Event<events_info::DiscoveryInfoRequest, QEvent::User + 33> DiscoveryInfoRequestEvent;
 typedef common::qt::Event<events_info::DiscoveryInfoResponse, QEvent::User + 34> DiscoveryInfoResponseEvent;
 
+typedef common::qt::Event<events_info::FindBigKeysRequest, QEvent::User + 35> FindBigKeysRequestEvent;
+typedef common::qt::Event<events_info::FindBigKeysResponse, QEvent::User + 36> FindBigKeysResponseEvent;
+
+typedef common::qt::Event<events_info::KeysDigestRequest, QEvent::User + 37> KeysDigestRequestEvent;
+typedef common::qt::Event<events_info::KeysDigestResponse, QEvent::User + 38> KeysDigestResponseEvent;
+
+typedef common::qt::Event<events_info::BulkDeleteRequest, QEvent::User + 39> BulkDeleteRequestEvent;
+typedef common::qt::Event<events_info::BulkDeleteResponse, QEvent::User + 40> BulkDeleteResponseEvent;
+
 typedef common::qt::Event<events_info::ProgressInfoResponse, QEvent::User + 100> ProgressResponseEvent;
 
 }  // namespace events
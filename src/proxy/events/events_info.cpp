@@ -101,11 +101,90 @@ LoadDatabaseContentRequest::LoadDatabaseContentRequest(initiator_type sender,
                                                        const core::pattern_t& pattern,
                                                        core::keys_limit_t keys_count,
                                                        core::cursor_t cursor,
+                                                       const core::command_buffer_t& key_cursor,
                                                        error_type er)
-    : base_class(sender, er), inf(inf), pattern(pattern), keys_count(keys_count), cursor_in(cursor) {}
+    : base_class(sender, er),
+      inf(inf),
+      pattern(pattern),
+      keys_count(keys_count),
+      cursor_in(cursor),
+      key_cursor_in(key_cursor) {}
 
 LoadDatabaseContentResponse::LoadDatabaseContentResponse(const base_class& request)
-    : base_class(request), keys(), cursor_out(0), db_keys_count(0) {}
+    : base_class(request), keys(), cursor_out(0), key_cursor_out(), db_keys_count(0) {}
+
+FindBigKeysRequest::FindBigKeysRequest(initiator_type sender,
+                                       core::IDataBaseInfoSPtr inf,
+                                       const core::pattern_t& pattern,
+                                       core::keys_limit_t scan_count,
+                                       size_t top_limit,
+                                       KeysUsageCriteria criteria,
+                                       size_t max_ops_per_sec,
+                                       error_type er)
+    : base_class(sender, er),
+      inf(inf),
+      pattern(pattern),
+      scan_count(scan_count),
+      top_limit(top_limit),
+      criteria(criteria),
+      max_ops_per_sec(max_ops_per_sec) {}
+
+FindBigKeysResponse::FindBigKeysResponse(const base_class& request)
+    : base_class(request), keys(), scanned_keys_count(0), db_keys_count(0), is_finished(false) {}
+
+KeysDigestRequest::KeysDigestRequest(initiator_type sender,
+                                     core::IDataBaseInfoSPtr inf,
+                                     const core::pattern_t& pattern,
+                                     core::keys_limit_t scan_count,
+                                     NDbKeysRangeDigest::range_t ranges_count,
+                                     size_t max_value_elements,
+                                     size_t max_string_bytes,
+                                     size_t max_ops_per_sec,
+                                     const ranges_t& ranges,
+                                     error_type er)
+    : base_class(sender, er),
+      inf(inf),
+      pattern(pattern),
+      scan_count(scan_count),
+      ranges_count(ranges_count),
+      max_value_elements(max_value_elements),
+      max_string_bytes(max_string_bytes),
+      max_ops_per_sec(max_ops_per_sec),
+      ranges(ranges) {}
+
+KeysDigestResponse::KeysDigestResponse(const base_class& request)
+    : base_class(request),
+      ranges_digests(),
+      keys(),
+      scanned_keys_count(0),
+      big_keys_count(0),
+      db_keys_count(0),
+      is_finished(false) {}
+
+BulkDeleteRequest::BulkDeleteRequest(initiator_type sender,
+                                     core::IDataBaseInfoSPtr inf,
+                                     const core::pattern_t& pattern,
+                                     core::keys_limit_t scan_count,
+                                     size_t batch_size,
+                                     size_t max_ops_per_sec,
+                                     bool dry_run,
+                                     error_type er)
+    : base_class(sender, er),
+      inf(inf),
+      pattern(pattern),
+      scan_count(scan_count),
+      batch_size(batch_size),
+      max_ops_per_sec(max_ops_per_sec),
+      dry_run(dry_run) {}
+
+BulkDeleteResponse::BulkDeleteResponse(const base_class& request)
+    : base_class(request),
+      removed_keys(),
+      scanned_keys_count(0),
+      matched_keys_count(0),
+      removed_keys_count(0),
+      db_keys_count(0),
+      is_finished(false) {}
 
 LoadServerChannelsRequest::LoadServerChannelsRequest(initiator_type sender, const std::string& pattern, error_type er)
     : base_class(sender, er), pattern(pattern) {}
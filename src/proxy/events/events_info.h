@@ -36,6 +36,8 @@
 #include <fastonosql/core/global.h>
 
 #include "proxy/db_client.h"
+#include "proxy/db_key_usage.h"
+#include "proxy/db_keys_digest.h"
 #include "proxy/db_ps_channel.h"
 
 namespace fastonosql {
@@ -188,12 +190,14 @@ struct LoadDatabaseContentRequest : public EventInfoBase {
                              const core::pattern_t& pattern,
                              core::keys_limit_t keys_count,
                              core::cursor_t cursor = 0,
+                             const core::command_buffer_t& key_cursor = core::command_buffer_t(),
                              error_type er = error_type());
 
   core::IDataBaseInfoSPtr inf;
   const core::pattern_t pattern;
   const core::keys_limit_t keys_count;  // requested
   const core::cursor_t cursor_in;
+  const core::command_buffer_t key_cursor_in;  // resume key for seek based engines, empty - from start
 };
 
 struct LoadDatabaseContentResponse : LoadDatabaseContentRequest {
@@ -203,9 +207,109 @@ struct LoadDatabaseContentResponse : LoadDatabaseContentRequest {
 
   keys_container_t keys;
   core::cursor_t cursor_out;
+  core::command_buffer_t key_cursor_out;
   core::keys_limit_t db_keys_count;  // total keys count
 };
 
+struct FindBigKeysRequest : public EventInfoBase {
+  typedef EventInfoBase base_class;
+  FindBigKeysRequest(initiator_type sender,
+                     core::IDataBaseInfoSPtr inf,
+                     const core::pattern_t& pattern,
+                     core::keys_limit_t scan_count,
+                     size_t top_limit,
+                     KeysUsageCriteria criteria,
+                     size_t max_ops_per_sec,
+                     error_type er = error_type());
+
+  core::IDataBaseInfoSPtr inf;
+  const core::pattern_t pattern;
+  const core::keys_limit_t scan_count;  // COUNT hint for every SCAN iteration
+  const size_t top_limit;               // per value type
+  const KeysUsageCriteria criteria;
+  const size_t max_ops_per_sec;  // 0 - unlimited
+};
+
+struct FindBigKeysResponse : FindBigKeysRequest {
+  typedef FindBigKeysRequest base_class;
+  typedef KeysUsageTop::keys_container_t keys_container_t;
+  explicit FindBigKeysResponse(const base_class& request);
+
+  keys_container_t keys;
+  size_t scanned_keys_count;
+  core::keys_limit_t db_keys_count;  // total keys count
+  bool is_finished;                  // false for interim results
+};
+
+struct KeysDigestRequest : public EventInfoBase {
+  typedef EventInfoBase base_class;
+  typedef std::vector<NDbKeysRangeDigest::range_t> ranges_t;
+  KeysDigestRequest(initiator_type sender,
+                    core::IDataBaseInfoSPtr inf,
+                    const core::pattern_t& pattern,
+                    core::keys_limit_t scan_count,
+                    NDbKeysRangeDigest::range_t ranges_count,
+                    size_t max_value_elements,
+                    size_t max_string_bytes,
+                    size_t max_ops_per_sec,
+                    const ranges_t& ranges = ranges_t(),
+                    error_type er = error_type());
+
+  core::IDataBaseInfoSPtr inf;
+  const core::pattern_t pattern;
+  const core::keys_limit_t scan_count;             // COUNT hint for every SCAN iteration
+  const NDbKeysRangeDigest::range_t ranges_count;  // keyspace is split by key hash into ranges
+  const size_t max_value_elements;                 // bigger collections are digested by length only
+  const size_t max_string_bytes;                   // longer strings are digested by length only
+  const size_t max_ops_per_sec;                    // scanned keys per second, 0 - unlimited
+  const ranges_t ranges;                           // empty - digests of all ranges, otherwise key digests
+};
+
+struct KeysDigestResponse : KeysDigestRequest {
+  typedef KeysDigestRequest base_class;
+  typedef std::vector<NDbKeysRangeDigest> ranges_container_t;
+  typedef std::vector<NDbKeyDigest> keys_container_t;
+  explicit KeysDigestResponse(const base_class& request);
+
+  ranges_container_t ranges_digests;
+  keys_container_t keys;  // interim results carry only keys found since previous one
+  size_t scanned_keys_count;
+  size_t big_keys_count;             // values over the limits, compared by type and length only
+  core::keys_limit_t db_keys_count;  // total keys count
+  bool is_finished;                  // false for interim results
+};
+
+struct BulkDeleteRequest : public EventInfoBase {
+  typedef EventInfoBase base_class;
+  BulkDeleteRequest(initiator_type sender,
+                    core::IDataBaseInfoSPtr inf,
+                    const core::pattern_t& pattern,
+                    core::keys_limit_t scan_count,
+                    size_t batch_size,
+                    size_t max_ops_per_sec,
+                    bool dry_run,
+                    error_type er = error_type());
+
+  core::IDataBaseInfoSPtr inf;
+  const core::pattern_t pattern;
+  const core::keys_limit_t scan_count;  // COUNT hint for every SCAN iteration
+  const size_t batch_size;              // keys per UNLINK command
+  const size_t max_ops_per_sec;         // 0 - unlimited
+  const bool dry_run;                   // only count matched keys
+};
+
+struct BulkDeleteResponse : BulkDeleteRequest {
+  typedef BulkDeleteRequest base_class;
+  explicit BulkDeleteResponse(const base_class& request);
+
+  core::NKeys removed_keys;    // interim results carry only keys removed since previous one
+  size_t scanned_keys_count;  // keys returned by SCAN pages
+  size_t matched_keys_count;
+  size_t removed_keys_count;
+  core::keys_limit_t db_keys_count;  // total keys count before start
+  bool is_finished;                  // false for interim results
+};
+
 struct LoadServerChannelsRequest : public EventInfoBase {
   typedef EventInfoBase base_class;
   LoadServerChannelsRequest(initiator_type sender, const std::string& pattern, error_type er = error_type());
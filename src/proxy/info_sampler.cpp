@@ -0,0 +1,206 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/info_sampler.h"
+
+#include "proxy/command/command.h"
+#include "proxy/deadline_caller.h"
+#include "proxy/resp_client.h"
+
+#if defined(BUILD_WITH_REDIS)
+#include <fastonosql/core/db/redis/db_connection.h>
+#include "proxy/db/redis/command.h"
+#include "proxy/db/redis/connection_settings.h"
+#endif
+
+#if defined(BUILD_WITH_PIKA)
+#include <fastonosql/core/db/pika/db_connection.h>
+#include "proxy/db/pika/command.h"
+#include "proxy/db/pika/connection_settings.h"
+#endif
+
+#if defined(BUILD_WITH_KEYDB)
+#include <fastonosql/core/db/keydb/db_connection.h>
+#include "proxy/db/keydb/command.h"
+#include "proxy/db/keydb/connection_settings.h"
+#endif
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+
+class RespInfoSampler : public IInfoSampler {
+ public:
+  RespInfoSampler(const common::net::HostAndPort& host, const std::string& auth, common::time64_t timeout_msec)
+      : client_(host, auth, timeout_msec) {}
+
+  common::Error Sample(std::string* info) override {
+    if (!info) {
+      DNOTREACHED();
+      return common::make_error_inval();
+    }
+
+    if (!client_.IsConnected()) {
+      common::Error err = client_.Connect();
+      if (err) {
+        return err;
+      }
+    }
+
+    RespReply reply;
+    common::Error err = client_.Execute({"INFO"}, &reply);
+    if (err) {
+      // next sample starts from a fresh connection
+      client_.Disconnect();
+      return err;
+    }
+
+    if (reply.type != RespReply::STRING) {
+      return common::make_error("Invalid INFO reply");
+    }
+
+    *info = reply.str;
+    return common::Error();
+  }
+
+ private:
+  RespClient client_;
+};
+
+// used only where RespClient can't go, core connection has no timeouts so every sample runs on an own
+// thread abandoned after timeout together with the connection it uses
+template <typename Connection, typename Command, typename Config>
+class RedisCompatibleInfoSampler : public IInfoSampler {
+ public:
+  RedisCompatibleInfoSampler(const Config& config, common::time64_t timeout_msec)
+      : config_(config), caller_(timeout_msec), connection_() {}
+
+  common::Error Sample(std::string* info) override {
+    if (!info) {
+      DNOTREACHED();
+      return common::make_error_inval();
+    }
+
+    if (!connection_) {
+      connection_ = MakeConnection();
+    }
+
+    const Config config = config_;
+    const std::shared_ptr<Connection> connection = connection_;
+    const std::shared_ptr<std::string> result = std::make_shared<std::string>();
+    common::Error err = caller_.Call([config, connection, result]() {
+      common::Error err;
+      if (!connection->IsConnected()) {
+        err = connection->Connect(config);
+        if (err) {
+          return err;
+        }
+      }
+
+      core::FastoObjectCommandIPtr cmd = CreateCommandFast<Command>(GEN_CMD_STRING("INFO"), core::C_INNER);
+      err = connection->Execute(cmd->GetInputCommand(), cmd.get());
+      if (err) {
+        return err;
+      }
+
+      *result = common::ConvertToString(cmd.get());
+      return common::Error();
+    });
+    if (err) {
+      // next sample starts from a fresh connection, a timed out one still belongs to its thread
+      connection_.reset();
+      return err;
+    }
+
+    *info = *result;
+    return common::Error();
+  }
+
+ private:
+  static std::shared_ptr<Connection> MakeConnection() {
+    return std::shared_ptr<Connection>(new Connection(nullptr), [](Connection* connection) {
+      if (connection->IsConnected()) {
+        common::Error err = connection->Disconnect();
+        UNUSED(err);
+      }
+      delete connection;
+    });
+  }
+
+  const Config config_;
+  DeadlineCaller caller_;
+  std::shared_ptr<Connection> connection_;
+};
+
+}  // namespace
+
+IInfoSampler::~IInfoSampler() {}
+
+IInfoSampler* IInfoSampler::Create(IConnectionSettingsBaseSPtr settings, common::time64_t timeout_msec) {
+  if (!settings) {
+    DNOTREACHED();
+    return nullptr;
+  }
+
+  common::net::HostAndPort host;
+  std::string auth;
+  const bool plain_tcp = GetRespEndpoint(settings, &host, &auth);
+  const core::ConnectionType connection_type = settings->GetType();
+#if defined(BUILD_WITH_REDIS)
+  if (connection_type == core::REDIS) {
+    if (plain_tcp) {
+      return new RespInfoSampler(host, auth, timeout_msec);
+    }
+    redis::ConnectionSettings* rsettings = static_cast<redis::ConnectionSettings*>(settings.get());
+    core::redis::RConfig rconfig(rsettings->GetInfo(), rsettings->GetSSHInfo());
+    typedef RedisCompatibleInfoSampler<core::redis::DBConnection, redis::Command, core::redis::RConfig> sampler_t;
+    return new sampler_t(rconfig, timeout_msec);
+  }
+#endif
+#if defined(BUILD_WITH_PIKA)
+  if (connection_type == core::PIKA) {
+    if (plain_tcp) {
+      return new RespInfoSampler(host, auth, timeout_msec);
+    }
+    pika::ConnectionSettings* psettings = static_cast<pika::ConnectionSettings*>(settings.get());
+    core::pika::RConfig rconfig(psettings->GetInfo(), psettings->GetSSHInfo());
+    typedef RedisCompatibleInfoSampler<core::pika::DBConnection, pika::Command, core::pika::RConfig> sampler_t;
+    return new sampler_t(rconfig, timeout_msec);
+  }
+#endif
+#if defined(BUILD_WITH_KEYDB)
+  if (connection_type == core::KEYDB) {
+    if (plain_tcp) {
+      return new RespInfoSampler(host, auth, timeout_msec);
+    }
+    keydb::ConnectionSettings* ksettings = static_cast<keydb::ConnectionSettings*>(settings.get());
+    core::keydb::RConfig rconfig(ksettings->GetInfo(), ksettings->GetSSHInfo());
+    typedef RedisCompatibleInfoSampler<core::keydb::DBConnection, keydb::Command, core::keydb::RConfig> sampler_t;
+    return new sampler_t(rconfig, timeout_msec);
+  }
+#endif
+
+  UNUSED(connection_type);
+  UNUSED(plain_tcp);
+  UNUSED(timeout_msec);
+  return nullptr;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,48 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <common/error.h>
+#include <common/types.h>
+
+#include "proxy/connection_settings/iconnection_settings.h"
+
+namespace fastonosql {
+namespace proxy {
+
+// keeps an own connection to a node and reads INFO through it, so periodic sampling
+// never waits in the queue of the node driver, reconnects lazily after errors;
+// connect and INFO are limited by timeout, for tls and ssh tunneled nodes by abandoning the sample
+class IInfoSampler {
+ public:
+  virtual ~IInfoSampler();
+
+  virtual common::Error Sample(std::string* info) WARN_UNUSED_RESULT = 0;
+
+  // nullptr for databases without INFO command
+  static IInfoSampler* Create(IConnectionSettingsBaseSPtr settings, common::time64_t timeout_msec);
+};
+
+typedef std::shared_ptr<IInfoSampler> IInfoSamplerSPtr;
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,161 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/metrics_exporter.h"
+
+#if defined(OS_WIN)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+
+#include <common/convert2string.h>
+#include <common/logger.h>
+
+#include "proxy/metrics_registry.h"
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+
+#if defined(OS_WIN)
+typedef SOCKET socket_t;
+const socket_t kInvalidSocket = INVALID_SOCKET;
+void CloseSocket(socket_t sock) {
+  closesocket(sock);
+}
+#else
+typedef int socket_t;
+const socket_t kInvalidSocket = -1;
+void CloseSocket(socket_t sock) {
+  close(sock);
+}
+#endif
+
+bool WaitReadable(socket_t sock, int msec) {
+  fd_set read_set;
+  FD_ZERO(&read_set);
+  FD_SET(sock, &read_set);
+  struct timeval wait;
+  wait.tv_sec = msec / 1000;
+  wait.tv_usec = (msec % 1000) * 1000;
+  return select(static_cast<int>(sock) + 1, &read_set, nullptr, nullptr, &wait) > 0;
+}
+
+void SendAll(socket_t sock, const std::string& data) {
+  size_t total = 0;
+  while (total < data.size()) {
+    const auto nwrite = send(sock, data.data() + total, static_cast<int>(data.size() - total), 0);
+    if (nwrite <= 0) {
+      return;
+    }
+    total += static_cast<size_t>(nwrite);
+  }
+}
+
+std::string MakeResponse(const std::string& status, const std::string& content_type, const std::string& body) {
+  return "HTTP/1.1 " + status + "\r\nContent-Type: " + content_type +
+         "\r\nContent-Length: " + common::ConvertToString(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+}
+
+void HandleClient(socket_t client) {
+  std::string request;
+  char buff[1024];
+  while (request.find("\r\n\r\n") == std::string::npos && request.size() < MetricsExporter::max_request_size) {
+    if (!WaitReadable(client, MetricsExporter::request_timeout_msec)) {
+      return;
+    }
+
+    const auto nread = recv(client, buff, sizeof(buff), 0);
+    if (nread <= 0) {
+      return;
+    }
+    request.append(buff, static_cast<size_t>(nread));
+  }
+
+  const std::string request_line = request.substr(0, request.find("\r\n"));
+  if (request_line.compare(0, 13, "GET /metrics ") == 0 || request_line.compare(0, 14, "HEAD /metrics ") == 0) {
+    SendAll(client, MakeResponse("200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                                 MetricsRegistry::GetInstance().Render()));
+    return;
+  }
+
+  SendAll(client, MakeResponse("404 Not Found", "text/plain; charset=utf-8", "Not found, use /metrics\n"));
+}
+
+}  // namespace
+
+MetricsExporter::MetricsExporter(uint16_t port, QObject* parent) : QObject(parent), port_(port), stop_(false) {}
+
+void MetricsExporter::Stop() {
+  stop_ = true;
+}
+
+void MetricsExporter::Routine() {
+  socket_t server = socket(AF_INET, SOCK_STREAM, 0);
+  if (server == kInvalidSocket) {
+    WARNING_LOG() << "Can't create metrics socket.";
+    emit Finished();
+    return;
+  }
+
+  int reuse = 1;
+  setsockopt(server, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+  // never exposed outside of the host
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port_);
+  if (bind(server, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) != 0 || listen(server, 8) != 0) {
+    CloseSocket(server);
+    WARNING_LOG() << "Can't listen metrics port " << port_ << ".";
+    emit Finished();
+    return;
+  }
+
+  INFO_LOG() << "Metrics are exported on http://127.0.0.1:" << port_ << "/metrics";
+  while (!stop_) {
+    if (!WaitReadable(server, poll_interval_msec)) {
+      continue;
+    }
+
+    socket_t client = accept(server, nullptr, nullptr);
+    if (client == kInvalidSocket) {
+      continue;
+    }
+
+    HandleClient(client);
+    CloseSocket(client);
+  }
+
+  CloseSocket(server);
+  emit Finished();
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,53 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include <QObject>
+
+namespace fastonosql {
+namespace proxy {
+
+// minimal http endpoint on 127.0.0.1:<port>, GET /metrics answers with MetricsRegistry::Render(),
+// lives in own thread, one scrape at a time is enough for prometheus
+class MetricsExporter : public QObject {
+  Q_OBJECT
+
+ public:
+  enum { poll_interval_msec = 200, request_timeout_msec = 2000, max_request_size = 8 * 1024 };
+
+  explicit MetricsExporter(uint16_t port, QObject* parent = Q_NULLPTR);
+
+  void Stop();  // thread safe
+
+ Q_SIGNALS:
+  void Finished();
+
+ public Q_SLOTS:
+  void Routine();
+
+ private:
+  const uint16_t port_;
+  std::atomic<bool> stop_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,236 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/metrics_registry.h"
+
+#include <memory>
+#include <sstream>
+
+#include <common/convert2string.h>
+#include <common/macros.h>
+
+#include <fastonosql/core/connection_types.h>
+
+#define METRICS_PREFIX "fastonosql_"
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+
+const double kLatencyBuckets[] = {0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+const char* const kLatencyBucketsLabels[] = {"0.001", "0.005", "0.01", "0.025", "0.05", "0.1",
+                                            "0.25",  "0.5",   "1",    "2.5",   "5",    "10"};
+const size_t kLatencyBucketsCount = SIZEOFMASS(kLatencyBuckets);
+
+std::string MakeMetricName(const std::string& field) {
+  std::string name = METRICS_PREFIX "info_";
+  for (char c : field) {
+    const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+    name += valid ? c : '_';
+  }
+  return name;
+}
+
+std::string EscapeLabel(const std::string& value) {
+  std::string result;
+  for (char c : value) {
+    if (c == '\\' || c == '"') {
+      result += '\\';
+      result += c;
+    } else if (c == '\n') {
+      result += "\\n";
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+std::string ConnectionLabel(const std::string& connection) {
+  return "connection=\"" + EscapeLabel(connection) + "\"";
+}
+
+void WriteHeader(std::ostream& out, const std::string& name, const char* type, const char* help) {
+  out << "# HELP " << name << " " << help << "\n";
+  out << "# TYPE " << name << " " << type << "\n";
+}
+
+}  // namespace
+
+MetricsRegistry::ConnectionStats::ConnectionStats()
+    : queue_depth(0),
+      latency_buckets(kLatencyBucketsCount + 1, 0),
+      latency_count(0),
+      latency_sum(0),
+      bytes_out(0),
+      bytes_in(0) {}
+
+MetricsRegistry::MetricsRegistry() : enabled_(false), mutex_(), servers_(), connections_() {}
+
+void MetricsRegistry::Enable() {
+  enabled_ = true;
+}
+
+bool MetricsRegistry::IsEnabled() const {
+  return enabled_;
+}
+
+void MetricsRegistry::SetServerInfo(const std::string& connection,
+                                    core::ConnectionType type,
+                                    core::IServerInfoSPtr info) {
+  if (!IsEnabled() || !info) {
+    return;
+  }
+
+  ServerInfoValues server;
+  server.type = common::ConvertToString(type);
+  const auto fields = core::GetInfoFieldsFromType(type);
+  for (size_t i = 0; i < fields.size(); ++i) {
+    const std::vector<core::Field>& section = fields[i].second;
+    for (size_t j = 0; j < section.size(); ++j) {
+      if (!section[j].IsIntegral()) {
+        continue;
+      }
+
+      std::unique_ptr<common::Value> value(info->GetValueByIndexes(i, j));  // allocate
+      double number = 0;
+      if (value && value->GetAsDouble(&number)) {
+        server.values.push_back({fields[i].first, section[j].name, number});
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  servers_[connection] = server;
+}
+
+void MetricsRegistry::RemoveServerInfo(const std::string& connection) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  servers_.erase(connection);
+}
+
+void MetricsRegistry::RequestQueued(const std::string& connection) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  connections_[connection].queue_depth++;
+}
+
+void MetricsRegistry::RequestDequeued(const std::string& connection) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  ConnectionStats& stats = connections_[connection];
+  if (stats.queue_depth > 0) {
+    stats.queue_depth--;
+  }
+}
+
+void MetricsRegistry::ObserveCommand(const std::string& connection,
+                                     double seconds,
+                                     size_t bytes_out,
+                                     size_t bytes_in) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  size_t bucket = 0;
+  while (bucket < kLatencyBucketsCount && seconds > kLatencyBuckets[bucket]) {
+    bucket++;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  ConnectionStats& stats = connections_[connection];
+  stats.latency_buckets[bucket]++;
+  stats.latency_count++;
+  stats.latency_sum += seconds;
+  stats.bytes_out += bytes_out;
+  stats.bytes_in += bytes_in;
+}
+
+std::string MetricsRegistry::Render() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::ostringstream out;
+  out.precision(15);
+
+  // same field can come from many servers, all series of one metric must be grouped
+  std::map<std::string, std::vector<std::string>> info_metrics;
+  for (const auto& server : servers_) {
+    const std::string labels = ConnectionLabel(server.first) + ",type=\"" + EscapeLabel(server.second.type) + "\"";
+    for (const InfoValue& value : server.second.values) {
+      std::ostringstream line;
+      line.precision(15);
+      line << "{" << labels << ",section=\"" << EscapeLabel(value.section) << "\"} " << value.value;
+      info_metrics[MakeMetricName(value.field)].push_back(line.str());
+    }
+  }
+
+  for (const auto& metric : info_metrics) {
+    WriteHeader(out, metric.first, "untyped", "Server info field of last sample.");
+    for (const std::string& line : metric.second) {
+      out << metric.first << line << "\n";
+    }
+  }
+
+  WriteHeader(out, METRICS_PREFIX "request_queue_depth", "gauge", "Requests posted to connection not yet handled.");
+  for (const auto& connection : connections_) {
+    out << METRICS_PREFIX "request_queue_depth{" << ConnectionLabel(connection.first) << "} "
+        << connection.second.queue_depth << "\n";
+  }
+
+  WriteHeader(out, METRICS_PREFIX "command_duration_seconds", "histogram", "Command round trip time.");
+  for (const auto& connection : connections_) {
+    const std::string label = ConnectionLabel(connection.first);
+    const ConnectionStats& stats = connection.second;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kLatencyBucketsCount; ++i) {
+      cumulative += stats.latency_buckets[i];
+      out << METRICS_PREFIX "command_duration_seconds_bucket{" << label << ",le=\"" << kLatencyBucketsLabels[i]
+          << "\"} " << cumulative << "\n";
+    }
+    out << METRICS_PREFIX "command_duration_seconds_bucket{" << label << ",le=\"+Inf\"} " << stats.latency_count
+        << "\n";
+    out << METRICS_PREFIX "command_duration_seconds_sum{" << label << "} " << stats.latency_sum << "\n";
+    out << METRICS_PREFIX "command_duration_seconds_count{" << label << "} " << stats.latency_count << "\n";
+  }
+
+  WriteHeader(out, METRICS_PREFIX "command_sent_bytes_total", "counter", "Bytes of commands sent.");
+  for (const auto& connection : connections_) {
+    out << METRICS_PREFIX "command_sent_bytes_total{" << ConnectionLabel(connection.first) << "} "
+        << connection.second.bytes_out << "\n";
+  }
+
+  WriteHeader(out, METRICS_PREFIX "command_received_bytes_total", "counter", "Payload bytes of command replies received.");
+  for (const auto& connection : connections_) {
+    out << METRICS_PREFIX "command_received_bytes_total{" << ConnectionLabel(connection.first) << "} "
+        << connection.second.bytes_in << "\n";
+  }
+  return out.str();
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
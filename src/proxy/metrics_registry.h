@@ -0,0 +1,85 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <common/patterns/singleton_pattern.h>
+
+#include <fastonosql/core/server/iserver_info.h>
+
+namespace fastonosql {
+namespace proxy {
+
+// latest server info of connected servers and client side stats per connection,
+// rendered in prometheus text exposition format by MetricsExporter
+class MetricsRegistry : public common::patterns::LazySingleton<MetricsRegistry> {
+ public:
+  friend class common::patterns::LazySingleton<MetricsRegistry>;
+
+  void Enable();
+  bool IsEnabled() const;
+
+  // thread safe, drivers update it from their own threads; integral info fields are copied on every new info
+  void SetServerInfo(const std::string& connection, core::ConnectionType type, core::IServerInfoSPtr info);
+  void RemoveServerInfo(const std::string& connection);
+
+  void RequestQueued(const std::string& connection);
+  void RequestDequeued(const std::string& connection);
+  void ObserveCommand(const std::string& connection, double seconds, size_t bytes_out, size_t bytes_in);
+
+  std::string Render() const;
+
+ private:
+  struct InfoValue {
+    std::string section;
+    std::string field;
+    double value;
+  };
+
+  struct ServerInfoValues {
+    std::string type;
+    std::vector<InfoValue> values;
+  };
+
+  struct ConnectionStats {
+    ConnectionStats();
+
+    int64_t queue_depth;
+    std::vector<uint64_t> latency_buckets;  // not cumulative, last is +Inf
+    uint64_t latency_count;
+    double latency_sum;
+    uint64_t bytes_out;
+    uint64_t bytes_in;
+  };
+
+  MetricsRegistry();
+
+  std::atomic<bool> enabled_;
+  mutable std::mutex mutex_;
+  std::map<std::string, ServerInfoValues> servers_;
+  std::map<std::string, ConnectionStats> connections_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
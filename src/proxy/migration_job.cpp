@@ -0,0 +1,463 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/migration_job.h"
+
+#include <algorithm>
+#include <string>
+
+#include <common/time.h>
+
+#include <fastonosql/core/icommand_translator.h>
+
+#include "proxy/server/iserver.h"
+#include "proxy/servers_manager.h"
+
+namespace fastonosql {
+namespace proxy {
+
+MigrationJob::Checkpoint::Checkpoint() : cursor(0), key_cursor(), migrated_keys(0) {}
+
+MigrationJob::Statistic::Statistic()
+    : migrated_keys(0), skipped_keys(0), failed_keys(0), total_keys(0), keys_per_sec(0), eta_msec(-1) {}
+
+MigrationJob::MigrationJob(IConnectionSettingsBaseSPtr source,
+                           IConnectionSettingsBaseSPtr destination,
+                           const core::pattern_t& pattern,
+                           core::keys_limit_t batch_size,
+                           size_t window,
+                           size_t workers,
+                           const Checkpoint& checkpoint,
+                           QObject* parent)
+    : QObject(parent),
+      source_settings_(source),
+      destination_settings_(destination),
+      pattern_(pattern),
+      batch_size_(std::max(batch_size, core::keys_limit_t(1))),
+      window_(std::max(window, size_t(1))),
+      workers_count_(std::min(std::max(workers, size_t(1)), size_t(max_workers))),
+      source_(),
+      workers_(),
+      ready_servers_(0),
+      checkpoint_(checkpoint),
+      cursor_(checkpoint.cursor),
+      key_cursor_(checkpoint.key_cursor),
+      source_exhausted_(false),
+      fetching_(false),
+      running_(false),
+      stopped_(false),
+      error_(),
+      page_keys_(),
+      page_values_(),
+      page_match_pos_(0),
+      pages_(),
+      first_page_id_(0),
+      in_flight_(0),
+      stat_(),
+      start_msec_(0),
+      resumed_keys_(checkpoint.migrated_keys) {
+  CHECK(source_settings_ && destination_settings_);
+  // embedded databases can't be opened twice by one process
+  if (IsLocalType(destination_settings_->GetType())) {
+    workers_count_ = 1;
+  }
+  stat_.migrated_keys = resumed_keys_;
+}
+
+MigrationJob::~MigrationJob() {
+  CloseServers();
+}
+
+void MigrationJob::Start() {
+  if (running_) {
+    DNOTREACHED() << "Migration already started.";
+    return;
+  }
+
+  // restart continues from the last committed checkpoint
+  running_ = true;
+  stopped_ = false;
+  error_ = common::Error();
+  ready_servers_ = 0;
+  source_exhausted_ = false;
+  cursor_ = checkpoint_.cursor;
+  key_cursor_ = checkpoint_.key_cursor;
+  start_msec_ = common::time::current_utc_mstime();
+
+  ServersManager& manager = ServersManager::GetInstance();
+  source_ = manager.CreateServer(source_settings_);
+  for (size_t i = 0; i < workers_count_; ++i) {
+    Worker worker;
+    worker.server = manager.CreateServer(destination_settings_);
+    workers_.push_back(worker);
+  }
+
+  std::vector<IServerSPtr> servers = {source_};
+  for (const Worker& worker : workers_) {
+    servers.push_back(worker.server);
+  }
+
+  for (IServerSPtr server : servers) {
+    if (!server) {
+      Finish(common::make_error("Invalid connection settings"));
+      return;
+    }
+
+    VERIFY(connect(server.get(), &IServer::ConnectFinished, this, &MigrationJob::HandleConnectFinished));
+    VERIFY(connect(server.get(), &IServer::LoadDiscoveryInfoFinished, this, &MigrationJob::HandleDiscoveryFinished));
+  }
+
+  VERIFY(connect(source_.get(), &IServer::LoadDatabaseContentFinished, this, &MigrationJob::HandlePageLoaded));
+  VERIFY(connect(source_.get(), &IServer::KeyLoaded, this, &MigrationJob::HandleKeyLoaded));
+  VERIFY(connect(source_.get(), &IServer::KeyAdded, this, &MigrationJob::HandleKeyLoaded));
+  VERIFY(connect(source_.get(), &IServer::ExecuteFinished, this, &MigrationJob::HandleSourceExecuteFinished));
+  for (const Worker& worker : workers_) {
+    VERIFY(connect(worker.server.get(), &IServer::ExecuteFinished, this,
+                   &MigrationJob::HandleDestinationExecuteFinished));
+  }
+
+  for (IServerSPtr server : servers) {
+    events_info::ConnectInfoRequest req(this);
+    server->Connect(req);
+  }
+}
+
+void MigrationJob::Stop() {
+  if (!running_ || stopped_) {
+    return;
+  }
+
+  stopped_ = true;
+  if (source_) {
+    source_->StopCurrentEvent();
+  }
+  TryFinish();
+}
+
+bool MigrationJob::IsRunning() const {
+  return running_;
+}
+
+void MigrationJob::HandleConnectFinished(const events_info::ConnectInfoResponse& res) {
+  if (res.initiator() != this) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+  }
+}
+
+void MigrationJob::HandleDiscoveryFinished(const events_info::DiscoveryInfoResponse& res) {
+  // discovery is requested by the server itself once our connect succeeded
+  QObject* server = sender();
+  if (res.initiator() != server || !running_) {
+    return;
+  }
+
+  if (server != source_.get() && !FindWorker(server)) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  ready_servers_++;
+  if (ready_servers_ == workers_.size() + 1) {
+    FetchNextPage();
+  }
+}
+
+void MigrationJob::HandlePageLoaded(const events_info::LoadDatabaseContentResponse& res) {
+  if (res.initiator() != this || !running_) {
+    return;
+  }
+
+  fetching_ = false;
+  common::Error err = res.errorInfo();
+  if (err) {
+    Finish(err);
+    return;
+  }
+
+  stat_.total_keys = res.db_keys_count;
+  cursor_ = res.cursor_out;
+  key_cursor_ = res.key_cursor_out;
+  source_exhausted_ = res.cursor_out == 0;
+
+  pages_.push_back({res.cursor_out, res.key_cursor_out, res.keys.size(), res.keys.empty()});
+  if (res.keys.empty() || stopped_) {
+    CommitWrittenPages();
+    FetchNextPage();
+    TryFinish();
+    return;
+  }
+
+  core::translator_t tran = source_->GetTranslator();
+  core::command_buffer_writer_t wr;
+  page_keys_.clear();
+  for (const core::NDbKValue& key : res.keys) {
+    core::command_buffer_t cmd_str;
+    err = tran->LoadKeyCommand(key.GetKey(), key.GetType(), &cmd_str);
+    if (err) {
+      stat_.skipped_keys++;
+      continue;
+    }
+    wr << cmd_str << "\n";
+    page_keys_.push_back(key);
+  }
+
+  if (page_keys_.empty()) {
+    pages_.back().written = true;
+    CommitWrittenPages();
+    FetchNextPage();
+    TryFinish();
+    return;
+  }
+
+  page_values_.clear();
+  page_match_pos_ = 0;
+  fetching_ = true;
+  events_info::ExecuteInfoRequest req(this, wr.str(), 0, 0, false, true, core::C_INNER);
+  source_->Execute(req);
+}
+
+void MigrationJob::HandleKeyLoaded(core::IDataBaseInfoSPtr db, core::NDbKValue key) {
+  UNUSED(db);
+  if (!fetching_ || page_match_pos_ >= page_keys_.size()) {
+    return;
+  }
+
+  // values arrive in command order, keys missing on the source are skipped over
+  for (size_t i = page_match_pos_; i < page_keys_.size(); ++i) {
+    const core::NKey listed = page_keys_[i].GetKey();
+    if (listed.GetKey() == key.GetKey().GetKey()) {
+      core::NKey nkey = key.GetKey();
+      nkey.SetTTL(listed.GetTTL());
+      page_values_.push_back(core::NDbKValue(nkey, key.GetValue()));
+      page_match_pos_ = i + 1;
+      return;
+    }
+  }
+}
+
+void MigrationJob::HandleSourceExecuteFinished(const events_info::ExecuteInfoResponse& res) {
+  if (res.initiator() != this || !running_) {
+    return;
+  }
+
+  fetching_ = false;
+  const size_t listed = page_keys_.size();
+  if (page_values_.size() < listed) {
+    stat_.failed_keys += listed - page_values_.size();
+  }
+  page_keys_.clear();
+
+  if (stopped_) {
+    page_values_.clear();
+    TryFinish();
+    return;
+  }
+
+  WriteBatch(page_values_);
+  page_values_.clear();
+  FetchNextPage();
+}
+
+void MigrationJob::HandleDestinationExecuteFinished(const events_info::ExecuteInfoResponse& res) {
+  if (res.initiator() != this || !running_) {
+    return;
+  }
+
+  Worker* worker = FindWorker(sender());
+  if (!worker || worker->batches.empty()) {
+    DNOTREACHED();
+    return;
+  }
+
+  const size_t page_id = worker->batches.front();
+  worker->batches.pop_front();
+  in_flight_--;
+
+  Page& page = pages_[page_id - first_page_id_];
+  common::Error err = res.errorInfo();
+  if (err) {
+    // a batch stops on its first failed command, keep the checkpoint before it and drain
+    stat_.failed_keys += page.keys_count;
+    error_ = err;
+    stopped_ = true;
+  } else {
+    page.written = true;
+    stat_.migrated_keys += page.keys_count;
+  }
+
+  CommitWrittenPages();
+  EmitProgress();
+  FetchNextPage();
+  TryFinish();
+}
+
+void MigrationJob::FetchNextPage() {
+  if (!running_ || stopped_ || fetching_ || source_exhausted_ || in_flight_ >= window_) {
+    return;
+  }
+
+  core::IDataBaseInfoSPtr inf = source_->GetCurrentDatabaseInfo();
+  if (!inf) {
+    Finish(common::make_error("Source database not discovered"));
+    return;
+  }
+
+  fetching_ = true;
+  events_info::LoadDatabaseContentRequest req(this, inf, pattern_, batch_size_, cursor_, key_cursor_);
+  source_->LoadDatabaseContent(req);
+}
+
+void MigrationJob::WriteBatch(const std::vector<core::NDbKValue>& values) {
+  Page& page = pages_.back();
+  const size_t page_id = first_page_id_ + pages_.size() - 1;
+
+  core::translator_t tran = workers_.front().server->GetTranslator();
+  core::command_buffer_writer_t wr;
+  size_t commands = 0;
+  for (const core::NDbKValue& value : values) {
+    core::command_buffer_t cmd_str;
+    common::Error err = tran->CreateKeyCommand(value, &cmd_str);
+    if (err) {
+      // type not supported by the destination engine
+      stat_.skipped_keys++;
+      continue;
+    }
+    wr << cmd_str << "\n";
+    commands++;
+
+    const core::NKey key = value.GetKey();
+    if (key.GetTTL() > 0) {
+      core::command_buffer_t ttl_str;
+      err = tran->ChangeKeyTTLCommand(key, key.GetTTL(), &ttl_str);
+      if (!err) {
+        wr << ttl_str << "\n";
+      }
+    }
+  }
+
+  page.keys_count = commands;
+  if (!commands) {
+    page.written = true;
+    CommitWrittenPages();
+    return;
+  }
+
+  // least loaded connection gets the batch
+  auto worker = std::min_element(workers_.begin(), workers_.end(), [](const Worker& lhs, const Worker& rhs) {
+    return lhs.batches.size() < rhs.batches.size();
+  });
+  worker->batches.push_back(page_id);
+  in_flight_++;
+
+  events_info::ExecuteInfoRequest req(this, wr.str(), 0, 0, false, true, core::C_INNER);
+  worker->server->Execute(req);
+}
+
+void MigrationJob::CommitWrittenPages() {
+  while (!pages_.empty() && pages_.front().written) {
+    const Page& page = pages_.front();
+    checkpoint_.cursor = page.cursor_out;
+    checkpoint_.key_cursor = page.key_cursor_out;
+    checkpoint_.migrated_keys += page.keys_count;
+    pages_.pop_front();
+    first_page_id_++;
+  }
+}
+
+void MigrationJob::EmitProgress() {
+  const common::time64_t elapsed = common::time::current_utc_mstime() - start_msec_;
+  if (elapsed > 0) {
+    stat_.keys_per_sec = static_cast<double>(stat_.migrated_keys - resumed_keys_) * 1000 / elapsed;
+  }
+
+  const size_t processed = stat_.migrated_keys + stat_.skipped_keys + stat_.failed_keys;
+  if (stat_.keys_per_sec > 0 && stat_.total_keys > processed) {
+    stat_.eta_msec = static_cast<common::time64_t>((stat_.total_keys - processed) * 1000 / stat_.keys_per_sec);
+  } else {
+    stat_.eta_msec = -1;
+  }
+
+  emit Progressed(stat_, checkpoint_);
+}
+
+void MigrationJob::TryFinish() {
+  if (!running_ || fetching_ || in_flight_) {
+    return;
+  }
+
+  if (stopped_) {
+    Finish(error_ ? error_ : common::make_error(common::COMMON_EINTR));
+    return;
+  }
+
+  if (source_exhausted_ && pages_.empty()) {
+    Finish(common::Error());
+  }
+}
+
+void MigrationJob::Finish(common::Error err) {
+  if (!running_) {
+    return;
+  }
+
+  CloseServers();
+  emit Finished(err, checkpoint_);
+}
+
+void MigrationJob::CloseServers() {
+  running_ = false;
+  ServersManager& manager = ServersManager::GetInstance();
+  if (source_) {
+    disconnect(source_.get(), nullptr, this, nullptr);
+    manager.CloseServer(source_);
+    source_.reset();
+  }
+  for (Worker& worker : workers_) {
+    if (worker.server) {
+      disconnect(worker.server.get(), nullptr, this, nullptr);
+      manager.CloseServer(worker.server);
+    }
+  }
+  workers_.clear();
+  pages_.clear();
+  in_flight_ = 0;
+  fetching_ = false;
+}
+
+MigrationJob::Worker* MigrationJob::FindWorker(QObject* server) {
+  for (Worker& worker : workers_) {
+    if (worker.server.get() == server) {
+      return &worker;
+    }
+  }
+
+  return nullptr;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
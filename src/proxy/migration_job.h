@@ -0,0 +1,155 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include <QObject>
+
+#include <common/error.h>
+
+#include <fastonosql/core/database/idatabase_info.h>
+#include <fastonosql/core/db_key.h>
+
+#include "proxy/connection_settings/iconnection_settings.h"
+#include "proxy/proxy_fwd.h"
+
+namespace fastonosql {
+namespace proxy {
+namespace events_info {
+struct ConnectInfoResponse;
+struct DiscoveryInfoResponse;
+struct ExecuteInfoResponse;
+struct LoadDatabaseContentResponse;
+}  // namespace events_info
+
+// Streams keys from one configured connection into another: the source is paged by
+// LoadDatabaseContent, values are loaded in batches and written to the destination with
+// commands produced by the destination translator. Up to "window" write batches are
+// kept in flight, spread over "workers" destination connections.
+class MigrationJob : public QObject {
+  Q_OBJECT
+
+ public:
+  enum { default_batch_size = 100, default_window = 4, default_workers = 2, max_workers = 16 };
+
+  // position after the last page fully written to the destination, safe to resume from
+  struct Checkpoint {
+    Checkpoint();
+
+    core::cursor_t cursor;
+    core::command_buffer_t key_cursor;
+    size_t migrated_keys;
+  };
+
+  struct Statistic {
+    Statistic();
+
+    size_t migrated_keys;
+    size_t skipped_keys;
+    size_t failed_keys;
+    core::keys_limit_t total_keys;
+    double keys_per_sec;
+    common::time64_t eta_msec;  // -1 if unknown
+  };
+
+  MigrationJob(IConnectionSettingsBaseSPtr source,
+               IConnectionSettingsBaseSPtr destination,
+               const core::pattern_t& pattern,
+               core::keys_limit_t batch_size = default_batch_size,
+               size_t window = default_window,
+               size_t workers = default_workers,
+               const Checkpoint& checkpoint = Checkpoint(),
+               QObject* parent = Q_NULLPTR);
+  ~MigrationJob() override;
+
+  void Start();
+  void Stop();
+  bool IsRunning() const;
+
+ Q_SIGNALS:
+  void Progressed(const proxy::MigrationJob::Statistic& stat, const proxy::MigrationJob::Checkpoint& checkpoint);
+  void Finished(common::Error err, const proxy::MigrationJob::Checkpoint& checkpoint);
+
+ private Q_SLOTS:
+  void HandleConnectFinished(const events_info::ConnectInfoResponse& res);
+  void HandleDiscoveryFinished(const events_info::DiscoveryInfoResponse& res);
+  void HandlePageLoaded(const events_info::LoadDatabaseContentResponse& res);
+  void HandleKeyLoaded(core::IDataBaseInfoSPtr db, core::NDbKValue key);
+  void HandleSourceExecuteFinished(const events_info::ExecuteInfoResponse& res);
+  void HandleDestinationExecuteFinished(const events_info::ExecuteInfoResponse& res);
+
+ private:
+  struct Page {
+    core::cursor_t cursor_out;
+    core::command_buffer_t key_cursor_out;
+    size_t keys_count;
+    bool written;
+  };
+
+  struct Worker {
+    IServerSPtr server;
+    std::deque<size_t> batches;  // page ids, in write order
+  };
+
+  void FetchNextPage();
+  void WriteBatch(const std::vector<core::NDbKValue>& values);
+  void CommitWrittenPages();
+  void EmitProgress();
+  void TryFinish();
+  void Finish(common::Error err);
+  void CloseServers();
+  Worker* FindWorker(QObject* server);
+
+  const IConnectionSettingsBaseSPtr source_settings_;
+  const IConnectionSettingsBaseSPtr destination_settings_;
+  const core::pattern_t pattern_;
+  const core::keys_limit_t batch_size_;
+  const size_t window_;
+  size_t workers_count_;
+
+  IServerSPtr source_;
+  std::vector<Worker> workers_;
+  size_t ready_servers_;
+
+  Checkpoint checkpoint_;
+  core::cursor_t cursor_;
+  core::command_buffer_t key_cursor_;
+  bool source_exhausted_;
+  bool fetching_;
+  bool running_;
+  bool stopped_;
+  common::Error error_;
+
+  std::vector<core::NDbKValue> page_keys_;  // listed keys of the page being loaded
+  std::vector<core::NDbKValue> page_values_;
+  size_t page_match_pos_;
+
+  std::deque<Page> pages_;  // pages not yet committed into the checkpoint
+  size_t first_page_id_;
+  size_t in_flight_;
+
+  Statistic stat_;
+  common::time64_t start_msec_;
+  const size_t resumed_keys_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,235 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/nodes_stats.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+long long ToLongLong(const std::string& value) {
+  return strtoll(value.c_str(), nullptr, 10);
+}
+
+long long Positive(long long value) {
+  return value > 0 ? value : 0;
+}
+
+void AddNode(const NodeInfoSample& sample, ShardStats* stats) {
+  stats->nodes_count++;
+  stats->ops_per_sec += sample.ops_per_sec;
+  stats->used_memory += sample.used_memory;
+}
+
+void FinishShard(ShardStats* stats) {
+  const long long lookups = stats->hits_delta + stats->misses_delta;
+  stats->hit_ratio = lookups ? static_cast<double>(stats->hits_delta) / lookups : -1;
+}
+}  // namespace
+
+NodeInfoSample::NodeInfoSample()
+    : timestamp(0),
+      role(),
+      master_host(),
+      master_port(),
+      ops_per_sec(0),
+      used_memory(0),
+      keyspace_hits(0),
+      keyspace_misses(0),
+      evicted_keys(0),
+      repl_offset(0) {}
+
+bool NodeInfoSample::IsMaster() const {
+  return role != "slave" && role != "replica";
+}
+
+std::string NodeInfoSample::GetMasterAddress() const {
+  if (IsMaster() || master_host.empty()) {
+    return std::string();
+  }
+  return master_host + ":" + master_port;
+}
+
+bool ParseNodeInfoSample(const std::string& info, common::time64_t timestamp, NodeInfoSample* sample) {
+  if (!sample) {
+    return false;
+  }
+
+  NodeInfoSample result;
+  result.timestamp = timestamp;
+  bool has_slave_offset = false;
+  size_t start = 0;
+  while (start < info.size()) {
+    size_t end = info.find('\n', start);
+    if (end == std::string::npos) {
+      end = info.size();
+    }
+
+    std::string line = info.substr(start, end - start);
+    start = end + 1;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+      continue;
+    }
+
+    const std::string field = line.substr(0, colon);
+    const std::string value = line.substr(colon + 1);
+    if (field == "role") {
+      result.role = value;
+    } else if (field == "master_host") {
+      result.master_host = value;
+    } else if (field == "master_port") {
+      result.master_port = value;
+    } else if (field == "instantaneous_ops_per_sec") {
+      result.ops_per_sec = ToLongLong(value);
+    } else if (field == "used_memory") {
+      result.used_memory = ToLongLong(value);
+    } else if (field == "keyspace_hits") {
+      result.keyspace_hits = ToLongLong(value);
+    } else if (field == "keyspace_misses") {
+      result.keyspace_misses = ToLongLong(value);
+    } else if (field == "evicted_keys") {
+      result.evicted_keys = ToLongLong(value);
+    } else if (field == "slave_repl_offset") {
+      result.repl_offset = ToLongLong(value);
+      has_slave_offset = true;
+    } else if (field == "master_repl_offset" && !has_slave_offset) {
+      result.repl_offset = ToLongLong(value);
+    }
+  }
+
+  if (result.role.empty()) {
+    return false;
+  }
+
+  *sample = result;
+  return true;
+}
+
+ShardStats::ShardStats()
+    : name(),
+      nodes_count(0),
+      ops_per_sec(0),
+      used_memory(0),
+      hit_ratio(-1),
+      replication_lag(0),
+      evictions_per_sec(0),
+      hits_delta(0),
+      misses_delta(0) {}
+
+NodesStatsPoint::NodesStatsPoint() : timestamp(0), total(), shards() {}
+
+NodesStatsSeries::NodeState::NodeState() : current(), hits_delta(0), misses_delta(0), evictions_per_sec(0) {}
+
+NodesStatsSeries::NodesStatsSeries(size_t capacity) : capacity_(capacity ? capacity : 1), nodes_(), points_() {}
+
+void NodesStatsSeries::SetSample(const std::string& node, const NodeInfoSample& sample) {
+  auto it = nodes_.find(node);
+  if (it == nodes_.end()) {
+    NodeState state;
+    state.current = sample;
+    nodes_[node] = state;
+    return;
+  }
+
+  // rates are measured between two samples of the same node, counters reset on restart
+  NodeState& state = it->second;
+  const NodeInfoSample& previous = state.current;
+  const common::time64_t elapsed_msec = sample.timestamp - previous.timestamp;
+  state.hits_delta = Positive(sample.keyspace_hits - previous.keyspace_hits);
+  state.misses_delta = Positive(sample.keyspace_misses - previous.keyspace_misses);
+  state.evictions_per_sec =
+      elapsed_msec > 0 ? Positive(sample.evicted_keys - previous.evicted_keys) * 1000.0 / elapsed_msec : 0;
+  state.current = sample;
+}
+
+void NodesStatsSeries::RemoveNode(const std::string& node) {
+  nodes_.erase(node);
+}
+
+void NodesStatsSeries::Clear() {
+  nodes_.clear();
+  points_.clear();
+}
+
+const NodesStatsPoint& NodesStatsSeries::Aggregate(common::time64_t timestamp) {
+  std::map<std::string, ShardStats> shards;
+  std::map<std::string, long long> master_offsets;
+  for (const auto& node : nodes_) {
+    const NodeInfoSample& sample = node.second.current;
+    if (sample.IsMaster()) {
+      master_offsets[node.first] = sample.repl_offset;
+    }
+  }
+
+  NodesStatsPoint point;
+  point.timestamp = timestamp;
+  point.total.name = "total";
+  for (const auto& node : nodes_) {
+    const NodeState& state = node.second;
+    const NodeInfoSample& sample = state.current;
+    // replicas of an unknown master still form a shard named by the master address
+    const std::string master = sample.IsMaster() ? node.first : sample.GetMasterAddress();
+    ShardStats& shard = shards[master.empty() ? node.first : master];
+    shard.name = master.empty() ? node.first : master;
+    AddNode(sample, &shard);
+    AddNode(sample, &point.total);
+    shard.hits_delta += state.hits_delta;
+    shard.misses_delta += state.misses_delta;
+    shard.evictions_per_sec += state.evictions_per_sec;
+    point.total.hits_delta += state.hits_delta;
+    point.total.misses_delta += state.misses_delta;
+    point.total.evictions_per_sec += state.evictions_per_sec;
+
+    auto master_offset = master_offsets.find(master);
+    if (!sample.IsMaster() && master_offset != master_offsets.end()) {
+      const long long lag = Positive(master_offset->second - sample.repl_offset);
+      shard.replication_lag = std::max(shard.replication_lag, lag);
+      point.total.replication_lag = std::max(point.total.replication_lag, lag);
+    }
+  }
+
+  FinishShard(&point.total);
+  for (auto& shard : shards) {
+    FinishShard(&shard.second);
+    point.shards.push_back(shard.second);
+  }
+  std::stable_sort(point.shards.begin(), point.shards.end(),
+                   [](const ShardStats& left, const ShardStats& right) { return left.ops_per_sec > right.ops_per_sec; });
+
+  points_.push_back(point);
+  while (points_.size() > capacity_) {
+    points_.pop_front();
+  }
+  return points_.back();
+}
+
+const NodesStatsSeries::points_t& NodesStatsSeries::GetPoints() const {
+  return points_;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,109 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <common/types.h>
+
+namespace fastonosql {
+namespace proxy {
+
+// counters of one INFO reply needed by the nodes dashboard
+struct NodeInfoSample {
+  NodeInfoSample();
+
+  bool IsMaster() const;
+  std::string GetMasterAddress() const;  // host:port of master for replicas
+
+  common::time64_t timestamp;
+  std::string role;
+  std::string master_host;
+  std::string master_port;
+  long long ops_per_sec;
+  long long used_memory;
+  long long keyspace_hits;
+  long long keyspace_misses;
+  long long evicted_keys;
+  long long repl_offset;  // master_repl_offset for masters, slave_repl_offset for replicas
+};
+
+bool ParseNodeInfoSample(const std::string& info, common::time64_t timestamp, NodeInfoSample* sample);
+
+// master with its replicas, or the whole set of nodes for the total
+struct ShardStats {
+  ShardStats();
+
+  std::string name;
+  size_t nodes_count;
+  long long ops_per_sec;
+  long long used_memory;
+  double hit_ratio;  // of lookups since the previous sample, -1 without lookups
+  long long replication_lag;  // max bytes a replica is behind its master
+  double evictions_per_sec;
+
+  long long hits_delta;
+  long long misses_delta;
+};
+
+struct NodesStatsPoint {
+  NodesStatsPoint();
+
+  common::time64_t timestamp;
+  ShardStats total;
+  std::vector<ShardStats> shards;  // hottest (by ops/sec) first
+};
+
+// latest sample of every node plus a rolling series of aggregated points,
+// nodes are identified by their host:port as replicas reference masters by it
+class NodesStatsSeries {
+ public:
+  typedef std::deque<NodesStatsPoint> points_t;
+  enum { default_capacity = 3600 };
+
+  explicit NodesStatsSeries(size_t capacity = default_capacity);
+
+  void SetSample(const std::string& node, const NodeInfoSample& sample);
+  void RemoveNode(const std::string& node);
+  void Clear();
+
+  // aggregates the latest samples and appends the point to the series
+  const NodesStatsPoint& Aggregate(common::time64_t timestamp);
+  const points_t& GetPoints() const;
+
+ private:
+  struct NodeState {
+    NodeState();
+
+    NodeInfoSample current;
+    long long hits_delta;
+    long long misses_delta;
+    double evictions_per_sec;
+  };
+
+  const size_t capacity_;
+  std::map<std::string, NodeState> nodes_;
+  points_t points_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
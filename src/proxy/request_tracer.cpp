@@ -0,0 +1,501 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/request_tracer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+
+#include <QThread>
+
+#include <common/file_system/file.h>
+
+#include "proxy/events/events.h"
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+
+const char kBinaryMagic[] = "FNTRACE1";
+const size_t kBinaryMagicSize = sizeof(kBinaryMagic) - 1;
+const size_t kReadChunkSize = 64 * 1024;
+
+// request being handled by current thread, posts and network calls are attributed to it
+thread_local uint64_t current_request_id = 0;
+
+static_assert(sizeof(RequestTracer::Record) == 24, "trace record layout is part of binary format");
+
+#define EVENT_NAME_CASE(req, resp, name) \
+  case events::req::EventType:           \
+  case events::resp::EventType:          \
+    return name
+
+const char* GetEventName(uint16_t type) {
+  switch (type) {
+    EVENT_NAME_CASE(ConnectRequestEvent, ConnectResponseEvent, "connect");
+    EVENT_NAME_CASE(DisconnectRequestEvent, DisconnectResponseEvent, "disconnect");
+    EVENT_NAME_CASE(ExecuteRequestEvent, ExecuteResponseEvent, "execute");
+    EVENT_NAME_CASE(LoadDatabasesInfoRequestEvent, LoadDatabasesInfoResponseEvent, "load databases");
+    EVENT_NAME_CASE(ServerInfoRequestEvent, ServerInfoResponseEvent, "server info");
+    EVENT_NAME_CASE(ServerInfoHistoryRequestEvent, ServerInfoHistoryResponseEvent, "server info history");
+    EVENT_NAME_CASE(ClearServerHistoryRequestEvent, ClearServerHistoryResponseEvent, "clear history");
+    EVENT_NAME_CASE(ServerPropertyInfoRequestEvent, ServerPropertyInfoResponseEvent, "server properties");
+    EVENT_NAME_CASE(ChangeServerPropertyInfoRequestEvent, ChangeServerPropertyInfoResponseEvent,
+                    "change server property");
+    EVENT_NAME_CASE(LoadServerChannelsRequestEvent, LoadServerChannelsResponseEvent, "load channels");
+    EVENT_NAME_CASE(LoadServerClientsRequestEvent, LoadServerClientsResponseEvent, "load clients");
+    EVENT_NAME_CASE(BackupRequestEvent, BackupResponseEvent, "backup");
+    EVENT_NAME_CASE(RestoreRequestEvent, RestoreResponseEvent, "restore");
+    EVENT_NAME_CASE(LoadDatabaseContentRequestEvent, LoadDatabaseContentResponseEvent, "load keys");
+    EVENT_NAME_CASE(DiscoveryInfoRequestEvent, DiscoveryInfoResponseEvent, "discovery");
+    EVENT_NAME_CASE(FindBigKeysRequestEvent, FindBigKeysResponseEvent, "find big keys");
+    EVENT_NAME_CASE(KeysDigestRequestEvent, KeysDigestResponseEvent, "keys digest");
+    EVENT_NAME_CASE(EnterModeEvent, LeaveModeEvent, "mode");
+    EVENT_NAME_CASE(CommandRootCreatedEvent, CommandRootCompleatedEvent, "command root");
+    case events::ProgressResponseEvent::EventType:
+      return "progress";
+    case 0:
+      return "command";
+    default:
+      return "event";
+  }
+}
+
+#undef EVENT_NAME_CASE
+
+std::string EscapeJson(const std::string& str) {
+  std::string result;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      result += ' ';
+    } else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+void WriteCompleteEvent(std::ostream& out,
+                        const char* name,
+                        const char* category,
+                        size_t tid,
+                        const RequestTracer::Record& begin,
+                        uint64_t end_usec) {
+  out << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+      << ",\"ts\":" << begin.timestamp_usec << ",\"dur\":" << end_usec - begin.timestamp_usec
+      << ",\"args\":{\"request\":" << begin.request_id << "}}";
+}
+
+void WriteAsyncEvent(std::ostream& out,
+                     const std::string& name,
+                     const char* category,
+                     uint64_t id,
+                     uint64_t begin_usec,
+                     uint64_t end_usec) {
+  out << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"b\",\"pid\":1,\"id\":" << id
+      << ",\"ts\":" << begin_usec << "}";
+  out << ",\n{\"name\":\"" << name << "\",\"cat\":\"" << category << "\",\"ph\":\"e\",\"pid\":1,\"id\":" << id
+      << ",\"ts\":" << end_usec << "}";
+}
+
+template <typename T>
+void AppendPod(std::string* out, const T& value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool ReadPod(const std::string& data, size_t* pos, T* value) {
+  if (data.size() - *pos < sizeof(T)) {
+    return false;
+  }
+  memcpy(value, data.data() + *pos, sizeof(T));
+  *pos += sizeof(T);
+  return true;
+}
+
+}  // namespace
+
+struct RequestTracer::Buffer {
+  Buffer(const std::string& name, size_t capacity) : mutex(), name(name), ring(capacity), next(0), size(0) {}
+
+  void Append(const Record& record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ring[next] = record;
+    next = (next + 1) % ring.size();
+    size = std::min(size + 1, ring.size());
+  }
+
+  ThreadTrace GetTrace() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    ThreadTrace trace;
+    trace.name = name;
+    trace.records.reserve(size);
+    const size_t first = (next + ring.size() - size) % ring.size();
+    for (size_t i = 0; i < size; ++i) {
+      trace.records.push_back(ring[(first + i) % ring.size()]);
+    }
+    return trace;
+  }
+
+  mutable std::mutex mutex;  // only contended while saving
+  std::string name;
+  std::vector<Record> ring;
+  size_t next;
+  size_t size;
+};
+
+RequestTracer::ScopedHandling::ScopedHandling(const QEvent* event, bool in_driver)
+    : in_driver_(in_driver),
+      event_type_(static_cast<uint16_t>(event->type())),
+      request_id_(0),
+      prev_request_id_(current_request_id),
+      event_seq_(0) {
+  RequestTracer& tracer = RequestTracer::GetInstance();
+  if (!tracer.IsEnabled()) {
+    return;
+  }
+
+  Pending pending;
+  if (tracer.TakePending(event, &pending)) {
+    request_id_ = pending.request_id;
+    event_seq_ = pending.event_seq;
+  } else {
+    request_id_ = ++tracer.last_request_id_;
+  }
+  current_request_id = request_id_;
+  tracer.Stamp(in_driver_ ? DRIVER_BEGIN : GUI_BEGIN, event_type_, request_id_, event_seq_);
+}
+
+RequestTracer::ScopedHandling::~ScopedHandling() {
+  if (!request_id_) {
+    return;
+  }
+
+  RequestTracer::GetInstance().Stamp(in_driver_ ? DRIVER_END : GUI_END, event_type_, request_id_, event_seq_);
+  current_request_id = prev_request_id_;
+}
+
+RequestTracer::ScopedNetwork::ScopedNetwork() {
+  RequestTracer& tracer = RequestTracer::GetInstance();
+  if (tracer.IsEnabled()) {
+    tracer.Stamp(NETWORK_SEND, 0, current_request_id, 0);
+  }
+}
+
+RequestTracer::ScopedNetwork::~ScopedNetwork() {
+  RequestTracer& tracer = RequestTracer::GetInstance();
+  if (tracer.IsEnabled()) {
+    tracer.Stamp(NETWORK_RECEIVE, 0, current_request_id, 0);
+  }
+}
+
+RequestTracer::RequestTracer()
+    : start_(std::chrono::steady_clock::now()),
+      enabled_(false),
+      last_request_id_(0),
+      last_event_seq_(0),
+      records_per_thread_(default_records_per_thread),
+      buffers_mutex_(),
+      buffers_(),
+      pending_mutex_(),
+      pending_() {}
+
+RequestTracer::~RequestTracer() {}
+
+void RequestTracer::Enable(size_t records_per_thread) {
+  records_per_thread_ = std::max<size_t>(records_per_thread, 1);
+  enabled_ = true;
+}
+
+bool RequestTracer::IsEnabled() const {
+  return enabled_;
+}
+
+void RequestTracer::SetThreadName(const std::string& name) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  Buffer* buffer = GetThreadBuffer();
+  std::lock_guard<std::mutex> lock(buffer->mutex);
+  buffer->name = name;
+}
+
+void RequestTracer::TracePost(const QEvent* event, bool reply) {
+  if (!IsEnabled()) {
+    return;
+  }
+
+  // driver replies and progress belong to the request in handling, gui always starts new one
+  Pending pending;
+  pending.request_id = reply && current_request_id ? current_request_id : ++last_request_id_;
+  pending.event_seq = ++last_event_seq_;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_[event] = pending;
+  }
+  Stamp(reply ? REPLY_POSTED : REQUEST_POSTED, static_cast<uint16_t>(event->type()), pending.request_id,
+        pending.event_seq);
+}
+
+bool RequestTracer::TakePending(const QEvent* event, Pending* pending) {
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  auto it = pending_.find(event);
+  if (it == pending_.end()) {
+    return false;
+  }
+
+  *pending = it->second;
+  pending_.erase(it);
+  return true;
+}
+
+RequestTracer::Buffer* RequestTracer::GetThreadBuffer() {
+  static thread_local Buffer* buffer = nullptr;
+  if (buffer) {
+    return buffer;
+  }
+
+  // buffers are never released, records of finished driver threads stay until saving
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  std::string name = "thread " + std::to_string(buffers_.size());
+  if (QThread::currentThread()->objectName().size()) {
+    name = QThread::currentThread()->objectName().toStdString();
+  }
+  buffers_.emplace_back(new Buffer(name, records_per_thread_));
+  buffer = buffers_.back().get();
+  return buffer;
+}
+
+void RequestTracer::Stamp(Stage stage, uint16_t event_type, uint64_t request_id, uint32_t event_seq) {
+  Record record;
+  record.timestamp_usec = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_).count());
+  record.request_id = request_id;
+  record.event_seq = event_seq;
+  record.event_type = event_type;
+  record.stage = stage;
+  record.reserved = 0;
+  GetThreadBuffer()->Append(record);
+}
+
+std::vector<RequestTracer::ThreadTrace> RequestTracer::GetTraces() const {
+  std::lock_guard<std::mutex> lock(buffers_mutex_);
+  std::vector<ThreadTrace> traces;
+  for (const auto& buffer : buffers_) {
+    traces.push_back(buffer->GetTrace());
+  }
+  return traces;
+}
+
+common::Error RequestTracer::SaveBinary(const std::string& path) const {
+  const std::vector<ThreadTrace> traces = GetTraces();
+  std::string data(kBinaryMagic, kBinaryMagicSize);
+  AppendPod(&data, static_cast<uint32_t>(traces.size()));
+  for (const ThreadTrace& trace : traces) {
+    AppendPod(&data, static_cast<uint32_t>(trace.name.size()));
+    data += trace.name;
+    AppendPod(&data, static_cast<uint64_t>(trace.records.size()));
+    data.append(reinterpret_cast<const char*>(trace.records.data()), trace.records.size() * sizeof(Record));
+  }
+
+  common::file_system::FileGuard<common::file_system::ANSIFile> file;
+  common::ErrnoError err = file.Open(path, "wb");
+  if (err) {
+    return common::make_error_from_errno(err);
+  }
+
+  if (!file.Write(data)) {
+    return common::make_error("Failed to write trace file: " + path);
+  }
+  return common::Error();
+}
+
+common::Error RequestTracer::LoadBinary(const std::string& path, std::vector<ThreadTrace>* traces) {
+  if (!traces) {
+    return common::make_error_inval();
+  }
+
+  common::file_system::FileGuard<common::file_system::ANSIFile> file;
+  common::ErrnoError err = file.Open(path, "rb");
+  if (err) {
+    return common::make_error_from_errno(err);
+  }
+
+  std::string data;
+  while (!file.IsEOF()) {
+    std::string chunk;
+    if (!file.Read(&chunk, kReadChunkSize)) {
+      break;
+    }
+    data += chunk;
+  }
+
+  const common::Error invalid = common::make_error("Invalid trace file: " + path);
+  if (data.compare(0, kBinaryMagicSize, kBinaryMagic) != 0) {
+    return invalid;
+  }
+
+  size_t pos = kBinaryMagicSize;
+  uint32_t threads_count = 0;
+  if (!ReadPod(data, &pos, &threads_count)) {
+    return invalid;
+  }
+
+  std::vector<ThreadTrace> result;
+  for (uint32_t i = 0; i < threads_count; ++i) {
+    ThreadTrace trace;
+    uint32_t name_size = 0;
+    if (!ReadPod(data, &pos, &name_size) || data.size() - pos < name_size) {
+      return invalid;
+    }
+    trace.name = data.substr(pos, name_size);
+    pos += name_size;
+
+    uint64_t records_count = 0;
+    if (!ReadPod(data, &pos, &records_count) || (data.size() - pos) / sizeof(Record) < records_count) {
+      return invalid;
+    }
+    trace.records.resize(records_count);
+    memcpy(trace.records.data(), data.data() + pos, records_count * sizeof(Record));
+    pos += records_count * sizeof(Record);
+    result.push_back(trace);
+  }
+
+  *traces = result;
+  return common::Error();
+}
+
+std::string RequestTracer::MakeChromeTrace(const std::vector<ThreadTrace>& traces) {
+  struct RequestSpan {
+    uint64_t begin_usec;
+    uint64_t end_usec;
+    std::string name;
+  };
+
+  std::ostringstream out;
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"" PROJECT_NAME_TITLE "\"}}";
+
+  std::map<uint32_t, Record> posts;  // event seq -> post record
+  std::map<uint64_t, RequestSpan> requests;
+  for (size_t tid = 0; tid < traces.size(); ++tid) {
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid << ",\"args\":{\"name\":\""
+        << EscapeJson(traces[tid].name) << "\"}}";
+
+    std::vector<Record> opened;  // handling may nest when gui spins event loop
+    std::vector<Record> network;
+    for (const Record& record : traces[tid].records) {
+      if (record.request_id) {
+        auto it = requests.find(record.request_id);
+        if (it == requests.end()) {
+          RequestSpan span = {record.timestamp_usec, record.timestamp_usec, GetEventName(record.event_type)};
+          requests[record.request_id] = span;
+        } else {
+          if (record.timestamp_usec < it->second.begin_usec) {
+            it->second.begin_usec = record.timestamp_usec;
+            it->second.name = GetEventName(record.event_type);
+          }
+          it->second.end_usec = std::max(it->second.end_usec, record.timestamp_usec);
+        }
+      }
+
+      switch (record.stage) {
+        case REQUEST_POSTED:
+        case REPLY_POSTED:
+          posts[record.event_seq] = record;
+          break;
+        case DRIVER_BEGIN:
+        case GUI_BEGIN:
+          opened.push_back(record);
+          break;
+        case DRIVER_END:
+        case GUI_END:
+          if (!opened.empty()) {
+            WriteCompleteEvent(out, GetEventName(opened.back().event_type),
+                               opened.back().stage == DRIVER_BEGIN ? "driver" : "gui", tid, opened.back(),
+                               record.timestamp_usec);
+            opened.pop_back();
+          }
+          break;
+        case NETWORK_SEND:
+          network.push_back(record);
+          break;
+        case NETWORK_RECEIVE:
+          if (!network.empty()) {
+            WriteCompleteEvent(out, "network", "network", tid, network.back(), record.timestamp_usec);
+            network.pop_back();
+          }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+
+  // queue wait: from post in one thread to begin of handling in other
+  for (const ThreadTrace& trace : traces) {
+    for (const Record& record : trace.records) {
+      if ((record.stage != DRIVER_BEGIN && record.stage != GUI_BEGIN) || !record.event_seq) {
+        continue;
+      }
+
+      auto post = posts.find(record.event_seq);
+      if (post != posts.end()) {
+        WriteAsyncEvent(out, std::string("queue ") + GetEventName(record.event_type), "queue", record.event_seq,
+                        post->second.timestamp_usec, record.timestamp_usec);
+      }
+    }
+  }
+
+  for (const auto& request : requests) {
+    WriteAsyncEvent(out, "request " + request.second.name, "request", request.first, request.second.begin_usec,
+                    request.second.end_usec);
+  }
+
+  out << "\n]}\n";
+  return out.str();
+}
+
+common::Error RequestTracer::ExportChromeTrace(const std::string& binary_path, const std::string& json_path) {
+  std::vector<ThreadTrace> traces;
+  common::Error err = LoadBinary(binary_path, &traces);
+  if (err) {
+    return err;
+  }
+
+  common::file_system::FileGuard<common::file_system::ANSIFile> file;
+  common::ErrnoError errn = file.Open(json_path, "wb");
+  if (errn) {
+    return common::make_error_from_errno(errn);
+  }
+
+  if (!file.Write(MakeChromeTrace(traces))) {
+    return common::make_error("Failed to write trace file: " + json_path);
+  }
+  return common::Error();
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,140 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <QEvent>
+
+#include <common/error.h>
+#include <common/macros.h>
+#include <common/patterns/singleton_pattern.h>
+
+namespace fastonosql {
+namespace proxy {
+
+// opt-in (--trace-requests) timeline of gui <-> driver events: every thread appends
+// fixed size records into own ring buffer, buffers are saved as binary file and
+// converted into chrome trace json (chrome://tracing, ui.perfetto.dev) offline
+class RequestTracer : public common::patterns::LazySingleton<RequestTracer> {
+ public:
+  friend class common::patterns::LazySingleton<RequestTracer>;
+
+  enum Stage : uint8_t {
+    REQUEST_POSTED = 0,  // gui -> driver postEvent
+    DRIVER_BEGIN,        // IDriver::customEvent
+    DRIVER_END,
+    NETWORK_SEND,  // IDriver::Execute
+    NETWORK_RECEIVE,
+    REPLY_POSTED,  // driver -> gui postEvent
+    GUI_BEGIN,     // IServer::customEvent
+    GUI_END
+  };
+
+  struct Record {
+    uint64_t timestamp_usec;  // since tracer creation
+    uint64_t request_id;
+    uint32_t event_seq;  // pairs post with handling of the same event
+    uint16_t event_type;
+    uint8_t stage;
+    uint8_t reserved;
+  };
+
+  struct ThreadTrace {
+    std::string name;
+    std::vector<Record> records;  // oldest first
+  };
+
+  enum { default_records_per_thread = 1 << 16 };
+
+  // stamps handling of posted event, nested posts and network calls belong to its request
+  class ScopedHandling {
+   public:
+    ScopedHandling(const QEvent* event, bool in_driver);
+    ~ScopedHandling();
+
+   private:
+    const bool in_driver_;
+    const uint16_t event_type_;
+    uint64_t request_id_;
+    uint64_t prev_request_id_;
+    uint32_t event_seq_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedHandling);
+  };
+
+  class ScopedNetwork {
+   public:
+    ScopedNetwork();
+    ~ScopedNetwork();
+
+   private:
+    DISALLOW_COPY_AND_ASSIGN(ScopedNetwork);
+  };
+
+  void Enable(size_t records_per_thread = default_records_per_thread);
+  bool IsEnabled() const;
+
+  void SetThreadName(const std::string& name);  // for calling thread
+
+  void TracePost(const QEvent* event, bool reply);
+
+  std::vector<ThreadTrace> GetTraces() const;
+  common::Error SaveBinary(const std::string& path) const WARN_UNUSED_RESULT;
+
+  static common::Error LoadBinary(const std::string& path, std::vector<ThreadTrace>* traces) WARN_UNUSED_RESULT;
+  static std::string MakeChromeTrace(const std::vector<ThreadTrace>& traces);
+  static common::Error ExportChromeTrace(const std::string& binary_path,
+                                         const std::string& json_path) WARN_UNUSED_RESULT;
+
+ private:
+  struct Buffer;
+  struct Pending {
+    uint64_t request_id;
+    uint32_t event_seq;
+  };
+
+  RequestTracer();
+  ~RequestTracer();
+
+  Buffer* GetThreadBuffer();
+  void Stamp(Stage stage, uint16_t event_type, uint64_t request_id, uint32_t event_seq);
+  bool TakePending(const QEvent* event, Pending* pending);
+
+  const std::chrono::steady_clock::time_point start_;
+  std::atomic<bool> enabled_;
+  std::atomic<uint64_t> last_request_id_;
+  std::atomic<uint32_t> last_event_seq_;
+  size_t records_per_thread_;
+
+  mutable std::mutex buffers_mutex_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+
+  std::mutex pending_mutex_;
+  std::unordered_map<const QEvent*, Pending> pending_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
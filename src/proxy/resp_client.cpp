@@ -0,0 +1,320 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/resp_client.h"
+
+#if defined(OS_WIN)
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
+#include <common/convert2string.h>
+#include <common/time.h>
+
+#include "proxy/connection_settings/iconnection_settings_ssh.h"
+
+#if defined(BUILD_WITH_REDIS)
+#include "proxy/db/redis/connection_settings.h"
+#endif
+
+#if defined(BUILD_WITH_PIKA)
+#include "proxy/db/pika/connection_settings.h"
+#endif
+
+#if defined(BUILD_WITH_DYNOMITE)
+#include "proxy/db/dynomite/connection_settings.h"
+#endif
+
+#if defined(BUILD_WITH_KEYDB)
+#include "proxy/db/keydb/connection_settings.h"
+#endif
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+const size_t kReadChunkSize = 16 * 1024;
+}  // namespace
+
+std::string MakeRespCommand(const std::vector<std::string>& args) {
+  std::string command = "*" + common::ConvertToString(args.size()) + "\r\n";
+  for (const std::string& arg : args) {
+    command += "$" + common::ConvertToString(arg.size()) + "\r\n" + arg + "\r\n";
+  }
+  return command;
+}
+
+bool GetRespEndpoint(IConnectionSettingsBaseSPtr settings, common::net::HostAndPort* host, std::string* auth) {
+  if (!settings || !host || !auth) {
+    DNOTREACHED();
+    return false;
+  }
+
+  IConnectionSettingsRemoteSSH* ssh = dynamic_cast<IConnectionSettingsRemoteSSH*>(settings.get());
+  if (ssh && ssh->GetSSHInfo().IsValid()) {
+    return false;
+  }
+
+  const core::ConnectionType connection_type = settings->GetType();
+#if defined(BUILD_WITH_REDIS)
+  if (connection_type == core::REDIS) {
+    core::redis::Config config = static_cast<redis::ConnectionSettings*>(settings.get())->GetInfo();
+    if (config.is_ssl || !config.hostsocket.empty()) {
+      return false;
+    }
+    *host = config.host;
+    *auth = config.auth;
+    return true;
+  }
+#endif
+#if defined(BUILD_WITH_PIKA)
+  if (connection_type == core::PIKA) {
+    core::pika::Config config = static_cast<pika::ConnectionSettings*>(settings.get())->GetInfo();
+    if (config.is_ssl) {
+      return false;
+    }
+    *host = config.host;
+    *auth = config.auth;
+    return true;
+  }
+#endif
+#if defined(BUILD_WITH_DYNOMITE)
+  if (connection_type == core::DYNOMITE) {
+    core::dynomite::Config config = static_cast<dynomite::ConnectionSettings*>(settings.get())->GetInfo();
+    if (config.is_ssl) {
+      return false;
+    }
+    *host = config.host;
+    *auth = config.auth;
+    return true;
+  }
+#endif
+#if defined(BUILD_WITH_KEYDB)
+  if (connection_type == core::KEYDB) {
+    core::keydb::Config config = static_cast<keydb::ConnectionSettings*>(settings.get())->GetInfo();
+    if (config.is_ssl || !config.hostsocket.empty()) {
+      return false;
+    }
+    *host = config.host;
+    *auth = config.auth;
+    return true;
+  }
+#endif
+
+  UNUSED(connection_type);
+  return false;
+}
+
+bool GetTlsEndpoint(IConnectionSettingsBaseSPtr settings, common::net::HostAndPort* host) {
+  if (!settings || !host) {
+    DNOTREACHED();
+    return false;
+  }
+
+  IConnectionSettingsRemoteSSH* ssh = dynamic_cast<IConnectionSettingsRemoteSSH*>(settings.get());
+  if (ssh && ssh->GetSSHInfo().IsValid()) {
+    return false;
+  }
+
+  const core::ConnectionType connection_type = settings->GetType();
+#if defined(BUILD_WITH_REDIS)
+  if (connection_type == core::REDIS) {
+    core::redis::Config config = static_cast<redis::ConnectionSettings*>(settings.get())->GetInfo();
+    if (!config.is_ssl) {
+      return false;
+    }
+    *host = config.host;
+    return true;
+  }
+#endif
+#if defined(BUILD_WITH_PIKA)
+  if (connection_type == core::PIKA) {
+    core::pika::Config config = static_cast<pika::ConnectionSettings*>(settings.get())->GetInfo();
+    if (!config.is_ssl) {
+      return false;
+    }
+    *host = config.host;
+    return true;
+  }
+#endif
+#if defined(BUILD_WITH_DYNOMITE)
+  if (connection_type == core::DYNOMITE) {
+    core::dynomite::Config config = static_cast<dynomite::ConnectionSettings*>(settings.get())->GetInfo();
+    if (!config.is_ssl) {
+      return false;
+    }
+    *host = config.host;
+    return true;
+  }
+#endif
+#if defined(BUILD_WITH_KEYDB)
+  if (connection_type == core::KEYDB) {
+    core::keydb::Config config = static_cast<keydb::ConnectionSettings*>(settings.get())->GetInfo();
+    if (!config.is_ssl) {
+      return false;
+    }
+    *host = config.host;
+    return true;
+  }
+#endif
+
+  UNUSED(connection_type);
+  return false;
+}
+
+RespClient::RespClient(const common::net::HostAndPort& host, const std::string& auth, common::time64_t timeout_msec)
+    : host_(host), auth_(auth), timeout_msec_(timeout_msec), socket_(), reader_() {}
+
+RespClient::~RespClient() {
+  Disconnect();
+}
+
+common::Error RespClient::Connect() {
+  Disconnect();
+
+  std::unique_ptr<socket_t> socket(new socket_t(host_));
+  struct timeval tv;
+  tv.tv_sec = timeout_msec_ / 1000;
+  tv.tv_usec = (timeout_msec_ % 1000) * 1000;
+  common::ErrnoError errn = socket->Connect(&tv);
+  if (errn) {
+    return common::make_error_from_errno(errn);
+  }
+  socket_ = std::move(socket);
+
+  if (auth_.empty()) {
+    return common::Error();
+  }
+
+  RespReply reply;
+  common::Error err = Execute({"AUTH", auth_}, &reply);
+  if (err) {
+    Disconnect();
+    return err;
+  }
+  return common::Error();
+}
+
+void RespClient::Disconnect() {
+  socket_.reset();
+  reader_ = RespReader();
+}
+
+bool RespClient::IsConnected() const {
+  return socket_ != nullptr;
+}
+
+common::Error RespClient::Execute(const std::vector<std::string>& args, RespReply* reply) {
+  if (!reply) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  if (!socket_) {
+    return common::make_error("Not connected");
+  }
+
+  // a late reply of a timed out command would be taken for the answer to the next one
+  const common::time64_t deadline = common::time::current_utc_mstime() + timeout_msec_;
+  common::Error err = Write(MakeRespCommand(args), deadline);
+  if (!err) {
+    err = Read(reply, deadline);
+  }
+  if (err) {
+    Disconnect();
+    return err;
+  }
+
+  if (reply->type == RespReply::ERROR_REPLY) {
+    return common::make_error(reply->str);
+  }
+  return common::Error();
+}
+
+common::Error RespClient::Wait(bool for_write, common::time64_t deadline) {
+  const common::time64_t left = deadline - common::time::current_utc_mstime();
+  if (left <= 0) {
+    return common::make_error("Operation timed out");
+  }
+
+  fd_set set;
+  const auto fd = socket_->GetFd();
+  FD_ZERO(&set);
+  FD_SET(fd, &set);
+  struct timeval wait;
+  wait.tv_sec = left / 1000;
+  wait.tv_usec = (left % 1000) * 1000;
+  const int ready = for_write ? select(static_cast<int>(fd) + 1, nullptr, &set, nullptr, &wait)
+                              : select(static_cast<int>(fd) + 1, &set, nullptr, nullptr, &wait);
+  if (ready < 0) {
+    return common::make_error("Socket wait failed");
+  }
+  if (ready == 0) {
+    return common::make_error("Operation timed out");
+  }
+  return common::Error();
+}
+
+common::Error RespClient::Write(const std::string& data, common::time64_t deadline) {
+  size_t total = 0;
+  while (total < data.size()) {
+    common::Error err = Wait(true, deadline);
+    if (err) {
+      return err;
+    }
+
+    size_t nwrite = 0;
+    common::ErrnoError errn = socket_->Write(data.data() + total, data.size() - total, &nwrite);
+    if (errn) {
+      return common::make_error_from_errno(errn);
+    }
+    total += nwrite;
+  }
+  return common::Error();
+}
+
+common::Error RespClient::Read(RespReply* reply, common::time64_t deadline) {
+  while (true) {
+    const RespReader::Status status = reader_.Next(reply);
+    if (status == RespReader::REPLY_READY) {
+      return common::Error();
+    }
+    if (status == RespReader::PROTOCOL_ERROR) {
+      return common::make_error("Invalid reply");
+    }
+
+    common::Error err = Wait(false, deadline);
+    if (err) {
+      return err;
+    }
+
+    common::char_buffer_t chunk;
+    common::ErrnoError errn = socket_->ReadToBuffer(&chunk, kReadChunkSize);
+    if (errn) {
+      return common::make_error_from_errno(errn);
+    }
+    if (chunk.empty()) {
+      return common::make_error("Connection closed by server");
+    }
+    reader_.Feed(chunk.data(), chunk.size());
+  }
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
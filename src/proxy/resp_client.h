@@ -0,0 +1,72 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <common/error.h>
+#include <common/net/socket_tcp.h>
+
+#include "proxy/connection_settings/iconnection_settings.h"
+#include "proxy/resp_reader.h"
+
+namespace fastonosql {
+namespace proxy {
+
+std::string MakeRespCommand(const std::vector<std::string>& args);
+
+// plain tcp endpoint of redis compatible connection, false for ssh tunnels, tls and unix sockets
+bool GetRespEndpoint(IConnectionSettingsBaseSPtr settings, common::net::HostAndPort* host, std::string* auth);
+// tls endpoint of redis compatible connection, false for plain tcp and ssh tunnels
+bool GetTlsEndpoint(IConnectionSettingsBaseSPtr settings, common::net::HostAndPort* host);
+
+// blocking redis protocol client for short service requests, connect and every command
+// are limited by timeout, unlike the core connection which waits for the server forever
+class RespClient {
+ public:
+  RespClient(const common::net::HostAndPort& host, const std::string& auth, common::time64_t timeout_msec);
+  ~RespClient();
+
+  // sends AUTH if password is set
+  common::Error Connect() WARN_UNUSED_RESULT;
+  void Disconnect();
+  bool IsConnected() const;
+
+  // server error replies are returned as errors
+  common::Error Execute(const std::vector<std::string>& args, RespReply* reply) WARN_UNUSED_RESULT;
+
+ private:
+  typedef common::net::SocketGuard<common::net::ClientSocketTcp> socket_t;
+
+  // until socket is ready or deadline passes
+  common::Error Wait(bool for_write, common::time64_t deadline);
+  common::Error Write(const std::string& data, common::time64_t deadline);
+  common::Error Read(RespReply* reply, common::time64_t deadline);
+
+  const common::net::HostAndPort host_;
+  const std::string auth_;
+  const common::time64_t timeout_msec_;
+  std::unique_ptr<socket_t> socket_;
+  RespReader reader_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,158 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/resp_reader.h"
+
+#include <stdlib.h>
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+bool ParseLength(const std::string& str, long long* out) {
+  if (str.empty()) {
+    return false;
+  }
+
+  char* end = nullptr;
+  const long long value = strtoll(str.c_str(), &end, 10);
+  if (*end != '\0') {
+    return false;
+  }
+
+  *out = value;
+  return true;
+}
+}  // namespace
+
+RespReply::RespReply() : type(NIL), str(), elements() {}
+
+RespReader::RespReader() : buffer_(), pos_(0) {}
+
+void RespReader::Feed(const char* data, size_t size) {
+  if (pos_ != 0) {
+    buffer_.erase(0, pos_);
+    pos_ = 0;
+  }
+  buffer_.append(data, size);
+}
+
+RespReader::Status RespReader::Next(RespReply* reply) {
+  size_t pos = pos_;
+  RespReply result;
+  const Status status = Parse(&pos, 0, &result);
+  if (status == REPLY_READY) {
+    pos_ = pos;
+    *reply = result;
+  }
+  return status;
+}
+
+bool RespReader::ReadLine(size_t* pos, std::string* line) const {
+  const size_t end = buffer_.find("\r\n", *pos);
+  if (end == std::string::npos) {
+    return false;
+  }
+
+  line->assign(buffer_, *pos, end - *pos);
+  *pos = end + 2;
+  return true;
+}
+
+RespReader::Status RespReader::Parse(size_t* pos, size_t depth, RespReply* reply) const {
+  if (depth > max_nesting) {
+    return PROTOCOL_ERROR;
+  }
+
+  if (*pos >= buffer_.size()) {
+    return NEED_MORE;
+  }
+
+  const char prefix = buffer_[*pos];
+  size_t cur = *pos + 1;
+  std::string line;
+  if (!ReadLine(&cur, &line)) {
+    return NEED_MORE;
+  }
+
+  switch (prefix) {
+    case '+':
+      reply->type = RespReply::STRING;
+      reply->str = line;
+      break;
+    case '-':
+      reply->type = RespReply::ERROR_REPLY;
+      reply->str = line;
+      break;
+    case ':':
+      reply->type = RespReply::INTEGER;
+      reply->str = line;
+      break;
+    case '$': {
+      long long size = 0;
+      if (!ParseLength(line, &size) || size < -1 || size > max_bulk_size) {
+        return PROTOCOL_ERROR;
+      }
+
+      if (size == -1) {
+        reply->type = RespReply::NIL;
+        break;
+      }
+
+      const size_t bulk_size = static_cast<size_t>(size);
+      if (buffer_.size() < cur + bulk_size + 2) {
+        return NEED_MORE;
+      }
+
+      reply->type = RespReply::STRING;
+      reply->str.assign(buffer_, cur, bulk_size);
+      cur += bulk_size + 2;
+      break;
+    }
+    case '*': {
+      long long count = 0;
+      if (!ParseLength(line, &count) || count < -1) {
+        return PROTOCOL_ERROR;
+      }
+
+      if (count == -1) {
+        reply->type = RespReply::NIL;
+        break;
+      }
+
+      reply->type = RespReply::ARRAY;
+      for (long long i = 0; i < count; ++i) {
+        RespReply element;
+        const Status status = Parse(&cur, depth + 1, &element);
+        if (status != REPLY_READY) {
+          return status;
+        }
+        reply->elements.push_back(element);
+      }
+      break;
+    }
+    default:
+      return PROTOCOL_ERROR;
+  }
+
+  *pos = cur;
+  return REPLY_READY;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,57 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace fastonosql {
+namespace proxy {
+
+struct RespReply {
+  enum Type { STRING, ERROR_REPLY, INTEGER, NIL, ARRAY };
+
+  RespReply();
+
+  Type type;
+  std::string str;  // value of simple, bulk, error and integer replies
+  std::vector<RespReply> elements;
+};
+
+// incremental parser of redis protocol, data may arrive in arbitrary chunks
+class RespReader {
+ public:
+  enum Status { REPLY_READY, NEED_MORE, PROTOCOL_ERROR };
+  enum { max_bulk_size = 512 * 1024 * 1024, max_nesting = 8 };
+
+  RespReader();
+
+  void Feed(const char* data, size_t size);
+  Status Next(RespReply* reply);
+
+ private:
+  Status Parse(size_t* pos, size_t depth, RespReply* reply) const;
+  bool ReadLine(size_t* pos, std::string* line) const;
+
+  std::string buffer_;
+  size_t pos_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -20,10 +20,12 @@
 
 #include <string>
 
+#include "proxy/sentinel/sentinel_watcher.h"
+
 namespace fastonosql {
 namespace proxy {
 
-ISentinel::ISentinel(const std::string& name) : name_(name), sentinels_() {}
+ISentinel::ISentinel(const std::string& name) : name_(name), sentinels_(), watcher_(new SentinelWatcher(this)) {}
 
 std::string ISentinel::GetName() const {
   return name_;
@@ -37,5 +39,17 @@ ISentinel::sentinels_t ISentinel::GetSentinels() const {
   return sentinels_;
 }
 
+void ISentinel::StartWatch() {
+  watcher_->Start(sentinels_);
+}
+
+void ISentinel::StopWatch() {
+  watcher_->Stop();
+}
+
+SentinelWatcher* ISentinel::GetWatcher() const {
+  return watcher_;
+}
+
 }  // namespace proxy
 }  // namespace fastonosql
@@ -27,6 +27,8 @@
 namespace fastonosql {
 namespace proxy {
 
+class SentinelWatcher;
+
 struct Sentinel {
   typedef std::vector<IServerSPtr> nodes_t;
 
@@ -44,12 +46,17 @@ class ISentinel : public IServerBase {
   void AddSentinel(sentinel_t root);
   sentinels_t GetSentinels() const;
 
+  void StartWatch();  // follow failovers of added sentinels
+  void StopWatch();
+  SentinelWatcher* GetWatcher() const;
+
  protected:
   explicit ISentinel(const std::string& name);
 
  private:
   const std::string name_;
   sentinels_t sentinels_;
+  SentinelWatcher* const watcher_;
 };
 
 }  // namespace proxy
@@ -0,0 +1,488 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/sentinel/sentinel_watcher.h"
+
+#if defined(OS_WIN)
+#include <winsock2.h>
+#else
+#include <sys/select.h>
+#endif
+
+#include <algorithm>
+#include <sstream>
+
+#include <QThread>
+
+#include <common/convert2string.h>
+#include <common/logger.h>
+#include <common/net/socket_tcp.h>
+#include <common/time.h>
+
+#include "proxy/resp_client.h"
+#include "proxy/server/iserver_remote.h"
+
+#define SENTINEL_SWITCH_MASTER_CHANNEL "+switch-master"
+#define SENTINEL_SDOWN_CHANNEL "+sdown"
+#define SENTINEL_SDOWN_CLEARED_CHANNEL "-sdown"
+#define SENTINEL_ODOWN_CHANNEL "+odown"
+#define SENTINEL_ODOWN_CLEARED_CHANNEL "-odown"
+
+namespace fastonosql {
+namespace proxy {
+
+namespace {
+
+typedef common::net::SocketGuard<common::net::ClientSocketTcp> ClientSocket;
+const size_t kReadChunkSize = 16 * 1024;
+
+std::string MakeAddress(const std::string& host, const std::string& port) {
+  return host + ":" + port;
+}
+
+std::string MakeAddress(const common::net::HostAndPort& host) {
+  return MakeAddress(host.GetHost(), common::ConvertToString(host.GetPort()));
+}
+
+std::vector<std::string> SplitWords(const std::string& payload) {
+  std::vector<std::string> words;
+  std::istringstream stream(payload);
+  std::string word;
+  while (stream >> word) {
+    words.push_back(word);
+  }
+  return words;
+}
+
+}  // namespace
+
+SentinelEvent::SentinelEvent() : type(DOWN_CLEARED), is_master(false), master_name(), address(), new_address() {}
+
+bool ParseSentinelEvent(const std::string& channel, const std::string& payload, SentinelEvent* event) {
+  if (!event) {
+    return false;
+  }
+
+  const std::vector<std::string> words = SplitWords(payload);
+  SentinelEvent result;
+  if (channel == SENTINEL_SWITCH_MASTER_CHANNEL) {
+    // <master name> <oldip> <oldport> <newip> <newport>
+    if (words.size() < 5) {
+      return false;
+    }
+
+    result.type = SentinelEvent::SWITCH_MASTER;
+    result.is_master = true;
+    result.master_name = words[0];
+    result.address = MakeAddress(words[1], words[2]);
+    result.new_address = MakeAddress(words[3], words[4]);
+    *event = result;
+    return true;
+  }
+
+  if (channel == SENTINEL_SDOWN_CHANNEL) {
+    result.type = SentinelEvent::SUBJECTIVE_DOWN;
+  } else if (channel == SENTINEL_ODOWN_CHANNEL) {
+    result.type = SentinelEvent::OBJECTIVE_DOWN;
+  } else if (channel == SENTINEL_SDOWN_CLEARED_CHANNEL || channel == SENTINEL_ODOWN_CLEARED_CHANNEL) {
+    result.type = SentinelEvent::DOWN_CLEARED;
+  } else {
+    return false;
+  }
+
+  // <instance type> <name> <ip> <port> [@ <master name> <master ip> <master port>]
+  if (words.size() < 4) {
+    return false;
+  }
+
+  result.is_master = words[0] == "master";
+  result.address = MakeAddress(words[2], words[3]);
+  if (result.is_master) {
+    result.master_name = words[1];
+  } else if (words.size() >= 6 && words[4] == "@") {
+    result.master_name = words[5];
+  }
+  *event = result;
+  return true;
+}
+
+SentinelFailoverInfo::SentinelFailoverInfo()
+    : master_name(), old_address(), new_address(), detection_msec(-1), reconnect_msec(0), rerouted_count(0), err() {}
+
+SentinelListener::SentinelListener(const common::net::HostAndPort& host, const std::string& auth, QObject* parent)
+    : QObject(parent), host_(host), auth_(auth), stop_(false) {}
+
+void SentinelListener::Stop() {
+  stop_ = true;
+}
+
+void SentinelListener::Routine() {
+  while (!stop_) {
+    common::Error err = Listen();
+    if (stop_) {
+      break;
+    }
+
+    if (err) {
+      WARNING_LOG() << "Sentinel " << MakeAddress(host_) << " subscription lost: " << err->GetDescription();
+    }
+    for (int i = 0; i < reconnect_delay_msec / poll_interval_msec && !stop_; ++i) {
+      QThread::msleep(poll_interval_msec);
+    }
+  }
+  emit Finished();
+}
+
+common::Error SentinelListener::Listen() {
+  ClientSocket client(host_);
+  struct timeval tv;
+  tv.tv_sec = connect_timeout_sec;
+  tv.tv_usec = 0;
+  common::ErrnoError errn = client.Connect(&tv);
+  if (errn) {
+    return common::make_error_from_errno(errn);
+  }
+
+  std::string request;
+  if (!auth_.empty()) {
+    request += MakeRespCommand({"AUTH", auth_});
+  }
+  request += MakeRespCommand({"SUBSCRIBE", SENTINEL_SWITCH_MASTER_CHANNEL, SENTINEL_SDOWN_CHANNEL,
+                              SENTINEL_SDOWN_CLEARED_CHANNEL, SENTINEL_ODOWN_CHANNEL, SENTINEL_ODOWN_CLEARED_CHANNEL});
+  size_t total = 0;
+  while (total < request.size()) {
+    size_t nwrite = 0;
+    errn = client.Write(request.data() + total, request.size() - total, &nwrite);
+    if (errn) {
+      return common::make_error_from_errno(errn);
+    }
+    total += nwrite;
+  }
+
+  RespReader reader;
+  const auto fd = client.GetFd();
+  while (!stop_) {
+    // short waits instead of blocking read, so Stop() is noticed without closing the socket from other thread
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    FD_SET(fd, &read_set);
+    struct timeval wait;
+    wait.tv_sec = 0;
+    wait.tv_usec = poll_interval_msec * 1000;
+    const int ready = select(static_cast<int>(fd) + 1, &read_set, nullptr, nullptr, &wait);
+    if (ready < 0) {
+      return common::make_error("Sentinel socket wait failed");
+    }
+    if (ready == 0) {
+      continue;
+    }
+
+    common::char_buffer_t chunk;
+    errn = client.ReadToBuffer(&chunk, kReadChunkSize);
+    if (errn) {
+      return common::make_error_from_errno(errn);
+    }
+    if (chunk.empty()) {
+      return common::make_error("Connection closed by sentinel");
+    }
+
+    reader.Feed(chunk.data(), chunk.size());
+    RespReply reply;
+    RespReader::Status status;
+    while ((status = reader.Next(&reply)) == RespReader::REPLY_READY) {
+      if (reply.type == RespReply::ERROR_REPLY) {
+        return common::make_error(reply.str);
+      }
+
+      if (reply.type == RespReply::ARRAY && reply.elements.size() == 3 && reply.elements[0].str == "message") {
+        emit MessageReceived(QString::fromStdString(reply.elements[1].str),
+                             QString::fromStdString(reply.elements[2].str));
+      }
+    }
+
+    if (status == RespReader::PROTOCOL_ERROR) {
+      return common::make_error("Invalid sentinel reply");
+    }
+  }
+  return common::Error();
+}
+
+SentinelWatcher::SentinelWatcher(QObject* parent)
+    : QObject(parent), listeners_(), nodes_(), down_since_(), applied_(), failovers_(), queued_() {}
+
+SentinelWatcher::~SentinelWatcher() {
+  Stop();
+}
+
+void SentinelWatcher::Start(const ISentinel::sentinels_t& sentinels) {
+  Stop();
+
+  for (const Sentinel& sent : sentinels) {
+    for (const IServerSPtr& node : sent.sentinels_nodes) {
+      if (std::find(nodes_.begin(), nodes_.end(), node) != nodes_.end()) {
+        continue;
+      }
+
+      nodes_.push_back(node);
+      VERIFY(connect(node.get(), &IServer::DisconnectFinished, this, &SentinelWatcher::HandleDisconnectFinished));
+      VERIFY(connect(node.get(), &IServer::ConnectFinished, this, &SentinelWatcher::HandleConnectFinished));
+    }
+
+    common::net::HostAndPort host;
+    std::string auth;
+    // raw subscription can't go through ssh tunnels, tls or unix sockets
+    if (!sent.sentinel || !GetRespEndpoint(sent.sentinel->CloneSettings(), &host, &auth)) {
+      const std::string name = sent.sentinel ? sent.sentinel->GetName() : std::string();
+      WARNING_LOG() << "Failover tracking isn't available for sentinel " << name
+                    << ", only direct tcp connections can be subscribed.";
+      continue;
+    }
+
+    QThread* thread = new QThread;
+    SentinelListener* listener = new SentinelListener(host, auth);
+    listener->moveToThread(thread);
+    VERIFY(connect(thread, &QThread::started, listener, &SentinelListener::Routine));
+    VERIFY(connect(listener, &SentinelListener::MessageReceived, this, &SentinelWatcher::HandleMessage));
+    VERIFY(connect(listener, &SentinelListener::Finished, thread, &QThread::quit));
+    VERIFY(connect(thread, &QThread::finished, listener, &SentinelListener::deleteLater));
+    VERIFY(connect(thread, &QThread::finished, thread, &QThread::deleteLater));
+    listeners_.push_back(listener);
+    thread->start();
+  }
+}
+
+void SentinelWatcher::Stop() {
+  // a listener may be inside connect for up to connect_timeout_sec, it finishes
+  // and deletes itself with its thread instead of being waited for here
+  for (SentinelListener* listener : listeners_) {
+    disconnect(listener, &SentinelListener::MessageReceived, this, &SentinelWatcher::HandleMessage);
+    listener->Stop();
+  }
+  listeners_.clear();
+
+  for (const IServerSPtr& node : nodes_) {
+    disconnect(node.get(), nullptr, this, nullptr);
+  }
+  nodes_.clear();
+  down_since_.clear();
+  applied_.clear();
+  failovers_.clear();
+  queued_.clear();
+}
+
+bool SentinelWatcher::IsRunning() const {
+  return !listeners_.empty();
+}
+
+void SentinelWatcher::HandleMessage(const QString& channel, const QString& payload) {
+  // messages queued before Stop
+  if (std::find(listeners_.begin(), listeners_.end(), sender()) == listeners_.end()) {
+    return;
+  }
+
+  SentinelEvent event;
+  if (!ParseSentinelEvent(channel.toStdString(), payload.toStdString(), &event) || !event.is_master) {
+    return;
+  }
+
+  if (event.type == SentinelEvent::SWITCH_MASTER) {
+    HandleSwitchMaster(event);
+    return;
+  }
+
+  if (event.type == SentinelEvent::DOWN_CLEARED) {
+    down_since_.erase(event.master_name);
+    return;
+  }
+
+  // every sentinel reports sdown, the first one starts the detection clock
+  if (down_since_.find(event.master_name) == down_since_.end()) {
+    down_since_[event.master_name] = common::time::current_utc_mstime();
+    WARNING_LOG() << "Sentinel reports master " << event.master_name << " (" << event.address << ") down.";
+    emit MasterDown(event.master_name, event.address);
+  }
+}
+
+void SentinelWatcher::HandleSwitchMaster(const SentinelEvent& event) {
+  auto applied = applied_.find(event.master_name);
+  if (applied != applied_.end() && applied->second == event.new_address) {
+    return;
+  }
+  applied_[event.master_name] = event.new_address;
+
+  if (failovers_.find(event.master_name) != failovers_.end()) {
+    // nodes of the running reroute still move to the previous address, they follow this switch after that
+    queued_[event.master_name].push_back(event);
+    return;
+  }
+
+  StartFailover(event);
+}
+
+void SentinelWatcher::StartFailover(const SentinelEvent& event) {
+  const size_t colon = event.new_address.rfind(':');
+  uint16_t port = 0;
+  if (colon == std::string::npos || !common::ConvertFromString(event.new_address.substr(colon + 1), &port)) {
+    return;
+  }
+
+  const common::time64_t now = common::time::current_utc_mstime();
+  Failover failover;
+  failover.info.master_name = event.master_name;
+  failover.info.old_address = event.address;
+  failover.info.new_address = event.new_address;
+  auto down = down_since_.find(event.master_name);
+  if (down != down_since_.end()) {
+    failover.info.detection_msec = now - down->second;
+    down_since_.erase(down);
+  }
+  failover.new_host = common::net::HostAndPort(event.new_address.substr(0, colon), port);
+  failover.switch_msec = now;
+
+  for (const IServerSPtr& node : nodes_) {
+    IServerRemote* remote = dynamic_cast<IServerRemote*>(node.get());
+    if (!remote || MakeAddress(remote->GetHost()) != event.address) {
+      continue;
+    }
+
+    failover.info.rerouted_count++;
+    if (node->IsConnected()) {
+      failover.pending.push_back(node);
+    } else {
+      remote->SetHost(failover.new_host);
+    }
+  }
+
+  failovers_[event.master_name] = failover;
+  for (const IServerSPtr& node : failover.pending) {
+    events_info::DisConnectInfoRequest req(this);
+    node->Disconnect(req);
+  }
+
+  if (failover.pending.empty()) {
+    FinishFailover(event.master_name);
+  }
+}
+
+SentinelWatcher::Failover* SentinelWatcher::FindFailover(IServer* server, std::string* master_name) {
+  for (auto& failover : failovers_) {
+    for (const IServerSPtr& node : failover.second.pending) {
+      if (node.get() == server) {
+        *master_name = failover.first;
+        return &failover.second;
+      }
+    }
+  }
+  return nullptr;
+}
+
+void SentinelWatcher::RemovePending(Failover* failover, IServer* server) {
+  auto it = std::find_if(failover->pending.begin(), failover->pending.end(),
+                         [server](const IServerSPtr& node) { return node.get() == server; });
+  if (it != failover->pending.end()) {
+    failover->pending.erase(it);
+  }
+}
+
+void SentinelWatcher::HandleDisconnectFinished(const events_info::DisConnectInfoResponse& res) {
+  if (res.initiator() != this) {
+    return;
+  }
+
+  IServer* server = qobject_cast<IServer*>(sender());
+  std::string master_name;
+  Failover* failover = FindFailover(server, &master_name);
+  if (!failover) {
+    return;
+  }
+
+  IServerRemote* remote = static_cast<IServerRemote*>(server);
+  if (server->IsConnected()) {
+    failover->info.err = common::make_error("Failed to disconnect from old master");
+    RemovePending(failover, server);
+    if (failover->pending.empty()) {
+      FinishFailover(master_name);
+    }
+    return;
+  }
+
+  remote->SetHost(failover->new_host);
+  events_info::ConnectInfoRequest req(this);
+  server->Connect(req);
+}
+
+void SentinelWatcher::HandleConnectFinished(const events_info::ConnectInfoResponse& res) {
+  if (res.initiator() != this) {
+    return;
+  }
+
+  IServer* server = qobject_cast<IServer*>(sender());
+  std::string master_name;
+  Failover* failover = FindFailover(server, &master_name);
+  if (!failover) {
+    return;
+  }
+
+  common::Error err = res.errorInfo();
+  if (err) {
+    failover->info.err = err;
+  }
+
+  RemovePending(failover, server);
+  if (failover->pending.empty()) {
+    FinishFailover(master_name);
+  }
+}
+
+void SentinelWatcher::FinishFailover(const std::string& master_name) {
+  auto it = failovers_.find(master_name);
+  if (it == failovers_.end()) {
+    return;
+  }
+
+  SentinelFailoverInfo info = it->second.info;
+  info.reconnect_msec = common::time::current_utc_mstime() - it->second.switch_msec;
+  failovers_.erase(it);
+
+  INFO_LOG() << "Sentinel failover of " << info.master_name << ": " << info.old_address << " -> " << info.new_address
+             << ", detected in " << info.detection_msec << " msec, " << info.rerouted_count
+             << " connection(s) rerouted in " << info.reconnect_msec << " msec"
+             << (info.err ? ", error: " + info.err->GetDescription() : std::string());
+  emit FailoverFinished(info);
+  StartQueuedFailover(master_name);
+}
+
+void SentinelWatcher::StartQueuedFailover(const std::string& master_name) {
+  // a switch without nodes to reroute finishes at once and starts the next one by itself
+  while (failovers_.find(master_name) == failovers_.end()) {
+    auto queued = queued_.find(master_name);
+    if (queued == queued_.end()) {
+      return;
+    }
+
+    const SentinelEvent event = queued->second.front();
+    queued->second.pop_front();
+    if (queued->second.empty()) {
+      queued_.erase(queued);
+    }
+    StartFailover(event);
+  }
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -0,0 +1,137 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <QObject>
+
+#include <common/error.h>
+#include <common/net/types.h>
+
+#include "proxy/events/events_info.h"
+#include "proxy/sentinel/isentinel.h"
+
+namespace fastonosql {
+namespace proxy {
+
+// message of sentinel pub/sub channels
+struct SentinelEvent {
+  enum Type { SWITCH_MASTER, SUBJECTIVE_DOWN, OBJECTIVE_DOWN, DOWN_CLEARED };
+
+  SentinelEvent();
+
+  Type type;
+  bool is_master;
+  std::string master_name;
+  std::string address;      // ip:port of instance, old master for switch
+  std::string new_address;  // ip:port of promoted replica for switch
+};
+
+bool ParseSentinelEvent(const std::string& channel, const std::string& payload, SentinelEvent* event);
+
+struct SentinelFailoverInfo {
+  SentinelFailoverInfo();
+
+  std::string master_name;
+  std::string old_address;
+  std::string new_address;
+  common::time64_t detection_msec;  // first down report to +switch-master, -1 if down wasn't seen
+  common::time64_t reconnect_msec;  // +switch-master to all rerouted drivers connected
+  size_t rerouted_count;
+  common::Error err;
+};
+
+// subscribed connection to one sentinel, reconnects until stopped, lives in own thread
+class SentinelListener : public QObject {
+  Q_OBJECT
+
+ public:
+  enum { poll_interval_msec = 200, reconnect_delay_msec = 3000, connect_timeout_sec = 5 };
+
+  SentinelListener(const common::net::HostAndPort& host, const std::string& auth, QObject* parent = Q_NULLPTR);
+
+  void Stop();  // thread safe
+
+ Q_SIGNALS:
+  void MessageReceived(const QString& channel, const QString& payload);
+  void Finished();
+
+ public Q_SLOTS:
+  void Routine();
+
+ private:
+  common::Error Listen();
+
+  const common::net::HostAndPort host_;
+  const std::string auth_;
+  std::atomic<bool> stop_;
+};
+
+// follows failovers announced by sentinels: drivers connected to the old master
+// are disconnected, pointed to the promoted replica and connected again
+class SentinelWatcher : public QObject {
+  Q_OBJECT
+
+ public:
+  explicit SentinelWatcher(QObject* parent = Q_NULLPTR);
+  ~SentinelWatcher() override;
+
+  void Start(const ISentinel::sentinels_t& sentinels);
+  void Stop();
+  bool IsRunning() const;
+
+ Q_SIGNALS:
+  void MasterDown(const std::string& master_name, const std::string& address);
+  void FailoverFinished(const proxy::SentinelFailoverInfo& info);
+
+ private Q_SLOTS:
+  void HandleMessage(const QString& channel, const QString& payload);
+  void HandleDisconnectFinished(const events_info::DisConnectInfoResponse& res);
+  void HandleConnectFinished(const events_info::ConnectInfoResponse& res);
+
+ private:
+  struct Failover {
+    SentinelFailoverInfo info;
+    common::net::HostAndPort new_host;
+    common::time64_t switch_msec;
+    std::vector<IServerSPtr> pending;
+  };
+
+  void HandleSwitchMaster(const SentinelEvent& event);
+  void StartFailover(const SentinelEvent& event);
+  void StartQueuedFailover(const std::string& master_name);
+  Failover* FindFailover(IServer* server, std::string* master_name);
+  void RemovePending(Failover* failover, IServer* server);
+  void FinishFailover(const std::string& master_name);
+
+  std::vector<SentinelListener*> listeners_;
+  std::vector<IServerSPtr> nodes_;
+  std::map<std::string, common::time64_t> down_since_;       // master name -> first down report
+  std::map<std::string, std::string> applied_;               // master name -> current address, every sentinel reports
+  std::map<std::string, Failover> failovers_;                // master name -> reroute in progress
+  std::map<std::string, std::deque<SentinelEvent>> queued_;  // master name -> switches after the running one
+};
+
+}  // namespace proxy
+}  // namespace fastonosql
@@ -28,6 +28,8 @@
 #include <fastonosql/core/db_traits.h>
 
 #include "proxy/driver/idriver.h"
+#include "proxy/metrics_registry.h"
+#include "proxy/request_tracer.h"
 
 namespace fastonosql {
 namespace proxy {
@@ -121,6 +123,10 @@ std::string IServer::GetName() const {
   return path.GetName();
 }
 
+IConnectionSettingsBaseSPtr IServer::CloneSettings() const {
+  return drv_->CloneSettings();
+}
+
 core::IServerInfoSPtr IServer::GetCurrentServerInfo() const {
   return drv_->GetCurrentServerInfoIfConnected();
 }
@@ -191,6 +197,24 @@ void IServer::LoadDatabaseContent(const events_info::LoadDatabaseContentRequest&
   NotifyStartEvent(ev);
 }
 
+void IServer::FindBigKeys(const events_info::FindBigKeysRequest& req) {
+  emit FindBigKeysStarted(req);
+  QEvent* ev = new events::FindBigKeysRequestEvent(this, req);
+  NotifyStartEvent(ev);
+}
+
+void IServer::LoadKeysDigest(const events_info::KeysDigestRequest& req) {
+  emit LoadKeysDigestStarted(req);
+  QEvent* ev = new events::KeysDigestRequestEvent(this, req);
+  NotifyStartEvent(ev);
+}
+
+void IServer::BulkDelete(const events_info::BulkDeleteRequest& req) {
+  emit BulkDeleteStarted(req);
+  QEvent* ev = new events::BulkDeleteRequestEvent(this, req);
+  NotifyStartEvent(ev);
+}
+
 void IServer::Execute(const events_info::ExecuteInfoRequest& req) {
   emit ExecuteStarted(req);
   QEvent* ev = new events::ExecuteRequestEvent(this, req);
@@ -252,6 +276,7 @@ void IServer::LoadClients(const events_info::LoadServerClientsRequest& req) {
 }
 
 void IServer::customEvent(QEvent* event) {
+  RequestTracer::ScopedHandling handling(event, false);
   QEvent::Type type = event->type();
   if (type == static_cast<QEvent::Type>(events::ConnectResponseEvent::EventType)) {
     events::ConnectResponseEvent* ev = static_cast<events::ConnectResponseEvent*>(event);
@@ -317,6 +342,15 @@ void IServer::customEvent(QEvent* event) {
   } else if (type == static_cast<QEvent::Type>(events::LoadDatabaseContentResponseEvent::EventType)) {
     events::LoadDatabaseContentResponseEvent* ev = static_cast<events::LoadDatabaseContentResponseEvent*>(event);
     HandleLoadDatabaseContentEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::FindBigKeysResponseEvent::EventType)) {
+    events::FindBigKeysResponseEvent* ev = static_cast<events::FindBigKeysResponseEvent*>(event);
+    HandleFindBigKeysEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::KeysDigestResponseEvent::EventType)) {
+    events::KeysDigestResponseEvent* ev = static_cast<events::KeysDigestResponseEvent*>(event);
+    HandleKeysDigestEvent(ev);
+  } else if (type == static_cast<QEvent::Type>(events::BulkDeleteResponseEvent::EventType)) {
+    events::BulkDeleteResponseEvent* ev = static_cast<events::BulkDeleteResponseEvent*>(event);
+    HandleBulkDeleteEvent(ev);
   } else if (type == static_cast<QEvent::Type>(events::ExecuteResponseEvent::EventType)) {
     events::ExecuteResponseEvent* ev = static_cast<events::ExecuteResponseEvent*>(event);
     HandleExecuteEvent(ev);
@@ -343,6 +377,8 @@ void IServer::timerEvent(QTimerEvent* event) {
 void IServer::NotifyStartEvent(QEvent* ev) {
   events_info::ProgressInfoResponse resp(0);
   emit ProgressChanged(resp);
+  RequestTracer::GetInstance().TracePost(ev, false);
+  MetricsRegistry::GetInstance().RequestQueued(drv_->GetConnectionPath().ToString());
   qApp->postEvent(drv_, ev);
 }
 
@@ -494,6 +530,62 @@ void IServer::HandleLoadDatabaseContentEvent(events::LoadDatabaseContentResponse
   emit LoadDatabaseContentFinished(v);
 }
 
+void IServer::HandleFindBigKeysEvent(events::FindBigKeysResponseEvent* ev) {
+  auto v = ev->value();
+  common::Error err = v.errorInfo();
+  if (!v.is_finished && !err) {
+    emit FindBigKeysUpdated(v);
+    return;
+  }
+
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+  emit FindBigKeysFinished(v);
+}
+
+void IServer::HandleKeysDigestEvent(events::KeysDigestResponseEvent* ev) {
+  auto v = ev->value();
+  common::Error err = v.errorInfo();
+  if (!v.is_finished && !err) {
+    emit LoadKeysDigestUpdated(v);
+    return;
+  }
+
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+  emit LoadKeysDigestFinished(v);
+}
+
+void IServer::HandleBulkDeleteEvent(events::BulkDeleteResponseEvent* ev) {
+  auto v = ev->value();
+  database_t cdb = GetCurrentDatabaseInfo();
+  if (cdb && !v.removed_keys.empty()) {
+    // only loaded keys are interesting for views, one signal per batch
+    core::NKeys removed;
+    for (const core::NKey& key : v.removed_keys) {
+      if (cdb->RemoveKey(key)) {
+        removed.push_back(key);
+      }
+    }
+    if (!removed.empty()) {
+      emit KeysRemoved(cdb, removed);
+    }
+  }
+
+  if (!v.is_finished) {
+    emit BulkDeleteUpdated(v);
+    return;
+  }
+
+  common::Error err = v.errorInfo();
+  if (err) {
+    LOG_ERROR(err, common::logging::LOG_LEVEL_ERR, true);
+  }
+  emit BulkDeleteFinished(v);
+}
+
 void IServer::CreateDB(core::IDataBaseInfoSPtr db) {
   database_t dbs = FindDatabase(db);
   if (!dbs) {
@@ -24,6 +24,7 @@
 #include <fastonosql/core/db_traits.h>
 #include <fastonosql/core/icommand_translator.h>
 
+#include "proxy/connection_settings/settings_fwd.h"
 #include "proxy/events/events.h"
 #include "proxy/proxy_fwd.h"
 #include "proxy/server/iserver_base.h"
@@ -55,6 +56,7 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   core::ConnectionType GetType() const;
   std::vector<core::info_field_t> GetInfoFields() const;
   std::string GetName() const override;
+  IConnectionSettingsBaseSPtr CloneSettings() const;  // for own connections to the same server
 
   database_t GetCurrentDatabaseInfo() const;
   core::IServerInfoSPtr GetCurrentServerInfo() const;
@@ -116,6 +118,18 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   void LoadDataBaseContentStarted(const events_info::LoadDatabaseContentRequest& req);
   void LoadDatabaseContentFinished(const events_info::LoadDatabaseContentResponse& res);
 
+  void FindBigKeysStarted(const events_info::FindBigKeysRequest& req);
+  void FindBigKeysUpdated(const events_info::FindBigKeysResponse& res);
+  void FindBigKeysFinished(const events_info::FindBigKeysResponse& res);
+
+  void LoadKeysDigestStarted(const events_info::KeysDigestRequest& req);
+  void LoadKeysDigestUpdated(const events_info::KeysDigestResponse& res);
+  void LoadKeysDigestFinished(const events_info::KeysDigestResponse& res);
+
+  void BulkDeleteStarted(const events_info::BulkDeleteRequest& req);
+  void BulkDeleteUpdated(const events_info::BulkDeleteResponse& res);
+  void BulkDeleteFinished(const events_info::BulkDeleteResponse& res);
+
   void LoadDiscoveryInfoStarted(const events_info::DiscoveryInfoRequest& res);
   void LoadDiscoveryInfoFinished(const events_info::DiscoveryInfoResponse& res);
 
@@ -132,6 +146,7 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
 
   void KeyAdded(core::IDataBaseInfoSPtr db, core::NDbKValue key);
   void KeyRemoved(core::IDataBaseInfoSPtr db, core::NKey key);
+  void KeysRemoved(core::IDataBaseInfoSPtr db, core::NKeys keys);  // batch of loaded keys removed at once
   void KeyLoaded(core::IDataBaseInfoSPtr db, core::NDbKValue key);
   void KeyRenamed(core::IDataBaseInfoSPtr db, core::NKey key, core::nkey_t new_name);
   void KeyTTLChanged(core::IDataBaseInfoSPtr db, core::NKey key, core::ttl_t ttl);
@@ -146,6 +161,12 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
                                                                          // LoadDatabasesFinished
   void LoadDatabaseContent(const events_info::LoadDatabaseContentRequest& req);  // signals: LoadDataBaseContentStarted,
                                                                                  // LoadDatabaseContentFinished
+  void FindBigKeys(const events_info::FindBigKeysRequest& req);  // signals: FindBigKeysStarted, FindBigKeysUpdated,
+                                                                 // FindBigKeysFinished
+  void LoadKeysDigest(const events_info::KeysDigestRequest& req);  // signals: LoadKeysDigestStarted,
+                                                                   // LoadKeysDigestUpdated, LoadKeysDigestFinished
+  void BulkDelete(const events_info::BulkDeleteRequest& req);  // signals: BulkDeleteStarted, BulkDeleteUpdated,
+                                                               // BulkDeleteFinished, KeysRemoved
   void Execute(const events_info::ExecuteInfoRequest& req);                      // signals: ExecuteStarted
 
   void BackupToPath(const events_info::BackupInfoRequest& req);      // signals: BackupStarted, BackupFinished
@@ -196,6 +217,9 @@ class IServer : public IServerBase, public std::enable_shared_from_this<IServer>
   // handle database events
   virtual void HandleLoadDatabaseInfosEvent(events::LoadDatabasesInfoResponseEvent* ev);
   virtual void HandleLoadDatabaseContentEvent(events::LoadDatabaseContentResponseEvent* ev);
+  virtual void HandleFindBigKeysEvent(events::FindBigKeysResponseEvent* ev);
+  virtual void HandleKeysDigestEvent(events::KeysDigestResponseEvent* ev);
+  virtual void HandleBulkDeleteEvent(events::BulkDeleteResponseEvent* ev);
 
   // handle command events
   virtual void HandleDiscoveryInfoResponseEvent(events::DiscoveryInfoResponseEvent* ev);
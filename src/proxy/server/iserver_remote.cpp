@@ -18,6 +18,8 @@
 
 #include "proxy/server/iserver_remote.h"
 
+#include "proxy/driver/idriver_remote.h"
+
 namespace fastonosql {
 namespace proxy {
 
@@ -25,5 +27,11 @@ IServerRemote::IServerRemote(IDriver* drv) : IServer(drv) {
   CHECK(IsCanRemote());
 }
 
+void IServerRemote::SetHost(const common::net::HostAndPort& host) {
+  CHECK(!IsConnected()) << "Host can be changed only while disconnected.";
+  IDriverRemote* rdrv = static_cast<IDriverRemote*>(drv_);
+  rdrv->SetHost(host);
+}
+
 }  // namespace proxy
 }  // namespace fastonosql
@@ -28,6 +28,8 @@ class IServerRemote : public IServer {
 
  public:
   virtual common::net::HostAndPort GetHost() const = 0;
+  // takes effect on the next connect, used to follow a master after failover
+  void SetHost(const common::net::HostAndPort& host);
   virtual core::ServerMode GetMode() const = 0;
   virtual core::ServerType GetRole() const = 0;
   virtual core::ServerState GetState() const = 0;
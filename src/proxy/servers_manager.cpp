@@ -18,14 +18,25 @@
 
 #include "proxy/servers_manager.h"
 
+#include <functional>
+#include <memory>
 #include <vector>
 
+#include <common/net/socket_tcp.h>
+#include <common/time.h>
+
+#include "proxy/command/command.h"
+#include "proxy/connection_settings/iconnection_settings_ssh.h"
+#include "proxy/deadline_caller.h"
+#include "proxy/resp_client.h"
+
 #if defined(ENTERPRISE_VERSION)
 #define PRO_VERSION
 #endif
 
 #if defined(BUILD_WITH_REDIS)
 #include <fastonosql/core/db/redis/db_connection.h>
+#include "proxy/db/redis/command.h"
 #include "proxy/db/redis/connection_settings.h"
 #include "proxy/db/redis/server.h"
 
@@ -79,18 +90,21 @@
 
 #if defined(BUILD_WITH_PIKA)
 #include <fastonosql/core/db/pika/db_connection.h>
+#include "proxy/db/pika/command.h"
 #include "proxy/db/pika/connection_settings.h"
 #include "proxy/db/pika/server.h"
 #endif
 
 #if defined(BUILD_WITH_DYNOMITE)
 #include <fastonosql/core/db/dynomite/db_connection.h>
+#include "proxy/db/dynomite/command.h"
 #include "proxy/db/dynomite/connection_settings.h"
 #include "proxy/db/dynomite/server.h"
 #endif
 
 #if defined(BUILD_WITH_KEYDB)
 #include <fastonosql/core/db/keydb/db_connection.h>
+#include "proxy/db/keydb/command.h"
 #include "proxy/db/keydb/connection_settings.h"
 #include "proxy/db/keydb/server.h"
 
@@ -109,6 +123,112 @@ namespace fastonosql {
 namespace proxy {
 
 namespace {
+// key:value lines of INFO reply
+void ParseHealthInfo(const std::string& content, ServersManager::HealthInfo* info) {
+  size_t start = 0;
+  while (start < content.size()) {
+    size_t end = content.find('\n', start);
+    if (end == std::string::npos) {
+      end = content.size();
+    }
+
+    std::string line = content.substr(start, end - start);
+    start = end + 1;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+
+    const size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+      continue;
+    }
+
+    const std::string field = line.substr(0, colon);
+    const std::string value = line.substr(colon + 1);
+    if (field == "role") {
+      info->role = value;
+    } else if (field == "redis_version" || (field.size() > 8 && field.compare(field.size() - 8, 8, "_version") == 0 &&
+                                            info->version.empty())) {
+      info->version = value;
+    } else if (field == "used_memory_human") {
+      info->used_memory = value;
+    }
+  }
+}
+
+common::Error CheckRespHealth(const common::net::HostAndPort& host,
+                              const std::string& auth,
+                              common::time64_t timeout_msec,
+                              ServersManager::HealthInfo* info) {
+  RespClient client(host, auth, timeout_msec);
+  common::time64_t start = common::time::current_utc_mstime();
+  common::Error err = client.Connect();
+  if (err) {
+    return err;
+  }
+  info->connect_msec = common::time::current_utc_mstime() - start;
+
+  RespReply reply;
+  start = common::time::current_utc_mstime();
+  err = client.Execute({"PING"}, &reply);
+  if (err) {
+    return err;
+  }
+  info->ping_msec = common::time::current_utc_mstime() - start;
+
+  // not fatal, proxies like dynomite don't know INFO
+  if (!client.Execute({"INFO"}, &reply) && reply.type == RespReply::STRING) {
+    ParseHealthInfo(reply.str, info);
+  }
+  return common::Error();
+}
+
+// used only where RespClient can't go, core connection has no timeouts so it runs under CheckBounded
+template <typename Connection, typename Command, typename Config>
+common::Error CheckRedisCompatibleHealth(const Config& config, ServersManager::HealthInfo* info) {
+  Connection connection(nullptr);
+  common::time64_t start = common::time::current_utc_mstime();
+  common::Error err = connection.Connect(config);
+  if (err) {
+    return err;
+  }
+  info->connect_msec = common::time::current_utc_mstime() - start;
+
+  core::FastoObjectCommandIPtr ping = CreateCommandFast<Command>(GEN_CMD_STRING("PING"), core::C_INNER);
+  start = common::time::current_utc_mstime();
+  err = connection.Execute(ping->GetInputCommand(), ping.get());
+  if (err) {
+    common::Error disconnect_err = connection.Disconnect();
+    UNUSED(disconnect_err);
+    return err;
+  }
+  info->ping_msec = common::time::current_utc_mstime() - start;
+
+  // not fatal, proxies like dynomite don't know INFO
+  core::FastoObjectCommandIPtr stat = CreateCommandFast<Command>(GEN_CMD_STRING("INFO"), core::C_INNER);
+  if (!connection.Execute(stat->GetInputCommand(), stat.get())) {
+    ParseHealthInfo(common::ConvertToString(stat.get()), info);
+  }
+  err = connection.Disconnect();
+  UNUSED(err);
+  return common::Error();
+}
+
+// a host which never answers costs an abandoned thread instead of a pool thread of the caller
+common::Error CheckBounded(std::function<common::Error(ServersManager::HealthInfo*)> check,
+                           common::time64_t timeout_msec,
+                           ServersManager::HealthInfo* info) {
+  std::shared_ptr<ServersManager::HealthInfo> result = std::make_shared<ServersManager::HealthInfo>();
+  DeadlineCaller caller(timeout_msec);
+  common::Error err = caller.Call([check, result]() { return check(result.get()); });
+  if (err) {
+    return err;
+  }
+
+  *info = *result;
+  return common::Error();
+}
+
 IServerSPtr CreateServerImpl(IConnectionSettingsBaseSPtr settings) {
   const core::ConnectionType connection_type = settings->GetType();
 #if defined(BUILD_WITH_REDIS)
@@ -266,6 +386,96 @@ common::Error ServersManager::TestConnection(IConnectionSettingsBaseSPtr connect
   return common::make_error("Invalid setting type");
 }
 
+ServersManager::HealthInfo::HealthInfo() : connect_msec(0), ping_msec(-1), role(), version(), used_memory() {}
+
+common::Error ServersManager::CheckHealth(IConnectionSettingsBaseSPtr connection,
+                                          common::time64_t timeout_msec,
+                                          HealthInfo* info) {
+  if (!connection || !info) {
+    DNOTREACHED();
+    return common::make_error_inval();
+  }
+
+  common::net::HostAndPort resp_host;
+  std::string resp_auth;
+  if (GetRespEndpoint(connection, &resp_host, &resp_auth)) {
+    return CheckRespHealth(resp_host, resp_auth, timeout_msec, info);
+  }
+
+  // hosts behind ssh tunnels are reachable only through the tunnel
+  IConnectionSettingsRemote* remote = dynamic_cast<IConnectionSettingsRemote*>(connection.get());
+  IConnectionSettingsRemoteSSH* ssh = dynamic_cast<IConnectionSettingsRemoteSSH*>(connection.get());
+  if (remote && !(ssh && ssh->GetSSHInfo().IsValid())) {
+    common::net::SocketGuard<common::net::ClientSocketTcp> probe(remote->GetHost());
+    struct timeval tv;
+    tv.tv_sec = timeout_msec / 1000;
+    tv.tv_usec = (timeout_msec % 1000) * 1000;
+    common::ErrnoError err = probe.Connect(&tv);
+    if (err) {
+      return common::make_error_from_errno(err);
+    }
+  }
+
+  const core::ConnectionType connection_type = connection->GetType();
+#if defined(BUILD_WITH_REDIS)
+  if (connection_type == core::REDIS) {
+    redis::ConnectionSettings* settings = static_cast<redis::ConnectionSettings*>(connection.get());
+    const core::redis::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    return CheckBounded(
+        [rconfig](HealthInfo* result) {
+          return CheckRedisCompatibleHealth<core::redis::DBConnection, redis::Command>(rconfig, result);
+        },
+        timeout_msec, info);
+  }
+#endif
+#if defined(BUILD_WITH_PIKA)
+  if (connection_type == core::PIKA) {
+    pika::ConnectionSettings* settings = static_cast<pika::ConnectionSettings*>(connection.get());
+    const core::pika::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    return CheckBounded(
+        [rconfig](HealthInfo* result) {
+          return CheckRedisCompatibleHealth<core::pika::DBConnection, pika::Command>(rconfig, result);
+        },
+        timeout_msec, info);
+  }
+#endif
+#if defined(BUILD_WITH_DYNOMITE)
+  if (connection_type == core::DYNOMITE) {
+    dynomite::ConnectionSettings* settings = static_cast<dynomite::ConnectionSettings*>(connection.get());
+    const core::dynomite::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    return CheckBounded(
+        [rconfig](HealthInfo* result) {
+          return CheckRedisCompatibleHealth<core::dynomite::DBConnection, dynomite::Command>(rconfig, result);
+        },
+        timeout_msec, info);
+  }
+#endif
+#if defined(BUILD_WITH_KEYDB)
+  if (connection_type == core::KEYDB) {
+    keydb::ConnectionSettings* settings = static_cast<keydb::ConnectionSettings*>(connection.get());
+    const core::keydb::RConfig rconfig(settings->GetInfo(), settings->GetSSHInfo());
+    return CheckBounded(
+        [rconfig](HealthInfo* result) {
+          return CheckRedisCompatibleHealth<core::keydb::DBConnection, keydb::Command>(rconfig, result);
+        },
+        timeout_msec, info);
+  }
+#endif
+
+  // other databases only know how to connect
+  return CheckBounded(
+      [this, connection](HealthInfo* result) {
+        const common::time64_t start = common::time::current_utc_mstime();
+        common::Error err = TestConnection(connection);
+        if (err) {
+          return err;
+        }
+        result->connect_msec = common::time::current_utc_mstime() - start;
+        return common::Error();
+      },
+      timeout_msec, info);
+}
+
 void ServersManager::Clear() {
   servers_.clear();
 }
@@ -425,6 +635,7 @@ void ServersManager::CloseSentinel(sentinel_t sentinel) {
     return;
   }
 
+  sentinel->StopWatch();
   auto nodes = sentinel->GetSentinels();
   for (auto node : nodes) {
     auto sent_nodes = node.sentinels_nodes;
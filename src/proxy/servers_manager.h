@@ -18,11 +18,13 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include <common/patterns/singleton_pattern.h>
 
 #include <common/error.h>
+#include <common/types.h>
 
 #include "proxy/connection_settings/iconnection_settings.h"
 
@@ -45,8 +47,26 @@ class ServersManager : public common::patterns::LazySingleton<ServersManager> {
  public:
   typedef IServerSPtr server_t;
   typedef std::vector<server_t> servers_t;
+
+  // filled by CheckHealth, fields the database doesn't report stay empty
+  struct HealthInfo {
+    HealthInfo();
+
+    common::time64_t connect_msec;
+    common::time64_t ping_msec;  // -1 if not measured
+    std::string role;
+    std::string version;
+    std::string used_memory;
+  };
+
   server_t CreateServer(IConnectionSettingsBaseSPtr settings);
   common::Error TestConnection(IConnectionSettingsBaseSPtr connection) WARN_UNUSED_RESULT;
+  // thread safe, redis compatible servers over plain tcp answer PING and INFO with connect and
+  // every command limited by timeout; tls, ssh and unix socket hosts go through the core connection
+  // on an own thread abandoned after timeout, other databases only connect the same way
+  common::Error CheckHealth(IConnectionSettingsBaseSPtr connection,
+                            common::time64_t timeout_msec,
+                            HealthInfo* info) WARN_UNUSED_RESULT;
   void CloseServer(server_t server);
 
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
@@ -33,6 +33,7 @@
 
 #include "proxy/connection_settings/iconnection_settings.h"
 #include "proxy/connection_settings_factory.h"
+#include "proxy/startup_profiler.h"
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
 #include "proxy/cluster_connection_settings_factory.h"
 #include "proxy/connection_settings/icluster_connection_settings.h"
@@ -68,6 +69,7 @@
 #endif
 #define SHOW_WELCOME_PAGE PREFIX "show_welcome_page"
 #define PYTHON_PATH PREFIX "python_path"
+#define MIGRATION_CHECKPOINTS PREFIX "migration_checkpoints"
 #define CONFIG_VERSION PREFIX "version"
 
 #if defined(OS_WIN)
@@ -111,9 +113,12 @@ SettingsManager::SettingsManager()
       cur_language_(),
       send_statistic_(),
       connections_(),
+      raw_connections_(),
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
       sentinels_(),
+      raw_sentinels_(),
       clusters_(),
+      raw_clusters_(),
       last_login_(),
       last_password_(),
       user_info_(),
@@ -125,7 +130,8 @@ SettingsManager::SettingsManager()
       auto_open_console_(),
       auto_connect_db_(),
       window_settings_(),
-      python_path_() {
+      python_path_(),
+      migration_checkpoints_() {
 }
 
 SettingsManager::~SettingsManager() {}
@@ -214,6 +220,7 @@ void SettingsManager::AddConnection(IConnectionSettingsBaseSPtr connection) {
     return;
   }
 
+  DecodeConnections();
   auto it = std::find(connections_.begin(), connections_.end(), connection);
   if (it == connections_.end()) {
     connections_.push_back(connection);
@@ -226,10 +233,12 @@ void SettingsManager::RemoveConnection(IConnectionSettingsBaseSPtr connection) {
     return;
   }
 
+  DecodeConnections();
   connections_.erase(std::remove(connections_.begin(), connections_.end(), connection));
 }
 
 SettingsManager::connection_settings_t SettingsManager::GetConnections() const {
+  DecodeConnections();
   return connections_;
 }
 
@@ -240,6 +249,7 @@ void SettingsManager::AddSentinel(ISentinelSettingsBaseSPtr sentinel) {
     return;
   }
 
+  DecodeConnections();
   auto it = std::find(sentinels_.begin(), sentinels_.end(), sentinel);
   if (it == sentinels_.end()) {
     sentinels_.push_back(sentinel);
@@ -252,10 +262,12 @@ void SettingsManager::RemoveSentinel(ISentinelSettingsBaseSPtr sentinel) {
     return;
   }
 
+  DecodeConnections();
   sentinels_.erase(std::remove(sentinels_.begin(), sentinels_.end(), sentinel));
 }
 
 SettingsManager::sentinel_settings_t SettingsManager::GetSentinels() const {
+  DecodeConnections();
   return sentinels_;
 }
 
@@ -265,6 +277,7 @@ void SettingsManager::AddCluster(IClusterSettingsBaseSPtr cluster) {
     return;
   }
 
+  DecodeConnections();
   auto it = std::find(clusters_.begin(), clusters_.end(), cluster);
   if (it == clusters_.end()) {
     clusters_.push_back(cluster);
@@ -277,10 +290,12 @@ void SettingsManager::RemoveCluster(IClusterSettingsBaseSPtr cluster) {
     return;
   }
 
+  DecodeConnections();
   clusters_.erase(std::remove(clusters_.begin(), clusters_.end(), cluster));
 }
 
 SettingsManager::cluster_settings_t SettingsManager::GetClusters() const {
+  DecodeConnections();
   return clusters_;
 }
 #endif
@@ -370,6 +385,19 @@ void SettingsManager::SetPythonPath(const QString& path) {
   python_path_ = path;
 }
 
+QVariantMap SettingsManager::GetMigrationCheckpoint(const QString& id) const {
+  return migration_checkpoints_.value(id).toMap();
+}
+
+void SettingsManager::SetMigrationCheckpoint(const QString& id, const QVariantMap& checkpoint) {
+  if (checkpoint.isEmpty()) {
+    migration_checkpoints_.remove(id);
+    return;
+  }
+
+  migration_checkpoints_[id] = checkpoint;
+}
+
 void SettingsManager::ReloadFromPath(const std::string& path, bool merge) {
   if (path.empty()) {
     return;
@@ -378,9 +406,12 @@ void SettingsManager::ReloadFromPath(const std::string& path, bool merge) {
   if (!merge) {
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
     sentinels_.clear();
+    raw_sentinels_.clear();
     clusters_.clear();
+    raw_clusters_.clear();
 #endif
     connections_.clear();
+    raw_connections_.clear();
     recent_connections_.clear();
   }
 
@@ -406,8 +437,50 @@ void SettingsManager::ReloadFromPath(const std::string& path, bool merge) {
   SetLoggingDirectory(logging_dir);
 
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
-  const QList<QVariant> clusters = settings.value(CLUSTERS).toList();
-  for (const auto& cluster : clusters) {
+  raw_clusters_.append(settings.value(CLUSTERS).toList());
+  raw_sentinels_.append(settings.value(SENTINELS).toList());
+  last_login_ = settings.value(LAST_LOGIN, QString()).toString();
+  last_password_ = settings.value(LAST_PASSWORD_HASH, QString()).toString();
+#endif
+
+  raw_connections_.append(settings.value(CONNECTIONS).toList());
+
+  const QStringList rconnections = settings.value(RCONNECTIONS).toStringList();
+  for (const auto& rconnection : rconnections) {
+    recent_connections_.push_back(rconnection);
+  }
+
+  show_welcome_page_ = settings.value(SHOW_WELCOME_PAGE, true).toBool();
+  auto_check_updates_ = settings.value(CHECKUPDATES, true).toBool();
+  auto_completion_ = settings.value(AUTOCOMPLETION, true).toBool();
+  auto_open_console_ = settings.value(AUTOOPENCONSOLE, true).toBool();
+  auto_connect_db_ = settings.value(AUTOCONNECTDB, true).toBool();
+  window_settings_ = settings.value(WINDOW_SETTINGS, QByteArray()).toByteArray();
+
+  QString qpython_path;
+  std::string python_path;
+  if (common::file_system::find_file_in_path(PYTHON_FILE_NAME, &python_path) &&
+      common::ConvertFromString(python_path, &qpython_path)) {
+  }
+  python_path_ = settings.value(PYTHON_PATH, qpython_path).toString();
+  migration_checkpoints_ = settings.value(MIGRATION_CHECKPOINTS).toMap();
+  config_version_ = settings.value(CONFIG_VERSION, PROJECT_VERSION_NUMBER).toUInt();
+}
+
+void SettingsManager::DecodeConnections() const {
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+  if (raw_connections_.isEmpty() && raw_sentinels_.isEmpty() && raw_clusters_.isEmpty()) {
+    return;
+  }
+#else
+  if (raw_connections_.isEmpty()) {
+    return;
+  }
+#endif
+
+  StartupProfiler::ScopedPhase phase("decode saved connections");
+#if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
+  for (const auto& cluster : raw_clusters_) {
     QString string = cluster.toString();
     common::char_buffer_t raw;
     if (common::utils::base64::decode64(common::ConvertToCharBytes(string), &raw)) {
@@ -417,9 +490,9 @@ void SettingsManager::ReloadFromPath(const std::string& path, bool merge) {
       }
     }
   }
+  raw_clusters_.clear();
 
-  const QList<QVariant> sentinels = settings.value(SENTINELS).toList();
-  for (const auto& sentinel : sentinels) {
+  for (const auto& sentinel : raw_sentinels_) {
     QString string = sentinel.toString();
     common::char_buffer_t raw;
     if (common::utils::base64::decode64(common::ConvertToCharBytes(string), &raw)) {
@@ -430,12 +503,10 @@ void SettingsManager::ReloadFromPath(const std::string& path, bool merge) {
       }
     }
   }
-  last_login_ = settings.value(LAST_LOGIN, QString()).toString();
-  last_password_ = settings.value(LAST_PASSWORD_HASH, QString()).toString();
+  raw_sentinels_.clear();
 #endif
 
-  const QList<QVariant> connections = settings.value(CONNECTIONS).toList();
-  for (const auto& connection : connections) {
+  for (const auto& connection : raw_connections_) {
     QString string = connection.toString();
     common::char_buffer_t raw;
     if (common::utils::base64::decode64(common::ConvertToCharBytes(string), &raw)) {
@@ -445,26 +516,7 @@ void SettingsManager::ReloadFromPath(const std::string& path, bool merge) {
       }
     }
   }
-
-  const QStringList rconnections = settings.value(RCONNECTIONS).toStringList();
-  for (const auto& rconnection : rconnections) {
-    recent_connections_.push_back(rconnection);
-  }
-
-  show_welcome_page_ = settings.value(SHOW_WELCOME_PAGE, true).toBool();
-  auto_check_updates_ = settings.value(CHECKUPDATES, true).toBool();
-  auto_completion_ = settings.value(AUTOCOMPLETION, true).toBool();
-  auto_open_console_ = settings.value(AUTOOPENCONSOLE, true).toBool();
-  auto_connect_db_ = settings.value(AUTOCONNECTDB, true).toBool();
-  window_settings_ = settings.value(WINDOW_SETTINGS, QByteArray()).toByteArray();
-
-  QString qpython_path;
-  std::string python_path;
-  if (common::file_system::find_file_in_path(PYTHON_FILE_NAME, &python_path) &&
-      common::ConvertFromString(python_path, &qpython_path)) {
-  }
-  python_path_ = settings.value(PYTHON_PATH, qpython_path).toString();
-  config_version_ = settings.value(CONFIG_VERSION, PROJECT_VERSION_NUMBER).toUInt();
+  raw_connections_.clear();
 }
 
 void SettingsManager::Load() {
@@ -497,6 +549,7 @@ void SettingsManager::Save() {
       }
     }
   }
+  clusters.append(raw_clusters_);
   settings.setValue(CLUSTERS, clusters);
 
   QList<QVariant> sentinels;
@@ -511,6 +564,7 @@ void SettingsManager::Save() {
       }
     }
   }
+  sentinels.append(raw_sentinels_);
   settings.setValue(SENTINELS, sentinels);
 #endif
 
@@ -526,6 +580,8 @@ void SettingsManager::Save() {
       }
     }
   }
+  // never decoded in this session, write back as is
+  connections.append(raw_connections_);
   settings.setValue(CONNECTIONS, connections);
 
   QStringList rconnections;
@@ -549,6 +605,7 @@ void SettingsManager::Save() {
   settings.setValue(LAST_PASSWORD_HASH, last_password_);
 #endif
   settings.setValue(PYTHON_PATH, python_path_);
+  settings.setValue(MIGRATION_CHECKPOINTS, migration_checkpoints_);
   settings.setValue(CONFIG_VERSION, config_version_);
 }
 
@@ -22,7 +22,9 @@
 #include <vector>
 
 #include <QFont>
+#include <QList>
 #include <QStringList>
+#include <QVariant>
 
 #include <common/patterns/singleton_pattern.h>
 
@@ -121,6 +123,10 @@ class SettingsManager : public common::patterns::Singleton<SettingsManager> {
   QString GetPythonPath() const;
   void SetPythonPath(const QString& path);
 
+  // last committed migration checkpoints, keyed by source/destination/pattern
+  QVariantMap GetMigrationCheckpoint(const QString& id) const;
+  void SetMigrationCheckpoint(const QString& id, const QVariantMap& checkpoint);  // empty checkpoint removes
+
   void ReloadFromPath(const std::string& path, bool merge);
 
   void Load();
@@ -144,6 +150,10 @@ class SettingsManager : public common::patterns::Singleton<SettingsManager> {
   SettingsManager();
   ~SettingsManager();
 
+  // saved connections are kept base64 encoded until first access,
+  // startup doesn't pay for parsing settings nobody looked at yet
+  void DecodeConnections() const;
+
   uint32_t config_version_;
 
   bool accepted_eula_;
@@ -152,10 +162,13 @@ class SettingsManager : public common::patterns::Singleton<SettingsManager> {
   QFont cur_font_;
   QString cur_language_;
   bool send_statistic_;
-  connection_settings_t connections_;
+  mutable connection_settings_t connections_;
+  mutable QList<QVariant> raw_connections_;
 #if defined(PRO_VERSION) || defined(ENTERPRISE_VERSION)
-  sentinel_settings_t sentinels_;
-  cluster_settings_t clusters_;
+  mutable sentinel_settings_t sentinels_;
+  mutable QList<QVariant> raw_sentinels_;
+  mutable cluster_settings_t clusters_;
+  mutable QList<QVariant> raw_clusters_;
   QString last_login_;
   QString last_password_;
   // runtime settings
@@ -169,6 +182,7 @@ class SettingsManager : public common::patterns::Singleton<SettingsManager> {
   bool auto_connect_db_;
   QByteArray window_settings_;
   QString python_path_;
+  QVariantMap migration_checkpoints_;
 };
 
 }  // namespace proxy
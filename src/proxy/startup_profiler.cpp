@@ -0,0 +1,91 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "proxy/startup_profiler.h"
+
+#include <iostream>
+
+#include <common/logger.h>
+#include <common/sprintf.h>
+#include <common/time.h>
+
+namespace fastonosql {
+namespace proxy {
+
+StartupProfiler::ScopedPhase::ScopedPhase(const std::string& name)
+    : name_(name), start_msec_(common::time::current_utc_mstime()) {}
+
+StartupProfiler::ScopedPhase::~ScopedPhase() {
+  StartupProfiler::GetInstance().AddPhase(name_, start_msec_, common::time::current_utc_mstime());
+}
+
+StartupProfiler::StartupProfiler()
+    : start_msec_(common::time::current_utc_mstime()), phases_(), verbose_(false), finished_(false) {}
+
+void StartupProfiler::SetVerbose(bool verbose) {
+  verbose_ = verbose;
+}
+
+bool StartupProfiler::IsVerbose() const {
+  return verbose_;
+}
+
+void StartupProfiler::AddPhase(const std::string& name, common::time64_t start_msec, common::time64_t finish_msec) {
+  const Phase phase = {name, start_msec - start_msec_, finish_msec - start_msec};
+  if (finished_) {
+    Report(common::MemSPrintf("Lazy init %s: %lld msec", name, static_cast<long long>(phase.duration_msec)));
+    return;
+  }
+
+  phases_.push_back(phase);
+}
+
+std::vector<StartupProfiler::Phase> StartupProfiler::GetPhases() const {
+  return phases_;
+}
+
+bool StartupProfiler::IsFinished() const {
+  return finished_;
+}
+
+void StartupProfiler::Finish() {
+  if (finished_) {
+    return;
+  }
+
+  finished_ = true;
+  for (const Phase& phase : phases_) {
+    Report(common::MemSPrintf("Startup phase %s: %lld msec (at %lld msec)", phase.name,
+                              static_cast<long long>(phase.duration_msec), static_cast<long long>(phase.start_msec)));
+  }
+  const common::time64_t total_msec = common::time::current_utc_mstime() - start_msec_;
+  Report(common::MemSPrintf("Startup finished in %lld msec", static_cast<long long>(total_msec)));
+}
+
+void StartupProfiler::Report(const std::string& line) const {
+  if (!verbose_) {
+    DEBUG_LOG() << line;
+    return;
+  }
+
+  INFO_LOG() << line;
+  std::cerr << line << std::endl;
+}
+
+}  // namespace proxy
+}  // namespace fastonosql
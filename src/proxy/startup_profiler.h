@@ -0,0 +1,77 @@
+/*  Copyright (C) 2014-2022 FastoGT. All right reserved.
+
+    This file is part of FastoNoSQL.
+
+    FastoNoSQL is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    FastoNoSQL is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with FastoNoSQL. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <common/macros.h>
+#include <common/patterns/singleton_pattern.h>
+#include <common/types.h>
+
+namespace fastonosql {
+namespace proxy {
+
+// wall time of startup phases, summary goes to log once main window is shown,
+// phases finished later (lazy initialization on first use) are logged right away
+class StartupProfiler : public common::patterns::LazySingleton<StartupProfiler> {
+ public:
+  friend class common::patterns::LazySingleton<StartupProfiler>;
+
+  struct Phase {
+    std::string name;
+    common::time64_t start_msec;  // since process start
+    common::time64_t duration_msec;
+  };
+
+  class ScopedPhase {
+   public:
+    explicit ScopedPhase(const std::string& name);
+    ~ScopedPhase();
+
+   private:
+    const std::string name_;
+    const common::time64_t start_msec_;
+
+    DISALLOW_COPY_AND_ASSIGN(ScopedPhase);
+  };
+
+  // --profile-startup, summary also printed to stderr and logged with info level
+  void SetVerbose(bool verbose);
+  bool IsVerbose() const;
+
+  void AddPhase(const std::string& name, common::time64_t start_msec, common::time64_t finish_msec);
+  std::vector<Phase> GetPhases() const;
+
+  bool IsFinished() const;
+  void Finish();
+
+ private:
+  StartupProfiler();
+
+  void Report(const std::string& line) const;
+
+  const common::time64_t start_msec_;
+  std::vector<Phase> phases_;
+  bool verbose_;
+  bool finished_;
+};
+
+}  // namespace proxy
+}  // namespace fastonosql